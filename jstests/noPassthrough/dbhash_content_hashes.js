@@ -0,0 +1,75 @@
+/**
+ * Tests that dbHash with 'useContentHashes' reports the content hashes WiredTiger keeps for
+ * collections instead of scanning them, that it only does so when every such collection has one,
+ * and that a full validate restores the hashes a member lost in an unclean shutdown.
+ *
+ * @tags: [requires_replication, requires_persistence, requires_wiredtiger]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({
+    nodes: [{}, {rsConfig: {priority: 0}}],
+    nodeOptions: {setParameter: {wiredTigerCollectionContentHashes: true}}
+});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const primaryDB = primary.getDB("test");
+
+assert.commandWorked(primaryDB.runCommand({create: "capped", capped: true, size: 4096}));
+assert.commandWorked(primaryDB.a.insert([{_id: 0}, {_id: 1, x: 1}, {_id: 2}]));
+assert.commandWorked(primaryDB.b.insert({_id: 0}));
+assert.commandWorked(primaryDB.a.update({_id: 1}, {$set: {x: 2}}));
+assert.commandWorked(primaryDB.a.remove({_id: 2}));
+assert.commandWorked(primaryDB.capped.insert({_id: 0}));
+rst.awaitReplication();
+
+function contentDbHash(node) {
+    return assert.commandWorked(node.getDB("test").runCommand({dbHash: 1, useContentHashes: true}));
+}
+
+// Capped collections do not keep a content hash, so they are scanned as usual.
+const scanned = assert.commandWorked(primaryDB.runCommand({dbHash: 1}));
+assert(!scanned.hasOwnProperty("contentHashed"), tojson(scanned));
+let primaryHash = contentDbHash(primary);
+assert.eq(["a", "b"], primaryHash.contentHashed, tojson(primaryHash));
+assert(primaryHash.collections.a.startsWith("content-"), tojson(primaryHash));
+assert.eq(scanned.collections.capped, primaryHash.collections.capped, tojson(primaryHash));
+
+// The combined hash is reported under another name, so it is never compared with a scan.
+assert(!primaryHash.hasOwnProperty("md5"), tojson(primaryHash));
+assert.neq(undefined, primaryHash.contentMd5, tojson(primaryHash));
+
+let secondary = rst.nodes[1];
+secondary.setSecondaryOk();
+let secondaryHash = contentDbHash(secondary);
+assert.eq(primaryHash.collections, secondaryHash.collections, tojson(secondaryHash));
+assert.eq(primaryHash.contentMd5, secondaryHash.contentMd5, tojson(secondaryHash));
+
+jsTestLog("Killing the secondary, which loses its content hashes");
+rst.stop(1, 9, {allowedExitCode: MongoRunner.EXIT_SIGKILL}, {forRestart: true});
+secondary = rst.start(1, {}, true /* restart */);
+rst.awaitSecondaryNodes();
+secondary.setSecondaryOk();
+
+// Without a trusted hash for every collection, the secondary scans all of them, so its result
+// matches a scan of the primary rather than a mix of both kinds of hashes.
+secondaryHash = contentDbHash(secondary);
+assert.eq([], secondaryHash.contentHashed, tojson(secondaryHash));
+assert(!secondaryHash.hasOwnProperty("contentMd5"), tojson(secondaryHash));
+assert.eq(scanned.md5, secondaryHash.md5, tojson(secondaryHash));
+
+// A full validate recomputes the hashes.
+for (let collName of ["a", "b"]) {
+    const res =
+        assert.commandWorked(secondary.getDB("test").runCommand({validate: collName, full: true}));
+    assert(res.valid, tojson(res));
+}
+secondaryHash = contentDbHash(secondary);
+assert.eq(primaryHash.collections, secondaryHash.collections, tojson(secondaryHash));
+assert.eq(primaryHash.contentMd5, secondaryHash.contentMd5, tojson(secondaryHash));
+
+rst.stopSet();
+})();
@@ -241,7 +241,7 @@ Future<void> AsyncDBClient::initWireVersion(const std::string& appName,
         });
 }
 
-Future<void> AsyncDBClient::_call(Message request, int32_t msgId, const BatonHandle& baton) {
+StatusWith<Message> AsyncDBClient::_prepareRequest(Message request, int32_t msgId) {
     auto swm = _compressorManager.compressMessage(request);
     if (!swm.isOK()) {
         return swm.getStatus();
@@ -257,8 +257,132 @@ Future<void> AsyncDBClient::_call(Message request, int32_t msgId, const BatonHan
 #else
     OpMsg::appendChecksum(&request);
 #endif
+    return request;
+}
+
+Future<void> AsyncDBClient::_call(Message request, int32_t msgId, const BatonHandle& baton) {
+    auto swm = _prepareRequest(std::move(request), msgId);
+    if (!swm.isOK()) {
+        return swm.getStatus();
+    }
+
+    return _session->asyncSinkMessage(swm.getValue(), baton);
+}
+
+Future<Message> AsyncDBClient::_pipeline(Message request, int32_t msgId) {
+    auto [promise, future] = makePromiseFuture<Message>();
+    bool startSending = false;
+    bool startReceiving = false;
+    {
+        stdx::lock_guard<Latch> lk(_pipelineMutex);
+        if (!_pipelineStatus.isOK()) {
+            return _pipelineStatus;
+        }
+
+        auto swm = _prepareRequest(std::move(request), msgId);
+        if (!swm.isOK()) {
+            return swm.getStatus();
+        }
+
+        _pipelineToSend.push_back(std::move(swm.getValue()));
+        invariant(_pipelineAwaiting.emplace(msgId, std::move(promise)).second);
+        startSending = !std::exchange(_pipelineSending, true);
+        startReceiving = !std::exchange(_pipelineReceiving, true);
+    }
+
+    if (startSending) {
+        _sendPipelined();
+    }
+    if (startReceiving) {
+        _receivePipelined();
+    }
+    return std::move(future);
+}
 
-    return _session->asyncSinkMessage(request, baton);
+void AsyncDBClient::_sendPipelined() {
+    Message request;
+    {
+        stdx::lock_guard<Latch> lk(_pipelineMutex);
+        if (!_pipelineStatus.isOK() || _pipelineToSend.empty()) {
+            _pipelineSending = false;
+            return;
+        }
+        request = std::move(_pipelineToSend.front());
+        _pipelineToSend.pop_front();
+    }
+
+    _session->asyncSinkMessage(std::move(request))
+        .getAsync([this, anchor = shared_from_this()](Status status) {
+            if (!status.isOK()) {
+                _failPipeline(std::move(status));
+                return;
+            }
+            _sendPipelined();
+        });
+}
+
+void AsyncDBClient::_receivePipelined() {
+    _session->asyncSourceMessage().getAsync([this, anchor = shared_from_this()](
+                                                StatusWith<Message> swm) {
+        if (swm.isOK() && swm.getValue().operation() == dbCompressed) {
+            swm = _compressorManager.decompressMessage(swm.getValue());
+        }
+        if (!swm.isOK()) {
+            _failPipeline(swm.getStatus());
+            return;
+        }
+
+        auto response = std::move(swm.getValue());
+        auto responseTo = response.header().getResponseToMsgId();
+        boost::optional<Promise<Message>> promise;
+        bool matched = false;
+        bool more = false;
+        {
+            stdx::lock_guard<Latch> lk(_pipelineMutex);
+            if (auto it = _pipelineAwaiting.find(responseTo); it != _pipelineAwaiting.end()) {
+                promise.emplace(std::move(it->second));
+                _pipelineAwaiting.erase(it);
+                matched = true;
+            } else {
+                // The response to a canceled request is dropped.
+                matched = _pipelineCanceled.erase(responseTo) > 0;
+            }
+            more = matched && _hasPipelinedResponsesOutstanding(lk);
+            _pipelineReceiving = more;
+        }
+
+        if (!matched) {
+            _failPipeline({ErrorCodes::Error(4972502),
+                           "ResponseId did not match any pipelined request"});
+            return;
+        }
+
+        if (promise) {
+            promise->emplaceValue(std::move(response));
+        }
+        if (more) {
+            _receivePipelined();
+        }
+    });
+}
+
+void AsyncDBClient::_failPipeline(Status status) {
+    stdx::unordered_map<int32_t, Promise<Message>> awaiting;
+    {
+        stdx::lock_guard<Latch> lk(_pipelineMutex);
+        if (_pipelineStatus.isOK()) {
+            _pipelineStatus = status;
+        }
+        _pipelineToSend.clear();
+        _pipelineCanceled.clear();
+        awaiting = std::exchange(_pipelineAwaiting, {});
+    }
+
+    // The stream can no longer be trusted, so make sure any outstanding read or write fails too.
+    _session->end();
+    for (auto& [_, promise] : awaiting) {
+        promise.setError(status);
+    }
 }
 
 Future<Message> AsyncDBClient::_waitForResponse(boost::optional<int32_t> msgId,
@@ -319,6 +443,48 @@ Future<executor::RemoteCommandResponse> AsyncDBClient::runCommandRequest(
         });
 }
 
+bool AsyncDBClient::_hasPipelinedResponsesOutstanding(WithLock) const {
+    return !_pipelineAwaiting.empty() || !_pipelineCanceled.empty();
+}
+
+bool AsyncDBClient::hasPipelinedResponsesOutstanding() {
+    stdx::lock_guard<Latch> lk(_pipelineMutex);
+    return _hasPipelinedResponsesOutstanding(lk);
+}
+
+void AsyncDBClient::cancelPipelinedCommandRequest(int32_t msgId) {
+    boost::optional<Promise<Message>> promise;
+    {
+        stdx::lock_guard<Latch> lk(_pipelineMutex);
+        auto it = _pipelineAwaiting.find(msgId);
+        if (it == _pipelineAwaiting.end()) {
+            return;
+        }
+        promise.emplace(std::move(it->second));
+        _pipelineAwaiting.erase(it);
+
+        // The request stays queued if it has not been written yet, so that every request on the
+        // connection still gets a response and the read loop only stops once the stream is idle.
+        _pipelineCanceled.insert(msgId);
+    }
+
+    promise->setError({ErrorCodes::CallbackCanceled, "Pipelined command request canceled"});
+}
+
+Future<executor::RemoteCommandResponse> AsyncDBClient::runPipelinedCommandRequest(
+    executor::RemoteCommandRequest request, int32_t msgId) {
+    invariant(_negotiatedProtocol);
+    auto startTimer = Timer();
+    auto opMsgRequest = OpMsgRequest::fromDBAndBody(
+        std::move(request.dbname), std::move(request.cmdObj), std::move(request.metadata));
+    auto requestMsg = rpc::messageFromOpMsgRequest(*_negotiatedProtocol, std::move(opMsgRequest));
+    return _pipeline(std::move(requestMsg), msgId)
+        .then([startTimer = std::move(startTimer)](Message responseMsg) {
+            rpc::UniqueReply response(responseMsg, rpc::makeReply(&responseMsg));
+            return executor::RemoteCommandResponse(*response, startTimer.elapsed());
+        });
+}
+
 Future<executor::RemoteCommandResponse> AsyncDBClient::_continueReceiveExhaustResponse(
     ClockSource::StopWatch stopwatch, boost::optional<int32_t> msgId, const BatonHandle& baton) {
     return _waitForResponse(msgId, baton)
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/client/authenticate.h"
@@ -36,12 +37,16 @@
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/rpc/protocol.h"
 #include "mongo/rpc/unique_message.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/stdx/unordered_set.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/ssl_connection_context.h"
 #include "mongo/transport/transport_layer.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/future.h"
 
 namespace mongo {
@@ -69,6 +74,30 @@ public:
                                         const BatonHandle& baton = nullptr,
                                         bool fireAndForget = false);
 
+    /**
+     * Sends a request without waiting for the responses to requests already pipelined on this
+     * connection, and matches the response to it by responseTo. The server still runs the requests
+     * of one connection in order, so pipelining saves connections rather than latency. A connection
+     * that has pipelined requests in flight must not be used for anything else.
+     *
+     * 'msgId' must come from nextMessageId(); it also identifies the request to
+     * cancelPipelinedCommandRequest().
+     */
+    Future<executor::RemoteCommandResponse> runPipelinedCommandRequest(
+        executor::RemoteCommandRequest request, int32_t msgId);
+
+    /**
+     * Fails the pipelined request 'msgId' with CallbackCanceled without disturbing the other
+     * requests on this connection. Its response is dropped when it arrives. Does nothing if the
+     * request has already completed.
+     */
+    void cancelPipelinedCommandRequest(int32_t msgId);
+
+    /**
+     * Returns true while a response to a pipelined request, canceled or not, is still expected.
+     */
+    bool hasPipelinedResponsesOutstanding();
+
     Future<executor::RemoteCommandResponse> beginExhaustCommandRequest(
         executor::RemoteCommandRequest request, const BatonHandle& baton = nullptr);
     Future<executor::RemoteCommandResponse> runExhaustCommand(OpMsgRequest request,
@@ -103,7 +132,13 @@ private:
         const BatonHandle& baton = nullptr);
     Future<Message> _waitForResponse(boost::optional<int32_t> msgId,
                                      const BatonHandle& baton = nullptr);
+    StatusWith<Message> _prepareRequest(Message request, int32_t msgId);
     Future<void> _call(Message request, int32_t msgId, const BatonHandle& baton = nullptr);
+    Future<Message> _pipeline(Message request, int32_t msgId);
+    bool _hasPipelinedResponsesOutstanding(WithLock) const;
+    void _sendPipelined();
+    void _receivePipelined();
+    void _failPipeline(Status status);
     BSONObj _buildIsMasterRequest(const std::string& appName,
                                   executor::NetworkConnectionHook* hook);
     void _parseIsMasterResponse(BSONObj request,
@@ -115,6 +150,16 @@ private:
     ServiceContext* const _svcCtx;
     MessageCompressorManager _compressorManager;
     boost::optional<rpc::Protocol> _negotiatedProtocol;
+
+    // State of pipelined requests. Requests are compressed when they are queued, so that a
+    // streaming compression context sees them in the order they are written.
+    Mutex _pipelineMutex = MONGO_MAKE_LATCH("AsyncDBClient::_pipelineMutex");
+    std::deque<Message> _pipelineToSend;
+    stdx::unordered_map<int32_t, Promise<Message>> _pipelineAwaiting;
+    stdx::unordered_set<int32_t> _pipelineCanceled;
+    bool _pipelineSending = false;
+    bool _pipelineReceiving = false;
+    Status _pipelineStatus = Status::OK();
 };
 
 }  // namespace mongo
@@ -0,0 +1,280 @@
+/**
+ *    Copyright (C) 2026-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/client/async_client.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/executor/remote_command_request.h"
+#include "mongo/rpc/legacy_reply_builder.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/transport/mock_session.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * A session whose reads complete only when the test delivers a message or an error, so that
+ * several pipelined requests can be outstanding at once.
+ */
+class PipelineTestSession : public transport::MockSession {
+public:
+    PipelineTestSession() : MockSession(nullptr) {}
+
+    Future<void> asyncSinkMessage(Message message, const BatonHandle& handle = nullptr) override {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_ended) {
+            return transport::TransportLayer::TicketSessionClosedStatus;
+        }
+        _sent.push_back(std::move(message));
+        return Future<void>::makeReady();
+    }
+
+    Future<Message> asyncSourceMessage(const BatonHandle& handle = nullptr) override {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_ended) {
+            return transport::TransportLayer::TicketSessionClosedStatus;
+        }
+        ASSERT_FALSE(_pendingRead) << "Reads on a session may not overlap";
+        if (!_received.empty()) {
+            auto message = std::move(_received.front());
+            _received.pop_front();
+            return Future<Message>::makeReady(std::move(message));
+        }
+        auto pf = makePromiseFuture<Message>();
+        _pendingRead.emplace(std::move(pf.promise));
+        return std::move(pf.future);
+    }
+
+    void end() override {
+        failRead(transport::TransportLayer::TicketSessionClosedStatus);
+    }
+
+    bool isConnected() override {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return !_ended;
+    }
+
+    /**
+     * Hands 'message' to the outstanding read, or to the next one.
+     */
+    void receive(Message message) {
+        auto promise = [&]() -> boost::optional<Promise<Message>> {
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (!_pendingRead) {
+                _received.push_back(std::move(message));
+                return boost::none;
+            }
+            return std::exchange(_pendingRead, boost::none);
+        }();
+        if (promise) {
+            promise->emplaceValue(std::move(message));
+        }
+    }
+
+    /**
+     * Ends the session, failing the outstanding read with 'status'.
+     */
+    void failRead(Status status) {
+        auto promise = [&] {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _ended = true;
+            return std::exchange(_pendingRead, boost::none);
+        }();
+        if (promise) {
+            promise->setError(std::move(status));
+        }
+    }
+
+    std::vector<int32_t> sentIds() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        std::vector<int32_t> ids;
+        for (auto& message : _sent) {
+            ids.push_back(message.header().getId());
+        }
+        return ids;
+    }
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("PipelineTestSession::_mutex");
+    std::vector<Message> _sent;
+    std::deque<Message> _received;
+    boost::optional<Promise<Message>> _pendingRead;
+    bool _ended = false;
+};
+
+class AsyncDBClientPipelineTest : public ServiceContextTest {
+public:
+    void setUp() override {
+        _session = std::make_shared<PipelineTestSession>();
+        _client = std::make_shared<AsyncDBClient>(
+            HostAndPort("localhost", 27017), _session, getServiceContext());
+
+        auto handshake = _client->initWireVersion("AsyncDBClientPipelineTest", nullptr);
+        rpc::LegacyReplyBuilder isMasterReply;
+        isMasterReply.setRawCommandReply(
+            BSON("ok" << 1 << "minWireVersion" << 0 << "maxWireVersion" << 0));
+        auto message = isMasterReply.done();
+        message.header().setResponseToMsgId(_session->sentIds().back());
+        _session->receive(std::move(message));
+        ASSERT_OK(handshake.getNoThrow());
+    }
+
+    /**
+     * Pipelines a ping and returns its message id along with the future for its response.
+     */
+    std::pair<int32_t, Future<executor::RemoteCommandResponse>> ping() {
+        auto msgId = nextMessageId();
+        executor::RemoteCommandRequest request(
+            HostAndPort("localhost", 27017), "admin", BSON("ping" << 1), nullptr);
+        return {msgId, _client->runPipelinedCommandRequest(std::move(request), msgId)};
+    }
+
+    /**
+     * Delivers the response to the request 'responseTo', tagged with 'n'.
+     */
+    void respond(int32_t responseTo, int n) {
+        OpMsg reply;
+        reply.body = BSON("ok" << 1 << "n" << n);
+        auto message = reply.serialize();
+        message.header().setResponseToMsgId(responseTo);
+        _session->receive(std::move(message));
+    }
+
+    PipelineTestSession& session() {
+        return *_session;
+    }
+
+    AsyncDBClient& client() {
+        return *_client;
+    }
+
+private:
+    std::shared_ptr<PipelineTestSession> _session;
+    std::shared_ptr<AsyncDBClient> _client;
+};
+
+TEST_F(AsyncDBClientPipelineTest, ResponsesAreMatchedByResponseTo) {
+    auto [firstId, first] = ping();
+    auto [secondId, second] = ping();
+    auto [thirdId, third] = ping();
+
+    // Every request is written before any response arrives.
+    ASSERT_EQ(4U, session().sentIds().size());
+
+    respond(thirdId, 3);
+    ASSERT_TRUE(third.isReady());
+    ASSERT_FALSE(first.isReady());
+    ASSERT_FALSE(second.isReady());
+
+    respond(firstId, 1);
+    respond(secondId, 2);
+    ASSERT_EQ(1, first.get().data["n"].numberInt());
+    ASSERT_EQ(2, second.get().data["n"].numberInt());
+    ASSERT_EQ(3, third.get().data["n"].numberInt());
+    ASSERT_FALSE(client().hasPipelinedResponsesOutstanding());
+}
+
+TEST_F(AsyncDBClientPipelineTest, ConnectionErrorFailsEveryRequest) {
+    auto [firstId, first] = ping();
+    auto [secondId, second] = ping();
+    auto [thirdId, third] = ping();
+
+    respond(secondId, 2);
+    ASSERT_OK(second.getNoThrow().getStatus());
+
+    session().failRead({ErrorCodes::HostUnreachable, "Connection reset"});
+    ASSERT_EQ(ErrorCodes::HostUnreachable, first.getNoThrow().getStatus());
+    ASSERT_EQ(ErrorCodes::HostUnreachable, third.getNoThrow().getStatus());
+
+    // The connection cannot be used for anything else afterwards.
+    auto [fourthId, fourth] = ping();
+    ASSERT_EQ(ErrorCodes::HostUnreachable, fourth.getNoThrow().getStatus());
+}
+
+TEST_F(AsyncDBClientPipelineTest, UnknownResponseToFailsEveryRequest) {
+    auto [firstId, first] = ping();
+    auto [secondId, second] = ping();
+
+    respond(secondId + firstId + 1, 0);
+    ASSERT_EQ(ErrorCodes::Error(4972502), first.getNoThrow().getStatus());
+    ASSERT_EQ(ErrorCodes::Error(4972502), second.getNoThrow().getStatus());
+}
+
+TEST_F(AsyncDBClientPipelineTest, CanceledRequestFailsWithoutWaitingForItsResponse) {
+    auto [firstId, first] = ping();
+    auto [secondId, second] = ping();
+
+    client().cancelPipelinedCommandRequest(firstId);
+    ASSERT_EQ(ErrorCodes::CallbackCanceled, first.getNoThrow().getStatus());
+    ASSERT_FALSE(second.isReady());
+    ASSERT_TRUE(client().hasPipelinedResponsesOutstanding());
+
+    // The late response to the canceled request is dropped rather than treated as unknown.
+    respond(firstId, 1);
+    ASSERT_FALSE(second.isReady());
+    respond(secondId, 2);
+    ASSERT_EQ(2, second.get().data["n"].numberInt());
+    ASSERT_FALSE(client().hasPipelinedResponsesOutstanding());
+
+    // Canceling a completed request has no effect.
+    client().cancelPipelinedCommandRequest(secondId);
+    auto [thirdId, third] = ping();
+    respond(thirdId, 3);
+    ASSERT_EQ(3, third.get().data["n"].numberInt());
+}
+
+TEST_F(AsyncDBClientPipelineTest, CanceledResponseOutstandingUntilItArrives) {
+    auto [firstId, first] = ping();
+    client().cancelPipelinedCommandRequest(firstId);
+    ASSERT_EQ(ErrorCodes::CallbackCanceled, first.getNoThrow().getStatus());
+
+    // Nothing waits for the response anymore, but the connection is not idle until it arrives.
+    ASSERT_TRUE(client().hasPipelinedResponsesOutstanding());
+    respond(firstId, 1);
+    ASSERT_FALSE(client().hasPipelinedResponsesOutstanding());
+}
+
+TEST_F(AsyncDBClientPipelineTest, EndFailsRequestsInFlight) {
+    auto [firstId, first] = ping();
+    auto [secondId, second] = ping();
+
+    client().end();
+    ASSERT_NOT_OK(first.getNoThrow().getStatus());
+    ASSERT_NOT_OK(second.getNoThrow().getStatus());
+    ASSERT_FALSE(client().hasPipelinedResponsesOutstanding());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/rebuild_indexes.h"
 #include "mongo/logv2/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace catalog {
@@ -154,6 +155,7 @@ void openCatalog(OperationContext* opCtx,
         ino.second.emplace_back(std::move(indexesToRebuild.second.back()));
     }
 
+    Timer rebuildTimer;
     for (const auto& entry : nsToIndexNameObjMap) {
         NamespaceString collNss(entry.first);
 
@@ -171,6 +173,13 @@ void openCatalog(OperationContext* opCtx,
         std::vector<BSONObj> indexSpecs = entry.second.second;
         fassert(40690, rebuildIndexesOnCollection(opCtx, collection, indexSpecs, RepairData::kNo));
     }
+    if (!nsToIndexNameObjMap.empty()) {
+        LOGV2(4972507,
+              "openCatalog: finished rebuilding indexes",
+              "numCollections"_attr = nsToIndexNameObjMap.size(),
+              "numIndexes"_attr = reconcileResult.indexesToRebuild.size(),
+              "durationMillis"_attr = rebuildTimer.millis());
+    }
 
     // Once all unfinished index builds have been dropped and the catalog has been reloaded, resume
     // or restart any unfinished index builds. This will not resume/restart any index builds to
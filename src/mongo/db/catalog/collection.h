@@ -245,7 +245,7 @@ public:
     };
 
     /**
-     * Callback function for callers of insertDocumentForBulkLoader().
+     * Callback function for callers of insertDocumentsForBulkLoader().
      */
     using OnRecordInsertedFn = std::function<Status(const RecordId& loc)>;
 
@@ -376,15 +376,18 @@ public:
                                            const std::vector<Timestamp>& timestamps) const = 0;
 
     /**
-     * Inserts a document into the record store for a bulk loader that manages the index building
-     * outside this Collection. The bulk loader is notified with the RecordId of the document
-     * inserted into the RecordStore.
+     * Inserts the documents in [begin, end) into the record store for a bulk loader that manages
+     * the index building outside this Collection. The documents are written with a single call,
+     * which lets the storage engine reserve RecordIds in one block and reuse one cursor for the
+     * whole batch. The bulk loader is notified with the RecordId of each document inserted into
+     * the RecordStore, in order.
      *
      * NOTE: It is up to caller to commit the indexes.
      */
-    virtual Status insertDocumentForBulkLoader(
+    virtual Status insertDocumentsForBulkLoader(
         OperationContext* const opCtx,
-        const BSONObj& doc,
+        const std::vector<BSONObj>::const_iterator begin,
+        const std::vector<BSONObj>::const_iterator end,
         const OnRecordInsertedFn& onRecordInserted) const = 0;
 
     /**
@@ -618,48 +618,70 @@ Status CollectionImpl::insertDocument(OperationContext* opCtx,
     return insertDocuments(opCtx, docs.begin(), docs.end(), opDebug, fromMigrate);
 }
 
-Status CollectionImpl::insertDocumentForBulkLoader(
-    OperationContext* opCtx, const BSONObj& doc, const OnRecordInsertedFn& onRecordInserted) const {
+Status CollectionImpl::insertDocumentsForBulkLoader(
+    OperationContext* opCtx,
+    const std::vector<BSONObj>::const_iterator begin,
+    const std::vector<BSONObj>::const_iterator end,
+    const OnRecordInsertedFn& onRecordInserted) const {
+    dassert(opCtx->lockState()->isCollectionLockedForMode(ns(), MODE_IX));
 
-    auto status = checkFailCollectionInsertsFailPoint(_ns, doc);
-    if (!status.isOK()) {
-        return status;
+    const size_t count = std::distance(begin, end);
+    if (count == 0) {
+        return Status::OK();
     }
 
-    status = checkValidation(opCtx, doc);
-    if (!status.isOK()) {
-        return status;
-    }
+    std::vector<Record> records;
+    records.reserve(count);
+    for (auto it = begin; it != end; ++it) {
+        auto status = checkFailCollectionInsertsFailPoint(_ns, *it);
+        if (!status.isOK()) {
+            return status;
+        }
 
-    dassert(opCtx->lockState()->isCollectionLockedForMode(ns(), MODE_IX));
+        status = checkValidation(opCtx, *it);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        records.emplace_back(Record{RecordId(), RecordData(it->objdata(), it->objsize())});
+    }
 
     // Using timestamp 0 for these inserts, which are non-oplog so we don't have an appropriate
     // timestamp to use.
-    StatusWith<RecordId> loc =
-        _shared->_recordStore->insertRecord(opCtx, doc.objdata(), doc.objsize(), Timestamp());
-
-    if (!loc.isOK())
-        return loc.getStatus();
+    std::vector<Timestamp> timestamps(count);
+    auto status = _shared->_recordStore->insertRecords(opCtx, &records, timestamps);
+    if (!status.isOK()) {
+        return status;
+    }
 
-    status = onRecordInserted(loc.getValue());
+    for (const auto& record : records) {
+        status = onRecordInserted(record.id);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
 
     if (MONGO_unlikely(failAfterBulkLoadDocInsert.shouldFail())) {
-        LOGV2(20290,
+        LOGV2(4972100,
               "Failpoint failAfterBulkLoadDocInsert enabled. Throwing "
               "WriteConflictException",
               "namespace"_attr = _ns);
         throw WriteConflictException();
     }
 
-    std::vector<InsertStatement> inserts;
-    OplogSlot slot;
-    // Fetch a new optime now, if necessary.
+    std::vector<OplogSlot> slots;
+    // Fetch new optimes now, if necessary.
     auto replCoord = repl::ReplicationCoordinator::get(opCtx);
     if (!replCoord->isOplogDisabledFor(opCtx, _ns)) {
-        // Populate 'slot' with a new optime.
-        slot = repl::getNextOpTime(opCtx);
+        slots = repl::getNextOpTimes(opCtx, count);
+    }
+
+    std::vector<InsertStatement> inserts;
+    inserts.reserve(count);
+    size_t i = 0;
+    for (auto it = begin; it != end; ++it, ++i) {
+        inserts.emplace_back(kUninitializedStmtId, *it, slots.empty() ? OplogSlot() : slots[i]);
     }
-    inserts.emplace_back(kUninitializedStmtId, doc, slot);
 
     getGlobalServiceContext()->getOpObserver()->onInserts(
         opCtx, ns(), uuid(), inserts.begin(), inserts.end(), false);
@@ -667,7 +689,7 @@ Status CollectionImpl::insertDocumentForBulkLoader(
     opCtx->recoveryUnit()->onCommit(
         [this](boost::optional<Timestamp>) { _shared->notifyCappedWaitersIfNeeded(); });
 
-    return loc.getStatus();
+    return Status::OK();
 }
 
 Status CollectionImpl::_insertDocuments(OperationContext* opCtx,
@@ -177,15 +177,16 @@ public:
                                    const std::vector<Timestamp>& timestamps) const final;
 
     /**
-     * Inserts a document into the record store for a bulk loader that manages the index building
-     * outside this Collection. The bulk loader is notified with the RecordId of the document
+     * Inserts documents into the record store for a bulk loader that manages the index building
+     * outside this Collection. The bulk loader is notified with the RecordId of each document
      * inserted into the RecordStore.
      *
      * NOTE: It is up to caller to commit the indexes.
      */
-    Status insertDocumentForBulkLoader(OperationContext* opCtx,
-                                       const BSONObj& doc,
-                                       const OnRecordInsertedFn& onRecordInserted) const final;
+    Status insertDocumentsForBulkLoader(OperationContext* opCtx,
+                                        std::vector<BSONObj>::const_iterator begin,
+                                        std::vector<BSONObj>::const_iterator end,
+                                        const OnRecordInsertedFn& onRecordInserted) const final;
 
     /**
      * Updates the document @ oldLocation with newDoc.
@@ -142,9 +142,10 @@ public:
         std::abort();
     }
 
-    Status insertDocumentForBulkLoader(OperationContext* opCtx,
-                                       const BSONObj& doc,
-                                       const OnRecordInsertedFn& onRecordInserted) const {
+    Status insertDocumentsForBulkLoader(OperationContext* opCtx,
+                                        std::vector<BSONObj>::const_iterator begin,
+                                        std::vector<BSONObj>::const_iterator end,
+                                        const OnRecordInsertedFn& onRecordInserted) const {
         std::abort();
     }
 
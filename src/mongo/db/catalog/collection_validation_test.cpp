@@ -34,6 +34,7 @@
 #include "mongo/db/catalog/catalog_test_fixture.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/fail_point.h"
@@ -87,6 +88,22 @@ public:
     BackgroundCollectionValidationTest() : CollectionValidationTest("wiredTiger") {}
 };
 
+/**
+ * Test fixture for validating collections that keep a content hash, which only the wiredTiger
+ * engine maintains.
+ */
+class ContentHashCollectionValidationTest : public CollectionValidationTest {
+public:
+    ContentHashCollectionValidationTest() : CollectionValidationTest("wiredTiger") {
+        // Must be set before the collection is created in setUp().
+        gWiredTigerCollectionContentHashes = true;
+    }
+
+    ~ContentHashCollectionValidationTest() {
+        gWiredTigerCollectionContentHashes = false;
+    }
+};
+
 /**
  * Calls validate on collection kNss with both kValidateFull and kValidateNormal validation levels
  * and verifies the results.
@@ -266,6 +283,82 @@ TEST_F(CollectionValidationTest, ValidateEnforceFastCount) {
                        {CollectionValidation::ValidateMode::kForegroundFullEnforceFastCount});
 }
 
+// Verify that validate() reports a content hash that does not match the records, and replaces it
+// along with one that is no longer trusted.
+TEST_F(ContentHashCollectionValidationTest, ValidateChecksAndRestoresContentHash) {
+    auto opCtx = operationContext();
+    const int numRecords = insertDataRange(opCtx, 0, 5);
+
+    auto contentHash = [&] {
+        AutoGetCollection coll(opCtx, kNss, MODE_IS);
+        return coll->getRecordStore()->contentHash(opCtx);
+    };
+    const auto expected = contentHash();
+    ASSERT(expected);
+    foregroundValidate(opCtx,
+                       /*valid*/ true,
+                       numRecords,
+                       /*numInvalidDocuments*/ 0,
+                       /*numErrors*/ 0);
+    ASSERT_EQ(*expected, *contentHash());
+
+    {
+        AutoGetCollection coll(opCtx, kNss, MODE_IX);
+        coll->getRecordStore()->updateContentHashAfterRepair(opCtx, *expected + 1);
+    }
+
+    // Like the fast count, a mismatch is only an error when enforced, and the hash is only
+    // replaced by a validation that found no errors.
+    {
+        ValidateResults validateResults;
+        BSONObjBuilder output;
+        ASSERT_OK(CollectionValidation::validate(
+            opCtx,
+            kNss,
+            CollectionValidation::ValidateMode::kForegroundFullEnforceFastCount,
+            CollectionValidation::RepairMode::kNone,
+            &validateResults,
+            &output));
+        ASSERT_FALSE(validateResults.valid);
+        ASSERT_EQ(1U, validateResults.errors.size());
+        ASSERT_STRING_CONTAINS(validateResults.errors[0], "content hash");
+        ASSERT_EQ(*expected + 1, *contentHash());
+    }
+    {
+        ValidateResults validateResults;
+        BSONObjBuilder output;
+        ASSERT_OK(
+            CollectionValidation::validate(opCtx,
+                                           kNss,
+                                           CollectionValidation::ValidateMode::kForegroundFull,
+                                           CollectionValidation::RepairMode::kNone,
+                                           &validateResults,
+                                           &output));
+        ASSERT_TRUE(validateResults.valid);
+        ASSERT(std::any_of(validateResults.warnings.begin(),
+                           validateResults.warnings.end(),
+                           [](const std::string& warning) {
+                               return warning.find("content hash") != std::string::npos;
+                           }));
+        ASSERT_EQ(*expected, *contentHash());
+    }
+
+    // Updating the size information from outside of validation makes the hash untrusted until
+    // the next validation.
+    {
+        AutoGetCollection coll(opCtx, kNss, MODE_IX);
+        coll->getRecordStore()->updateStatsAfterRepair(opCtx, numRecords, 0);
+    }
+    ASSERT_FALSE(contentHash());
+    foregroundValidate(opCtx,
+                       /*valid*/ true,
+                       numRecords,
+                       /*numInvalidDocuments*/ 0,
+                       /*numErrors*/ 0,
+                       {CollectionValidation::ValidateMode::kForegroundFull});
+    ASSERT_EQ(*expected, *contentHash());
+}
+
 /**
  * Waits for a parallel running collection validation operation to start and then hang at a
  * failpoint.
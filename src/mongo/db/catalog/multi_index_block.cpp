@@ -33,6 +33,8 @@
 
 #include "mongo/db/catalog/multi_index_block.h"
 
+#include <algorithm>
+#include <limits>
 #include <ostream>
 
 #include "mongo/base/error_codes.h"
@@ -58,8 +60,10 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/producer_consumer_queue.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/scopeguard.h"
@@ -74,6 +78,36 @@ MONGO_FAIL_POINT_DEFINE(hangAfterStartingIndexBuildUnlocked);
 MONGO_FAIL_POINT_DEFINE(hangIndexBuildDuringCollectionScanPhaseBeforeInsertion);
 MONGO_FAIL_POINT_DEFINE(hangIndexBuildDuringCollectionScanPhaseAfterInsertion);
 MONGO_FAIL_POINT_DEFINE(leaveIndexBuildUnfinishedForShutdown);
+MONGO_FAIL_POINT_DEFINE(failIndexKeyGeneration);
+
+namespace {
+
+// With parallel key generation, 1/kKeyGenerationQueueMemoryShare of the index build memory limit
+// holds documents waiting for key generation and the rest is divided among the sorters.
+constexpr std::size_t kKeyGenerationQueueMemoryShare = 8;
+
+/**
+ * Checks the 'failIndexKeyGeneration' fail point before generating the keys of 'doc' for the index
+ * named 'indexName'. Returns Status::OK if key generation should proceed.
+ */
+Status checkFailIndexKeyGenerationFailPoint(StringData indexName, const BSONObj& doc) {
+    Status s = Status::OK();
+    failIndexKeyGeneration.executeIf(
+        [&](const BSONObj& data) {
+            s = {ErrorCodes::FailPointEnabled,
+                 str::stream() << "Failpoint (failIndexKeyGeneration) has been enabled (" << data
+                               << "), so rejecting document for index " << indexName << ": "
+                               << doc};
+        },
+        [&](const BSONObj& data) {
+            // If the failpoint specifies no index or matches this one, fail.
+            const auto indexElem = data["indexName"];
+            return !indexElem || indexName == indexElem.str();
+        });
+    return s;
+}
+
+}  // namespace
 
 MultiIndexBlock::~MultiIndexBlock() {
     invariant(_buildIsCleanedUp);
@@ -205,10 +239,17 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlock::init(
         std::vector<BSONObj> indexInfoObjs;
         indexInfoObjs.reserve(indexSpecs.size());
         std::size_t eachIndexBuildMaxMemoryUsageBytes = 0;
+        _keyGenerationQueueMaxBytes = 0;
         if (!indexSpecs.empty()) {
-            eachIndexBuildMaxMemoryUsageBytes =
-                static_cast<std::size_t>(maxIndexBuildMemoryUsageMegabytes.load()) * 1024 * 1024 /
-                indexSpecs.size();
+            auto maxMemoryUsageBytes =
+                static_cast<std::size_t>(maxIndexBuildMemoryUsageMegabytes.load()) * 1024 * 1024;
+            // Documents queued for parallel key generation count against the same memory limit as
+            // the sorters.
+            if (indexSpecs.size() > 1 && gUseParallelKeyGenerationForIndexBuilds.load()) {
+                _keyGenerationQueueMaxBytes = maxMemoryUsageBytes / kKeyGenerationQueueMemoryShare;
+                maxMemoryUsageBytes -= _keyGenerationQueueMaxBytes;
+            }
+            eachIndexBuildMaxMemoryUsageBytes = maxMemoryUsageBytes / indexSpecs.size();
         }
         _eachIndexBuildMaxMemoryUsageBytes = eachIndexBuildMaxMemoryUsageBytes;
 
@@ -346,6 +387,187 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlock::init(
     }
 }
 
+/**
+ * Generates the keys of every index being built on a dedicated thread per index. The collection
+ * scan copies documents into batches that are shared by all workers and handed to each of them
+ * through a bounded queue, so that key generation and sorter insertion for different indexes
+ * overlap with each other and with the scan itself.
+ *
+ * Each worker only touches the BulkBuilder of its own index. Documents whose key generation error
+ * was suppressed are collected by the workers and recorded with the skipped record tracker on the
+ * scanning thread in finish(), as that requires the index build's OperationContext.
+ */
+class MultiIndexBlock::ParallelKeyGenerator {
+public:
+    /**
+     * Every batch is shared by all of the workers and stays alive until the slowest worker has
+     * processed it, so each worker may fall up to 'maxQueuedBytes' of documents behind the scan.
+     */
+    ParallelKeyGenerator(OperationContext* opCtx,
+                         std::vector<IndexToBuild>* indexes,
+                         size_t maxQueuedBytes)
+        : _indexes(indexes),
+          _maxBatchBytes(std::max(maxQueuedBytes / kMinQueuedBatches, size_t(1))) {
+        _workers.reserve(_indexes->size());
+        for (size_t i = 0; i < _indexes->size(); ++i) {
+            BatchQueue::Options options;
+            options.maxQueueDepth = std::max(maxQueuedBytes, size_t(1));
+            options.costFunc.maxCost = options.maxQueueDepth;
+            _workers.push_back(std::make_unique<Worker>(options));
+        }
+        for (size_t i = 0; i < _workers.size(); ++i) {
+            _workers[i]->thread = stdx::thread([this, i, svcCtx = opCtx->getServiceContext()] {
+                _runWorker(svcCtx, i);
+            });
+        }
+    }
+
+    ~ParallelKeyGenerator() {
+        _closeAndJoin();
+    }
+
+    /**
+     * Queues 'doc' for key generation on every index. Throws if a worker failed.
+     */
+    void add(const BSONObj& doc, const RecordId& loc) {
+        _batch.docs.emplace_back(doc.getOwned(), loc);
+        _batch.bytes += _batch.docs.back().first.objsize();
+        if (_batch.docs.size() >= kBatchSize || _batch.bytes >= _maxBatchBytes) {
+            _flush();
+        }
+    }
+
+    /**
+     * Waits for the keys of every queued document to be added to every index. Returns the first
+     * error encountered by a worker. Otherwise records the skipped documents and returns the
+     * RecordId of the last document processed.
+     */
+    StatusWith<boost::optional<RecordId>> finish(OperationContext* opCtx,
+                                                 const CollectionPtr& collection) {
+        if (!_batch.docs.empty()) {
+            try {
+                _flush();
+            } catch (const DBException&) {
+                // A worker failed; its status is reported below.
+            }
+        }
+        _closeAndJoin();
+
+        for (size_t i = 0; i < _workers.size(); ++i) {
+            if (!_workers[i]->status.isOK()) {
+                return _workers[i]->status;
+            }
+        }
+
+        for (size_t i = 0; i < _workers.size(); ++i) {
+            auto interceptor =
+                (*_indexes)[i].block->getEntry(opCtx, collection)->indexBuildInterceptor();
+            if (!interceptor || !interceptor->getSkippedRecordTracker()) {
+                continue;
+            }
+            for (const auto& loc : _workers[i]->skippedRecords) {
+                interceptor->getSkippedRecordTracker()->record(opCtx, loc);
+            }
+        }
+        return _lastQueuedRecordId;
+    }
+
+private:
+    struct Batch {
+        std::vector<std::pair<BSONObj, RecordId>> docs;
+        size_t bytes = 0;
+    };
+
+    /**
+     * Weighs a batch by the size of its documents. A batch larger than the whole queue, which a
+     * few large documents can produce, is admitted into an otherwise empty queue.
+     */
+    struct BatchCost {
+        size_t operator()(const std::shared_ptr<const Batch>& batch) const {
+            return std::clamp(batch->bytes, size_t(1), maxCost);
+        }
+
+        size_t maxCost = std::numeric_limits<size_t>::max();
+    };
+
+    using BatchQueue = SingleProducerSingleConsumerQueue<std::shared_ptr<const Batch>, BatchCost>;
+
+    // Maximum number of documents handed to the workers at a time.
+    static constexpr size_t kBatchSize = 128;
+    // Batches are cut by size so that at least this many fit in a worker's queue.
+    static constexpr size_t kMinQueuedBatches = 16;
+
+    struct Worker {
+        explicit Worker(BatchQueue::Options options) : queue(std::move(options)) {}
+
+        BatchQueue queue;
+        stdx::thread thread;
+        // Written by the worker thread, read after it is joined.
+        Status status = Status::OK();
+        std::vector<RecordId> skippedRecords;
+    };
+
+    void _flush() {
+        auto batch = std::make_shared<const Batch>(std::exchange(_batch, {}));
+        _batch.docs.reserve(kBatchSize);
+        // Pushes are not interruptible: every batch must reach every index so that all sorters
+        // hold keys for the same set of documents when the scan stops.
+        for (auto&& worker : _workers) {
+            worker->queue.push(std::shared_ptr<const Batch>(batch));
+        }
+        _lastQueuedRecordId = batch->docs.back().second;
+    }
+
+    void _runWorker(ServiceContext* svcCtx, size_t indexNum) {
+        Client::initThread("IndexBuildKeyGenerator", svcCtx, nullptr);
+        // The worker's OperationContext only provides scratch space for key generation.
+        auto opCtx = cc().makeOperationContext();
+        auto& worker = *_workers[indexNum];
+        auto& index = (*_indexes)[indexNum];
+        auto onSuppressedError = [&](const RecordId& loc) {
+            worker.skippedRecords.push_back(loc);
+        };
+
+        try {
+            while (true) {
+                auto batch = worker.queue.pop();
+                for (const auto& [doc, loc] : batch->docs) {
+                    if (index.filterExpression && !index.filterExpression->matchesBSON(doc)) {
+                        continue;
+                    }
+                    uassertStatusOK(
+                        checkFailIndexKeyGenerationFailPoint(index.block->getIndexName(), doc));
+                    uassertStatusOK(index.bulk->insert(
+                        opCtx.get(), doc, loc, index.options, onSuppressedError));
+                }
+            }
+        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueConsumed>&) {
+            // The scan is done and every queued batch has been processed.
+        } catch (...) {
+            worker.status = exceptionToStatus();
+            // Unblocks the scan, which fails on its next push.
+            worker.queue.closeConsumerEnd();
+        }
+    }
+
+    void _closeAndJoin() {
+        for (auto&& worker : _workers) {
+            worker->queue.closeProducerEnd();
+        }
+        for (auto&& worker : _workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+
+    std::vector<IndexToBuild>* const _indexes;
+    const size_t _maxBatchBytes;
+    std::vector<std::unique_ptr<Worker>> _workers;
+    Batch _batch;
+    boost::optional<RecordId> _lastQueuedRecordId;
+};
+
 Status MultiIndexBlock::insertAllDocumentsInCollection(
     OperationContext* opCtx,
     const CollectionPtr& collection,
@@ -429,6 +651,29 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
     bool readOnce = useReadOnceCursorsForIndexBuilds.load();
     opCtx->recoveryUnit()->setReadOnce(readOnce);
 
+    std::unique_ptr<ParallelKeyGenerator> keyGenerator;
+    if (_indexes.size() > 1 && _keyGenerationQueueMaxBytes > 0) {
+        keyGenerator =
+            std::make_unique<ParallelKeyGenerator>(opCtx, &_indexes, _keyGenerationQueueMaxBytes);
+    }
+
+    // Waits for the key generator to catch up with the scan so that _lastRecordIdInserted reflects
+    // the documents whose keys are in every sorter.
+    auto finishKeyGeneration = [&]() -> Status {
+        if (!keyGenerator) {
+            return Status::OK();
+        }
+        auto swLastRecordId = keyGenerator->finish(opCtx, collection);
+        keyGenerator.reset();
+        if (!swLastRecordId.isOK()) {
+            return swLastRecordId.getStatus();
+        }
+        if (swLastRecordId.getValue()) {
+            _lastRecordIdInserted = swLastRecordId.getValue();
+        }
+        return Status::OK();
+    };
+
     try {
         // The phase will be kCollectionScan when resuming an index build from the collection scan
         // phase.
@@ -459,7 +704,11 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
 
             // The external sorter is not part of the storage engine and therefore does not need a
             // WriteUnitOfWork to write keys.
-            uassertStatusOK(_insert(opCtx, objToIndex, loc));
+            if (keyGenerator) {
+                keyGenerator->add(objToIndex, loc);
+            } else {
+                uassertStatusOK(_insert(opCtx, objToIndex, loc));
+            }
 
             _failPointHangDuringBuild(opCtx,
                                       &hangIndexBuildDuringCollectionScanPhaseAfterInsertion,
@@ -472,7 +721,16 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
             progress->hit();
             n++;
         }
+
+        uassertStatusOK(finishKeyGeneration());
     } catch (DBException& ex) {
+        // A key generation failure takes precedence over the error that stopped the scan.
+        auto keyGenerationStatus = finishKeyGeneration();
+        if (!keyGenerationStatus.isOK()) {
+            _phase = IndexBuildPhaseEnum::kInitialized;
+            return keyGenerationStatus;
+        }
+
         if (ex.isA<ErrorCategory::Interruption>() || ex.isA<ErrorCategory::ShutdownError>() ||
             ErrorCodes::IndexBuildAborted == ex.code()) {
             // If the collection scan is stopped because due to an interrupt or shutdown event, we
@@ -562,7 +820,10 @@ Status MultiIndexBlock::_insert(OperationContext* opCtx, const BSONObj& doc, con
             continue;
         }
 
-        Status idxStatus = Status::OK();
+        Status idxStatus =
+            checkFailIndexKeyGenerationFailPoint(_indexes[i].block->getIndexName(), doc);
+        if (!idxStatus.isOK())
+            return idxStatus;
 
         // When calling insert, BulkBuilderImpl's Sorter performs file I/O that may result in an
         // exception.
@@ -319,6 +319,12 @@ private:
 
     Status _insert(OperationContext* opCtx, const BSONObj& wholeDocument, const RecordId& loc);
 
+    /**
+     * Pipelines key generation and sorter insertion for each index onto its own thread during the
+     * collection scan. Defined in multi_index_block.cpp.
+     */
+    class ParallelKeyGenerator;
+
     // Is set during init() and ensures subsequent function calls act on the same Collection.
     boost::optional<UUID> _collectionUUID;
 
@@ -330,6 +336,10 @@ private:
 
     std::size_t _eachIndexBuildMaxMemoryUsageBytes = 0;
 
+    // Portion of the index build memory limit set aside for documents waiting for parallel key
+    // generation. Zero when keys are generated on the scanning thread.
+    std::size_t _keyGenerationQueueMaxBytes = 0;
+
     // Set to true when no work remains to be done, the object can safely destruct without leaving
     // incorrect state set anywhere.
     bool _buildIsCleanedUp = true;
@@ -32,10 +32,14 @@
 #include "mongo/db/catalog/multi_index_block.h"
 
 #include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/catalog/multi_index_block_gen.h"
 #include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/fail_point.h"
 
 namespace mongo {
 namespace {
@@ -183,5 +187,144 @@ TEST_F(MultiIndexBlockTest, InitWriteConflictException) {
     indexer->abortIndexBuild(operationContext(), coll, MultiIndexBlock::kNoopOnCleanUpFn);
 }
 
+/**
+ * Builds more than one index at a time with the keys of each index generated on its own thread.
+ */
+class MultiIndexBlockParallelKeyGenerationTest : public MultiIndexBlockTest {
+private:
+    void setUp() override {
+        MultiIndexBlockTest::setUp();
+        _useParallelKeyGeneration = gUseParallelKeyGenerationForIndexBuilds.swap(true);
+    }
+
+    void tearDown() override {
+        gUseParallelKeyGenerationForIndexBuilds.store(_useParallelKeyGeneration);
+        MultiIndexBlockTest::tearDown();
+    }
+
+protected:
+    // Spans several batches handed to the key generation threads.
+    static constexpr int kNumDocs = 300;
+
+    void insertDocuments() {
+        for (int i = 0; i < kNumDocs; ++i) {
+            insertDocument(BSON("_id" << i << "a" << i << "b" << i));
+        }
+    }
+
+    void insertDocument(const BSONObj& doc) {
+        ASSERT_OK(storageInterface()->insertDocument(
+            operationContext(), getNSS(), {doc, Timestamp()}, repl::OpTime::kUninitializedTerm));
+    }
+
+    static BSONObj makeSpec(BSONObj key, const std::string& name) {
+        return BSON("key" << key << "name" << name << "v"
+                          << static_cast<int>(IndexDescriptor::kLatestIndexVersion));
+    }
+
+private:
+    bool _useParallelKeyGeneration = false;
+};
+
+TEST_F(MultiIndexBlockParallelKeyGenerationTest, KeyGenerationErrorFailsCollectionScan) {
+    insertDocuments();
+    auto indexer = getIndexer();
+
+    Lock::DBLock dbLock(operationContext(), getNSS().db(), MODE_X);
+    AutoGetCollection autoColl(operationContext(), getNSS(), MODE_X);
+    CollectionWriter coll(autoColl);
+
+    {
+        WriteUnitOfWork wuow(operationContext());
+        ASSERT_OK(indexer
+                      ->init(operationContext(),
+                             coll,
+                             {makeSpec(BSON("a" << 1), "a_1"), makeSpec(BSON("b" << 1), "b_1")},
+                             MultiIndexBlock::kNoopOnInitFn)
+                      .getStatus());
+        wuow.commit();
+    }
+
+    // Only the thread generating keys for 'b_1' fails.
+    {
+        FailPointEnableBlock failPoint("failIndexKeyGeneration", BSON("indexName"
+                                                                      << "b_1"));
+        ASSERT_EQ(ErrorCodes::FailPointEnabled,
+                  indexer->insertAllDocumentsInCollection(operationContext(), coll.get()));
+    }
+
+    indexer->abortIndexBuild(operationContext(), coll, MultiIndexBlock::kNoopOnCleanUpFn);
+}
+
+TEST_F(MultiIndexBlockParallelKeyGenerationTest, SuppressedKeyGenerationErrorsAreRecorded) {
+    insertDocuments();
+    insertDocument(
+        BSON("_id" << kNumDocs << "a" << BSON_ARRAY(1 << 2) << "b" << BSON_ARRAY(1 << 2)));
+    auto indexer = getIndexer();
+
+    Lock::DBLock dbLock(operationContext(), getNSS().db(), MODE_X);
+    AutoGetCollection autoColl(operationContext(), getNSS(), MODE_X);
+    CollectionWriter coll(autoColl);
+
+    {
+        WriteUnitOfWork wuow(operationContext());
+        ASSERT_OK(indexer
+                      ->init(operationContext(),
+                             coll,
+                             {makeSpec(BSON("a" << 1), "a_1"),
+                              makeSpec(BSON("a" << 1 << "b" << 1), "a_1_b_1")},
+                             MultiIndexBlock::kNoopOnInitFn)
+                      .getStatus());
+        wuow.commit();
+    }
+
+    // Parallel arrays cannot be indexed, but the error is only reported once the skipped record is
+    // retried with constraints enforced.
+    ASSERT_OK(indexer->insertAllDocumentsInCollection(operationContext(), coll.get()));
+    ASSERT_OK(indexer->dumpInsertsFromBulk(operationContext(), coll.get()));
+    ASSERT_EQ(ErrorCodes::CannotIndexParallelArrays,
+              indexer->retrySkippedRecords(operationContext(), coll.get()));
+
+    indexer->abortIndexBuild(operationContext(), coll, MultiIndexBlock::kNoopOnCleanUpFn);
+}
+
+TEST_F(MultiIndexBlockParallelKeyGenerationTest, InterruptDuringCollectionScan) {
+    insertDocuments();
+    auto indexer = getIndexer();
+    auto opCtx = operationContext();
+
+    Lock::DBLock dbLock(opCtx, getNSS().db(), MODE_X);
+    AutoGetCollection autoColl(opCtx, getNSS(), MODE_X);
+    CollectionWriter coll(autoColl);
+
+    {
+        WriteUnitOfWork wuow(opCtx);
+        ASSERT_OK(indexer
+                      ->init(opCtx,
+                             coll,
+                             {makeSpec(BSON("a" << 1), "a_1"), makeSpec(BSON("b" << 1), "b_1")},
+                             MultiIndexBlock::kNoopOnInitFn)
+                      .getStatus());
+        wuow.commit();
+    }
+
+    // Kill the operation after the first batch has been handed to the key generation threads.
+    {
+        FailPointEnableBlock failPoint("hangIndexBuildDuringCollectionScanPhaseBeforeInsertion",
+                                       BSON("fieldsToMatch" << BSON("_id" << kNumDocs / 2)));
+        stdx::thread killer([&] {
+            failPoint->waitForTimesEntered(failPoint.initialTimesEntered() + 1);
+            stdx::lock_guard<Client> lk(*opCtx->getClient());
+            opCtx->markKilled(ErrorCodes::Interrupted);
+        });
+        auto status = indexer->insertAllDocumentsInCollection(opCtx, coll.get());
+        killer.join();
+        ASSERT_EQ(ErrorCodes::Interrupted, status);
+    }
+
+    auto isResumable = false;
+    indexer->abortWithoutCleanup(opCtx, coll.get(), isResumable);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -48,6 +48,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/execution_context.h"
 #include "mongo/db/storage/key_string.h"
+#include "mongo/db/storage/record_content_hash.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/object_check.h"
@@ -338,6 +339,7 @@ void ValidateAdaptor::traverseRecordStore(OperationContext* opCtx,
                                           BSONObjBuilder* output) {
     _numRecords = 0;  // need to reset it because this function can be called more than once.
     long long dataSizeTotal = 0;
+    uint64_t contentHashTotal = 0;
     long long interruptIntervalNumBytes = 0;
     long long nInvalid = 0;
     long long numCorruptRecordsSizeBytes = 0;
@@ -360,6 +362,9 @@ void ValidateAdaptor::traverseRecordStore(OperationContext* opCtx,
         _progress.set(CurOp::get(opCtx)->setProgress_inlock(curopMessage, totalRecords));
     }
 
+    // A background validation reads a checkpoint, which the content hash does not describe.
+    const bool hashContent = !_validateState->isBackground() && rs->maintainsContentHash();
+
     bool corruptRecordsSizeLimitWarning = false;
     const std::unique_ptr<SeekableRecordThrottleCursor>& traverseRecordStoreCursor =
         _validateState->getTraverseRecordStoreCursor();
@@ -372,6 +377,9 @@ void ValidateAdaptor::traverseRecordStore(OperationContext* opCtx,
         auto dataSize = record->data.size();
         interruptIntervalNumBytes += dataSize;
         dataSizeTotal += dataSize;
+        if (hashContent) {
+            contentHashTotal += hashRecordContent(record->data.data(), dataSize);
+        }
         size_t validatedSize = 0;
         Status status = validateRecord(opCtx, record->id, record->data, &validatedSize, results);
 
@@ -407,6 +415,9 @@ void ValidateAdaptor::traverseRecordStore(OperationContext* opCtx,
                 results->repaired = true;
                 results->numRemovedCorruptRecords++;
                 _numRecords--;
+                if (hashContent) {
+                    contentHashTotal -= hashRecordContent(record->data.data(), dataSize);
+                }
             } else {
                 if (results->valid) {
                     results->errors.push_back("Detected one or more invalid documents. See logs.");
@@ -455,11 +466,29 @@ void ValidateAdaptor::traverseRecordStore(OperationContext* opCtx,
         results->valid = false;
     }
 
+    if (hashContent) {
+        if (auto contentHash = rs->contentHash(opCtx);
+            contentHash && *contentHash != contentHashTotal) {
+            std::string msg = str::stream()
+                << "content hash (" << *contentHash << ") does not match the hash of the records ("
+                << contentHashTotal << ") for collection '"
+                << _validateState->getCollection()->ns() << "'";
+            if (_validateState->shouldEnforceFastCount()) {
+                results->errors.push_back(msg);
+                results->valid = false;
+            } else {
+                results->warnings.push_back(msg);
+            }
+        }
+    }
+
     // Do not update the record store stats if we're in the background as we've validated a
     // checkpoint and it may not have the most up-to-date changes.
     if (results->valid && !_validateState->isBackground()) {
-        _validateState->getCollection()->getRecordStore()->updateStatsAfterRepair(
-            opCtx, _numRecords, dataSizeTotal);
+        rs->updateStatsAfterRepair(opCtx, _numRecords, dataSizeTotal);
+        if (hashContent) {
+            rs->updateContentHashAfterRepair(opCtx, contentHashTotal);
+        }
     }
 
     _progress->finished();
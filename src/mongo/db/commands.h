@@ -44,6 +44,7 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/read_concern_support_result.h"
 #include "mongo/db/repl/read_concern_args.h"
@@ -473,6 +474,15 @@ public:
         return LogicalOp::opCommand;
     }
 
+    /**
+     * Returns the admission priority of user operations running this command. Long-running
+     * commands return kBatch so that interactive operations are admitted ahead of them when the
+     * server is overloaded.
+     */
+    virtual OperationContext::Priority getAdmissionPriority() const {
+        return OperationContext::Priority::kInteractive;
+    }
+
     /**
      * Returns whether this operation is a read, write, command, or multi-document transaction.
      *
@@ -31,10 +31,12 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog_helper.h"
@@ -46,11 +48,13 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/mutex.h"
+#include "mongo/util/hex.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/timer.h"
@@ -87,6 +91,10 @@ public:
         return false;
     }
 
+    OperationContext::Priority getAdmissionPriority() const override {
+        return OperationContext::Priority::kBatch;
+    }
+
     ReadConcernSupportResult supportsReadConcern(const BSONObj& cmdObj,
                                                  repl::ReadConcernLevel level) const final {
 
@@ -136,6 +144,24 @@ public:
                 str::stream() << "Invalid db name: " << ns,
                 NamespaceString::validDBName(ns, NamespaceString::DollarInDbNameBehavior::Allow));
 
+        // Collections whose storage keeps a content hash report it instead of being scanned. The
+        // hash always describes the latest data, so it cannot be combined with reading from a
+        // snapshot. Content hashes are used for every collection that keeps one or for none, and
+        // the result combining them is reported as 'contentMd5' rather than 'md5', so that 'md5'
+        // always means the same across members. A member that lost its hashes, e.g. after a
+        // rollback, reports 'md5' instead, and the caller has to compare scans of every member.
+        const bool useContentHashes = cmdObj["useContentHashes"].trueValue();
+        if (useContentHashes) {
+            uassert(ErrorCodes::InvalidOptions,
+                    "The 'useContentHashes' option cannot be used with"
+                    " '$_internalReadAtClusterTime'",
+                    !cmdObj.hasField("$_internalReadAtClusterTime"));
+            uassert(ErrorCodes::InvalidOptions,
+                    "The 'useContentHashes' option cannot be used with snapshot read concern",
+                    repl::ReadConcernArgs::get(opCtx).getLevel() !=
+                        repl::ReadConcernLevel::kSnapshotReadConcern);
+        }
+
         if (auto elem = cmdObj["$_internalReadAtClusterTime"]) {
             uassert(ErrorCodes::InvalidOptions,
                     "The '$_internalReadAtClusterTime' option is only supported when testing"
@@ -228,7 +254,10 @@ public:
 
         std::map<std::string, std::string> collectionToHashMap;
         std::map<std::string, OptionalCollectionUUID> collectionToUUIDMap;
+        std::map<std::string, boost::optional<uint64_t>> collectionToContentHashMap;
         std::set<std::string> cappedCollectionSet;
+        std::set<std::string> contentHashedCollectionSet;
+        std::vector<NamespaceString> deferredCollections;
 
         bool noError = true;
         catalog::forEachCollectionFromDb(
@@ -268,24 +297,56 @@ public:
                     collectionToUUIDMap[collNss.coll().toString()] = uuid;
                 }
 
-                // Compute the hash for this collection.
-                std::string hash = _hashCollection(opCtx, db, collNss);
-
-                collectionToHashMap[collNss.coll().toString()] = hash;
+                // Whether content hashes are used is only known once every collection was seen.
+                if (useContentHashes) {
+                    auto rs = collection->getRecordStore();
+                    if (rs->maintainsContentHash()) {
+                        collectionToContentHashMap[collNss.coll().toString()] =
+                            rs->contentHash(opCtx);
+                    }
+                    deferredCollections.push_back(collNss);
+                } else {
+                    collectionToHashMap[collNss.coll().toString()] =
+                        _hashCollection(opCtx, db, collNss);
+                }
 
                 return true;
             });
         if (!noError)
             return false;
 
+        const bool allContentHashesKnown = !collectionToContentHashMap.empty() &&
+            std::all_of(collectionToContentHashMap.begin(),
+                        collectionToContentHashMap.end(),
+                        [](const auto& entry) { return bool(entry.second); });
+
+        // Content hashes are never combined with reading at a timestamp, so the database is locked
+        // in S mode and the deferred collections can still be scanned.
+        for (const auto& collNss : deferredCollections) {
+            // The prefix keeps a content hash from matching the hash of a scan.
+            const auto collName = collNss.coll().toString();
+            auto contentHash = collectionToContentHashMap.find(collName);
+            if (allContentHashesKnown && contentHash != collectionToContentHashMap.end()) {
+                collectionToHashMap[collName] = "content-" + zeroPaddedHex(*contentHash->second);
+                contentHashedCollectionSet.insert(collName);
+            } else {
+                collectionToHashMap[collName] = _hashCollection(opCtx, db, collNss);
+            }
+        }
+
         BSONObjBuilder bb(result.subobjStart("collections"));
         BSONArrayBuilder cappedCollections;
+        BSONArrayBuilder contentHashedCollections;
         BSONObjBuilder collectionsByUUID;
 
         for (auto elem : cappedCollectionSet) {
             cappedCollections.append(elem);
         }
 
+        for (auto elem : contentHashedCollectionSet) {
+            contentHashedCollections.append(elem);
+        }
+
         for (auto entry : collectionToUUIDMap) {
             auto collName = entry.first;
             auto uuid = entry.second;
@@ -302,13 +363,16 @@ public:
         bb.done();
 
         result.append("capped", BSONArray(cappedCollections.done()));
+        if (useContentHashes) {
+            result.append("contentHashed", BSONArray(contentHashedCollections.done()));
+        }
         result.append("uuids", collectionsByUUID.done());
 
         md5digest d;
         md5_finish(&globalState, d);
         std::string hash = digestToString(d);
 
-        result.append("md5", hash);
+        result.append(contentHashedCollectionSet.empty() ? "md5" : "contentMd5", hash);
         result.appendNumber("timeMillis", timer.millis());
 
         return 1;
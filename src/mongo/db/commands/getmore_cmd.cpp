@@ -555,6 +555,7 @@ public:
 
             CursorId respondWithId = 0;
             CursorResponseBuilder::Options options;
+            options.useDocumentSequences = reply->canUseDocumentSequences();
             if (!opCtx->inMultiDocumentTransaction()) {
                 options.atClusterTime = repl::ReadConcernArgs::get(opCtx).getArgsAtClusterTime();
             }
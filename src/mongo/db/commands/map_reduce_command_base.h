@@ -44,6 +44,10 @@ public:
                "details.";
     }
 
+    OperationContext::Priority getAdmissionPriority() const override {
+        return OperationContext::Priority::kBatch;
+    }
+
     /**
      * The mapReduce command supports only 'local' and 'available' readConcern levels.
      * For aggregation-based mapReduce there are no known restrictions to broader support, but work
@@ -290,6 +290,19 @@ public:
                 Lock::GlobalLock lk(opCtx, MODE_S);
             }
 
+            {
+                // The barrier above guarantees that no new oplog segment is started from here on,
+                // but older versions only read the oplog's own table, so any existing segments
+                // must be merged back into it first.
+                AutoGetOplog oplogRead(opCtx, OplogAccessMode::kRead);
+                const auto& oplog = oplogRead.getCollection();
+                uassert(ErrorCodes::IllegalOperation,
+                        "Cannot downgrade while the oplog is partitioned into segments. Restart "
+                        "with partitionedOplog disabled to merge the segments back into the oplog "
+                        "table, then retry the downgrade",
+                        !oplog || !oplog->getRecordStore()->hasOplogSegments());
+            }
+
             if (failDowngrading.shouldFail())
                 return false;
 
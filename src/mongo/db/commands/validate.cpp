@@ -105,6 +105,10 @@ public:
         return false;
     }
 
+    OperationContext::Priority getAdmissionPriority() const override {
+        return OperationContext::Priority::kBatch;
+    }
+
     virtual void addRequiredPrivileges(const std::string& dbname,
                                        const BSONObj& cmdObj,
                                        std::vector<Privilege>* out) const {
@@ -360,9 +360,12 @@ bool LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t d
             invariant(!opCtx->recoveryUnit()->isTimestamped());
 
         OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
+        // Waiters are ordered by the priority and deadline of the operation even when the wait
+        // itself is not interruptible.
+        const auto admission = TicketHolder::Admission::forOperation(opCtx);
         if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
+            holder->waitForTicket(interruptible, admission);
+        } else if (!holder->waitForTicketUntil(interruptible, deadline, admission)) {
             return false;
         }
         restoreStateOnErrorGuard.dismiss();
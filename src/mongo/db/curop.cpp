@@ -689,6 +689,7 @@ void CurOp::reportState(OperationContext* opCtx, BSONObjBuilder* builder, bool t
 
     builder->append("op", logicalOpToString(_logicalOp));
     builder->append("ns", _ns);
+    builder->append("priority", OperationContext::priorityToString(opCtx->getPriority()));
 
     // When the currentOp command is run, it returns a single response object containing all current
     // operations; this request will fail if the response exceeds the 16MB document limit. By
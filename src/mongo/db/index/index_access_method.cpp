@@ -490,6 +490,12 @@ public:
                   const RecordId& loc,
                   const InsertDeleteOptions& options) final;
 
+    Status insert(OperationContext* opCtx,
+                  const BSONObj& obj,
+                  const RecordId& loc,
+                  const InsertDeleteOptions& options,
+                  const OnSuppressedErrorFn& onSuppressedError) final;
+
     void addToSorter(const KeyString::Value& keyString) final {
         _sorter->add(keyString, mongo::NullValue());
     }
@@ -559,6 +565,22 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
                                                           const BSONObj& obj,
                                                           const RecordId& loc,
                                                           const InsertDeleteOptions& options) {
+    return insert(opCtx, obj, loc, options, [&](const RecordId& skippedLoc) {
+        // If a key generation error was suppressed, record the document as "skipped" so the
+        // index builder can retry at a point when data is consistent.
+        auto interceptor = _indexCatalogEntry->indexBuildInterceptor();
+        if (interceptor && interceptor->getSkippedRecordTracker()) {
+            interceptor->getSkippedRecordTracker()->record(opCtx, skippedLoc);
+        }
+    });
+}
+
+Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(
+    OperationContext* opCtx,
+    const BSONObj& obj,
+    const RecordId& loc,
+    const InsertDeleteOptions& options,
+    const OnSuppressedErrorFn& onSuppressedError) {
     auto& executionCtx = StorageExecutionContext::get(opCtx);
 
     auto keys = executionCtx.keys();
@@ -575,19 +597,14 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
             multikeyPaths.get(),
             loc,
             [&](Status status, const BSONObj&, boost::optional<RecordId>) {
-                // If a key generation error was suppressed, record the document as "skipped" so the
-                // index builder can retry at a point when data is consistent.
-                auto interceptor = _indexCatalogEntry->indexBuildInterceptor();
-                if (interceptor && interceptor->getSkippedRecordTracker()) {
-                    LOGV2_DEBUG(20684,
-                                1,
-                                "Recording suppressed key generation error to retry later: "
-                                "{error} on {loc}: {obj}",
-                                "error"_attr = status,
-                                "loc"_attr = loc,
-                                "obj"_attr = redact(obj));
-                    interceptor->getSkippedRecordTracker()->record(opCtx, loc);
-                }
+                LOGV2_DEBUG(20684,
+                            1,
+                            "Recording suppressed key generation error to retry later: "
+                            "{error} on {loc}: {obj}",
+                            "error"_attr = status,
+                            "loc"_attr = loc,
+                            "obj"_attr = redact(obj));
+                onSuppressedError(loc);
             });
     } catch (...) {
         return exceptionToStatus();
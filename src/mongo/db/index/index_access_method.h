@@ -248,6 +248,23 @@ public:
                               const RecordId& loc,
                               const InsertDeleteOptions& options) = 0;
 
+        /**
+         * Called with the RecordId of a document whose key generation error was suppressed.
+         */
+        using OnSuppressedErrorFn = std::function<void(const RecordId& loc)>;
+
+        /**
+         * Like insert(), but reports documents whose key generation error was suppressed to
+         * 'onSuppressedError' rather than recording them with the index build interceptor. This
+         * allows keys to be generated on a thread other than the one driving the index build, as
+         * 'opCtx' is only used for its scratch buffers.
+         */
+        virtual Status insert(OperationContext* opCtx,
+                              const BSONObj& obj,
+                              const RecordId& loc,
+                              const InsertDeleteOptions& options,
+                              const OnSuppressedErrorFn& onSuppressedError) = 0;
+
         /**
          * Inserts the keyString directly into the sorter. No additional logic (related to multikey
          * paths, etc.) is performed.
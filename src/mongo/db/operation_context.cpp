@@ -82,6 +82,26 @@ OperationContext::~OperationContext() {
     releaseOperationKey();
 }
 
+StringData OperationContext::priorityToString(Priority priority) {
+    switch (priority) {
+        case Priority::kInternal:
+            return "internal"_sd;
+        case Priority::kInteractive:
+            return "interactive"_sd;
+        case Priority::kBatch:
+            return "batch"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+OperationContext::Priority OperationContext::getPriority() const {
+    if (auto priority = _priority.load(); priority != kPriorityUnset) {
+        return static_cast<Priority>(priority);
+    }
+    return _client && !_client->isFromUserConnection() ? Priority::kInternal
+                                                       : Priority::kInteractive;
+}
+
 void OperationContext::setDeadlineAndMaxTime(Date_t when,
                                              Microseconds maxTime,
                                              ErrorCodes::Error timeoutError) {
@@ -94,6 +94,21 @@ class OperationContext : public Interruptible, public Decorable<OperationContext
     OperationContext& operator=(const OperationContext&) = delete;
 
 public:
+    /**
+     * The class of an operation for admission scheduling. Operations waiting to be admitted are
+     * served in this order, and by deadline within a class.
+     */
+    enum class Priority {
+        // Operations of clients that do not come from a user connection, such as replication.
+        kInternal,
+        // Latency-sensitive user operations. The default for user connections.
+        kInteractive,
+        // Long-running user operations, such as analytic or validation commands.
+        kBatch,
+    };
+
+    static StringData priorityToString(Priority priority);
+
     OperationContext(Client* client, OperationId opId);
     virtual ~OperationContext();
 
@@ -437,6 +452,19 @@ public:
         return _alwaysInterruptAtStepDownOrUp.load();
     }
 
+    /**
+     * Returns the admission priority of this operation. Unless set explicitly, it is kInternal for
+     * operations of clients that do not come from a user connection and kInteractive otherwise.
+     */
+    Priority getPriority() const;
+
+    /**
+     * May be called while another thread reads the priority, such as currentOp.
+     */
+    void setPriority(Priority priority) {
+        _priority.store(static_cast<int>(priority));
+    }
+
     /**
      * Clears metadata associated with a multi-document transaction.
      */
@@ -641,6 +669,10 @@ private:
 
     // Whether this operation is an exhaust command.
     bool _exhaust = false;
+
+    // The admission priority, if set explicitly, or else kPriorityUnset. See getPriority().
+    static constexpr int kPriorityUnset = -1;
+    AtomicWord<int> _priority{kPriorityUnset};
 };
 
 // Gets a TimeZoneDatabase pointer from the ServiceContext.
@@ -97,6 +97,7 @@ void CursorResponseBuilder::done(CursorId cursorId, StringData cursorNamespace)
 void CursorResponseBuilder::abandon() {
     invariant(_active);
     _batch.reset();
+    _docSeqBuilder.reset();
     _cursorObject.reset();
     _bodyBuilder.reset();
     _replyBuilder->reset();
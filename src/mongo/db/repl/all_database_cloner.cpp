@@ -51,7 +51,9 @@ AllDatabaseCloner::AllDatabaseCloner(InitialSyncSharedData* sharedData,
           "AllDatabaseCloner"_sd, sharedData, source, client, storageInterface, dbPool),
       _connectStage("connect", this, &AllDatabaseCloner::connectStage),
       _getInitialSyncIdStage("getInitialSyncId", this, &AllDatabaseCloner::getInitialSyncIdStage),
-      _listDatabasesStage("listDatabases", this, &AllDatabaseCloner::listDatabasesStage) {}
+      _listDatabasesStage("listDatabases", this, &AllDatabaseCloner::listDatabasesStage),
+      _createClientFn(
+          [] { return std::make_unique<DBClientConnection>(true /* autoReconnect */); }) {}
 
 BaseCloner::ClonerStages AllDatabaseCloner::getStages() {
     return {&_connectStage, &_getInitialSyncIdStage, &_listDatabasesStage};
@@ -102,6 +104,23 @@ Status AllDatabaseCloner::ensurePrimaryOrSecondary(
                                 << " is neither primary nor secondary.");
 }
 
+std::unique_ptr<DBClientConnection> AllDatabaseCloner::_makeWorkerClient() {
+    auto client = _createClientFn();
+    client->setHandshakeValidationHook(
+        [this](const executor::RemoteCommandResponse& isMasterReply) {
+            return ensurePrimaryOrSecondary(isMasterReply);
+        });
+    return client;
+}
+
+void AllDatabaseCloner::shutdownWorkerClients() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _workerClientsShutDown = true;
+    if (_currentDatabaseCloner) {
+        _currentDatabaseCloner->shutdownWorkerClients();
+    }
+}
+
 BaseCloner::AfterStageBehavior AllDatabaseCloner::connectStage() {
     auto* client = getClient();
     // If the client already has the address (from a previous attempt), we must allow it to
@@ -196,6 +215,10 @@ void AllDatabaseCloner::postStage() {
                                                                       getClient(),
                                                                       getStorageInterface(),
                                                                       getDBPool());
+            _currentDatabaseCloner->setCreateClientFn([this] { return _makeWorkerClient(); });
+            if (_workerClientsShutDown) {
+                _currentDatabaseCloner->shutdownWorkerClients();
+            }
         }
         auto dbStatus = _currentDatabaseCloner->run();
         if (dbStatus.isOK()) {
@@ -62,6 +62,20 @@ public:
 
     std::string toString() const;
 
+    /**
+     * Sets how the database cloners create the clients of their parallel collection cloning
+     * workers. Must be called before run().
+     */
+    void setCreateClientFn(const DatabaseCloner::CreateClientFn& createClientFn) {
+        _createClientFn = createClientFn;
+    }
+
+    /**
+     * Shuts down the clients of the parallel collection cloning workers of the current and any
+     * later database cloner. Used to cancel the clone.
+     */
+    void shutdownWorkerClients();
+
 protected:
     ClonerStages getStages() final;
 
@@ -99,6 +113,12 @@ private:
      */
     Status ensurePrimaryOrSecondary(const executor::RemoteCommandResponse& isMasterReply);
 
+    /**
+     * Creates a client for a parallel collection cloning worker, which validates the sync source
+     * the same way our own client does.
+     */
+    std::unique_ptr<DBClientConnection> _makeWorkerClient();
+
     /**
      * Stage function that makes a connection to the sync source.
      */
@@ -138,7 +158,9 @@ private:
     ConnectStage _getInitialSyncIdStage;                     // (R)
     ClonerStage<AllDatabaseCloner> _listDatabasesStage;      // (R)
     std::vector<std::string> _databases;                     // (X)
+    DatabaseCloner::CreateClientFn _createClientFn;          // (X)
     std::unique_ptr<DatabaseCloner> _currentDatabaseCloner;  // (MX)
+    bool _workerClientsShutDown = false;                     // (M)
     Stats _stats;                                            // (MX)
 };
 
@@ -121,7 +121,7 @@ Status CollectionBulkLoaderImpl::_insertDocumentsForUncappedCollection(
         Status status = writeConflictRetry(
             _opCtx.get(), "CollectionBulkLoaderImpl/insertDocumentsUncapped", _nss.ns(), [&] {
                 WriteUnitOfWork wunit(_opCtx.get());
-                auto insertIter = iter;
+                auto insertEnd = iter;
                 int bytesInBlock = 0;
                 locs.clear();
 
@@ -130,16 +130,19 @@ Status CollectionBulkLoaderImpl::_insertDocumentsForUncappedCollection(
                     return Status::OK();
                 };
 
-                while (insertIter != end && bytesInBlock < collectionBulkLoaderBatchSizeInBytes) {
-                    const auto& doc = *insertIter++;
-                    bytesInBlock += doc.objsize();
-                    // This version of insert will not update any indexes.
-                    const auto status =
-                        (*_collection)
-                            ->insertDocumentForBulkLoader(_opCtx.get(), doc, onRecordInserted);
-                    if (!status.isOK()) {
-                        return status;
-                    }
+                while (insertEnd != end && bytesInBlock < collectionBulkLoaderBatchSizeInBytes) {
+                    bytesInBlock += insertEnd->objsize();
+                    ++insertEnd;
+                }
+
+                // Append the whole block to the record store in one call so that RecordIds are
+                // reserved together and a single cursor is used. This version of insert will not
+                // update any indexes.
+                const auto status = (*_collection)
+                                        ->insertDocumentsForBulkLoader(
+                                            _opCtx.get(), iter, insertEnd, onRecordInserted);
+                if (!status.isOK()) {
+                    return status;
                 }
 
                 wunit.commit();
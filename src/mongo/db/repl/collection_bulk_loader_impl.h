@@ -92,7 +92,8 @@ private:
     /**
      * For uncapped collections, we will insert documents in batches of size
      * collectionBulkLoaderBatchSizeInBytes or up to one document size greater. All insertions in a
-     * given batch will be inserted in one WriteUnitOfWork.
+     * given batch will be inserted in one WriteUnitOfWork, with a single batched record store
+     * insert.
      */
     Status _insertDocumentsForUncappedCollection(const std::vector<BSONObj>::const_iterator begin,
                                                  const std::vector<BSONObj>::const_iterator end);
@@ -32,12 +32,16 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/string_data.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands/list_collections_filter.h"
 #include "mongo/db/repl/database_cloner.h"
 #include "mongo/db/repl/database_cloner_common.h"
 #include "mongo/db/repl/database_cloner_gen.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace repl {
@@ -51,7 +55,9 @@ DatabaseCloner::DatabaseCloner(const std::string& dbName,
     : InitialSyncBaseCloner(
           "DatabaseCloner"_sd, sharedData, source, client, storageInterface, dbPool),
       _dbName(dbName),
-      _listCollectionsStage("listCollections", this, &DatabaseCloner::listCollectionsStage) {
+      _listCollectionsStage("listCollections", this, &DatabaseCloner::listCollectionsStage),
+      _createClientFn(
+          [] { return std::make_unique<DBClientConnection>(true /* autoReconnect */); }) {
     invariant(!dbName.empty());
     _stats.dbname = dbName;
 }
@@ -127,57 +133,165 @@ void DatabaseCloner::postStage() {
             _stats.collectionStats.back().ns = coll.first.ns();
         }
     }
-    for (const auto& coll : _collections) {
-        auto& sourceNss = coll.first;
-        auto& collectionOptions = coll.second;
-        {
-            stdx::lock_guard<Latch> lk(_mutex);
-            _currentCollectionCloner = std::make_unique<CollectionCloner>(sourceNss,
-                                                                          collectionOptions,
-                                                                          getSharedData(),
-                                                                          getSource(),
-                                                                          getClient(),
-                                                                          getStorageInterface(),
-                                                                          getDBPool());
-        }
-        auto collStatus = _currentCollectionCloner->run();
-        if (collStatus.isOK()) {
-            LOGV2_DEBUG(21148,
-                        1,
-                        "collection clone finished: {namespace}",
-                        "Collection clone finished",
-                        "namespace"_attr = sourceNss);
-        } else {
-            LOGV2_ERROR(21149,
-                        "collection clone for '{namespace}' failed due to {error}",
-                        "Collection clone failed",
-                        "namespace"_attr = sourceNss,
-                        "error"_attr = collStatus.toString());
-            setSyncFailedStatus({ErrorCodes::InitialSyncFailure,
-                                 collStatus
-                                     .withContext(str::stream() << "Error cloning collection '"
-                                                                << sourceNss.toString() << "'")
-                                     .toString()});
-        }
-        {
-            stdx::lock_guard<Latch> lk(_mutex);
-            _stats.collectionStats[_stats.clonedCollections] = _currentCollectionCloner->getStats();
-            _currentCollectionCloner = nullptr;
+
+    const auto parallelism =
+        std::min(static_cast<size_t>(initialSyncCollectionClonerParallelism.load()),
+                 _collections.size());
+    if (parallelism > 1) {
+        _cloneCollectionsInParallel(parallelism);
+    } else {
+        for (size_t index = 0; index < _collections.size(); ++index) {
             // Abort the database cloner if the collection clone failed.
-            if (!collStatus.isOK())
+            if (!_cloneCollection(index, getClient()).isOK())
                 return;
+        }
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_stats.clonedCollections == _collections.size()) {
+        _stats.end = getSharedData()->getClock()->now();
+    }
+}
+
+Status DatabaseCloner::_cloneCollection(size_t index, DBClientConnection* client) {
+    auto& sourceNss = _collections[index].first;
+    auto& collectionOptions = _collections[index].second;
+    auto collectionCloner = std::make_unique<CollectionCloner>(sourceNss,
+                                                               collectionOptions,
+                                                               getSharedData(),
+                                                               getSource(),
+                                                               client,
+                                                               getStorageInterface(),
+                                                               getDBPool());
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _activeCollectionCloners.emplace(index, collectionCloner.get());
+    }
+    auto collStatus = collectionCloner->run();
+    if (collStatus.isOK()) {
+        LOGV2_DEBUG(21148,
+                    1,
+                    "collection clone finished: {namespace}",
+                    "Collection clone finished",
+                    "namespace"_attr = sourceNss);
+    } else {
+        LOGV2_ERROR(21149,
+                    "collection clone for '{namespace}' failed due to {error}",
+                    "Collection clone failed",
+                    "namespace"_attr = sourceNss,
+                    "error"_attr = collStatus.toString());
+        setSyncFailedStatus({ErrorCodes::InitialSyncFailure,
+                             collStatus
+                                 .withContext(str::stream() << "Error cloning collection '"
+                                                            << sourceNss.toString() << "'")
+                                 .toString()});
+    }
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _stats.collectionStats[index] = collectionCloner->getStats();
+        _activeCollectionCloners.erase(index);
+        if (collStatus.isOK())
             _stats.clonedCollections++;
+    }
+    return collStatus;
+}
+
+void DatabaseCloner::_cloneCollectionsInParallel(size_t parallelism) {
+    auto claimNextCollection = [this]() -> boost::optional<size_t> {
+        if (mustExit())
+            return boost::none;
+        stdx::lock_guard<Latch> lk(_mutex);
+        // Stop handing out collections once any of them failed to clone.
+        if (!getStatus(lk).isOK() || _nextCollectionToClone == _collections.size())
+            return boost::none;
+        return _nextCollectionToClone++;
+    };
+
+    auto cloneCollections = [&](DBClientConnection* client) {
+        while (auto index = claimNextCollection()) {
+            if (!_cloneCollection(*index, client).isOK())
+                return;
         }
+    };
+
+    LOGV2_DEBUG(4972200,
+                1,
+                "Cloning collections in parallel",
+                "db"_attr = _dbName,
+                "collections"_attr = _collections.size(),
+                "parallelism"_attr = parallelism);
+
+    std::vector<stdx::thread> workers;
+    for (size_t worker = 1; worker < parallelism; ++worker) {
+        workers.emplace_back([&, worker] {
+            const std::string threadName = str::stream()
+                << "DatabaseCloner-" << _dbName << "-" << worker;
+            Client::initThread(threadName);
+            std::unique_ptr<DBClientConnection> client;
+            ON_BLOCK_EXIT([&] {
+                if (client) {
+                    _removeWorkerClient(client.get());
+                }
+            });
+            try {
+                client = _createClientFn();
+                // Registered before connecting, so that cancelling the clone also interrupts the
+                // connection attempt.
+                _addWorkerClient(client.get());
+                _connectWorkerClient(client.get());
+            } catch (const DBException& ex) {
+                // The remaining workers still clone every collection, so failing to connect only
+                // costs us parallelism.
+                LOGV2_WARNING(4972201,
+                              "Failed to open an additional connection for parallel collection "
+                              "cloning",
+                              "db"_attr = _dbName,
+                              "source"_attr = getSource(),
+                              "error"_attr = ex.toStatus());
+                return;
+            }
+            cloneCollections(client.get());
+        });
+    }
+
+    cloneCollections(getClient());
+    for (auto&& worker : workers) {
+        worker.join();
+    }
+}
+
+void DatabaseCloner::_connectWorkerClient(DBClientConnection* client) {
+    uassertStatusOK(client->connect(getSource(), StringData()));
+    uassertStatusOK(replAuthenticate(client).withContext(
+        str::stream() << "Failed to authenticate to " << getSource()));
+}
+
+void DatabaseCloner::_addWorkerClient(DBClientConnection* client) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_workerClientsShutDown) {
+        client->shutdownAndDisallowReconnect();
     }
+    _workerClients.insert(client);
+}
+
+void DatabaseCloner::_removeWorkerClient(DBClientConnection* client) {
     stdx::lock_guard<Latch> lk(_mutex);
-    _stats.end = getSharedData()->getClock()->now();
+    _workerClients.erase(client);
+}
+
+void DatabaseCloner::shutdownWorkerClients() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _workerClientsShutDown = true;
+    for (auto client : _workerClients) {
+        client->shutdownAndDisallowReconnect();
+    }
 }
 
 DatabaseCloner::Stats DatabaseCloner::getStats() const {
     stdx::lock_guard<Latch> lk(_mutex);
     DatabaseCloner::Stats stats = _stats;
-    if (_currentCollectionCloner) {
-        stats.collectionStats[_stats.clonedCollections] = _currentCollectionCloner->getStats();
+    for (const auto& [index, collectionCloner] : _activeCollectionCloners) {
+        stats.collectionStats[index] = collectionCloner->getStats();
     }
     return stats;
 }
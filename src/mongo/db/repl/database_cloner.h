@@ -29,6 +29,10 @@
 
 #pragma once
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
 #include <vector>
 
 #include "mongo/db/repl/base_cloner.h"
@@ -54,6 +58,11 @@ public:
         void append(BSONObjBuilder* builder) const;
     };
 
+    /**
+     * Returns a new, unconnected client for the sync source.
+     */
+    using CreateClientFn = std::function<std::unique_ptr<DBClientConnection>()>;
+
     DatabaseCloner(const std::string& dbName,
                    InitialSyncSharedData* sharedData,
                    const HostAndPort& source,
@@ -69,6 +78,20 @@ public:
 
     static CollectionOptions parseCollectionOptions(const BSONObj& element);
 
+    /**
+     * Sets how the parallel collection cloning workers create their clients, which they then
+     * connect to the sync source. Must be called before run().
+     */
+    void setCreateClientFn(const CreateClientFn& createClientFn) {
+        _createClientFn = createClientFn;
+    }
+
+    /**
+     * Shuts down the clients of the parallel collection cloning workers and keeps them, and any
+     * the workers create afterwards, from reconnecting. Used to cancel the clone.
+     */
+    void shutdownWorkerClients();
+
 protected:
     ClonerStages getStages() final;
 
@@ -89,10 +112,37 @@ private:
 
     /**
      * The postStage creates and runs the individual CollectionCloners on each database found on
-     * the sync source, and sets the end time in _stats when done.
+     * the sync source, and sets the end time in _stats when done. Up to
+     * 'initialSyncCollectionClonerParallelism' collections are cloned concurrently.
      */
     void postStage() final;
 
+    /**
+     * Clones the collection at 'index' in _collections using 'client'. Marks the sync as failed
+     * and returns the error if the collection could not be cloned.
+     */
+    Status _cloneCollection(size_t index, DBClientConnection* client);
+
+    /**
+     * Clones _collections on 'parallelism' worker threads. Each worker claims the next uncloned
+     * collection until all are claimed or one of them fails. Worker 0 uses our own client; the
+     * other workers open their own connections to the sync source.
+     */
+    void _cloneCollectionsInParallel(size_t parallelism);
+
+    /**
+     * Connects the client of a parallel worker to the sync source and authenticates it.
+     */
+    void _connectWorkerClient(DBClientConnection* client);
+
+    /**
+     * Registers the client of a parallel worker so that shutdownWorkerClients() reaches it, and
+     * shuts it down at once if the worker clients were already shut down.
+     */
+    void _addWorkerClient(DBClientConnection* client);
+
+    void _removeWorkerClient(DBClientConnection* client);
+
     std::string describeForFuzzer(BaseClonerStage* stage) const final {
         return _dbName + " db: { " + stage->getName() + ": 1 } ";
     }
@@ -109,8 +159,15 @@ private:
     const std::string _dbName;                                                // (R)
     ClonerStage<DatabaseCloner> _listCollectionsStage;                        // (R)
     std::vector<std::pair<NamespaceString, CollectionOptions>> _collections;  // (X)
-    std::unique_ptr<CollectionCloner> _currentCollectionCloner;               // (MX)
-    Stats _stats;                                                             // (MX)
+    // Creates the clients used by the parallel workers other than worker 0.
+    CreateClientFn _createClientFn;  // (X)
+    // Collection cloners currently running, keyed by their index in _collections.
+    std::map<size_t, CollectionCloner*> _activeCollectionCloners;  // (M)
+    size_t _nextCollectionToClone = 0;                             // (M)
+    // Clients of the parallel workers other than worker 0.
+    std::set<DBClientConnection*> _workerClients;  // (M)
+    bool _workerClientsShutDown = false;           // (M)
+    Stats _stats;                                  // (MX)
 };
 
 }  // namespace repl
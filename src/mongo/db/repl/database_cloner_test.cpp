@@ -32,10 +32,13 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/repl/database_cloner.h"
 #include "mongo/db/repl/initial_sync_cloner_test_fixture.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/service_context_test_fixture.h"
 #include "mongo/dbtests/mock/mock_dbclient_connection.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
 #include "mongo/util/concurrency/thread_pool.h"
@@ -61,6 +64,8 @@ protected:
                    const BSONObj& idIndexSpec,
                    const std::vector<BSONObj>& secondaryIndexSpecs)
             -> StatusWith<std::unique_ptr<CollectionBulkLoaderMock>> {
+            // Parallel collection cloners create their collections concurrently.
+            stdx::lock_guard<Latch> lk(_collectionsMutex);
             const auto collInfo = &_collections[nss];
 
             auto localLoader = std::make_unique<CollectionBulkLoaderMock>(collInfo->stats);
@@ -105,6 +110,7 @@ protected:
         return cloner->_collections;
     }
 
+    Mutex _collectionsMutex = MONGO_MAKE_LATCH("DatabaseClonerTest::_collectionsMutex");
     std::map<NamespaceString, CollectionCloneInfo> _collections;
 
     static std::string _dbName;
@@ -494,5 +500,249 @@ TEST_F(DatabaseClonerTest, DatabaseAndCollectionStats) {
     ASSERT_EQ(_clock.now(), stats.collectionStats[1].end);
 }
 
+/**
+ * A mock connection that records when it is shut down for good.
+ */
+class ShutdownRecordingDBClientConnection : public MockDBClientConnection {
+public:
+    ShutdownRecordingDBClientConnection(MockRemoteDBServer* remoteServer,
+                                        std::shared_ptr<AtomicWord<bool>> shutDown)
+        : MockDBClientConnection(remoteServer, true /* autoReconnect */),
+          _shutDown(std::move(shutDown)) {}
+
+    void shutdownAndDisallowReconnect() override {
+        MockDBClientConnection::shutdownAndDisallowReconnect();
+        _shutDown->store(true);
+    }
+
+private:
+    std::shared_ptr<AtomicWord<bool>> _shutDown;
+};
+
+class DatabaseClonerParallelTest : public DatabaseClonerTest {
+protected:
+    void setUp() override {
+        DatabaseClonerTest::setUp();
+        _originalParallelism = initialSyncCollectionClonerParallelism.load();
+        initialSyncCollectionClonerParallelism.store(2);
+
+        const BSONObj idIndexSpec = BSON("v" << 1 << "key" << BSON("_id" << 1) << "name"
+                                             << "_id_");
+        std::vector<BSONObj> sourceInfos;
+        for (auto&& name : {"a", "b", "c"}) {
+            sourceInfos.push_back(BSON("name" << name << "type"
+                                              << "collection"
+                                              << "options" << BSONObj() << "info"
+                                              << BSON("readOnly" << false << "uuid"
+                                                                 << UUID::gen())));
+        }
+        _mockServer->setCommandReply("listCollections", createListCollectionsResponse(sourceInfos));
+        // The workers claim collections in no fixed order, so every collection gets the same
+        // replies.
+        _mockServer->setCommandReply("count", createCountResponse(0));
+        _mockServer->setCommandReply("listIndexes",
+                                     createCursorResponse(_dbName + ".a", BSON_ARRAY(idIndexSpec)));
+    }
+
+    void tearDown() override {
+        initialSyncCollectionClonerParallelism.store(_originalParallelism);
+        DatabaseClonerTest::tearDown();
+    }
+
+    std::unique_ptr<DatabaseCloner> makeParallelDatabaseCloner() {
+        auto cloner = makeDatabaseCloner();
+        cloner->setCreateClientFn([this] {
+            const auto autoReconnect = true;
+            return std::unique_ptr<DBClientConnection>(
+                new MockDBClientConnection(_mockServer.get(), autoReconnect));
+        });
+        return cloner;
+    }
+
+    Status getSharedDataStatus() {
+        stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
+        return getSharedData()->getStatus(lk);
+    }
+
+    int _originalParallelism = 1;
+};
+
+TEST_F(DatabaseClonerParallelTest, WorkerConnectFailureLeavesCollectionsToOtherWorkers) {
+    initialSyncCollectionClonerParallelism.store(3);
+
+    auto cloner = makeDatabaseCloner();
+    AtomicWord<int> connectAttempts{0};
+    cloner->setCreateClientFn([&]() -> std::unique_ptr<DBClientConnection> {
+        connectAttempts.fetchAndAdd(1);
+        uasserted(ErrorCodes::HostUnreachable, "fake connect failure");
+    });
+
+    ASSERT_OK(cloner->run());
+
+    // Only the workers beyond the first open their own connection.
+    ASSERT_EQ(2, connectAttempts.load());
+    ASSERT_EQUALS(3U, _collections.size());
+    for (auto&& name : {"a", "b", "c"}) {
+        ASSERT(_collections[NamespaceString{_dbName, name}].stats->commitCalled);
+    }
+
+    auto stats = cloner->getStats();
+    ASSERT_EQ(3, stats.clonedCollections);
+    ASSERT_NOT_EQUALS(Date_t(), stats.end);
+}
+
+TEST_F(DatabaseClonerParallelTest, CollectionFailureWhileOtherCollectionIsCloning) {
+    auto createCollectionForBulk = _storageInterface.createCollectionForBulkFn;
+    _storageInterface.createCollectionForBulkFn =
+        [&, createCollectionForBulk](const NamespaceString& nss,
+                                     const CollectionOptions& options,
+                                     const BSONObj& idIndexSpec,
+                                     const std::vector<BSONObj>& secondaryIndexSpecs)
+        -> StatusWith<std::unique_ptr<CollectionBulkLoaderMock>> {
+        if (nss.coll() == "b") {
+            return Status(ErrorCodes::OperationFailed, "fake createCollection failure");
+        }
+        return createCollectionForBulk(nss, options, idIndexSpec, secondaryIndexSpecs);
+    };
+    auto cloner = makeParallelDatabaseCloner();
+
+    // Hold 'a' before it starts and 'b' just before it creates its collection, so both are in
+    // progress at once.
+    auto collClonerBeforeFailPoint = globalFailPointRegistry().find("hangBeforeClonerStage");
+    auto collClonerAfterFailPoint = globalFailPointRegistry().find("hangAfterClonerStage");
+    auto beforeTimesEntered = collClonerBeforeFailPoint->setMode(
+        FailPoint::alwaysOn,
+        0,
+        fromjson("{cloner: 'CollectionCloner', stage: 'count', nss: '" + _dbName + ".a'}"));
+    auto afterTimesEntered = collClonerAfterFailPoint->setMode(
+        FailPoint::alwaysOn,
+        0,
+        fromjson("{cloner: 'CollectionCloner', stage: 'listIndexes', nss: '" + _dbName + ".b'}"));
+
+    Status status = Status::OK();
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        status = cloner->run();
+    });
+    collClonerBeforeFailPoint->waitForTimesEntered(beforeTimesEntered + 1);
+    collClonerAfterFailPoint->waitForTimesEntered(afterTimesEntered + 1);
+
+    // Let 'b' fail. 'a' then stops at its next check and no worker claims 'c'.
+    collClonerAfterFailPoint->setMode(FailPoint::off);
+    clonerThread.join();
+    collClonerBeforeFailPoint->setMode(FailPoint::off);
+
+    ASSERT_EQ(ErrorCodes::InitialSyncFailure, status.code());
+    auto sharedStatus = getSharedDataStatus();
+    ASSERT_EQ(ErrorCodes::InitialSyncFailure, sharedStatus.code());
+    ASSERT_STRING_CONTAINS(sharedStatus.reason(), _dbName + ".b");
+    ASSERT_EQUALS(0U, _collections.size());
+
+    auto stats = cloner->getStats();
+    ASSERT_EQ(3, stats.collections);
+    ASSERT_EQ(0, stats.clonedCollections);
+    ASSERT_EQ(Date_t(), stats.end);
+    ASSERT_EQ(Date_t(), stats.collectionStats[2].start);
+}
+
+TEST_F(DatabaseClonerParallelTest, ShutdownWhileWorkersAreCloning) {
+    auto cloner = makeParallelDatabaseCloner();
+
+    auto collClonerBeforeFailPoint = globalFailPointRegistry().find("hangBeforeClonerStage");
+    auto timesEntered = collClonerBeforeFailPoint->setMode(
+        FailPoint::alwaysOn, 0, fromjson("{cloner: 'CollectionCloner', stage: 'count'}"));
+
+    Status status = Status::OK();
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        status = cloner->run();
+    });
+
+    // Both workers are holding a collection.
+    collClonerBeforeFailPoint->waitForTimesEntered(timesEntered + 2);
+
+    {
+        stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
+        getSharedData()->setStatusIfOK(
+            lk, Status(ErrorCodes::CallbackCanceled, "Initial sync was cancelled"));
+    }
+    clonerThread.join();
+    collClonerBeforeFailPoint->setMode(FailPoint::off);
+
+    ASSERT_NOT_OK(status);
+    ASSERT_EQ(ErrorCodes::CallbackCanceled, getSharedDataStatus().code());
+    ASSERT_EQUALS(0U, _collections.size());
+
+    auto stats = cloner->getStats();
+    ASSERT_EQ(0, stats.clonedCollections);
+    ASSERT_EQ(Date_t(), stats.end);
+}
+
+TEST_F(DatabaseClonerParallelTest, ShutdownWorkerClientsWhileWorkersAreCloning) {
+    initialSyncCollectionClonerParallelism.store(3);
+
+    auto cloner = makeDatabaseCloner();
+    Mutex mutex = MONGO_MAKE_LATCH("DatabaseClonerParallelTest::mutex");
+    std::vector<std::shared_ptr<AtomicWord<bool>>> workerClientsShutDown;
+    cloner->setCreateClientFn([&] {
+        auto shutDown = std::make_shared<AtomicWord<bool>>(false);
+        {
+            stdx::lock_guard<Latch> lk(mutex);
+            workerClientsShutDown.push_back(shutDown);
+        }
+        return std::unique_ptr<DBClientConnection>(
+            new ShutdownRecordingDBClientConnection(_mockServer.get(), shutDown));
+    });
+
+    auto collClonerBeforeFailPoint = globalFailPointRegistry().find("hangBeforeClonerStage");
+    auto timesEntered = collClonerBeforeFailPoint->setMode(
+        FailPoint::alwaysOn, 0, fromjson("{cloner: 'CollectionCloner', stage: 'count'}"));
+
+    Status status = Status::OK();
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        status = cloner->run();
+    });
+
+    // All three workers are holding a collection, so both extra workers have connected.
+    collClonerBeforeFailPoint->waitForTimesEntered(timesEntered + 3);
+
+    // Cancel the clone the way the initial syncer does.
+    {
+        stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
+        getSharedData()->setStatusIfOK(
+            lk, Status(ErrorCodes::CallbackCanceled, "Initial sync was cancelled"));
+    }
+    cloner->shutdownWorkerClients();
+    {
+        stdx::lock_guard<Latch> lk(mutex);
+        ASSERT_EQ(2U, workerClientsShutDown.size());
+        for (const auto& shutDown : workerClientsShutDown) {
+            ASSERT(shutDown->load());
+        }
+    }
+
+    clonerThread.join();
+    collClonerBeforeFailPoint->setMode(FailPoint::off);
+
+    ASSERT_NOT_OK(status);
+    ASSERT_EQ(ErrorCodes::CallbackCanceled, getSharedDataStatus().code());
+    ASSERT_EQ(0, cloner->getStats().clonedCollections);
+}
+
+TEST_F(DatabaseClonerParallelTest, WorkerClientsCreatedAfterShutdownAreShutDown) {
+    auto cloner = makeDatabaseCloner();
+    auto shutDown = std::make_shared<AtomicWord<bool>>(false);
+    cloner->setCreateClientFn([&] {
+        return std::unique_ptr<DBClientConnection>(
+            new ShutdownRecordingDBClientConnection(_mockServer.get(), shutDown));
+    });
+    cloner->shutdownWorkerClients();
+
+    // Unlike a real connection, the mock connection reconnects anyway, so the clone still runs.
+    ASSERT_OK(cloner->run());
+    ASSERT(shutDown->load());
+}
+
 }  // namespace repl
 }  // namespace mongo
@@ -43,6 +43,7 @@
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/repl/apply_ops.h"
 #include "mongo/db/repl/oplog_applier_utils.h"
+#include "mongo/db/repl/oplog_dependency_graph.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/transaction_oplog_application.h"
 #include "mongo/db/stats/counters.h"
@@ -73,6 +74,17 @@ ServerStatusMetricField<Counter64> displayOplogApplicationBatchSize("repl.apply.
 TimerStats applyBatchStats;
 ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches", &applyBatchStats);
 
+// Time spent in each phase of a batch: assigning ops to writers, then waiting for the oplog writes
+// that did not overlap with that, then applying the ops on the writer threads.
+TimerStats prepareBatchStats;
+ServerStatusMetricField<TimerStats> displayPrepareBatch("repl.apply.phases.prepare",
+                                                        &prepareBatchStats);
+TimerStats waitForOplogWritesStats;
+ServerStatusMetricField<TimerStats> displayWaitForOplogWrites(
+    "repl.apply.phases.waitForOplogWrites", &waitForOplogWritesStats);
+TimerStats applyOpsStats;
+ServerStatusMetricField<TimerStats> displayApplyOps("repl.apply.phases.applyOps", &applyOpsStats);
+
 /**
  * Used for logging a report of ops that take longer than "slowMS" to apply. This is called
  * right before returning from applyOplogEntryOrGroupedInserts, and it returns the same status.
@@ -128,6 +140,27 @@ void _addOplogChainOpsToWriterVectors(OperationContext* opCtx,
         opCtx, &derivedOps->back(), writerVectors, collPropertiesCache, shouldSerialize);
 }
 
+/**
+ * Adds 'ops', which must be in the order they would be applied by a single writer, to 'graph'.
+ * CRUD ops are keyed by the same hash used to assign them to writer vectors, so ops on the same
+ * document, or on the same capped collection, keep their relative order. Commands are barriers.
+ */
+void fillDependencyGraph(OperationContext* opCtx,
+                         const std::vector<const OplogEntry*>& ops,
+                         OplogDependencyGraph* graph) {
+    CachedCollectionProperties collPropertiesCache;
+    for (auto op : ops) {
+        if (op->isCrudOpType()) {
+            graph->addKeyedOp(op,
+                              OplogApplierUtils::getWriterHash(opCtx, *op, &collPropertiesCache));
+        } else if (op->getOpType() == OpTypeEnum::kCommand) {
+            graph->addBarrierOp(op);
+        } else {
+            graph->addIndependentOp(op);
+        }
+    }
+}
+
 }  // namespace
 
 
@@ -138,7 +171,12 @@ public:
     ApplyBatchFinalizer(ReplicationCoordinator* replCoord) : _replCoord(replCoord) {}
     virtual ~ApplyBatchFinalizer(){};
 
-    virtual void record(const OpTimeAndWallTime& newOpTimeAndWallTime) {
+    /**
+     * Records that the batch ending at 'newOpTimeAndWallTime' has been applied. 'journalFlushed',
+     * if set, becomes ready once the batch's writes are durable.
+     */
+    virtual void record(const OpTimeAndWallTime& newOpTimeAndWallTime,
+                        boost::optional<SharedSemiFuture<void>> journalFlushed) {
         _recordApplied(newOpTimeAndWallTime);
     };
 
@@ -167,7 +205,8 @@ public:
           _waiterThread{&ApplyBatchFinalizerForJournal::_run, this} {};
     ~ApplyBatchFinalizerForJournal();
 
-    void record(const OpTimeAndWallTime& newOpTimeAndWallTime) override;
+    void record(const OpTimeAndWallTime& newOpTimeAndWallTime,
+                boost::optional<SharedSemiFuture<void>> journalFlushed) override;
 
 private:
     /**
@@ -177,12 +216,16 @@ private:
      */
     void _run();
 
-    // Protects _cond, _shutdownSignaled, and _latestOpTime.
+    // Protects _cond, _shutdownSignaled, _latestOpTime and _latestJournalFlushed.
     Mutex _mutex = MONGO_MAKE_LATCH("OplogApplierImpl::_mutex");
     // Used to alert our thread of a new OpTime.
     stdx::condition_variable _cond;
     // The next OpTime to set as the ReplicationCoordinator's lastOpTime after flushing.
     OpTimeAndWallTime _latestOpTimeAndWallTime;
+    // The journal flush round requested when the batch ending at _latestOpTimeAndWallTime was
+    // applied. Waiting for it, rather than requesting a new round, lets the next batch be applied
+    // while the flush covering this one is in progress.
+    boost::optional<SharedSemiFuture<void>> _latestJournalFlushed;
     // Once this is set to true the _run method will terminate.
     bool _shutdownSignaled = false;
     // Thread that will _run(). Must be initialized last as it depends on the other variables.
@@ -198,11 +241,13 @@ ApplyBatchFinalizerForJournal::~ApplyBatchFinalizerForJournal() {
     _waiterThread.join();
 }
 
-void ApplyBatchFinalizerForJournal::record(const OpTimeAndWallTime& newOpTimeAndWallTime) {
+void ApplyBatchFinalizerForJournal::record(const OpTimeAndWallTime& newOpTimeAndWallTime,
+                                           boost::optional<SharedSemiFuture<void>> journalFlushed) {
     _recordApplied(newOpTimeAndWallTime);
 
     stdx::unique_lock<Latch> lock(_mutex);
     _latestOpTimeAndWallTime = newOpTimeAndWallTime;
+    _latestJournalFlushed = std::move(journalFlushed);
     _cond.notify_all();
 }
 
@@ -211,6 +256,7 @@ void ApplyBatchFinalizerForJournal::_run() {
 
     while (true) {
         OpTimeAndWallTime latestOpTimeAndWallTime = {OpTime(), Date_t()};
+        boost::optional<SharedSemiFuture<void>> latestJournalFlushed;
 
         {
             stdx::unique_lock<Latch> lock(_mutex);
@@ -224,10 +270,16 @@ void ApplyBatchFinalizerForJournal::_run() {
 
             latestOpTimeAndWallTime = _latestOpTimeAndWallTime;
             _latestOpTimeAndWallTime = {OpTime(), Date_t()};
+            latestJournalFlushed = std::exchange(_latestJournalFlushed, boost::none);
         }
 
+        // Flush rounds complete in order, so the round requested for the latest batch also covers
+        // all earlier batches. If it failed, for example because it was interrupted by a
+        // replication state change, fall back to waiting for a new round.
         auto opCtx = cc().makeOperationContext();
-        JournalFlusher::get(opCtx.get())->waitForJournalFlush();
+        if (!latestJournalFlushed || !latestJournalFlushed->getNoThrow().isOK()) {
+            JournalFlusher::get(opCtx.get())->waitForJournalFlush();
+        }
         _recordDurable(latestOpTimeAndWallTime);
     }
 }
@@ -363,7 +415,10 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
             &opCtx, lastOpTimeInBatch.getTimestamp(), orderedCommit);
 
         // 4. Finalize this batch. The finalizer advances the global timestamp to lastOpTimeInBatch.
-        finalizer->record({lastOpTimeInBatch, lastWallTimeInBatch});
+        // Durability of the batch is tracked asynchronously, so the next batch can be applied
+        // while the journal flush requested for this one is in progress.
+        finalizer->record({lastOpTimeInBatch, lastWallTimeInBatch},
+                          std::exchange(_lastBatchJournalFlushed, boost::none));
     }
 }
 
@@ -480,12 +535,24 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
         //   and create a pseudo oplog.
         std::vector<std::vector<OplogEntry>> derivedOps;
 
+        // With the dependency graph, all ops are first gathered into a single writer vector, which
+        // keeps them in the order a single writer would apply them.
+        const bool useDependencyGraph = oplogApplicationUsesDependencyGraph.load();
         std::vector<std::vector<const OplogEntry*>> writerVectors(
-            _writerPool->getStats().numThreads);
+            useDependencyGraph ? 1 : _writerPool->getStats().numThreads);
+        Timer phaseTimer;
         fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
 
+        OplogDependencyGraph dependencyGraph;
+        if (useDependencyGraph) {
+            fillDependencyGraph(opCtx, writerVectors.front(), &dependencyGraph);
+        }
+        prepareBatchStats.record(phaseTimer);
+
         // Wait for writes to finish before applying ops.
+        phaseTimer.reset();
         _writerPool->waitForIdle();
+        waitForOplogWritesStats.record(phaseTimer);
 
         // Use this fail point to hold the PBWM lock after we have written the oplog entries but
         // before we have applied them.
@@ -503,18 +570,27 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
         }
 
         {
+            TimerHolder applyOpsTimer(&applyOpsStats);
             std::vector<Status> statusVector(_writerPool->getStats().numThreads, Status::OK());
 
             // Doles out all the work to the writer pool threads. writerVectors is not modified,
             // but  applyOplogBatchPerWorker will modify the vectors that it contains.
-            invariant(writerVectors.size() == statusVector.size());
-            for (size_t i = 0; i < writerVectors.size(); i++) {
-                if (writerVectors[i].empty())
+            invariant(useDependencyGraph || writerVectors.size() == statusVector.size());
+            const size_t numWorkers = useDependencyGraph
+                ? std::min(statusVector.size(), dependencyGraph.size())
+                : writerVectors.size();
+            if (useDependencyGraph && numWorkers > 0) {
+                dependencyGraph.start(numWorkers);
+            }
+            for (size_t i = 0; i < numWorkers; i++) {
+                if (!useDependencyGraph && writerVectors[i].empty())
                     continue;
 
                 _writerPool->schedule(
                     [this,
-                     &writer = writerVectors.at(i),
+                     useDependencyGraph,
+                     &dependencyGraph,
+                     writer = useDependencyGraph ? nullptr : &writerVectors.at(i),
                      &status = statusVector.at(i),
                      &multikeyVector = multikeyVector.at(i)](auto scheduleStatus) {
                         invariant(scheduleStatus);
@@ -526,7 +602,13 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
                         opCtx->setShouldParticipateInFlowControl(false);
 
                         status = opCtx->runWithoutInterruptionExceptAtGlobalShutdown([&] {
-                            return applyOplogBatchPerWorker(opCtx.get(), &writer, &multikeyVector);
+                            // With the dependency graph, every writer pulls ready ops from the
+                            // graph until all ops have been applied.
+                            if (useDependencyGraph) {
+                                return _applyReadyOpsPerWorker(
+                                    opCtx.get(), &dependencyGraph, &multikeyVector);
+                            }
+                            return applyOplogBatchPerWorker(opCtx.get(), writer, &multikeyVector);
                         });
                     });
             }
@@ -561,7 +643,7 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
     // new writes with timestamps associated with those oplog entries will show up in the future. We
     // want to flush the journal as soon as possible in order to free ops waiting with 'j' write
     // concern.
-    JournalFlusher::get(opCtx)->triggerJournalFlush();
+    _lastBatchJournalFlushed = JournalFlusher::get(opCtx)->triggerJournalFlushAndGetFuture();
 
     // Use this fail point to hold the PBWM lock and prevent the batch from completing.
     if (MONGO_unlikely(pauseBatchApplicationBeforeCompletion.shouldFail())) {
@@ -774,6 +856,35 @@ Status applyOplogEntryOrGroupedInserts(OperationContext* opCtx,
     }
 }
 
+Status OplogApplierImpl::_applyReadyOpsPerWorker(OperationContext* opCtx,
+                                                 OplogDependencyGraph* dependencyGraph,
+                                                 WorkerMultikeyPathInfo* workerMultikeyPathInfo) {
+    // Whether this worker finishes, fails or is interrupted, the others must not keep waiting for
+    // ops which depend on ops it will no longer apply.
+    ON_BLOCK_EXIT([&] { dependencyGraph->cancel(); });
+
+    std::vector<OplogDependencyGraph::NodeId> nodes;
+    std::vector<const OplogEntry*> ops;
+    while (dependencyGraph->getReadyOps(&nodes)) {
+        ops.clear();
+        for (auto node : nodes) {
+            ops.push_back(dependencyGraph->getOp(node));
+        }
+
+        WorkerMultikeyPathInfo multikeyPathInfo;
+        auto status = applyOplogBatchPerWorker(opCtx, &ops, &multikeyPathInfo);
+        if (!status.isOK()) {
+            return status;
+        }
+        workerMultikeyPathInfo->insert(
+            workerMultikeyPathInfo->end(), multikeyPathInfo.begin(), multikeyPathInfo.end());
+
+        dependencyGraph->markApplied(nodes);
+    }
+
+    return Status::OK();
+}
+
 Status OplogApplierImpl::applyOplogBatchPerWorker(OperationContext* opCtx,
                                                   std::vector<const OplogEntry*>* ops,
                                                   WorkerMultikeyPathInfo* workerMultikeyPathInfo) {
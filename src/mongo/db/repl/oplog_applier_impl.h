@@ -40,10 +40,13 @@
 #include "mongo/db/repl/replication_metrics.h"
 #include "mongo/db/repl/session_update_tracker.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/util/future.h"
 
 namespace mongo {
 namespace repl {
 
+class OplogDependencyGraph;
+
 /**
  * Applies oplog entries.
  * Primarily used to apply batches of operations fetched from a sync source during steady state
@@ -104,6 +107,14 @@ private:
                                         std::vector<std::vector<OplogEntry>>* derivedOps,
                                         SessionUpdateTracker* sessionUpdateTracker) noexcept;
 
+    /**
+     * Run by each writer thread when the batch is applied through an OplogDependencyGraph: applies
+     * ready ops with applyOplogBatchPerWorker() until every op in the graph has been applied.
+     */
+    Status _applyReadyOpsPerWorker(OperationContext* opCtx,
+                                   OplogDependencyGraph* dependencyGraph,
+                                   WorkerMultikeyPathInfo* workerMultikeyPathInfo);
+
     // Not owned by us.
     ReplicationCoordinator* const _replCoord;
 
@@ -119,6 +130,10 @@ private:
     // we will apply all operations that were fetched.
     OpTime _beginApplyingOpTime = OpTime();
 
+    // The journal flush round requested once the last batch was applied. Its writes are durable
+    // once this is ready.
+    boost::optional<SharedSemiFuture<void>> _lastBatchJournalFlushed;
+
     void fillWriterVectors(OperationContext* opCtx,
                            std::vector<OplogEntry>* ops,
                            std::vector<std::vector<const OplogEntry*>>* writerVectors,
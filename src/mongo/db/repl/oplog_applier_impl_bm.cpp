@@ -0,0 +1,559 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/commands/server_status_internal.h"
+#include "mongo/db/logical_session_id.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/repl/oplog_applier_impl.h"
+#include "mongo/db/repl/oplog_buffer_blocking_queue.h"
+#include "mongo/db/repl/oplog_entry_test_helpers.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
+#include "mongo/db/repl/replication_consistency_markers_mock.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/repl/storage_interface_impl.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/update/document_diff_serialization.h"
+#include "mongo/db/update/update_oplog_entry_serialization.h"
+#include "mongo/db/update/update_oplog_entry_version.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/str.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+// Names an oplog dump to replay with BM_ApplyRecordedOplog: a file of concatenated BSON oplog
+// entries, such as mongodump writes for local.oplog.rs.
+constexpr auto kRecordedOplogFileEnvVar = "OPLOG_APPLIER_BM_FILE";
+
+const NamespaceString kNss("test.oplog_applier_bm");
+const NamespaceString kCmdNss("admin.$cmd");
+
+// Oplog entries that each iteration of BM_ApplySyntheticOplog applies.
+constexpr int kOpsPerIteration = 10 * 1000;
+
+// Inserts grouped in each applyOps entry, and in each entry of a transaction.
+constexpr int kOpsPerApplyOps = 10;
+
+// Transactions are spread across this many sessions.
+constexpr int kNumSessions = 100;
+
+enum class Workload { kInsert, kUpdate, kDelete, kApplyOps, kTransaction, kMixed };
+
+/**
+ * Returns the number of CRUD operations applying 'entry' performs, counting each operation in an
+ * applyOps entry.
+ */
+long long countOps(const OplogEntry& entry) {
+    if (entry.getCommandType() == OplogEntry::CommandType::kApplyOps) {
+        return entry.getObject().firstElement().Obj().nFields();
+    }
+    return 1;
+}
+
+/**
+ * Generates oplog entries for a single collection. It keeps track of which documents exist once
+ * the entries it returned so far are applied, so that updates and deletes always find their
+ * document as on a healthy secondary. The live documents are the _ids in [_firstLiveId, _nextId).
+ */
+class SyntheticOplog {
+public:
+    SyntheticOplog(NamespaceString nss, UUID uuid) : _nss(std::move(nss)), _uuid(uuid) {
+        for (int i = 0; i < kNumSessions; ++i) {
+            _sessions.push_back({makeLogicalSessionIdForTest(), 0});
+        }
+    }
+
+    /**
+     * Returns the inserts needed before 'numOps' operations of 'workload' can be generated.
+     */
+    std::vector<OplogEntry> makeSetup(Workload workload, int numOps) {
+        std::vector<OplogEntry> entries;
+        if (workload == Workload::kUpdate || workload == Workload::kDelete ||
+            workload == Workload::kMixed) {
+            while (_nextId - _firstLiveId < numOps) {
+                entries.push_back(_makeInsert());
+            }
+        }
+        return entries;
+    }
+
+    /**
+     * Returns at least 'numOps' operations of 'workload'.
+     */
+    std::vector<OplogEntry> make(Workload workload, int numOps) {
+        std::vector<OplogEntry> entries;
+        switch (workload) {
+            case Workload::kInsert:
+                for (int i = 0; i < numOps; ++i) {
+                    entries.push_back(_makeInsert());
+                }
+                break;
+            case Workload::kUpdate: {
+                const int numLive = _nextId - _firstLiveId;
+                for (int i = 0; i < numOps; ++i) {
+                    entries.push_back(_makeUpdate(_firstLiveId + i % numLive));
+                }
+                break;
+            }
+            case Workload::kDelete:
+                for (int i = 0; i < numOps; ++i) {
+                    entries.push_back(_makeDelete());
+                }
+                break;
+            case Workload::kApplyOps:
+                for (int i = 0; i < numOps; i += kOpsPerApplyOps) {
+                    entries.push_back(makeCommandOplogEntry(
+                        _nextOpTime(), kCmdNss, BSON("applyOps" << _makeInsertArray())));
+                }
+                break;
+            case Workload::kTransaction:
+                // Each transaction is a partialTxn entry followed by the commit entry, which
+                // carries the rest of the transaction's operations.
+                for (int i = 0; i < numOps; i += 2 * kOpsPerApplyOps) {
+                    auto& session = _sessions[(i / (2 * kOpsPerApplyOps)) % kNumSessions];
+                    ++session.second;
+                    auto partialTxn = makeCommandOplogEntryWithSessionInfoAndStmtId(
+                        _nextOpTime(),
+                        kCmdNss,
+                        BSON("applyOps" << _makeInsertArray() << "partialTxn" << true),
+                        session.first,
+                        session.second,
+                        StmtId(0),
+                        OpTime());
+                    auto commit = makeCommandOplogEntryWithSessionInfoAndStmtId(
+                        _nextOpTime(),
+                        kCmdNss,
+                        BSON("applyOps" << _makeInsertArray()),
+                        session.first,
+                        session.second,
+                        StmtId(kOpsPerApplyOps),
+                        partialTxn.getOpTime());
+                    entries.push_back(std::move(partialTxn));
+                    entries.push_back(std::move(commit));
+                }
+                break;
+            case Workload::kMixed: {
+                // Half inserts, four in ten updates and one in ten deletes. Deletes remove the
+                // oldest documents while updates go to the newest half, so they never meet.
+                const int numLive = _nextId - _firstLiveId;
+                for (int i = 0; i < numOps; ++i) {
+                    const int kind = i % 10;
+                    if (kind < 5) {
+                        entries.push_back(_makeInsert());
+                    } else if (kind < 9) {
+                        entries.push_back(_makeUpdate(_nextId - 1 - i % (numLive / 2)));
+                    } else {
+                        entries.push_back(_makeDelete());
+                    }
+                }
+                break;
+            }
+        }
+        return entries;
+    }
+
+private:
+    OpTime _nextOpTime() {
+        // The oldest timestamp trails the stable timestamp by minSnapshotHistoryWindowInSeconds,
+        // so one second per entry keeps it within a few entries of the last applied batch.
+        return OpTime(Timestamp(Seconds(++_lastSecs), 1), 1);
+    }
+
+    static BSONObj _makeDocument(int id) {
+        return BSON("_id" << id << "x" << 0 << "payload" << std::string(100, 'a'));
+    }
+
+    BSONArray _makeInsertArray() {
+        BSONArrayBuilder ops;
+        for (int i = 0; i < kOpsPerApplyOps; ++i) {
+            ops.append(BSON("op"
+                            << "i"
+                            << "ns" << _nss.ns() << "ui" << _uuid << "o"
+                            << _makeDocument(_nextId++)));
+        }
+        return ops.arr();
+    }
+
+    OplogEntry _makeInsert() {
+        return makeOplogEntry(_nextOpTime(),
+                              OpTypeEnum::kInsert,
+                              _nss,
+                              _makeDocument(_nextId++),
+                              boost::none,
+                              {},
+                              Date_t(),
+                              boost::none,
+                              _uuid);
+    }
+
+    OplogEntry _makeUpdate(int id) {
+        auto diff = BSON(doc_diff::kUpdateSectionFieldName << BSON("x" << ++_lastUpdateValue));
+        return makeOplogEntry(_nextOpTime(),
+                              OpTypeEnum::kUpdate,
+                              _nss,
+                              BSON("$v" << static_cast<int>(UpdateOplogEntryVersion::kDeltaV2)
+                                        << update_oplog_entry::kDiffObjectFieldName << diff),
+                              BSON("_id" << id),
+                              {},
+                              Date_t(),
+                              boost::none,
+                              _uuid);
+    }
+
+    OplogEntry _makeDelete() {
+        invariant(_firstLiveId < _nextId);
+        return makeOplogEntry(_nextOpTime(),
+                              OpTypeEnum::kDelete,
+                              _nss,
+                              BSON("_id" << _firstLiveId++),
+                              boost::none,
+                              {},
+                              Date_t(),
+                              boost::none,
+                              _uuid);
+    }
+
+    const NamespaceString _nss;
+    const UUID _uuid;
+    std::vector<std::pair<LogicalSessionId, TxnNumber>> _sessions;
+    long long _lastSecs = 0;
+    long long _lastUpdateValue = 0;
+    int _firstLiveId = 0;
+    int _nextId = 0;
+};
+
+/**
+ * Reads the oplog entries in the BSON file at 'path'.
+ */
+std::vector<OplogEntry> readRecordedOplog(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    uassert(ErrorCodes::FileOpenFailed,
+            str::stream() << "Failed to open recorded oplog file " << path,
+            file.is_open());
+    const std::string contents{std::istreambuf_iterator<char>(file),
+                               std::istreambuf_iterator<char>()};
+
+    std::vector<OplogEntry> entries;
+    for (size_t offset = 0; offset < contents.size();) {
+        const char* data = contents.data() + offset;
+        uassertStatusOKWithContext(validateBSON(data, contents.size() - offset),
+                                   str::stream() << "Invalid BSON at offset " << offset << " of "
+                                                 << path);
+        BSONObj doc(data);
+        entries.push_back(uassertStatusOK(OplogEntry::parse(doc.getOwned())));
+        offset += doc.objsize();
+    }
+    return entries;
+}
+
+/**
+ * Runs an OplogApplierImpl with its own writer pool against an in-process WiredTiger instance, set
+ * up as OplogApplierImplTest does.
+ */
+class OplogApplierBenchmarkFixture : public ServiceContextMongoDTest {
+public:
+    OplogApplierBenchmarkFixture(OplogApplication::Mode mode, int numWriterThreads)
+        : ServiceContextMongoDTest("wiredTiger"),
+          _opCtx(makeOperationContext()),
+          _writerPool(makeReplWriterPool(numWriterThreads)) {
+        auto serviceContext = getServiceContext();
+
+        ReplicationCoordinator::set(serviceContext,
+                                    std::make_unique<ReplicationCoordinatorMock>(serviceContext));
+        invariant(ReplicationCoordinator::get(serviceContext)
+                      ->setFollowerMode(MemberState::RS_SECONDARY));
+        StorageInterface::set(serviceContext, std::make_unique<StorageInterfaceImpl>());
+        setOplogCollectionName(serviceContext);
+        createOplog(_opCtx.get());
+
+        // (Generic FCV reference): This FCV reference should exist across LTS binary versions.
+        serverGlobalParams.mutableFeatureCompatibility.setVersion(
+            ServerGlobalParams::FeatureCompatibility::kLatest);
+
+        createCollection(NamespaceString::kSessionTransactionsTableNamespace, UUID::gen());
+
+        _applier = std::make_unique<OplogApplierImpl>(nullptr,  // executor
+                                                      &_oplogBuffer,
+                                                      &noopOplogApplierObserver,
+                                                      ReplicationCoordinator::get(serviceContext),
+                                                      &_consistencyMarkers,
+                                                      StorageInterface::get(serviceContext),
+                                                      OplogApplier::Options(mode),
+                                                      _writerPool.get());
+    }
+
+    ~OplogApplierBenchmarkFixture() {
+        _applier.reset();
+        _writerPool->shutdown();
+        _writerPool->join();
+        _opCtx.reset();
+        StorageInterface::set(getServiceContext(), {});
+        tearDown();
+    }
+
+    void createCollection(const NamespaceString& nss, const UUID& uuid) {
+        CollectionOptions options;
+        options.uuid = uuid;
+        uassertStatusOK(
+            StorageInterface::get(_opCtx.get())->createCollection(_opCtx.get(), nss, options));
+    }
+
+    /**
+     * Applies 'entries' in the batches the OplogBatcher forms from them, and adds the time spent
+     * forming batches to 'batchingMicros'.
+     */
+    void apply(const std::vector<OplogEntry>& entries, long long* batchingMicros) {
+        OplogApplier::BatchLimits limits;
+        limits.ops = replBatchLimitOperations.load();
+        limits.bytes = replBatchLimitBytes.load();
+
+        auto storageEngine = getServiceContext()->getStorageEngine();
+        auto next = entries.cbegin();
+        while (true) {
+            // Keep the buffer filled up to its size limit, like BackgroundSync does.
+            OplogBuffer::Batch toPush;
+            size_t bufferSize = _oplogBuffer.getSize();
+            for (; next != entries.cend(); ++next) {
+                const auto& raw = next->getRaw();
+                if (bufferSize + raw.objsize() > _oplogBuffer.getMaxSize()) {
+                    break;
+                }
+                bufferSize += raw.objsize();
+                toPush.push_back(raw);
+            }
+            if (!toPush.empty()) {
+                _oplogBuffer.push(_opCtx.get(), toPush.cbegin(), toPush.cend());
+            }
+
+            Timer batchingTimer;
+            auto batch = uassertStatusOK(_applier->getNextApplierBatch(_opCtx.get(), limits));
+            *batchingMicros += batchingTimer.micros();
+            if (batch.empty()) {
+                return;
+            }
+
+            const auto lastTimestamp = batch.back().getTimestamp();
+            uassertStatusOK(_applier->applyOplogBatch(_opCtx.get(), std::move(batch)));
+
+            // Let storage discard history the way it would once the batch became majority
+            // committed.
+            storageEngine->setStableTimestamp(lastTimestamp);
+        }
+    }
+
+private:
+    void _doTest() override {}
+
+    ServiceContext::UniqueOperationContext _opCtx;
+    std::unique_ptr<ThreadPool> _writerPool;
+    OplogBufferBlockingQueue _oplogBuffer;
+    ReplicationConsistencyMarkersMock _consistencyMarkers;
+    std::unique_ptr<OplogApplierImpl> _applier;
+};
+
+/**
+ * Accumulates the per-phase time OplogApplierImpl reports in serverStatus over the measured part
+ * of each iteration.
+ */
+class PhaseTimes {
+public:
+    void start() {
+        _startReport = _getReport();
+    }
+
+    void stop() {
+        const auto report = _getReport();
+        for (auto&& phase : report) {
+            _totalMillis[phase.fieldName()] += phase.Obj()["totalMillis"].numberLong() -
+                _startReport[phase.fieldName()].Obj()["totalMillis"].numberLong();
+        }
+    }
+
+    void setCounters(benchmark::State& state) const {
+        for (auto&& [phase, millis] : _totalMillis) {
+            state.counters[phase + "Millis"] =
+                benchmark::Counter(millis, benchmark::Counter::kAvgIterations);
+        }
+    }
+
+private:
+    static BSONObj _getReport() {
+        BSONObjBuilder builder;
+        MetricTree::theMetricTree->appendTo(builder);
+        return builder.obj().getFieldDotted("metrics.repl.apply.phases").Obj().getOwned();
+    }
+
+    BSONObj _startReport;
+    std::map<std::string, long long> _totalMillis;
+};
+
+void setCounters(benchmark::State& state,
+                 long long numOps,
+                 long long batchingMicros,
+                 const PhaseTimes& phaseTimes) {
+    state.SetItemsProcessed(numOps);
+    state.counters["batchingMillis"] =
+        benchmark::Counter(batchingMicros / 1000.0, benchmark::Counter::kAvgIterations);
+    phaseTimes.setCounters(state);
+}
+
+/**
+ * Applies kOpsPerIteration synthetic operations of the workload range(0) selects, as a secondary
+ * with range(1) writer threads. The documents that updates and deletes need are inserted outside
+ * of the measured time. Reports operations applied per second, and the average time per
+ * iteration spent forming batches and in each phase of OplogApplierImpl::_applyOplogBatch().
+ */
+void BM_ApplySyntheticOplog(benchmark::State& state) {
+    const auto workload = static_cast<Workload>(state.range(0));
+    const int numWriterThreads = state.range(1);
+
+    OplogApplierBenchmarkFixture fixture(OplogApplication::Mode::kSecondary, numWriterThreads);
+    const auto uuid = UUID::gen();
+    fixture.createCollection(kNss, uuid);
+    SyntheticOplog oplog(kNss, uuid);
+
+    long long numOps = 0;
+    long long batchingMicros = 0;
+    long long setupBatchingMicros = 0;
+    PhaseTimes phaseTimes;
+    for (auto _ : state) {
+        state.PauseTiming();
+        fixture.apply(oplog.makeSetup(workload, kOpsPerIteration), &setupBatchingMicros);
+        const auto entries = oplog.make(workload, kOpsPerIteration);
+        for (const auto& entry : entries) {
+            numOps += countOps(entry);
+        }
+        phaseTimes.start();
+        state.ResumeTiming();
+
+        fixture.apply(entries, &batchingMicros);
+
+        state.PauseTiming();
+        phaseTimes.stop();
+        state.ResumeTiming();
+    }
+
+    setCounters(state, numOps, batchingMicros, phaseTimes);
+}
+
+/**
+ * Replays the recorded oplog named by kRecordedOplogFileEnvVar with range(0) writer threads. The
+ * entries are applied in initial sync mode, which tolerates updates and deletes of documents that
+ * were not in the recording. Collections that the recording writes to but does not create are
+ * created beforehand, without secondary indexes.
+ */
+void BM_ApplyRecordedOplog(benchmark::State& state) {
+    const char* path = std::getenv(kRecordedOplogFileEnvVar);
+    if (!path) {
+        state.SkipWithError("Set OPLOG_APPLIER_BM_FILE to an oplog dump to replay");
+        return;
+    }
+    const auto entries = readRecordedOplog(path);
+
+    long long numOps = 0;
+    long long batchingMicros = 0;
+    PhaseTimes phaseTimes;
+    std::unique_ptr<OplogApplierBenchmarkFixture> fixture;
+    for (auto _ : state) {
+        // The recording can only be applied once, so each iteration starts from a new instance.
+        state.PauseTiming();
+        fixture.reset();
+        fixture = std::make_unique<OplogApplierBenchmarkFixture>(
+            OplogApplication::Mode::kInitialSync, state.range(0));
+        std::set<NamespaceString> createdNss{NamespaceString::kSessionTransactionsTableNamespace};
+        auto precreate = [&](const NamespaceString& nss, const boost::optional<UUID>& uuid) {
+            if (uuid && nss.isReplicated() && createdNss.insert(nss).second) {
+                fixture->createCollection(nss, *uuid);
+            }
+        };
+        for (const auto& entry : entries) {
+            numOps += countOps(entry);
+            if (entry.isCrudOpType()) {
+                precreate(entry.getNss(), entry.getUuid());
+            } else if (entry.getCommandType() == OplogEntry::CommandType::kCreate) {
+                createdNss.emplace(entry.getNss().db(), entry.getObject().firstElement().str());
+            } else if (entry.getCommandType() == OplogEntry::CommandType::kApplyOps) {
+                for (auto&& op : entry.getObject().firstElement().Obj()) {
+                    auto innerEntry = uassertStatusOK(
+                        ReplOperation::parse(IDLParserErrorContext("applyOps"), op.Obj()));
+                    precreate(innerEntry.getNss(), innerEntry.getUuid());
+                }
+            }
+        }
+        phaseTimes.start();
+        state.ResumeTiming();
+
+        fixture->apply(entries, &batchingMicros);
+
+        state.PauseTiming();
+        phaseTimes.stop();
+        state.ResumeTiming();
+    }
+
+    setCounters(state, numOps, batchingMicros, phaseTimes);
+}
+
+void syntheticOplogArgs(benchmark::internal::Benchmark* b) {
+    for (int workload = 0; workload <= static_cast<int>(Workload::kMixed); ++workload) {
+        for (int numWriterThreads : {1, 4, 16}) {
+            b->Args({workload, numWriterThreads});
+        }
+    }
+}
+
+BENCHMARK(BM_ApplySyntheticOplog)
+    ->ArgNames({"workload", "writers"})
+    ->Apply(syntheticOplogArgs)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_ApplyRecordedOplog)
+    ->ArgName("writers")
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -458,6 +458,123 @@ TEST_F(OplogApplierImplTest,
                                                      createOplogCollectionOptions()));
 }
 
+/**
+ * Applies a batch of CRUD ops on three collections whose names start with 'prefix', through the
+ * writer vectors or through the dependency graph, and returns the resulting contents of each
+ * collection sorted by _id. Some ops in the batch depend on earlier ops on the same document and
+ * the others are independent of each other.
+ */
+std::vector<std::vector<BSONObj>> applyMixedBatch(OperationContext* opCtx,
+                                                  ReplicationConsistencyMarkers* consistencyMarkers,
+                                                  StorageInterface* storageInterface,
+                                                  ThreadPool* writerPool,
+                                                  const std::string& prefix,
+                                                  bool useDependencyGraph) {
+    const std::vector<NamespaceString> nss = {NamespaceString("test." + prefix + "_a"),
+                                              NamespaceString("test." + prefix + "_b"),
+                                              NamespaceString("test." + prefix + "_c")};
+    for (const auto& collNss : nss) {
+        createCollectionWithUuid(opCtx, collNss);
+    }
+
+    static long long lastSecond = 1000;
+    auto nextOpTime = [] { return OpTime(Timestamp(Seconds(lastSecond++), 0), 1LL); };
+    auto insert = [&](size_t coll, BSONObj doc) {
+        return makeInsertDocumentOplogEntry(nextOpTime(), nss[coll], doc);
+    };
+    auto update = [&](size_t coll, int id, BSONObj set) {
+        return makeUpdateDocumentOplogEntry(
+            nextOpTime(), nss[coll], BSON("_id" << id), BSON("$set" << set));
+    };
+    auto remove = [&](size_t coll, int id) {
+        return makeDeleteDocumentOplogEntry(nextOpTime(), nss[coll], BSON("_id" << id));
+    };
+
+    std::vector<OplogEntry> ops;
+    for (int id = 0; id < 8; ++id) {
+        for (size_t coll = 0; coll < nss.size(); ++coll) {
+            ops.push_back(insert(coll, BSON("_id" << id << "x" << 0)));
+        }
+    }
+
+    // Chains of dependent ops on a few documents, interleaved with each other and with
+    // independent updates of every other document.
+    for (int round = 1; round <= 3; ++round) {
+        ops.push_back(update(0, 0, BSON("x" << round)));
+        ops.push_back(update(1, 1, BSON("x" << round * 10)));
+        for (int id = 2; id < 8; ++id) {
+            ops.push_back(update(2, id, BSON("round" << round)));
+        }
+    }
+    ops.push_back(remove(0, 3));
+    ops.push_back(insert(0, BSON("_id" << 3 << "x" << -1)));
+    ops.push_back(update(0, 3, BSON("x" << -2)));
+    ops.push_back(remove(1, 4));
+    ops.push_back(update(1, 5, BSON("x" << 5)));
+    ops.push_back(remove(1, 5));
+
+    const bool wasUsingDependencyGraph = oplogApplicationUsesDependencyGraph.load();
+    oplogApplicationUsesDependencyGraph.store(useDependencyGraph);
+    ON_BLOCK_EXIT([&] { oplogApplicationUsesDependencyGraph.store(wasUsingDependencyGraph); });
+
+    NoopOplogApplierObserver observer;
+    OplogApplierImpl oplogApplier(nullptr,  // executor
+                                  nullptr,  // oplogBuffer
+                                  &observer,
+                                  ReplicationCoordinator::get(opCtx),
+                                  consistencyMarkers,
+                                  storageInterface,
+                                  OplogApplier::Options(OplogApplication::Mode::kSecondary),
+                                  writerPool);
+    ASSERT_EQUALS(ops.back().getOpTime(),
+                  unittest::assertGet(oplogApplier.applyOplogBatch(opCtx, ops)));
+
+    std::vector<std::vector<BSONObj>> contents;
+    for (const auto& collNss : nss) {
+        std::vector<BSONObj> docs;
+        CollectionReader reader(opCtx, collNss);
+        for (auto doc = reader.next(); doc.isOK(); doc = reader.next()) {
+            docs.push_back(doc.getValue().getOwned());
+        }
+        std::sort(docs.begin(), docs.end(), [](const BSONObj& lhs, const BSONObj& rhs) {
+            return lhs["_id"].numberInt() < rhs["_id"].numberInt();
+        });
+        contents.push_back(std::move(docs));
+    }
+    return contents;
+}
+
+TEST_F(OplogApplierImplTest, MultiApplyWithDependencyGraphMatchesWriterVectors) {
+    auto writerPool = makeReplWriterPool();
+    auto hashed = applyMixedBatch(_opCtx.get(),
+                                  getConsistencyMarkers(),
+                                  getStorageInterface(),
+                                  writerPool.get(),
+                                  "hashed",
+                                  false /* useDependencyGraph */);
+    auto graph = applyMixedBatch(_opCtx.get(),
+                                 getConsistencyMarkers(),
+                                 getStorageInterface(),
+                                 writerPool.get(),
+                                 "graph",
+                                 true /* useDependencyGraph */);
+
+    // Dependent ops were applied in order on both paths.
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 0 << "x" << 3), graph[0][0]);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 3 << "x" << -2), graph[0][3]);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1 << "x" << 30), graph[1][1]);
+    ASSERT_EQUALS(6U, graph[1].size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 7 << "x" << 0 << "round" << 3), graph[2][7]);
+
+    ASSERT_EQUALS(hashed.size(), graph.size());
+    for (size_t coll = 0; coll < hashed.size(); ++coll) {
+        ASSERT_EQUALS(hashed[coll].size(), graph[coll].size());
+        for (size_t i = 0; i < hashed[coll].size(); ++i) {
+            ASSERT_BSONOBJ_EQ(hashed[coll][i], graph[coll][i]);
+        }
+    }
+}
+
 TEST_F(OplogApplierImplTest,
        OplogApplicationThreadFuncUsesApplyOplogEntryOrGroupedInsertsToApplyOperation) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
@@ -74,6 +74,27 @@ CachedCollectionProperties::getCollectionPropertiesImpl(OperationContext* opCtx,
     return collProperties;
 }
 
+namespace {
+/**
+ * Includes the _id of the document in the hash so we get parallelism even if all writes are to a
+ * single collection.
+ *
+ * For capped collections, this is illegal, since capped collections must preserve insertion order.
+ */
+void hashIdIfNotCapped(const OplogEntry& op,
+                       const CachedCollectionProperties::CollectionProperties& collProperties,
+                       uint32_t* hash) {
+    if (collProperties.isCapped) {
+        return;
+    }
+    BSONElement id = op.getIdElement();
+    BSONElementComparator elementHasher(BSONElementComparator::FieldNamesMode::kIgnore,
+                                        collProperties.collator);
+    const size_t idHash = elementHasher.hash(id);
+    MurmurHash3_x86_32(&idHash, sizeof(idHash), *hash, hash);
+}
+}  // namespace
+
 void OplogApplierUtils::processCrudOp(OperationContext* opCtx,
                                       OplogEntry* op,
                                       uint32_t* hash,
@@ -81,18 +102,7 @@ void OplogApplierUtils::processCrudOp(OperationContext* opCtx,
                                       CachedCollectionProperties* collPropertiesCache) {
     auto collProperties = collPropertiesCache->getCollectionProperties(opCtx, *hashedNs);
 
-    // Include the _id of the document in the hash so we get parallelism even if all writes are to a
-    // single collection.
-    //
-    // For capped collections, this is illegal, since capped collections must preserve
-    // insertion order.
-    if (!collProperties.isCapped) {
-        BSONElement id = op->getIdElement();
-        BSONElementComparator elementHasher(BSONElementComparator::FieldNamesMode::kIgnore,
-                                            collProperties.collator);
-        const size_t idHash = elementHasher.hash(id);
-        MurmurHash3_x86_32(&idHash, sizeof(idHash), *hash, hash);
-    }
+    hashIdIfNotCapped(*op, collProperties, hash);
 
     if (op->getOpType() == OpTypeEnum::kInsert && collProperties.isCapped) {
         // Mark capped collection ops before storing them to ensure we do not attempt to
@@ -101,6 +111,18 @@ void OplogApplierUtils::processCrudOp(OperationContext* opCtx,
     }
 }
 
+uint32_t OplogApplierUtils::getWriterHash(OperationContext* opCtx,
+                                          const OplogEntry& op,
+                                          CachedCollectionProperties* collPropertiesCache) {
+    auto hashedNs = StringMapHasher().hashed_key(op.getNss().ns());
+    uint32_t hash = static_cast<uint32_t>(hashedNs.hash());
+    if (op.isCrudOpType()) {
+        hashIdIfNotCapped(
+            op, collPropertiesCache->getCollectionProperties(opCtx, hashedNs), &hash);
+    }
+    return hash;
+}
+
 uint32_t OplogApplierUtils::addToWriterVector(
     OperationContext* opCtx,
     OplogEntry* op,
@@ -82,6 +82,14 @@ public:
                               StringMapHashedKey* hashedNs,
                               CachedCollectionProperties* collPropertiesCache);
 
+    /**
+     * Returns the hash used to pick a writer for 'op': the namespace, combined with the _id of the
+     * document for CRUD ops on non-capped collections. Ops which must be applied in order relative
+     * to each other always have the same hash.
+     */
+    static uint32_t getWriterHash(OperationContext* opCtx,
+                                  const OplogEntry& op,
+                                  CachedCollectionProperties* collPropertiesCache);
 
     /**
      * Adds a single oplog entry to the appropriate writer vector.  Returns the index of the
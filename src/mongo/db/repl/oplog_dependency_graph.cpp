@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_dependency_graph.h"
+
+#include <algorithm>
+
+namespace mongo {
+namespace repl {
+
+void OplogDependencyGraph::addIndependentOp(const OplogEntry* op) {
+    _addNode(op);
+}
+
+void OplogDependencyGraph::addKeyedOp(const OplogEntry* op, uint32_t key) {
+    auto node = _addNode(op);
+    auto [it, inserted] = _lastNodeForKey.try_emplace(key, node);
+    if (!inserted) {
+        _addEdge(it->second, node);
+        it->second = node;
+    }
+}
+
+void OplogDependencyGraph::addBarrierOp(const OplogEntry* op) {
+    NodeId node = _nodes.size();
+    _nodes.emplace_back(op);
+
+    // Every operation added since the last barrier already depends on that barrier, so depending
+    // on them is enough to be ordered after everything that came before.
+    if (!_nodesSinceLastBarrier.empty()) {
+        for (auto previous : _nodesSinceLastBarrier) {
+            _addEdge(previous, node);
+        }
+    } else if (_lastBarrier) {
+        _addEdge(*_lastBarrier, node);
+    }
+
+    _lastBarrier = node;
+    _nodesSinceLastBarrier.clear();
+    _lastNodeForKey.clear();
+}
+
+OplogDependencyGraph::NodeId OplogDependencyGraph::_addNode(const OplogEntry* op) {
+    NodeId node = _nodes.size();
+    _nodes.emplace_back(op);
+    if (_lastBarrier) {
+        _addEdge(*_lastBarrier, node);
+    }
+    _nodesSinceLastBarrier.push_back(node);
+    return node;
+}
+
+void OplogDependencyGraph::_addEdge(NodeId from, NodeId to) {
+    _nodes[from].dependents.push_back(to);
+    ++_nodes[to].numPending;
+}
+
+void OplogDependencyGraph::start(std::size_t numWorkers) {
+    invariant(numWorkers > 0);
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _numWorkers = numWorkers;
+    for (NodeId node = 0; node < _nodes.size(); ++node) {
+        if (_nodes[node].numPending == 0) {
+            _ready.push_back(node);
+        }
+    }
+}
+
+bool OplogDependencyGraph::getReadyOps(std::vector<NodeId>* nodes) {
+    nodes->clear();
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    _readyCV.wait(lk, [&] {
+        return _cancelled || !_ready.empty() || _numApplied == _nodes.size();
+    });
+    if (_cancelled || _ready.empty()) {
+        return false;
+    }
+
+    // Take a share of the ready operations rather than all of them, so that the other workers have
+    // something to do, but more than one at a time so that inserts can still be grouped.
+    auto count = std::max<std::size_t>(1, _ready.size() / _numWorkers);
+    nodes->assign(_ready.begin(), _ready.begin() + count);
+    _ready.erase(_ready.begin(), _ready.begin() + count);
+    return true;
+}
+
+void OplogDependencyGraph::markApplied(const std::vector<NodeId>& nodes) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (auto node : nodes) {
+        for (auto dependent : _nodes[node].dependents) {
+            if (--_nodes[dependent].numPending == 0) {
+                _ready.push_back(dependent);
+            }
+        }
+    }
+    _numApplied += nodes.size();
+    _readyCV.notify_all();
+}
+
+void OplogDependencyGraph::cancel() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _cancelled = true;
+    _readyCV.notify_all();
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Tracks the ordering constraints between the operations of an oplog application batch, and hands
+ * operations out to writer threads as soon as every operation they depend on has been applied.
+ *
+ * Operations are added in oplog order. An operation depends on:
+ *  - the previous operation added with the same conflict key, which is how CRUD ops on the same
+ *    document (or on the same capped collection) stay ordered;
+ *  - the previous barrier operation, if any.
+ * A barrier operation depends on every operation added before it, and is used for commands.
+ * Operations added without a key or barrier only depend on the previous barrier.
+ *
+ * Once built, the graph is applied by calling start() and then, from any number of worker threads,
+ * looping on getReadyOps() and markApplied().
+ */
+class OplogDependencyGraph {
+    OplogDependencyGraph(const OplogDependencyGraph&) = delete;
+    OplogDependencyGraph& operator=(const OplogDependencyGraph&) = delete;
+
+public:
+    using NodeId = std::size_t;
+
+    OplogDependencyGraph() = default;
+
+    /**
+     * Adds an operation which is only ordered with respect to barriers.
+     */
+    void addIndependentOp(const OplogEntry* op);
+
+    /**
+     * Adds an operation which must be applied after all previously added operations with the
+     * same 'key'.
+     */
+    void addKeyedOp(const OplogEntry* op, uint32_t key);
+
+    /**
+     * Adds an operation which must be applied after all previously added operations, and before
+     * all operations added after it.
+     */
+    void addBarrierOp(const OplogEntry* op);
+
+    std::size_t size() const {
+        return _nodes.size();
+    }
+
+    /**
+     * Makes the operations without dependencies available to getReadyOps(). Each call to
+     * getReadyOps() takes at most an even share of the ready operations among 'numWorkers'.
+     * Must be called once, after all operations have been added.
+     */
+    void start(std::size_t numWorkers);
+
+    /**
+     * Blocks until some operations are ready to be applied, and moves them into 'nodes'. The
+     * operations handed out together do not depend on each other, and may be applied in any order.
+     * Returns false once every operation has been applied, or the graph has been cancelled.
+     */
+    bool getReadyOps(std::vector<NodeId>* nodes);
+
+    /**
+     * Records that the operations in 'nodes' have been applied, making the operations that depend
+     * on them available to getReadyOps().
+     */
+    void markApplied(const std::vector<NodeId>& nodes);
+
+    /**
+     * Wakes up all threads waiting in getReadyOps() and makes future calls return false. Used when
+     * a worker fails, since the operations depending on its operations will never become ready.
+     */
+    void cancel();
+
+    const OplogEntry* getOp(NodeId node) const {
+        return _nodes[node].op;
+    }
+
+private:
+    struct Node {
+        explicit Node(const OplogEntry* op) : op(op) {}
+
+        const OplogEntry* op;
+
+        // Operations which may only be applied once this one has been.
+        std::vector<NodeId> dependents;
+
+        // Number of operations this one depends on which have not been applied yet.
+        std::size_t numPending = 0;
+    };
+
+    NodeId _addNode(const OplogEntry* op);
+    void _addEdge(NodeId from, NodeId to);
+
+    std::vector<Node> _nodes;
+
+    // The following are only used while the graph is built.
+    stdx::unordered_map<uint32_t, NodeId> _lastNodeForKey;
+    boost::optional<NodeId> _lastBarrier;
+    std::vector<NodeId> _nodesSinceLastBarrier;
+
+    // Protects the members below, and the 'numPending' fields of '_nodes' once start() has been
+    // called.
+    Mutex _mutex = MONGO_MAKE_LATCH("OplogDependencyGraph::_mutex");
+    stdx::condition_variable _readyCV;
+
+    std::deque<NodeId> _ready;
+    std::size_t _numWorkers = 1;
+    std::size_t _numApplied = 0;
+    bool _cancelled = false;
+};
+
+}  // namespace repl
+}  // namespace mongo
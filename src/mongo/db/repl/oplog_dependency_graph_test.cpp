@@ -0,0 +1,168 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_dependency_graph.h"
+#include "mongo/db/repl/oplog_entry_test_helpers.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+using NodeId = OplogDependencyGraph::NodeId;
+
+const NamespaceString nss("test.t");
+
+std::vector<OplogEntry> makeInserts(int count) {
+    std::vector<OplogEntry> ops;
+    for (int i = 0; i < count; ++i) {
+        ops.push_back(makeInsertDocumentOplogEntry(
+            OpTime(Timestamp(Seconds(1), i + 1), 1), nss, BSON("_id" << i)));
+    }
+    return ops;
+}
+
+std::vector<const OplogEntry*> getOps(const OplogDependencyGraph& graph,
+                                      const std::vector<NodeId>& nodes) {
+    std::vector<const OplogEntry*> ops;
+    for (auto node : nodes) {
+        ops.push_back(graph.getOp(node));
+    }
+    return ops;
+}
+
+TEST(OplogDependencyGraphTest, EmptyGraphHasNothingToApply) {
+    OplogDependencyGraph graph;
+    graph.start(4);
+
+    std::vector<NodeId> nodes;
+    ASSERT_FALSE(graph.getReadyOps(&nodes));
+    ASSERT(nodes.empty());
+}
+
+TEST(OplogDependencyGraphTest, OpsWithDifferentKeysAreReadyTogether) {
+    auto ops = makeInserts(3);
+    OplogDependencyGraph graph;
+    graph.addKeyedOp(&ops[0], 1);
+    graph.addKeyedOp(&ops[1], 2);
+    graph.addIndependentOp(&ops[2]);
+    graph.start(1);
+
+    std::vector<NodeId> nodes;
+    ASSERT_TRUE(graph.getReadyOps(&nodes));
+    ASSERT_EQ(3U, nodes.size());
+    graph.markApplied(nodes);
+    ASSERT_FALSE(graph.getReadyOps(&nodes));
+}
+
+TEST(OplogDependencyGraphTest, OpsWithTheSameKeyAreAppliedInOrder) {
+    auto ops = makeInserts(3);
+    OplogDependencyGraph graph;
+    graph.addKeyedOp(&ops[0], 1);
+    graph.addKeyedOp(&ops[1], 2);
+    graph.addKeyedOp(&ops[2], 1);
+    graph.start(1);
+
+    std::vector<NodeId> nodes;
+    ASSERT_TRUE(graph.getReadyOps(&nodes));
+    ASSERT(getOps(graph, nodes) == std::vector<const OplogEntry*>({&ops[0], &ops[1]}));
+    graph.markApplied(nodes);
+
+    ASSERT_TRUE(graph.getReadyOps(&nodes));
+    ASSERT(getOps(graph, nodes) == std::vector<const OplogEntry*>({&ops[2]}));
+    graph.markApplied(nodes);
+    ASSERT_FALSE(graph.getReadyOps(&nodes));
+}
+
+TEST(OplogDependencyGraphTest, BarrierIsOrderedAfterAndBeforeAllOtherOps) {
+    auto ops = makeInserts(5);
+    OplogDependencyGraph graph;
+    graph.addKeyedOp(&ops[0], 1);
+    graph.addIndependentOp(&ops[1]);
+    graph.addBarrierOp(&ops[2]);
+    graph.addKeyedOp(&ops[3], 2);
+    graph.addIndependentOp(&ops[4]);
+    graph.start(1);
+
+    std::vector<NodeId> nodes;
+    ASSERT_TRUE(graph.getReadyOps(&nodes));
+    ASSERT(getOps(graph, nodes) == std::vector<const OplogEntry*>({&ops[0], &ops[1]}));
+    graph.markApplied(nodes);
+
+    ASSERT_TRUE(graph.getReadyOps(&nodes));
+    ASSERT(getOps(graph, nodes) == std::vector<const OplogEntry*>({&ops[2]}));
+    graph.markApplied(nodes);
+
+    ASSERT_TRUE(graph.getReadyOps(&nodes));
+    ASSERT(getOps(graph, nodes) == std::vector<const OplogEntry*>({&ops[3], &ops[4]}));
+    graph.markApplied(nodes);
+    ASSERT_FALSE(graph.getReadyOps(&nodes));
+}
+
+TEST(OplogDependencyGraphTest, ReadyOpsAreSharedBetweenWorkers) {
+    auto ops = makeInserts(8);
+    OplogDependencyGraph graph;
+    for (auto&& op : ops) {
+        graph.addIndependentOp(&op);
+    }
+    graph.start(4);
+
+    std::vector<NodeId> nodes;
+    ASSERT_TRUE(graph.getReadyOps(&nodes));
+    ASSERT_EQ(2U, nodes.size());
+}
+
+TEST(OplogDependencyGraphTest, CancelWakesUpWaitingWorkers) {
+    auto ops = makeInserts(2);
+    OplogDependencyGraph graph;
+    graph.addKeyedOp(&ops[0], 1);
+    graph.addKeyedOp(&ops[1], 1);
+    graph.start(2);
+
+    std::vector<NodeId> first;
+    ASSERT_TRUE(graph.getReadyOps(&first));
+
+    // The second op depends on the first one, so this worker waits until the graph is cancelled.
+    bool gotOps = true;
+    stdx::thread waiter([&] {
+        std::vector<NodeId> nodes;
+        gotOps = graph.getReadyOps(&nodes);
+    });
+    graph.cancel();
+    waiter.join();
+    ASSERT_FALSE(gotOps);
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -32,6 +32,7 @@
 #include "mongo/db/repl/oplog_fetcher.h"
 
 #include "mongo/base/counter.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/matcher.h"
@@ -322,6 +323,8 @@ Milliseconds OplogFetcher::_getRetriedFindMaxTime() const {
 
 void OplogFetcher::_finishCallback(Status status) {
     invariant(isActive());
+    _stopPrefetching();
+
     // If the oplog fetcher is shutting down, consolidate return code to CallbackCanceled.
     if (_isShuttingDown() && status != ErrorCodes::CallbackCanceled) {
         status = Status(ErrorCodes::CallbackCanceled,
@@ -392,10 +395,13 @@ void OplogFetcher::_runQuery(const executor::TaskExecutor::CallbackArgs& callbac
             return;
         }
 
-        auto batchResult = _getNextBatch();
+        auto batchResult = _prefetchThread ? _getNextPrefetchedBatch() : _getNextBatch();
         if (!batchResult.isOK()) {
             auto brStatus = batchResult.getStatus();
 
+            // The prefetch thread, if any, has stopped after handing over the error.
+            _stopPrefetching();
+
             // Recreate a cursor if we have enough retries left.
             if (_oplogFetcherRestartDecision->shouldContinue(this, brStatus)) {
                 hangBeforeOplogFetcherRetries.pauseWhileSet();
@@ -421,14 +427,115 @@ void OplogFetcher::_runQuery(const executor::TaskExecutor::CallbackArgs& callbac
             return;
         }
 
-        if (_cursor->isDead()) {
+        if (batchResult.getValue().cursorDead) {
             // This means the sync source closes the tailable cursor with a returned cursorId of 0.
             // Any users of the oplog fetcher should create a new oplog fetcher if they see a
             // successful status and would like to continue fetching more oplog entries.
             _finishCallback(Status::OK());
             return;
         }
+
+        // Keep reading from the sync source while this thread hands batches to the buffer, so a
+        // slow enqueue does not leave the connection idle.
+        if (auto maxBatches = oplogFetcherPrefetchBatches.load();
+            maxBatches > 0 && !_prefetchThread) {
+            _startPrefetching(maxBatches);
+        }
+    }
+}
+
+void OplogFetcher::_startPrefetching(size_t maxBatches) {
+    invariant(!_prefetchThread);
+    invariant(!_firstBatch);
+
+    {
+        stdx::lock_guard<Latch> lk(_prefetchMutex);
+        _prefetchRunning = true;
+        _prefetchStopRequested = false;
+        _prefetchedBytes = 0;
+    }
+    _prefetchThread.emplace([this, maxBatches] { _prefetchLoop(maxBatches); });
+}
+
+void OplogFetcher::_prefetchLoop(size_t maxBatches) {
+    Client::initThread("OplogFetcherPrefetcher");
+
+    while (true) {
+        {
+            stdx::unique_lock<Latch> lk(_prefetchMutex);
+            // A single batch may exceed the byte limit, so one is always allowed.
+            _prefetchCV.wait(lk, [&] {
+                return _prefetchStopRequested || _prefetchedBatches.empty() ||
+                    (_prefetchedBatches.size() < maxBatches &&
+                     _prefetchedBytes < static_cast<size_t>(oplogFetcherPrefetchMaxBytes.load()));
+            });
+            if (_prefetchStopRequested) {
+                _prefetchRunning = false;
+                return;
+            }
+        }
+
+        auto batchResult = _getNextBatch();
+        bool last = !batchResult.isOK() || batchResult.getValue().cursorDead;
+
+        stdx::lock_guard<Latch> lk(_prefetchMutex);
+        _prefetchedBytes += _getBatchBytes(batchResult);
+        _prefetchedBatches.push_back(std::move(batchResult));
+        _prefetchCV.notify_all();
+        if (last) {
+            _prefetchRunning = false;
+            return;
+        }
+    }
+}
+
+StatusWith<OplogFetcher::FetchedBatch> OplogFetcher::_getNextPrefetchedBatch() {
+    stdx::unique_lock<Latch> lk(_prefetchMutex);
+    _prefetchCV.wait(lk, [&] { return !_prefetchedBatches.empty(); });
+
+    auto batchResult = std::move(_prefetchedBatches.front());
+    _prefetchedBatches.pop_front();
+    _prefetchedBytes -= _getBatchBytes(batchResult);
+    _prefetchCV.notify_all();
+    return batchResult;
+}
+
+size_t OplogFetcher::_getBatchBytes(const StatusWith<FetchedBatch>& batchResult) {
+    if (!batchResult.isOK()) {
+        return 0;
+    }
+    size_t bytes = 0;
+    for (const auto& doc : batchResult.getValue().documents) {
+        bytes += doc.objsize();
+    }
+    return bytes;
+}
+
+void OplogFetcher::_stopPrefetching() {
+    if (!_prefetchThread) {
+        return;
+    }
+
+    bool running;
+    {
+        stdx::lock_guard<Latch> lk(_prefetchMutex);
+        _prefetchStopRequested = true;
+        _prefetchCV.notify_all();
+        running = _prefetchRunning;
     }
+
+    if (running) {
+        // The thread may be waiting on the sync source. The cursor is being abandoned, so closing
+        // the connection is the quickest way to wake it.
+        _conn->shutdown();
+    }
+
+    _prefetchThread->join();
+    _prefetchThread.reset();
+
+    stdx::lock_guard<Latch> lk(_prefetchMutex);
+    _prefetchedBatches.clear();
+    _prefetchedBytes = 0;
 }
 
 Status OplogFetcher::_connect() {
@@ -558,8 +665,8 @@ void OplogFetcher::_createNewCursor(bool initialFind) {
     readersCreatedStats.increment();
 }
 
-StatusWith<OplogFetcher::Documents> OplogFetcher::_getNextBatch() {
-    Documents batch;
+StatusWith<OplogFetcher::FetchedBatch> OplogFetcher::_getNextBatch() {
+    FetchedBatch batch;
     try {
         Timer timer;
         // If it is the first batch, we should initialize the cursor, which will run the find query.
@@ -600,12 +707,17 @@ StatusWith<OplogFetcher::Documents> OplogFetcher::_getNextBatch() {
         }
 
         while (_cursor->moreInCurrentBatch()) {
-            batch.emplace_back(_cursor->nextSafe());
+            batch.documents.emplace_back(_cursor->nextSafe());
         }
 
         // This value is only used on a successful batch for metrics.repl.network.getmores. This
         // metric intentionally tracks the time taken by the initial find as well.
-        _lastBatchElapsedMS = timer.millis();
+        batch.elapsedMS = timer.millis();
+
+        batch.firstBatch = std::exchange(_firstBatch, false);
+        batch.metadataObj = _metadataObj;
+        batch.postBatchResumeToken = _cursor->getPostBatchResumeToken();
+        batch.cursorDead = _cursor->isDead();
     } catch (const DBException& ex) {
         if (_cursor->connectionHasPendingReplies()) {
             // Close the connection because the connection cannot be used anymore as more data is on
@@ -619,9 +731,11 @@ StatusWith<OplogFetcher::Documents> OplogFetcher::_getNextBatch() {
     return batch;
 }
 
-Status OplogFetcher::_onSuccessfulBatch(const Documents& documents) {
+Status OplogFetcher::_onSuccessfulBatch(const FetchedBatch& batch) {
     hangBeforeProcessingSuccessfulBatch.pauseWhileSet();
 
+    const auto& documents = batch.documents;
+
     if (_isShuttingDown()) {
         return Status(ErrorCodes::CallbackCanceled, "oplog fetcher shutting down");
     }
@@ -679,7 +793,7 @@ Status OplogFetcher::_onSuccessfulBatch(const Documents& documents) {
         LOGV2_DEBUG(21271, 2, "Oplog fetcher read 0 operations from remote oplog");
     }
 
-    auto oqMetadataResult = rpc::OplogQueryMetadata::readFromMetadata(_metadataObj);
+    auto oqMetadataResult = rpc::OplogQueryMetadata::readFromMetadata(batch.metadataObj);
     if (!oqMetadataResult.isOK()) {
         LOGV2_ERROR(21278,
                     "invalid oplog query metadata from sync source {syncSource}: "
@@ -687,12 +801,12 @@ Status OplogFetcher::_onSuccessfulBatch(const Documents& documents) {
                     "Invalid oplog query metadata from sync source",
                     "syncSource"_attr = _source,
                     "error"_attr = oqMetadataResult.getStatus(),
-                    "metadata"_attr = _metadataObj);
+                    "metadata"_attr = batch.metadataObj);
         return oqMetadataResult.getStatus();
     }
     auto oqMetadata = oqMetadataResult.getValue();
 
-    if (_firstBatch) {
+    if (batch.firstBatch) {
         auto status =
             _checkRemoteOplogStart(documents, oqMetadata.getLastOpApplied(), oqMetadata.getRBID());
         if (!status.isOK()) {
@@ -725,7 +839,7 @@ Status OplogFetcher::_onSuccessfulBatch(const Documents& documents) {
     auto previousOpTimeFetched = _getLastOpTimeFetched();
 
     auto validateResult = OplogFetcher::validateDocuments(
-        documents, _firstBatch, previousOpTimeFetched.getTimestamp(), _startingPoint);
+        documents, batch.firstBatch, previousOpTimeFetched.getTimestamp(), _startingPoint);
     if (!validateResult.isOK()) {
         return validateResult.getStatus();
     }
@@ -736,7 +850,7 @@ Status OplogFetcher::_onSuccessfulBatch(const Documents& documents) {
     // Process replset metadata.  It is important that this happen after we've validated the
     // first batch, so we don't progress our knowledge of the commit point from a
     // response that triggers a rollback.
-    auto metadataResult = rpc::ReplSetMetadata::readFromMetadata(_metadataObj);
+    auto metadataResult = rpc::ReplSetMetadata::readFromMetadata(batch.metadataObj);
     if (!metadataResult.isOK()) {
         LOGV2_ERROR(21279,
                     "invalid replication metadata from sync source {syncSource}: "
@@ -744,7 +858,7 @@ Status OplogFetcher::_onSuccessfulBatch(const Documents& documents) {
                     "Invalid replication metadata from sync source",
                     "syncSource"_attr = _source,
                     "error"_attr = metadataResult.getStatus(),
-                    "metadata"_attr = _metadataObj);
+                    "metadata"_attr = batch.metadataObj);
         return metadataResult.getStatus();
     }
     auto replSetMetadata = metadataResult.getValue();
@@ -772,12 +886,12 @@ Status OplogFetcher::_onSuccessfulBatch(const Documents& documents) {
     opsReadStats.increment(info.networkDocumentCount);
     networkByteStats.increment(info.networkDocumentBytes);
 
-    oplogBatchStats.recordMillis(_lastBatchElapsedMS, documents.empty());
+    oplogBatchStats.recordMillis(batch.elapsedMS, documents.empty());
 
-    if (_cursor->getPostBatchResumeToken()) {
+    if (batch.postBatchResumeToken) {
         auto pbrt = ResumeTokenOplogTimestamp::parse(
             IDLParserErrorContext("OplogFetcher PostBatchResumeToken"),
-            *_cursor->getPostBatchResumeToken());
+            *batch.postBatchResumeToken);
         info.resumeToken = pbrt.getTs();
     }
 
@@ -811,7 +925,6 @@ Status OplogFetcher::_onSuccessfulBatch(const Documents& documents) {
         _lastFetched = lastDocOpTime;
     }
 
-    _firstBatch = false;
     return Status::OK();
 }
 
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <cstddef>
+#include <deque>
 #include <functional>
 
 #include "mongo/base/status_with.h"
@@ -42,6 +43,8 @@
 #include "mongo/db/repl/data_replicator_external_state.h"
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_process.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/fail_point.h"
 
 namespace mongo {
@@ -318,6 +321,19 @@ private:
      */
     BSONObj _makeFindQuery(long long findTimeout) const;
 
+    /**
+     * A batch read from the sync source, along with the state of the cursor right after reading it.
+     * Capturing this lets a batch be processed while the cursor already reads the next one.
+     */
+    struct FetchedBatch {
+        Documents documents;
+        bool firstBatch = false;
+        BSONObj metadataObj;
+        int elapsedMS = 0;
+        boost::optional<BSONObj> postBatchResumeToken;
+        bool cursorDead = false;
+    };
+
     /**
      * Gets the next batch from the exhaust cursor.
      *
@@ -325,7 +341,7 @@ private:
      * shouldContinue function to see if it should create a new cursor and if so, calls
      * _createNewCursor.
      */
-    StatusWith<Documents> _getNextBatch();
+    StatusWith<FetchedBatch> _getNextBatch();
 
     /**
      * Function called by the oplog fetcher when it gets a successful batch from the sync source.
@@ -333,7 +349,37 @@ private:
      *
      * On failure returns a status that will be passed to _finishCallback.
      */
-    Status _onSuccessfulBatch(const Documents& documents);
+    Status _onSuccessfulBatch(const FetchedBatch& batch);
+
+    /**
+     * Starts a thread that reads up to 'maxBatches' batches, and no more than
+     * oplogFetcherPrefetchMaxBytes, from the current cursor ahead of _runQuery processing them.
+     * Must only be called once the first batch has been processed, since processing the first
+     * batch may use the connection.
+     */
+    void _startPrefetching(size_t maxBatches);
+
+    /**
+     * Body of the prefetch thread. Stops after handing over an error or the cursor's last batch.
+     */
+    void _prefetchLoop(size_t maxBatches);
+
+    /**
+     * Waits for the prefetch thread to hand over its next batch.
+     */
+    StatusWith<FetchedBatch> _getNextPrefetchedBatch();
+
+    /**
+     * Returns the size of the documents in 'batchResult', which counts against
+     * oplogFetcherPrefetchMaxBytes while the batch waits to be processed.
+     */
+    static size_t _getBatchBytes(const StatusWith<FetchedBatch>& batchResult);
+
+    /**
+     * Stops and joins the prefetch thread, if any, and drops the batches it read ahead. If the
+     * thread is still reading, its connection is shut down to interrupt it.
+     */
+    void _stopPrefetching();
 
     /**
      * Notifies caller that the oplog fetcher has completed processing operations from the remote
@@ -455,7 +501,17 @@ private:
     // Handle to currently scheduled _runQuery task.
     executor::TaskExecutor::CallbackHandle _runQueryHandle;
 
-    int _lastBatchElapsedMS = 0;
+    // Reads batches ahead of processing when oplogFetcherPrefetchBatches is nonzero. Only
+    // _runQuery's thread starts and stops it.
+    boost::optional<stdx::thread> _prefetchThread;
+
+    // Protects the prefetch state below.
+    Mutex _prefetchMutex = MONGO_MAKE_LATCH("OplogFetcher::_prefetchMutex");
+    stdx::condition_variable _prefetchCV;
+    std::deque<StatusWith<FetchedBatch>> _prefetchedBatches;
+    size_t _prefetchedBytes = 0;
+    bool _prefetchRunning = false;
+    bool _prefetchStopRequested = false;
 };
 
 class OplogFetcherFactory {
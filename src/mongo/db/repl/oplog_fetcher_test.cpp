@@ -38,9 +38,11 @@
 #include "mongo/db/vector_clock.h"
 #include "mongo/dbtests/mock/mock_dbclient_connection.h"
 #include "mongo/executor/thread_pool_task_executor_test_fixture.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/rpc/metadata.h"
 #include "mongo/rpc/metadata/oplog_query_metadata.h"
 #include "mongo/rpc/metadata/repl_set_metadata.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/task_executor_proxy.h"
 #include "mongo/unittest/unittest.h"
@@ -2452,4 +2454,245 @@ TEST_F(OplogFetcherTest, CheckFindCommandIncludesRequestResumeTokenWhenRequested
     oplogFetcher->join();
 }
 
+class OplogFetcherPrefetchTest : public OplogFetcherTest {
+protected:
+    void setUp() override;
+    void tearDown() override;
+
+    /**
+     * Waits until the oplog fetcher has enqueued 'numBatches' batches.
+     */
+    void waitForEnqueuedBatches(size_t numBatches);
+
+    void validateEnqueuedBatch(size_t index, bool skipFirstDoc, OplogFetcher::Documents docs);
+
+    Mutex _enqueuedMutex = MONGO_MAKE_LATCH("OplogFetcherPrefetchTest::_enqueuedMutex");
+    stdx::condition_variable _enqueuedCV;
+    std::vector<OplogFetcher::Documents> _enqueuedBatches;
+
+    int _originalPrefetchBatches = 0;
+};
+
+void OplogFetcherPrefetchTest::setUp() {
+    OplogFetcherTest::setUp();
+
+    _originalPrefetchBatches = oplogFetcherPrefetchBatches.load();
+    oplogFetcherPrefetchBatches.store(2);
+
+    // Batches are enqueued on the oplog fetcher's thread while the prefetch thread is already
+    // reading the next one, so record every batch rather than only the last.
+    enqueueDocumentsFn = [this](OplogFetcher::Documents::const_iterator begin,
+                                OplogFetcher::Documents::const_iterator end,
+                                const OplogFetcher::DocumentsInfo& info) -> Status {
+        stdx::lock_guard<Latch> lk(_enqueuedMutex);
+        _enqueuedBatches.emplace_back(begin, end);
+        _enqueuedCV.notify_all();
+        return Status::OK();
+    };
+}
+
+void OplogFetcherPrefetchTest::tearDown() {
+    oplogFetcherPrefetchBatches.store(_originalPrefetchBatches);
+    OplogFetcherTest::tearDown();
+}
+
+void OplogFetcherPrefetchTest::waitForEnqueuedBatches(size_t numBatches) {
+    stdx::unique_lock<Latch> lk(_enqueuedMutex);
+    _enqueuedCV.wait(lk, [&] { return _enqueuedBatches.size() >= numBatches; });
+}
+
+void OplogFetcherPrefetchTest::validateEnqueuedBatch(size_t index,
+                                                     bool skipFirstDoc,
+                                                     OplogFetcher::Documents docs) {
+    stdx::lock_guard<Latch> lk(_enqueuedMutex);
+    ASSERT_LT(index, _enqueuedBatches.size());
+    const auto& enqueued = _enqueuedBatches[index];
+
+    auto docs_iter = docs.begin();
+    if (skipFirstDoc) {
+        docs_iter++;
+    }
+    ASSERT_EQ(static_cast<size_t>(docs.end() - docs_iter), enqueued.size());
+
+    auto enqueue_iter = enqueued.begin();
+    while (docs_iter != docs.end()) {
+        ASSERT_BSONOBJ_EQ(*docs_iter++, *enqueue_iter++);
+    }
+}
+
+TEST_F(OplogFetcherPrefetchTest, PrefetchedBatchesAreEnqueuedInOrder) {
+    ShutdownState shutdownState;
+
+    auto oplogFetcher = getOplogFetcherAfterConnectionCreated(std::ref(shutdownState));
+    auto conn = oplogFetcher->getDBClientConnection_forTest();
+
+    CursorId cursorId = 22LL;
+    auto metadataObj = makeOplogBatchMetadata(replSetMetadata, oqMetadata);
+    OplogFetcher::Documents firstBatch = {
+        makeNoopOplogEntry(lastFetched),
+        makeNoopOplogEntry({{Seconds(456), 0}, lastFetched.getTerm()})};
+    OplogFetcher::Documents secondBatch = {
+        makeNoopOplogEntry({{Seconds(457), 0}, lastFetched.getTerm()}),
+        makeNoopOplogEntry({{Seconds(458), 0}, lastFetched.getTerm()})};
+    OplogFetcher::Documents thirdBatch = {
+        makeNoopOplogEntry({{Seconds(459), 0}, lastFetched.getTerm()})};
+    OplogFetcher::Documents fourthBatch = {
+        makeNoopOplogEntry({{Seconds(460), 0}, lastFetched.getTerm()}),
+        makeNoopOplogEntry({{Seconds(461), 0}, lastFetched.getTerm()})};
+
+    // The first batch is read by the oplog fetcher itself. After processing it, the oplog fetcher
+    // starts the prefetch thread, which blocks on call() for the getMore command.
+    processSingleRequestResponse(conn, makeFirstBatch(cursorId, firstBatch, metadataObj), true);
+    waitForEnqueuedBatches(1);
+
+    // Hold the oplog fetcher while it processes the second batch.
+    auto hangFailPoint = globalFailPointRegistry().find("hangBeforeProcessingSuccessfulBatch");
+    auto timesEntered = hangFailPoint->setMode(FailPoint::alwaysOn);
+
+    auto m = processSingleRequestResponse(
+        conn, makeSubsequentBatch(cursorId, secondBatch, metadataObj, true /* moreToCome */), true);
+    validateGetMoreCommand(m,
+                           cursorId,
+                           durationCount<Milliseconds>(oplogFetcher->getAwaitDataTimeout_forTest()),
+                           dataReplicatorExternalState->getCurrentTermAndLastCommittedOpTime());
+    hangFailPoint->waitForTimesEntered(timesEntered + 1);
+
+    // The prefetch thread keeps reading while the second batch is held. After this, it is blocked
+    // on recv() for the fourth batch.
+    processSingleExhaustResponse(
+        conn, makeSubsequentBatch(cursorId, thirdBatch, metadataObj, true /* moreToCome */), true);
+    {
+        stdx::lock_guard<Latch> lk(_enqueuedMutex);
+        ASSERT_EQ(1U, _enqueuedBatches.size());
+    }
+
+    hangFailPoint->setMode(FailPoint::off);
+    waitForEnqueuedBatches(3);
+
+    processSingleExhaustResponse(
+        conn,
+        makeSubsequentBatch(cursorId, fourthBatch, metadataObj, false /* moreToCome */),
+        true);
+    waitForEnqueuedBatches(4);
+
+    validateEnqueuedBatch(0, true /* skipFirstDoc */, firstBatch);
+    validateEnqueuedBatch(1, false /* skipFirstDoc */, secondBatch);
+    validateEnqueuedBatch(2, false /* skipFirstDoc */, thirdBatch);
+    validateEnqueuedBatch(3, false /* skipFirstDoc */, fourthBatch);
+    ASSERT_EQUALS(fourthBatch.back()["ts"].timestamp(),
+                  oplogFetcher->getLastOpTimeFetched_forTest().getTimestamp());
+
+    oplogFetcher->shutdown();
+    oplogFetcher->join();
+
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, shutdownState.getStatus());
+}
+
+TEST_F(OplogFetcherPrefetchTest, PrefetchErrorShutsDownOplogFetcherWithoutRetries) {
+    ShutdownState shutdownState;
+
+    // Create an oplog fetcher without any retries.
+    auto oplogFetcher = getOplogFetcherAfterConnectionCreated(std::ref(shutdownState));
+    auto conn = oplogFetcher->getDBClientConnection_forTest();
+
+    CursorId cursorId = 22LL;
+    auto metadataObj = makeOplogBatchMetadata(replSetMetadata, oqMetadata);
+    OplogFetcher::Documents firstBatch = {
+        makeNoopOplogEntry(lastFetched),
+        makeNoopOplogEntry({{Seconds(456), 0}, lastFetched.getTerm()})};
+
+    processSingleRequestResponse(conn, makeFirstBatch(cursorId, firstBatch, metadataObj), true);
+    waitForEnqueuedBatches(1);
+
+    // The prefetch thread fails to get the next batch and hands the error to the oplog fetcher.
+    processSingleRequestResponse(
+        conn, mongo::Status{mongo::ErrorCodes::NetworkTimeout, "Fake socket timeout"});
+
+    oplogFetcher->join();
+
+    ASSERT_EQUALS(ErrorCodes::NetworkTimeout, shutdownState.getStatus());
+    validateEnqueuedBatch(0, true /* skipFirstDoc */, firstBatch);
+    stdx::lock_guard<Latch> lk(_enqueuedMutex);
+    ASSERT_EQ(1U, _enqueuedBatches.size());
+}
+
+TEST_F(OplogFetcherPrefetchTest, PrefetchRestartsAfterCursorIsRecreated) {
+    ShutdownState shutdownState;
+
+    // Create an oplog fetcher with one retry.
+    auto oplogFetcher = getOplogFetcherAfterConnectionCreated(std::ref(shutdownState), 1);
+    auto conn = oplogFetcher->getDBClientConnection_forTest();
+
+    CursorId cursorId = 22LL;
+    auto metadataObj = makeOplogBatchMetadata(replSetMetadata, oqMetadata);
+    OplogFetcher::Documents firstBatch = {
+        makeNoopOplogEntry(lastFetched),
+        makeNoopOplogEntry({{Seconds(456), 0}, lastFetched.getTerm()})};
+
+    processSingleRequestResponse(conn, makeFirstBatch(cursorId, firstBatch, metadataObj), true);
+    waitForEnqueuedBatches(1);
+    lastFetched = oplogFetcher->getLastOpTimeFetched_forTest();
+
+    // The prefetch thread fails to get the next batch. The oplog fetcher stops it and recreates
+    // the cursor on its own thread.
+    processSingleRequestResponse(
+        conn, mongo::Status{mongo::ErrorCodes::NetworkTimeout, "Fake socket timeout"}, true);
+
+    cursorId = 23LL;
+    OplogFetcher::Documents secondBatch = {
+        firstBatch.back(), makeNoopOplogEntry({{Seconds(457), 0}, lastFetched.getTerm()})};
+
+    auto m = processSingleRequestResponse(
+        conn, makeFirstBatch(cursorId, secondBatch, metadataObj), true);
+    validateFindCommand(
+        m, lastFetched, durationCount<Milliseconds>(oplogFetcher->getRetriedFindMaxTime_forTest()));
+    waitForEnqueuedBatches(2);
+
+    // Prefetching resumes on the new cursor.
+    OplogFetcher::Documents thirdBatch = {
+        makeNoopOplogEntry({{Seconds(458), 0}, lastFetched.getTerm()})};
+    m = processSingleRequestResponse(
+        conn, makeSubsequentBatch(cursorId, thirdBatch, metadataObj, false /* moreToCome */), true);
+    validateGetMoreCommand(m,
+                           cursorId,
+                           durationCount<Milliseconds>(oplogFetcher->getAwaitDataTimeout_forTest()),
+                           dataReplicatorExternalState->getCurrentTermAndLastCommittedOpTime());
+    waitForEnqueuedBatches(3);
+
+    validateEnqueuedBatch(1, true /* skipFirstDoc */, secondBatch);
+    validateEnqueuedBatch(2, false /* skipFirstDoc */, thirdBatch);
+
+    oplogFetcher->shutdown();
+    oplogFetcher->join();
+
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, shutdownState.getStatus());
+}
+
+TEST_F(OplogFetcherPrefetchTest, ShutdownWhilePrefetchIsBlockedOnNetwork) {
+    ShutdownState shutdownState;
+
+    auto oplogFetcher = getOplogFetcherAfterConnectionCreated(std::ref(shutdownState), 1);
+    auto conn = oplogFetcher->getDBClientConnection_forTest();
+
+    CursorId cursorId = 22LL;
+    auto metadataObj = makeOplogBatchMetadata(replSetMetadata, oqMetadata);
+    OplogFetcher::Documents firstBatch = {
+        makeNoopOplogEntry(lastFetched),
+        makeNoopOplogEntry({{Seconds(456), 0}, lastFetched.getTerm()})};
+
+    // After this, the prefetch thread is blocked on call() for the getMore command while the oplog
+    // fetcher waits for it to hand over a batch.
+    processSingleRequestResponse(conn, makeFirstBatch(cursorId, firstBatch, metadataObj), true);
+    waitForEnqueuedBatches(1);
+
+    // Shutting down closes the connection, which fails the blocked read. The oplog fetcher reports
+    // the shutdown rather than retrying, even though it has a restart left.
+    oplogFetcher->shutdown();
+    oplogFetcher->join();
+
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, shutdownState.getStatus());
+    stdx::lock_guard<Latch> lk(_enqueuedMutex);
+    ASSERT_EQ(1U, _enqueuedBatches.size());
+}
+
 }  // namespace
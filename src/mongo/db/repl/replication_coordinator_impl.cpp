@@ -202,62 +202,6 @@ constexpr StringData kQuiesceModeShutdownMessage =
 
 }  // namespace
 
-void ReplicationCoordinatorImpl::WaiterList::add_inlock(const OpTime& opTime,
-                                                        SharedWaiterHandle waiter) {
-    _waiters.emplace(opTime, std::move(waiter));
-}
-
-SharedSemiFuture<void> ReplicationCoordinatorImpl::WaiterList::add_inlock(
-    const OpTime& opTime, boost::optional<WriteConcernOptions> wc) {
-    auto pf = makePromiseFuture<void>();
-    _waiters.emplace(opTime, std::make_shared<Waiter>(std::move(pf.promise), std::move(wc)));
-    return std::move(pf.future);
-}
-
-bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(SharedWaiterHandle waiter) {
-    for (auto iter = _waiters.begin(); iter != _waiters.end(); iter++) {
-        if (iter->second == waiter) {
-            _waiters.erase(iter);
-            return true;
-        }
-    }
-    return false;
-}
-
-template <typename Func>
-void ReplicationCoordinatorImpl::WaiterList::setValueIf_inlock(Func&& func,
-                                                               boost::optional<OpTime> opTime) {
-    for (auto it = _waiters.begin(); it != _waiters.end() && (!opTime || it->first <= *opTime);) {
-        const auto& waiter = it->second;
-        try {
-            if (func(it->first, waiter)) {
-                waiter->promise.emplaceValue();
-                it = _waiters.erase(it);
-            } else {
-                ++it;
-            }
-        } catch (const DBException& e) {
-            waiter->promise.setError(e.toStatus());
-            it = _waiters.erase(it);
-        }
-    }
-}
-
-void ReplicationCoordinatorImpl::WaiterList::setValueAll_inlock() {
-    for (auto& [opTime, waiter] : _waiters) {
-        waiter->promise.emplaceValue();
-    }
-    _waiters.clear();
-}
-
-void ReplicationCoordinatorImpl::WaiterList::setErrorAll_inlock(Status status) {
-    invariant(!status.isOK());
-    for (auto& [opTime, waiter] : _waiters) {
-        waiter->promise.setError(status);
-    }
-    _waiters.clear();
-}
-
 namespace {
 ReplicationCoordinator::Mode getReplicationModeFromSettings(const ReplSettings& settings) {
     if (settings.usingReplSets()) {
@@ -1308,8 +1252,13 @@ void ReplicationCoordinatorImpl::setMyLastDurableOpTimeAndWallTimeForward(
     }
 
     if (opTimeAndWallTime.opTime > _getMyLastDurableOpTime_inlock()) {
+        // Fulfill the promises of the {j: true} and majority waiters this wakes up once _mutex has
+        // been released.
+        WaiterList::DeferredSignals deferredSignals(lock, &_replicationWaiterList);
         _setMyLastDurableOpTimeAndWallTime(lock, opTimeAndWallTime, false);
+        auto readyWaiters = deferredSignals.release(lock);
         _reportUpstream_inlock(std::move(lock));
+        WaiterList::signal(std::move(readyWaiters));
     }
 }
 
@@ -4566,6 +4515,9 @@ void ReplicationCoordinatorImpl::_wakeReadyWaiters(WithLock lk, boost::optional<
 
 Status ReplicationCoordinatorImpl::processReplSetUpdatePosition(const UpdatePositionArgs& updates) {
     stdx::unique_lock<Latch> lock(_mutex);
+    // Advancing the commit point can satisfy every majority write waiting on it at once, so their
+    // promises are fulfilled in one pass once _mutex has been released.
+    WaiterList::DeferredSignals deferredSignals(lock, &_replicationWaiterList);
     Status status = Status::OK();
     bool somethingChanged = false;
     for (UpdatePositionArgs::UpdateIterator update = updates.updatesBegin();
@@ -4578,8 +4530,12 @@ Status ReplicationCoordinatorImpl::processReplSetUpdatePosition(const UpdatePosi
         somethingChanged = true;
     }
 
-    if (somethingChanged && !_getMemberState_inlock().primary()) {
-        lock.unlock();
+    const bool shouldForwardProgress = somethingChanged && !_getMemberState_inlock().primary();
+    auto readyWaiters = deferredSignals.release(lock);
+    lock.unlock();
+
+    WaiterList::signal(std::move(readyWaiters));
+    if (shouldForwardProgress) {
         // Must do this outside _mutex
         _externalState->forwardSlaveProgress();
     }
@@ -63,6 +63,7 @@ namespace {
 
 const auto kRecoveryBatchLogLevel = logv2::LogSeverity::Debug(2);
 const auto kRecoveryOperationLogLevel = logv2::LogSeverity::Debug(3);
+const auto kRecoveryProgressLogIntervalSecs = 10;
 
 /**
  * Tracks and logs operations applied during recovery.
@@ -83,6 +84,16 @@ public:
                            "lastOpTime"_attr = batch.back().getOpTime(),
                            "numOpsApplied"_attr = _numOpsApplied);
 
+        if (_progressTimer.seconds() >= kRecoveryProgressLogIntervalSecs) {
+            LOGV2(4972510,
+                  "Replication recovery oplog application progress",
+                  "numOpsApplied"_attr = _numOpsApplied,
+                  "numBatches"_attr = _numBatches,
+                  "nextOpTime"_attr = batch.front().getOpTime(),
+                  "durationMillis"_attr = _timer.millis());
+            _progressTimer.reset();
+        }
+
         _numOpsApplied += batch.size();
         if (shouldLog(::mongo::logv2::LogComponent::kStorageRecovery, kRecoveryOperationLogLevel)) {
             std::size_t i = 0;
@@ -111,12 +122,15 @@ public:
               "Completed oplog application for recovery",
               "numOpsApplied"_attr = _numOpsApplied,
               "numBatches"_attr = _numBatches,
-              "applyThroughOpTime"_attr = applyThroughOpTime);
+              "applyThroughOpTime"_attr = applyThroughOpTime,
+              "durationMillis"_attr = _timer.millis());
     }
 
 private:
     std::size_t _numBatches = 0;
     std::size_t _numOpsApplied = 0;
+    Timer _timer;
+    Timer _progressTimer;
 };
 
 /**
@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/replication_waiter_list.h"
+
+namespace mongo {
+namespace repl {
+
+ReplicationWaiterList::DeferredSignals::DeferredSignals(WithLock, ReplicationWaiterList* list)
+    : _list(list) {
+    invariant(!_list->_deferred);
+    _list->_deferred.emplace();
+}
+
+ReplicationWaiterList::DeferredSignals::~DeferredSignals() {
+    if (_list) {
+        signal(std::exchange(_list->_deferred, boost::none).value());
+    }
+}
+
+ReplicationWaiterList::ReadyWaiters ReplicationWaiterList::DeferredSignals::release(WithLock) {
+    invariant(_list);
+    return std::exchange(std::exchange(_list, nullptr)->_deferred, boost::none).value();
+}
+
+void ReplicationWaiterList::add_inlock(const OpTime& opTime, SharedWaiterHandle waiter) {
+    _waiters.emplace(opTime, std::move(waiter));
+}
+
+SharedSemiFuture<void> ReplicationWaiterList::add_inlock(const OpTime& opTime,
+                                                         boost::optional<WriteConcernOptions> wc) {
+    auto pf = makePromiseFuture<void>();
+    _waiters.emplace(opTime, std::make_shared<Waiter>(std::move(pf.promise), std::move(wc)));
+    return std::move(pf.future);
+}
+
+bool ReplicationWaiterList::remove_inlock(SharedWaiterHandle waiter) {
+    for (auto iter = _waiters.begin(); iter != _waiters.end(); iter++) {
+        if (iter->second == waiter) {
+            _waiters.erase(iter);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReplicationWaiterList::setValueAll_inlock() {
+    for (auto& [opTime, waiter] : _waiters) {
+        _signal_inlock(std::move(waiter), Status::OK());
+    }
+    _waiters.clear();
+}
+
+void ReplicationWaiterList::setErrorAll_inlock(Status status) {
+    invariant(!status.isOK());
+    for (auto& [opTime, waiter] : _waiters) {
+        _signal_inlock(std::move(waiter), status);
+    }
+    _waiters.clear();
+}
+
+void ReplicationWaiterList::signal(ReadyWaiters waiters) {
+    for (auto& [waiter, status] : waiters) {
+        if (status.isOK()) {
+            waiter->promise.emplaceValue();
+        } else {
+            waiter->promise.setError(std::move(status));
+        }
+    }
+}
+
+void ReplicationWaiterList::_signal_inlock(SharedWaiterHandle waiter, Status status) {
+    if (_deferred) {
+        _deferred->emplace_back(std::move(waiter), std::move(status));
+        return;
+    }
+
+    if (status.isOK()) {
+        waiter->promise.emplaceValue();
+    } else {
+        waiter->promise.setError(std::move(status));
+    }
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/db/write_concern_options.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/future.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Waiters for the replication system to reach some OpTime, such as replication waiters for a write
+ * concern or read concern waiters for the node's own lastApplied, sorted by OpTime. Every method
+ * except signal() must be called while holding the mutex of the owner, which guards the list.
+ *
+ * Fulfilling a waiter's promise wakes up the waiting thread, or runs its continuation inline, so
+ * doing it for a large number of waiters while holding the owner's mutex makes the critical
+ * section proportionally longer. While a DeferredSignals guard is in scope, the waiters that are
+ * woken up are only removed from the list, and the owner fulfills all their promises in one pass
+ * once it has released its mutex.
+ */
+class ReplicationWaiterList {
+public:
+    struct Waiter {
+        Promise<void> promise;
+        boost::optional<WriteConcernOptions> writeConcern;
+        explicit Waiter(Promise<void> p, boost::optional<WriteConcernOptions> w = boost::none)
+            : promise(std::move(p)), writeConcern(w) {}
+    };
+
+    using SharedWaiterHandle = std::shared_ptr<Waiter>;
+
+    // Waiters which have been removed from the list but whose promises have not been fulfilled
+    // yet, along with the status to fulfill them with.
+    using ReadyWaiters = std::vector<std::pair<SharedWaiterHandle, Status>>;
+
+    /**
+     * Defers fulfilling the promises of the waiters woken up while it is in scope. Guards may not
+     * be nested for the same list.
+     */
+    class DeferredSignals {
+        DeferredSignals(const DeferredSignals&) = delete;
+        DeferredSignals& operator=(const DeferredSignals&) = delete;
+
+    public:
+        DeferredSignals(WithLock, ReplicationWaiterList* list);
+
+        // Fulfills the promises of the waiters woken up so far if release() was not called, for
+        // instance because an exception was thrown. The owner's mutex must still be held.
+        ~DeferredSignals();
+
+        // Stops deferring and returns the waiters woken up so far. They must be passed to
+        // signal(), normally after releasing the owner's mutex.
+        ReadyWaiters release(WithLock);
+
+    private:
+        ReplicationWaiterList* _list;
+    };
+
+    // Adds waiter into the list.
+    void add_inlock(const OpTime& opTime, SharedWaiterHandle waiter);
+    // Adds a waiter into the list and returns the future of the waiter's promise.
+    SharedSemiFuture<void> add_inlock(const OpTime& opTime,
+                                      boost::optional<WriteConcernOptions> w = boost::none);
+    // Returns whether waiter is found and removed.
+    bool remove_inlock(SharedWaiterHandle waiter);
+    // Signals all waiters whose opTime is <= the given opTime (if any) that satisfy the
+    // condition in func.
+    template <typename Func>
+    void setValueIf_inlock(Func&& func, boost::optional<OpTime> opTime = boost::none);
+    // Signals all waiters from the list and fulfills promises with OK status.
+    void setValueAll_inlock();
+    // Signals all waiters from the list and fulfills promises with Error status.
+    void setErrorAll_inlock(Status status);
+
+    // Fulfills the promises of waiters returned by DeferredSignals::release().
+    static void signal(ReadyWaiters waiters);
+
+private:
+    // Fulfills the promise of a waiter that has been removed from the list, or defers it if a
+    // DeferredSignals guard is in scope.
+    void _signal_inlock(SharedWaiterHandle waiter, Status status);
+
+    // Waiters sorted by OpTime.
+    std::multimap<OpTime, SharedWaiterHandle> _waiters;
+
+    // Set while a DeferredSignals guard is in scope.
+    boost::optional<ReadyWaiters> _deferred;
+};
+
+template <typename Func>
+void ReplicationWaiterList::setValueIf_inlock(Func&& func, boost::optional<OpTime> opTime) {
+    for (auto it = _waiters.begin(); it != _waiters.end() && (!opTime || it->first <= *opTime);) {
+        try {
+            if (func(it->first, it->second)) {
+                _signal_inlock(std::move(it->second), Status::OK());
+                it = _waiters.erase(it);
+            } else {
+                ++it;
+            }
+        } catch (const DBException& e) {
+            _signal_inlock(std::move(it->second), e.toStatus());
+            it = _waiters.erase(it);
+        }
+    }
+}
+
+}  // namespace repl
+}  // namespace mongo
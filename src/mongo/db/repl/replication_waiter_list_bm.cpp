@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/repl/replication_waiter_list.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+/**
+ * Measures how long the owner's mutex is held to wake up range(0) majority write waiters after the
+ * commit point advances past all of them. Each waiter has a continuation attached, as
+ * awaitReplication callers do. With range(1) set, the promises are fulfilled after releasing the
+ * mutex through a DeferredSignals guard, which is what processReplSetUpdatePosition() does.
+ */
+void BM_WakeMajorityWaiters(benchmark::State& state) {
+    const int numWaiters = state.range(0);
+    const bool deferSignals = state.range(1);
+
+    Mutex mutex = MONGO_MAKE_LATCH("BM_WakeMajorityWaiters::mutex");
+    ReplicationWaiterList waiters;
+    AtomicWord<long long> numSignaled{0};
+    int64_t timestamp = 0;
+
+    for (auto _ : state) {
+        {
+            stdx::lock_guard<Latch> lk(mutex);
+            for (int i = 0; i < numWaiters; ++i) {
+                auto pf = makePromiseFuture<void>();
+                std::move(pf.future).getAsync([&](Status) { numSignaled.fetchAndAdd(1); });
+                waiters.add_inlock(OpTime(Timestamp(1, ++timestamp), 1),
+                                   std::make_shared<ReplicationWaiterList::Waiter>(
+                                       std::move(pf.promise), WriteConcernOptions()));
+            }
+        }
+
+        const OpTime commitPoint(Timestamp(1, timestamp), 1);
+        auto isSatisfied = [&](const OpTime& opTime, const auto&) {
+            return opTime <= commitPoint;
+        };
+
+        Timer timer;
+        stdx::unique_lock<Latch> lk(mutex);
+        if (deferSignals) {
+            ReplicationWaiterList::DeferredSignals deferredSignals(lk, &waiters);
+            waiters.setValueIf_inlock(isSatisfied, commitPoint);
+            auto readyWaiters = deferredSignals.release(lk);
+            lk.unlock();
+            state.SetIterationTime(timer.micros() / 1000000.0);
+            ReplicationWaiterList::signal(std::move(readyWaiters));
+        } else {
+            waiters.setValueIf_inlock(isSatisfied, commitPoint);
+            lk.unlock();
+            state.SetIterationTime(timer.micros() / 1000000.0);
+        }
+    }
+
+    invariant(numSignaled.load() == numWaiters * state.iterations());
+    state.SetItemsProcessed(numWaiters * state.iterations());
+}
+
+BENCHMARK(BM_WakeMajorityWaiters)
+    ->Args({10 * 1000, 0})
+    ->Args({10 * 1000, 1})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -66,6 +66,7 @@
 #include "mongo/logv2/log.h"
 #include "mongo/s/catalog/type_config_version.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
@@ -460,6 +461,13 @@ StatusWith<std::set<NamespaceString>> RollbackImpl::_namespacesForOp(const Oplog
 
 void RollbackImpl::_runPhaseFromAbortToReconstructPreparedTxns(
     OperationContext* opCtx, RollBackLocalOperations::RollbackCommonPoint commonPoint) noexcept {
+    Timer phaseTimer;
+    auto endPhase = [&](std::string phase) {
+        _rollbackStats.phaseDurations.emplace_back(std::move(phase),
+                                                   Milliseconds(phaseTimer.millis()));
+        phaseTimer.reset();
+    };
+
     // Stop and wait for all background index builds to complete before starting the rollback
     // process.
     _stopAndWaitForIndexBuilds(opCtx);
@@ -472,6 +480,7 @@ void RollbackImpl::_runPhaseFromAbortToReconstructPreparedTxns(
     // prepared transaction. This will require us to scan all sessions and call
     // abortPreparedTransactionForRollback() on any txnParticipant with a prepared transaction.
     killSessionsAbortAllPreparedTransactions(opCtx);
+    endPhase("abortIndexBuildsAndPreparedTransactions");
 
     // Ask the record store for the pre-rollback counts of any collections whose counts will
     // change and create a map with the adjusted counts for post-rollback. While finding the
@@ -480,6 +489,7 @@ void RollbackImpl::_runPhaseFromAbortToReconstructPreparedTxns(
     // and thus must be set after recovering from the oplog.
     auto status = _findRecordStoreCounts(opCtx);
     fassert(31227, status);
+    endPhase("findRecordStoreCounts");
 
     if (shouldCreateDataFiles()) {
         // Write a rollback file for each namespace that has documents that would be deleted by
@@ -488,6 +498,7 @@ void RollbackImpl::_runPhaseFromAbortToReconstructPreparedTxns(
         // those prepared transactions, which we know we will abort anyway.
         status = _writeRollbackFiles(opCtx);
         fassert(31228, status);
+        endPhase("writeRollbackFiles");
     } else {
         LOGV2(21598, "Not writing rollback files. 'createRollbackDataFiles' set to false");
     }
@@ -501,6 +512,7 @@ void RollbackImpl::_runPhaseFromAbortToReconstructPreparedTxns(
 
     // Recover to the stable timestamp.
     auto stableTimestamp = _recoverToStableTimestamp(opCtx);
+    endPhase("recoverToStableTimestamp");
 
     _rollbackStats.stableTimestamp = stableTimestamp;
     _listener->onRecoverToStableTimestamp(stableTimestamp);
@@ -546,11 +558,13 @@ void RollbackImpl::_runPhaseFromAbortToReconstructPreparedTxns(
 
     // Run the recovery process.
     _replicationProcess->getReplicationRecovery()->recoverFromOplog(opCtx, stableTimestamp);
+    endPhase("recoverFromOplog");
     _listener->onRecoverFromOplog();
 
     // Sets the correct post-rollback counts on any collections whose counts changed during the
     // rollback.
     _correctRecordStoreCounts(opCtx);
+    endPhase("correctRecordStoreCounts");
 
     tenant_migration_donor::recoverTenantMigrationAccessBlockers(opCtx);
 
@@ -559,6 +573,7 @@ void RollbackImpl::_runPhaseFromAbortToReconstructPreparedTxns(
     // collection counts, reconstruct the prepared transactions now, adding on any additional counts
     // to the now corrected record store.
     reconstructPreparedTransactions(opCtx, OplogApplication::Mode::kRecovering);
+    endPhase("reconstructPreparedTransactions");
 }
 
 void RollbackImpl::_correctRecordStoreCounts(OperationContext* opCtx) {
@@ -1303,6 +1318,11 @@ void RollbackImpl::_summarizeRollback(OperationContext* opCtx) const {
     if (_rollbackStats.stableTimestamp) {
         attrs.add("stableTimestamp", *_rollbackStats.stableTimestamp);
     }
+    BSONObjBuilder phaseDurations;
+    for (const auto& [phase, duration] : _rollbackStats.phaseDurations) {
+        phaseDurations.append(phase, durationCount<Milliseconds>(duration));
+    }
+    attrs.add("phaseDurationMillis", phaseDurations.obj());
     attrs.add("shardIdentityRolledBack", _observerInfo.shardIdentityRolledBack);
     attrs.add("configServerConfigVersionRolledBack",
               _observerInfo.configServerConfigVersionRolledBack);
@@ -30,6 +30,9 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/db/op_observer.h"
@@ -37,6 +40,7 @@
 #include "mongo/db/repl/roll_back_local_operations.h"
 #include "mongo/db/repl/rollback.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -105,6 +109,12 @@ struct RollbackStats {
      * The wall clock time of the first operation after the common point, if known.
      */
     boost::optional<Date_t> firstOpWallClockTimeAfterCommonPoint;
+
+    /**
+     * How long each phase of rollback that ran took, in the order the phases ran. Recovering to
+     * the stable timestamp includes rebuilding any indexes the recovered catalog is missing.
+     */
+    std::vector<std::pair<std::string, Milliseconds>> phaseDurations;
 };
 
 /**
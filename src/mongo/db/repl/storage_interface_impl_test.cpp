@@ -49,6 +49,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_applier_impl_test_fixture.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_impl.h"
 #include "mongo/db/service_context_d_test_fixture.h"
@@ -57,6 +58,7 @@
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace {
@@ -582,6 +584,118 @@ TEST_F(StorageInterfaceImplTest, CreateCollectionWithIDIndexCommits) {
     ASSERT_EQ(count, 2LL);
 }
 
+/**
+ * Returns the '_id' of every document in 'coll' in RecordId order.
+ */
+std::vector<int> getIdsInRecordOrder(OperationContext* opCtx, const CollectionPtr& coll) {
+    std::vector<int> ids;
+    auto cursor = coll->getRecordStore()->getCursor(opCtx);
+    while (auto record = cursor->next()) {
+        ids.push_back(record->data.toBson()["_id"].numberInt());
+    }
+    return ids;
+}
+
+/**
+ * Creates a bulk loader for a new collection 'nss' with only an _id index.
+ */
+std::unique_ptr<CollectionBulkLoader> makeIdIndexBulkLoader(StorageInterfaceImpl* storage,
+                                                            const NamespaceString& nss) {
+    auto loaderStatus = storage->createCollectionForBulkLoading(
+        nss, generateOptionsWithUuid(), makeIdIndexSpec(nss), {});
+    ASSERT_OK(loaderStatus.getStatus());
+    return std::move(loaderStatus.getValue());
+}
+
+std::vector<BSONObj> makeBulkLoaderDocs(int numDocs) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < numDocs; ++i) {
+        docs.push_back(BSON("_id" << i));
+    }
+    return docs;
+}
+
+TEST_F(StorageInterfaceImplTest, BulkLoaderInsertsDocumentsInBlocksOfBatchSize) {
+    auto opCtx = getOperationContext();
+    StorageInterfaceImpl storage;
+    auto nss = makeNamespace(_agent);
+    auto docs = makeBulkLoaderDocs(10);
+
+    // Every block holds three documents, so the last block is a partial one.
+    const auto originalBatchSize = collectionBulkLoaderBatchSizeInBytes;
+    collectionBulkLoaderBatchSizeInBytes = 2 * docs[0].objsize() + 1;
+    ON_BLOCK_EXIT([&] { collectionBulkLoaderBatchSizeInBytes = originalBatchSize; });
+
+    auto loader = makeIdIndexBulkLoader(&storage, nss);
+    ASSERT_OK(loader->insertDocuments(docs.begin(), docs.end()));
+    ASSERT_OK(loader->commit());
+
+    AutoGetCollectionForReadCommand coll(opCtx, nss);
+    ASSERT(coll);
+    ASSERT_EQ(coll->getRecordStore()->numRecords(opCtx), 10LL);
+    ASSERT(getIdsInRecordOrder(opCtx, coll.getCollection()) ==
+           std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    auto collIdxCat = coll->getIndexCatalog();
+    auto idIdxDesc = collIdxCat->findIdIndex(opCtx);
+    ASSERT_EQ(getIndexKeyCount(opCtx, collIdxCat, idIdxDesc), 10LL);
+}
+
+TEST_F(StorageInterfaceImplTest, BulkLoaderFailureInMiddleOfBlockKeepsOnlyEarlierBlocks) {
+    auto opCtx = getOperationContext();
+    StorageInterfaceImpl storage;
+    auto nss = makeNamespace(_agent);
+    auto docs = makeBulkLoaderDocs(10);
+
+    const auto originalBatchSize = collectionBulkLoaderBatchSizeInBytes;
+    collectionBulkLoaderBatchSizeInBytes = 2 * docs[0].objsize() + 1;
+    ON_BLOCK_EXIT([&] { collectionBulkLoaderBatchSizeInBytes = originalBatchSize; });
+
+    // Reject the fifth document, which is the second document of the second block.
+    auto failPoint = globalFailPointRegistry().find("failCollectionInserts");
+    failPoint->setMode(FailPoint::skip, 4, BSON("collectionNS" << nss.ns()));
+    ON_BLOCK_EXIT([&] { failPoint->setMode(FailPoint::off); });
+
+    auto loader = makeIdIndexBulkLoader(&storage, nss);
+    ASSERT_EQUALS(ErrorCodes::FailPointEnabled,
+                  loader->insertDocuments(docs.begin(), docs.end()));
+
+    // The failed block is rolled back as a whole; the block committed before it is kept.
+    AutoGetCollectionForReadCommand coll(opCtx, nss);
+    ASSERT(coll);
+    ASSERT_EQ(coll->getRecordStore()->numRecords(opCtx), 3LL);
+    ASSERT(getIdsInRecordOrder(opCtx, coll.getCollection()) == std::vector<int>({0, 1, 2}));
+}
+
+TEST_F(StorageInterfaceImplTest, BulkLoaderRetriesBlockAfterWriteConflict) {
+    auto opCtx = getOperationContext();
+    StorageInterfaceImpl storage;
+    auto nss = makeNamespace(_agent);
+    auto docs = makeBulkLoaderDocs(10);
+
+    const auto originalBatchSize = collectionBulkLoaderBatchSizeInBytes;
+    collectionBulkLoaderBatchSizeInBytes = 2 * docs[0].objsize() + 1;
+    ON_BLOCK_EXIT([&] { collectionBulkLoaderBatchSizeInBytes = originalBatchSize; });
+
+    // The first block throws a WriteConflictException after its records are inserted.
+    auto failPoint = globalFailPointRegistry().find("failAfterBulkLoadDocInsert");
+    failPoint->setMode(FailPoint::nTimes, 1);
+    ON_BLOCK_EXIT([&] { failPoint->setMode(FailPoint::off); });
+
+    auto loader = makeIdIndexBulkLoader(&storage, nss);
+    ASSERT_OK(loader->insertDocuments(docs.begin(), docs.end()));
+    ASSERT_OK(loader->commit());
+
+    // The retried block is inserted exactly once.
+    AutoGetCollectionForReadCommand coll(opCtx, nss);
+    ASSERT(coll);
+    ASSERT_EQ(coll->getRecordStore()->numRecords(opCtx), 10LL);
+    ASSERT(getIdsInRecordOrder(opCtx, coll.getCollection()) ==
+           std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    auto collIdxCat = coll->getIndexCatalog();
+    auto idIdxDesc = collIdxCat->findIdIndex(opCtx);
+    ASSERT_EQ(getIndexKeyCount(opCtx, collIdxCat, idIdxDesc), 10LL);
+}
+
 void _testDestroyUncommitedCollectionBulkLoader(
     OperationContext* opCtx,
     const NamespaceString& nss,
@@ -0,0 +1,393 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/tenant_file_import.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <iterator>
+#include <set>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/catalog/uncommitted_collections.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/cloner_utils.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/storage/bson_collection_catalog_entry.h"
+#include "mongo/db/storage/durable_catalog.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace repl {
+namespace tenant_file_import {
+
+const StringData kManifestFileName = "tenantFileImportManifest.bson"_sd;
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+// The storage engine metadata file that a backup cursor includes in every backup, and the
+// extension of the data file of each ident.
+const auto kBackupMetadataFileName = "WiredTiger.backup"_sd;
+const auto kDataFileExtension = ".wt"_sd;
+
+const std::size_t kBackupCursorBatchSize = 100;
+
+std::string dataFileName(StringData ident) {
+    return str::stream() << ident << kDataFileExtension;
+}
+
+/**
+ * Returns the idents of the collection and of every index named in 'catalogEntry'.
+ */
+std::vector<std::string> getIdents(const BSONObj& catalogEntry) {
+    std::vector<std::string> idents{catalogEntry["ident"].String()};
+    for (const auto& indexIdent : catalogEntry["idxIdent"].Obj()) {
+        idents.push_back(indexIdent.String());
+    }
+    return idents;
+}
+
+void copyFile(const fs::path& from, const fs::path& to) {
+    boost::system::error_code ec;
+    fs::create_directories(to.parent_path(), ec);
+    if (!ec) {
+        fs::copy_file(from, to, ec);
+    }
+    uassert(ErrorCodes::FileStreamFailed,
+            str::stream() << "Failed to copy " << from.string() << " to " << to.string() << ": "
+                          << ec.message(),
+            !ec);
+}
+
+std::string readFile(const fs::path& path) {
+    std::ifstream in(path.string(), std::ios::binary);
+    uassert(ErrorCodes::FileOpenFailed, str::stream() << "Failed to open " << path.string(), in);
+    std::string contents{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    uassert(ErrorCodes::FileStreamFailed,
+            str::stream() << "Failed to read " << path.string(),
+            !in.bad());
+    return contents;
+}
+
+void writeManifest(const fs::path& snapshotDir, const TenantFileImportManifest& manifest) {
+    const auto path = snapshotDir / kManifestFileName.toString();
+    const auto obj = manifest.toBSON();
+    std::ofstream out(path.string(), std::ios::binary | std::ios::trunc);
+    out.write(obj.objdata(), obj.objsize());
+    out.flush();
+    uassert(ErrorCodes::FileStreamFailed, str::stream() << "Failed to write " << path.string(), out);
+}
+
+TenantFileImportManifest readManifest(const fs::path& snapshotDir) {
+    const auto path = snapshotDir / kManifestFileName.toString();
+    const auto contents = readFile(path);
+    uassertStatusOKWithContext(validateBSON(contents.data(), contents.size()),
+                               str::stream() << "Invalid manifest " << path.string());
+    return TenantFileImportManifest::parse(IDLParserErrorContext("TenantFileImportManifest"),
+                                           BSONObj(contents.data()));
+}
+
+void importCollection(OperationContext* opCtx,
+                      const fs::path& snapshotDir,
+                      const StringMap<std::string>& backupMetadata,
+                      const TenantFileImportCollection& coll) {
+    const auto& nss = coll.getNs();
+    const auto& catalogEntry = coll.getCatalogEntry();
+    const auto idents = getIdents(catalogEntry);
+    const auto storageMetadata = uassertStatusOK(makeStorageMetadata(backupMetadata, idents));
+
+    // The storage engine imports each ident from the data file at the path it would have created
+    // it at.
+    const fs::path dbpath(storageGlobalParams.dbpath);
+    std::vector<fs::path> copiedFiles;
+    auto removeCopiedFiles = makeGuard([&] {
+        for (const auto& path : copiedFiles) {
+            boost::system::error_code ec;
+            fs::remove(path, ec);
+        }
+    });
+    for (const auto& ident : idents) {
+        const auto fileName = dataFileName(ident);
+        copyFile(snapshotDir / fileName, dbpath / fileName);
+        copiedFiles.push_back(dbpath / fileName);
+    }
+
+    AutoGetDb autoDb(opCtx, nss.db(), MODE_IX);
+    Lock::CollectionLock collLock(opCtx, nss, MODE_X);
+    autoDb.ensureDbExists();
+
+    WriteUnitOfWork wuow(opCtx);
+
+    auto importResult = uassertStatusOK(DurableCatalog::get(opCtx)->importCollection(
+        opCtx,
+        nss,
+        catalogEntry,
+        storageMetadata,
+        DurableCatalog::ImportCollectionUUIDOption::kKeepOld));
+    // The storage engine owns the files now, and drops the idents if this write unit of work rolls
+    // back.
+    removeCopiedFiles.dismiss();
+
+    // Counting the imported records would read all of the tenant's data, so the sizes in the
+    // manifest are taken as the collection's fast count. They were read from the live collection
+    // rather than the checkpoint the files were copied from, so they are only estimates until the
+    // collection is validated.
+    importResult.rs->updateStatsAfterRepair(opCtx, coll.getNumRecords(), coll.getDataSize());
+
+    std::shared_ptr<Collection> ownedCollection =
+        Collection::Factory::get(opCtx)->make(opCtx,
+                                              nss,
+                                              importResult.catalogId,
+                                              importResult.uuid,
+                                              std::move(importResult.rs));
+    ownedCollection->init(opCtx);
+    ownedCollection->setCommitted(false);
+    UncommittedCollections::addToTxn(opCtx, std::move(ownedCollection));
+
+    wuow.commit();
+
+    LOGV2(4972511,
+          "Imported collection from tenant file snapshot",
+          "namespace"_attr = nss,
+          "uuid"_attr = importResult.uuid,
+          "numRecords"_attr = coll.getNumRecords(),
+          "dataSize"_attr = coll.getDataSize());
+}
+
+}  // namespace
+
+TenantFileImportManifest takeSnapshot(OperationContext* opCtx,
+                                      StringData tenantId,
+                                      const std::string& snapshotDir) {
+    Timer timer;
+    auto storageEngine = opCtx->getServiceContext()->getStorageEngine();
+
+    // The last stable checkpoint before the backup cursor is opened is at or before the checkpoint
+    // the backup cursor copies.
+    const auto checkpointTimestamp = storageEngine->getLastStableRecoveryTimestamp();
+
+    auto backupCursor = uassertStatusOK(
+        storageEngine->beginNonBlockingBackup(opCtx, StorageEngine::BackupOptions()));
+    ON_BLOCK_EXIT([&] { storageEngine->endNonBlockingBackup(opCtx); });
+
+    // Maps the path of each file in the backup, relative to the dbpath, to its full path.
+    const fs::path dbpath(storageGlobalParams.dbpath);
+    StringMap<fs::path> backupFiles;
+    for (auto batch = uassertStatusOK(backupCursor->getNextBatch(kBackupCursorBatchSize));
+         !batch.empty();
+         batch = uassertStatusOK(backupCursor->getNextBatch(kBackupCursorBatchSize))) {
+        for (const auto& block : batch) {
+            const fs::path path(block.filename);
+            backupFiles.emplace(path.lexically_relative(dbpath).generic_string(), path);
+        }
+    }
+    uassert(ErrorCodes::SnapshotUnavailable,
+            str::stream() << "The backup does not include " << kBackupMetadataFileName,
+            backupFiles.count(kBackupMetadataFileName));
+
+    // The catalog is read after the backup cursor is open, so every collection and index that
+    // existed at the backup's checkpoint and still exists is found, and anything newer is missing
+    // its files.
+    std::vector<TenantFileImportCollection> collections;
+    std::set<std::string> filesToCopy{kBackupMetadataFileName.toString()};
+    {
+        Lock::GlobalLock lk(opCtx, MODE_IS);
+        auto durableCatalog = storageEngine->getCatalog();
+        for (const auto& entry : durableCatalog->getAllCatalogEntries(opCtx)) {
+            if (!ClonerUtils::isNamespaceForTenant(entry.nss, tenantId)) {
+                continue;
+            }
+
+            const auto catalogEntry = durableCatalog->getCatalogEntry(opCtx, entry.catalogId);
+
+            // The data file of an index that is still being built holds only part of its keys,
+            // and the recipient has no build to finish it with.
+            BSONCollectionCatalogEntry::MetaData md;
+            md.parse(catalogEntry["md"].Obj());
+            for (const auto& index : md.indexes) {
+                uassert(ErrorCodes::SnapshotUnavailable,
+                        str::stream() << "Index " << index.name() << " on collection "
+                                      << entry.nss << " is still being built",
+                        index.ready && !index.buildUUID);
+            }
+
+            for (const auto& ident : getIdents(catalogEntry)) {
+                const auto fileName = dataFileName(ident);
+                uassert(ErrorCodes::SnapshotUnavailable,
+                        str::stream() << "Collection " << entry.nss
+                                      << " changed after the backup's checkpoint; no file "
+                                      << fileName << " in the backup",
+                        backupFiles.count(fileName));
+                filesToCopy.insert(fileName);
+            }
+
+            auto collection =
+                CollectionCatalog::get(opCtx).lookupCollectionByNamespace(opCtx, entry.nss);
+            uassert(ErrorCodes::SnapshotUnavailable,
+                    str::stream() << "Collection " << entry.nss << " was dropped",
+                    collection);
+
+            TenantFileImportCollection coll;
+            coll.setNs(entry.nss);
+            coll.setNumRecords(static_cast<long long>(collection->numRecords(opCtx)));
+            coll.setDataSize(static_cast<long long>(collection->dataSize(opCtx)));
+            coll.setCatalogEntry(catalogEntry);
+            collections.push_back(std::move(coll));
+        }
+    }
+
+    const fs::path dir(snapshotDir);
+    for (const auto& fileName : filesToCopy) {
+        copyFile(backupFiles.find(fileName)->second, dir / fileName);
+    }
+
+    TenantFileImportManifest manifest;
+    manifest.setTenantId(tenantId);
+    manifest.setCheckpointTimestamp(checkpointTimestamp);
+    manifest.setCollections(std::move(collections));
+    writeManifest(dir, manifest);
+
+    LOGV2(4972512,
+          "Took tenant file snapshot",
+          "tenantId"_attr = tenantId,
+          "snapshotDir"_attr = snapshotDir,
+          "numCollections"_attr = manifest.getCollections().size(),
+          "numFiles"_attr = filesToCopy.size(),
+          "checkpointTimestamp"_attr = checkpointTimestamp,
+          "durationMillis"_attr = timer.millis());
+    return manifest;
+}
+
+void importSnapshot(OperationContext* opCtx, const std::string& snapshotDir) {
+    Timer timer;
+    const fs::path dir(snapshotDir);
+    const auto manifest = readManifest(dir);
+    const auto backupMetadata = uassertStatusOK(
+        parseBackupMetadata(readFile(dir / kBackupMetadataFileName.toString())));
+
+    // The files are only copied into this node's dbpath. Other members of a replica set could not
+    // apply a replicated import, so the import must not be replicated at all.
+    auto replCoord = ReplicationCoordinator::get(opCtx);
+    for (const auto& coll : manifest.getCollections()) {
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "Collection " << coll.getNs() << " does not belong to tenant "
+                              << manifest.getTenantId(),
+                ClonerUtils::isNamespaceForTenant(coll.getNs(), manifest.getTenantId()));
+        uassert(ErrorCodes::IllegalOperation,
+                str::stream() << "Cannot import collection " << coll.getNs()
+                              << " from a tenant file snapshot with replicated writes",
+                replCoord->isOplogDisabledFor(opCtx, coll.getNs()));
+    }
+
+    std::vector<std::string> importedNamespaces;
+    for (const auto& coll : manifest.getCollections()) {
+        importCollection(opCtx, dir, backupMetadata, coll);
+        importedNamespaces.push_back(coll.getNs().ns());
+    }
+
+    if (!importedNamespaces.empty()) {
+        LOGV2_WARNING(4972514,
+                      "The fast counts of collections imported from a tenant file snapshot are "
+                      "estimates. Run validate on the collections to correct them",
+                      "tenantId"_attr = manifest.getTenantId(),
+                      "namespaces"_attr = importedNamespaces);
+    }
+
+    LOGV2(4972513,
+          "Imported tenant file snapshot",
+          "tenantId"_attr = manifest.getTenantId(),
+          "snapshotDir"_attr = snapshotDir,
+          "numCollections"_attr = manifest.getCollections().size(),
+          "durationMillis"_attr = timer.millis());
+}
+
+StatusWith<StringMap<std::string>> parseBackupMetadata(StringData contents) {
+    // The file holds one line with each URI followed by one line with its configuration.
+    StringMap<std::string> metadata;
+    size_t pos = 0;
+    auto nextLine = [&]() -> boost::optional<StringData> {
+        if (pos >= contents.size()) {
+            return boost::none;
+        }
+        auto end = contents.find('\n', pos);
+        if (end == std::string::npos) {
+            end = contents.size();
+        }
+        auto line = contents.substr(pos, end - pos);
+        pos = end + 1;
+        return line;
+    };
+
+    while (auto uri = nextLine()) {
+        auto config = nextLine();
+        if (uri->empty() || !config) {
+            return Status(ErrorCodes::FailedToParse,
+                          str::stream() << "Malformed backup metadata at offset " << pos);
+        }
+        metadata[uri->toString()] = config->toString();
+    }
+    return metadata;
+}
+
+StatusWith<BSONObj> makeStorageMetadata(const StringMap<std::string>& backupMetadata,
+                                        const std::vector<std::string>& idents) {
+    BSONObjBuilder builder;
+    for (const auto& ident : idents) {
+        auto table = backupMetadata.find("table:" + ident);
+        auto file = backupMetadata.find("file:" + dataFileName(ident));
+        if (table == backupMetadata.end() || file == backupMetadata.end()) {
+            return Status(ErrorCodes::NoSuchKey,
+                          str::stream() << "No backup metadata for ident " << ident);
+        }
+        builder.append(ident,
+                       BSON("tableMetadata" << table->second << "fileMetadata" << file->second));
+    }
+    return builder.obj();
+}
+
+}  // namespace tenant_file_import
+}  // namespace repl
+}  // namespace mongo
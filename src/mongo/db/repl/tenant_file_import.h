@@ -0,0 +1,93 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/repl/tenant_file_import_manifest_gen.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class OperationContext;
+
+namespace repl {
+
+/**
+ * Physical copy of a tenant's collections: rather than cloning documents and rebuilding indexes,
+ * the data files of the tenant's collections are copied from a backup cursor on the source and
+ * imported on the destination through the import-collection path of the durable catalog. Only
+ * storage engines whose files the import path understands, that is WiredTiger, are supported.
+ */
+namespace tenant_file_import {
+
+// Name of the file in a snapshot directory that holds its TenantFileImportManifest.
+extern const StringData kManifestFileName;
+
+/**
+ * Opens a backup cursor and copies the data files of every collection of 'tenantId' into
+ * 'snapshotDir', along with the storage engine metadata of the backup and a manifest describing
+ * the collections. Throws SnapshotUnavailable if a collection's files are not part of the backup,
+ * which happens when it was created or had an index built after the backup's checkpoint, or if an
+ * index of a collection is still being built.
+ */
+TenantFileImportManifest takeSnapshot(OperationContext* opCtx,
+                                      StringData tenantId,
+                                      const std::string& snapshotDir);
+
+/**
+ * Imports the collections of a snapshot taken by takeSnapshot() into this node, keeping their
+ * UUIDs. The data files are copied into this node's dbpath only, so the import is not replicated:
+ * throws IllegalOperation unless writes to the collections are unreplicated, as on a standalone or
+ * within an UnreplicatedWritesBlock. The fast count of each collection is set to the estimate in
+ * the manifest, which validate corrects. Throws if any collection already exists.
+ */
+void importSnapshot(OperationContext* opCtx, const std::string& snapshotDir);
+
+/**
+ * Parses the contents of the storage engine metadata file written by a backup cursor into a map
+ * from each URI to its configuration.
+ */
+StatusWith<StringMap<std::string>> parseBackupMetadata(StringData contents);
+
+/**
+ * Returns the storage metadata argument DurableCatalog::importCollection() expects for 'idents',
+ * using the configurations in 'backupMetadata'.
+ */
+StatusWith<BSONObj> makeStorageMetadata(const StringMap<std::string>& backupMetadata,
+                                        const std::vector<std::string>& idents);
+
+}  // namespace tenant_file_import
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,328 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/catalog/multi_index_block.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/repl/storage_interface_impl.h"
+#include "mongo/db/repl/tenant_file_import.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/db/storage/control/storage_control.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_engine_init.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+using namespace tenant_file_import;
+
+TEST(TenantFileImportTest, ParseBackupMetadata) {
+    auto metadata = unittest::assertGet(
+        parseBackupMetadata("file:collection-0-1.wt\n"
+                            "allocation_size=4KB,checkpoint=(WiredTigerCheckpoint.3=(addr=\"01\"))\n"
+                            "table:collection-0-1\n"
+                            "app_metadata=(formatVersion=1),colgroups=,key_format=q\n"));
+    ASSERT_EQ(2U, metadata.size());
+    ASSERT_EQ("allocation_size=4KB,checkpoint=(WiredTigerCheckpoint.3=(addr=\"01\"))",
+              metadata["file:collection-0-1.wt"]);
+    ASSERT_EQ("app_metadata=(formatVersion=1),colgroups=,key_format=q",
+              metadata["table:collection-0-1"]);
+}
+
+TEST(TenantFileImportTest, ParseBackupMetadataWithoutTrailingNewline) {
+    auto metadata = unittest::assertGet(parseBackupMetadata("table:index-1-1\nkey_format=u"));
+    ASSERT_EQ(1U, metadata.size());
+    ASSERT_EQ("key_format=u", metadata["table:index-1-1"]);
+}
+
+TEST(TenantFileImportTest, ParseBackupMetadataRejectsUriWithoutConfig) {
+    ASSERT_EQ(ErrorCodes::FailedToParse,
+              parseBackupMetadata("table:index-1-1\nkey_format=u\nfile:index-1-1.wt\n")
+                  .getStatus());
+}
+
+TEST(TenantFileImportTest, MakeStorageMetadata) {
+    StringMap<std::string> backupMetadata{{"table:collection-0-1", "key_format=q"},
+                                          {"file:collection-0-1.wt", "checkpoint=(c)"},
+                                          {"table:index-1-1", "key_format=u"},
+                                          {"file:index-1-1.wt", "checkpoint=(i)"},
+                                          {"table:index-2-1", "key_format=u"}};
+
+    auto storageMetadata = unittest::assertGet(
+        makeStorageMetadata(backupMetadata, {"collection-0-1", "index-1-1"}));
+    ASSERT_BSONOBJ_EQ(
+        BSON("collection-0-1" << BSON("tableMetadata"
+                                      << "key_format=q"
+                                      << "fileMetadata"
+                                      << "checkpoint=(c)")
+                              << "index-1-1"
+                              << BSON("tableMetadata"
+                                      << "key_format=u"
+                                      << "fileMetadata"
+                                      << "checkpoint=(i)")),
+        storageMetadata);
+}
+
+TEST(TenantFileImportTest, MakeStorageMetadataRequiresFileMetadata) {
+    StringMap<std::string> backupMetadata{{"table:index-2-1", "key_format=u"}};
+    ASSERT_EQ(ErrorCodes::NoSuchKey,
+              makeStorageMetadata(backupMetadata, {"index-2-1"}).getStatus());
+}
+
+/**
+ * Takes snapshots on a WiredTiger node and imports them into another WiredTiger node, which is
+ * the same storage engine restarted on an empty dbpath.
+ */
+class TenantFileImportWiredTigerTest : public ServiceContextMongoDTest {
+protected:
+    TenantFileImportWiredTigerTest()
+        : ServiceContextMongoDTest("wiredTiger"),
+          _snapshotDir("tenant_file_import_snapshot"),
+          _recipientDbpath("tenant_file_import_recipient") {}
+
+    void setUp() override {
+        ServiceContextMongoDTest::setUp();
+        auto service = getServiceContext();
+        ReplicationCoordinator::set(service, std::make_unique<ReplicationCoordinatorMock>(service));
+        _donorDbpath = storageGlobalParams.dbpath;
+        _opCtx = cc().makeOperationContext();
+    }
+
+    void tearDown() override {
+        // The fixture shuts down the running storage engine only after the recipient's dbpath has
+        // been removed, so move back to the donor's.
+        if (storageGlobalParams.dbpath != _donorDbpath) {
+            restartStorageEngine(_donorDbpath);
+        }
+        _opCtx.reset();
+        ServiceContextMongoDTest::tearDown();
+    }
+
+    OperationContext* opCtx() {
+        return _opCtx.get();
+    }
+
+    const std::string& snapshotDir() {
+        return _snapshotDir.path();
+    }
+
+    /**
+     * Creates 'nss' with an index on 'a' and inserts 'numDocs' documents into it. Returns the
+     * UUID of the collection.
+     */
+    UUID createCollection(const NamespaceString& nss, int numDocs) {
+        CollectionOptions options;
+        options.uuid = UUID::gen();
+        ASSERT_OK(_storage.createCollection(opCtx(), nss, options));
+        ASSERT_OK(_storage.createIndexesOnEmptyCollection(
+            opCtx(), nss, {BSON("v" << 2 << "key" << BSON("a" << 1) << "name" << kIndexName)}));
+
+        std::vector<InsertStatement> docs;
+        for (int i = 0; i < numDocs; ++i) {
+            docs.emplace_back(BSON("_id" << i << "a" << i));
+        }
+        ASSERT_OK(_storage.insertDocuments(opCtx(), nss, docs));
+        return *options.uuid;
+    }
+
+    /**
+     * Takes a checkpoint, which the backup cursor of the next snapshot copies.
+     */
+    void checkpoint() {
+        getServiceContext()->getStorageEngine()->flushAllFiles(opCtx(),
+                                                               false /* callerHoldsReadLock */);
+    }
+
+    /**
+     * Restarts the storage engine on the empty recipient dbpath.
+     */
+    void restartOnRecipient() {
+        restartStorageEngine(_recipientDbpath.path());
+    }
+
+    /**
+     * Checks that 'nss' has the UUID it had on the donor and its 'numDocs' documents, found both
+     * by a collection scan and through the index on 'a'.
+     */
+    void assertImported(const NamespaceString& nss, const UUID& uuid, int numDocs) {
+        {
+            AutoGetCollectionForRead coll(opCtx(), nss);
+            ASSERT(coll.getCollection());
+            ASSERT_EQ(uuid, coll->uuid());
+            ASSERT_EQ(numDocs, coll->numRecords(opCtx()));
+            ASSERT_EQ(2, coll->getIndexCatalog()->numIndexesReady(opCtx()));
+        }
+
+        auto byId = unittest::assertGet(
+            _storage.findDocuments(opCtx(),
+                                   nss,
+                                   boost::none,
+                                   StorageInterface::ScanDirection::kForward,
+                                   {},
+                                   BoundInclusion::kIncludeStartKeyOnly,
+                                   static_cast<std::size_t>(numDocs + 1)));
+        auto byA = unittest::assertGet(
+            _storage.findDocuments(opCtx(),
+                                   nss,
+                                   kIndexName,
+                                   StorageInterface::ScanDirection::kBackward,
+                                   {},
+                                   BoundInclusion::kIncludeStartKeyOnly,
+                                   static_cast<std::size_t>(numDocs + 1)));
+        ASSERT_EQ(static_cast<std::size_t>(numDocs), byId.size());
+        ASSERT_EQ(static_cast<std::size_t>(numDocs), byA.size());
+        for (int i = 0; i < numDocs; ++i) {
+            ASSERT_BSONOBJ_EQ(BSON("_id" << i << "a" << i), byId[i]);
+            ASSERT_BSONOBJ_EQ(byId[i], byA[numDocs - 1 - i]);
+        }
+    }
+
+    static constexpr StringData kIndexName = "a_1"_sd;
+
+private:
+    void restartStorageEngine(const std::string& dbpath) {
+        auto service = getServiceContext();
+        _opCtx.reset();
+        {
+            auto opCtx = cc().makeOperationContext();
+            Lock::GlobalLock lk(opCtx.get(), MODE_X);
+            DatabaseHolder::get(opCtx.get())->closeAll(opCtx.get());
+        }
+        shutdownGlobalStorageEngineCleanly(service);
+        service->clearStorageEngine();
+
+        storageGlobalParams.dbpath = dbpath;
+        {
+            auto opCtx = cc().makeOperationContext();
+            initializeStorageEngine(opCtx.get(),
+                                    StorageEngineInitFlags::kAllowNoLockFile |
+                                        StorageEngineInitFlags::kSkipMetadataFile);
+        }
+        StorageControl::startStorageControls(service, true /* forTestOnly */);
+        service->getStorageEngine()->notifyStartupComplete();
+        _opCtx = cc().makeOperationContext();
+    }
+
+    StorageInterfaceImpl _storage;
+    unittest::TempDir _snapshotDir;
+    unittest::TempDir _recipientDbpath;
+    std::string _donorDbpath;
+    ServiceContext::UniqueOperationContext _opCtx;
+};
+
+TEST_F(TenantFileImportWiredTigerTest, ImportSnapshotIntoAnotherNode) {
+    const NamespaceString nss1("tenantA_db1.coll");
+    const NamespaceString nss2("tenantA_db2.coll");
+    const NamespaceString otherTenantNss("tenantB_db.coll");
+    const auto uuid1 = createCollection(nss1, 10);
+    const auto uuid2 = createCollection(nss2, 3);
+    createCollection(otherTenantNss, 5);
+    checkpoint();
+
+    auto manifest = takeSnapshot(opCtx(), "tenantA", snapshotDir());
+    ASSERT_EQ("tenantA", manifest.getTenantId());
+    ASSERT_EQ(2U, manifest.getCollections().size());
+
+    restartOnRecipient();
+    importSnapshot(opCtx(), snapshotDir());
+
+    assertImported(nss1, uuid1, 10);
+    assertImported(nss2, uuid2, 3);
+    AutoGetCollectionForRead otherTenantColl(opCtx(), otherTenantNss);
+    ASSERT_FALSE(otherTenantColl.getCollection());
+}
+
+TEST_F(TenantFileImportWiredTigerTest, ImportSnapshotRejectsExistingCollection) {
+    const NamespaceString nss("tenantA_db.coll");
+    createCollection(nss, 1);
+    checkpoint();
+    takeSnapshot(opCtx(), "tenantA", snapshotDir());
+
+    ASSERT_THROWS(importSnapshot(opCtx(), snapshotDir()), DBException);
+}
+
+TEST_F(TenantFileImportWiredTigerTest, ImportSnapshotRequiresUnreplicatedWrites) {
+    const NamespaceString nss("tenantA_db.coll");
+    createCollection(nss, 1);
+    checkpoint();
+    takeSnapshot(opCtx(), "tenantA", snapshotDir());
+    restartOnRecipient();
+
+    auto service = getServiceContext();
+    ReplSettings replSettings;
+    replSettings.setReplSetString("rs0");
+    ReplicationCoordinator::set(
+        service, std::make_unique<ReplicationCoordinatorMock>(service, replSettings));
+
+    ASSERT_THROWS_CODE(
+        importSnapshot(opCtx(), snapshotDir()), DBException, ErrorCodes::IllegalOperation);
+    AutoGetCollectionForRead coll(opCtx(), nss);
+    ASSERT_FALSE(coll.getCollection());
+}
+
+TEST_F(TenantFileImportWiredTigerTest, TakeSnapshotRejectsUnfinishedIndexBuild) {
+    const NamespaceString nss("tenantA_db.coll");
+    createCollection(nss, 3);
+
+    MultiIndexBlock indexer;
+    {
+        AutoGetCollection autoColl(opCtx(), nss, MODE_X);
+        CollectionWriter coll(autoColl);
+        ASSERT_OK(indexer
+                      .init(opCtx(),
+                            coll,
+                            BSON("v" << 2 << "key" << BSON("b" << 1) << "name"
+                                     << "b_1"),
+                            MultiIndexBlock::kNoopOnInitFn)
+                      .getStatus());
+    }
+    ON_BLOCK_EXIT([&] {
+        AutoGetCollection autoColl(opCtx(), nss, MODE_X);
+        CollectionWriter coll(autoColl);
+        indexer.abortIndexBuild(opCtx(), coll, MultiIndexBlock::kNoopOnCleanUpFn);
+    });
+    checkpoint();
+
+    ASSERT_THROWS_CODE(takeSnapshot(opCtx(), "tenantA", snapshotDir()),
+                       DBException,
+                       ErrorCodes::SnapshotUnavailable);
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
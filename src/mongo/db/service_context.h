@@ -388,10 +388,17 @@ public:
     //
 
     /**
-     * Sets the storage engine for this instance. May be called up to once per instance.
+     * Sets the storage engine for this instance. May be called up to once per instance, unless
+     * clearStorageEngine() is called in between.
      */
     void setStorageEngine(std::unique_ptr<StorageEngine> engine);
 
+    /**
+     * Destroys the storage engine of this instance so that another can be set. The storage engine
+     * must have been shut down already. Only for tests that restart the storage engine.
+     */
+    void clearStorageEngine();
+
     /**
      * Return the storage engine instance we're using.
      */
@@ -1003,6 +1003,11 @@ void execCommandDatabase(OperationContext* opCtx,
             APIParameters::get(opCtx) = APIParameters::fromClient(apiParamsFromClient);
         }
 
+        // Only user operations take the priority of the command; internal ones keep theirs.
+        if (opCtx->getPriority() == OperationContext::Priority::kInteractive) {
+            opCtx->setPriority(command->getAdmissionPriority());
+        }
+
         if (isHello) {
             // Preload generic ClientMetadata ahead of our first hello request. After the first
             // request, metaElement should always be empty.
@@ -1384,6 +1389,12 @@ DbResponse receivedCommands(OperationContext* opCtx,
                             const Message& message,
                             const ServiceEntryPointCommon::Hooks& behaviors) {
     auto replyBuilder = rpc::makeReplyBuilder(rpc::protocolForMessage(message));
+    if (message.operation() == dbMsg &&
+        OpMsg::isFlagSet(message, OpMsg::kDocumentSequencesAccepted)) {
+        // Only replies that go straight back to a session may reference documents in place.
+        auto client = opCtx->getClient();
+        replyBuilder->acceptDocumentSequences(client->session() && !client->isInDirectClient());
+    }
     OpMsgRequest request;
     Command* c = nullptr;
     [&] {
@@ -56,13 +56,17 @@
 #include "mongo/config.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/sorter/sorter_gen.h"
+#include "mongo/db/sorter/sorter_stats.h"
 #include "mongo/db/storage/encryption_hooks.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/s/is_mongos.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/destructor_guard.h"
+#include "mongo/util/future.h"
 #include "mongo/util/str.h"
 #include "mongo/util/unowned_ptr.h"
 
@@ -184,6 +188,11 @@ private:
  * closeSource() functions to ensure the FileIterator is not holding the file open when the file is
  * deleted. Since it is one among many FileIterators, it cannot close a file that may still be in
  * use elsewhere.
+ *
+ * Unless sorterReadAheadEnabled is false, the block following the one being consumed is read,
+ * decrypted and decompressed on the sorter read-ahead pool, so that a merge over many ranges
+ * overlaps its disk reads with comparisons. At most one read is outstanding per FileIterator, which
+ * is therefore the only user of '_file' while it is in flight.
  */
 template <typename Key, typename Value>
 class FileIterator : public SortIteratorInterface<Key, Value> {
@@ -223,7 +232,12 @@ public:
                 _file.good());
     }
 
+    ~FileIterator() {
+        DESTRUCTOR_GUARD(waitForReadAhead());
+    }
+
     void closeSource() {
+        waitForReadAhead();
         _file.close();
         uassert(50969,
                 str::stream() << "error closing file \"" << _fileFullPath
@@ -288,28 +302,94 @@ private:
     }
 
     /**
-     * Tries to read from disk and places any results in _bufferReader. If there is no more data to
-     * read, then _done is set to true and the function returns immediately.
+     * A block of a spilled range, already decrypted and decompressed. 'eof' is set instead when
+     * there is no more data to read.
+     */
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size = 0;
+        bool eof = false;
+    };
+
+    /**
+     * Places the next block of the range in _bufferReader, either by collecting the outstanding
+     * read-ahead or by reading it now. If there is no more data to read, then _done is set to true
+     * and the function returns immediately. Otherwise, starts reading the following block.
      */
     void fillBufferFromDisk() {
-        int32_t rawSize;
-        read(&rawSize, sizeof(rawSize));
-        if (_done)
+        Block block;
+        if (_readAhead) {
+            auto readAhead = std::move(*_readAhead);
+            _readAhead.reset();
+            block = std::move(readAhead).get();
+        } else {
+            block = readBlock();
+        }
+
+        if (block.eof) {
+            _done = true;
+            return;
+        }
+
+        _buffer = std::move(block.data);
+        _bufferReader.reset(new BufReader(_buffer.get(), block.size));
+
+        startReadAhead();
+    }
+
+    void startReadAhead() {
+        if (!gSorterReadAheadEnabled.load())
             return;
 
+        auto pf = makePromiseFuture<Block>();
+        _readAhead.emplace(std::move(pf.future));
+        scheduleReadAhead([this, promise = std::move(pf.promise)](Status status) mutable {
+            if (!status.isOK()) {
+                promise.setError(status);
+                return;
+            }
+            promise.setWith([&] { return readBlock(); });
+            sorterStats.readAheadBlocks.increment();
+        });
+    }
+
+    /**
+     * Waits for the outstanding read-ahead, if any, so that '_file' may be used or closed by this
+     * thread. The block read ahead is discarded.
+     */
+    void waitForReadAhead() {
+        if (!_readAhead)
+            return;
+        auto readAhead = std::move(*_readAhead);
+        _readAhead.reset();
+        std::move(readAhead).getNoThrow().getStatus().ignore();
+    }
+
+    /**
+     * Reads the next block of the range from disk, then decrypts and decompresses it. May be
+     * called from the read-ahead pool, so it must not modify any state other than '_file'.
+     */
+    Block readBlock() {
+        Block block;
+
+        int32_t rawSize;
+        if (!read(&rawSize, sizeof(rawSize))) {
+            block.eof = true;
+            return block;
+        }
+
         // negative size means compressed
         const bool compressed = rawSize < 0;
         int32_t blockSize = std::abs(rawSize);
 
-        _buffer.reset(new char[blockSize]);
-        read(_buffer.get(), blockSize);
-        uassert(16816, "file too short?", !_done);
+        std::unique_ptr<char[]> buffer(new char[blockSize]);
+        uassert(16816, "file too short?", read(buffer.get(), blockSize));
 
         if (auto encryptionHooks = getEncryptionHooksIfEnabled()) {
             std::unique_ptr<char[]> out(new char[blockSize]);
             size_t outLen;
             Status status =
-                encryptionHooks->unprotectTmpData(reinterpret_cast<uint8_t*>(_buffer.get()),
+                encryptionHooks->unprotectTmpData(reinterpret_cast<uint8_t*>(buffer.get()),
                                                   blockSize,
                                                   reinterpret_cast<uint8_t*>(out.get()),
                                                   blockSize,
@@ -318,37 +398,40 @@ private:
                     str::stream() << "Failed to unprotect data: " << status.toString(),
                     status.isOK());
             blockSize = outLen;
-            _buffer.swap(out);
+            buffer.swap(out);
         }
 
         if (!compressed) {
-            _bufferReader.reset(new BufReader(_buffer.get(), blockSize));
-            return;
+            block.data = std::move(buffer);
+            block.size = blockSize;
+            return block;
         }
 
-        dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
+        dassert(snappy::IsValidCompressedBuffer(buffer.get(), blockSize));
 
         size_t uncompressedSize;
         uassert(17061,
                 "couldn't get uncompressed length",
-                snappy::GetUncompressedLength(_buffer.get(), blockSize, &uncompressedSize));
+                snappy::GetUncompressedLength(buffer.get(), blockSize, &uncompressedSize));
 
         std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
         uassert(17062,
                 "decompression failed",
-                snappy::RawUncompress(_buffer.get(), blockSize, decompressionBuffer.get()));
+                snappy::RawUncompress(buffer.get(), blockSize, decompressionBuffer.get()));
 
         // hold on to decompressed data and throw out compressed data at block exit
-        _buffer.swap(decompressionBuffer);
-        _bufferReader.reset(new BufReader(_buffer.get(), uncompressedSize));
+        block.data = std::move(decompressionBuffer);
+        block.size = uncompressedSize;
+        return block;
     }
 
     /**
-     * Attempts to read data from disk. Sets _done to true when file offset reaches _fileEndOffset.
+     * Attempts to read data from disk. Returns false without reading when the file offset has
+     * reached _fileEndOffset.
      *
      * Masserts on any file errors
      */
-    void read(void* out, size_t size) {
+    bool read(void* out, size_t size) {
         invariant(_file.is_open());
 
         const std::streampos offset = _file.tellg();
@@ -359,8 +442,7 @@ private:
 
         if (offset >= _fileEndOffset) {
             invariant(offset == _fileEndOffset);
-            _done = true;
-            return;
+            return false;
         }
 
         _file.read(reinterpret_cast<char*>(out), size);
@@ -369,6 +451,7 @@ private:
                               << "\": " << myErrnoWithDescription(),
                 _file.good());
         verify(_file.gcount() == static_cast<std::streamsize>(size));
+        return true;
     }
 
     const Settings _settings;
@@ -381,6 +464,9 @@ private:
     std::streampos _fileEndOffset;    // File offset at which the sorted data range ends.
     std::ifstream _file;
 
+    // The outstanding read of the block following the one in _bufferReader, if any.
+    boost::optional<Future<Block>> _readAhead;
+
     // Checksum value that is updated with each read of a data object from disk. We can compare
     // this value with _originalChecksum to check for data corruption if and only if the
     // FileIterator is exhausted.
@@ -410,6 +496,9 @@ public:
           _remaining(opts.limit ? opts.limit : std::numeric_limits<unsigned long long>::max()),
           _first(true),
           _greater(comp) {
+        sorterStats.merges.increment();
+        sorterStats.mergedRanges.increment(iters.size());
+
         for (size_t i = 0; i < iters.size(); i++) {
             iters[i]->openSource();
             if (iters[i]->more()) {
@@ -584,6 +673,11 @@ public:
         if (!this->_shouldKeepFilesOnDestruction) {
             DESTRUCTOR_GUARD(boost::filesystem::remove(this->_fileFullPath));
         }
+
+        // Intermediate merge files are only created by done(), so they are never persisted.
+        for (const auto& mergeFileFullPath : _mergeFileFullPaths) {
+            DESTRUCTOR_GUARD(boost::filesystem::remove(mergeFileFullPath));
+        }
     }
 
     void add(const Key& key, const Value& val) {
@@ -619,7 +713,7 @@ public:
         }
 
         spill();
-        return Iterator::merge(this->_iters, this->_opts, _comp);
+        return Iterator::merge(mergeSpilledRangesIfNeeded(), this->_opts, _comp);
     }
 
 private:
@@ -635,6 +729,82 @@ private:
         const Comparator& _comp;
     };
 
+    /**
+     * Returns the ranges for the final merge. While more ranges have been spilled than
+     * maxSorterMergeFanIn, merges consecutive groups of at most that many ranges into single
+     * ranges, up to sorterMergeParallelism groups at a time. Since groups are merged concurrently,
+     * each one is written to its own file next to the spill file. Groups are consecutive and keep
+     * their relative order, so the final merge remains stable.
+     *
+     * The spilled ranges in '_iters' are left in place so that persistDataForShutdown() still
+     * describes the spill file.
+     */
+    std::vector<std::shared_ptr<Iterator>> mergeSpilledRangesIfNeeded() {
+        const size_t fanIn = gMaxSorterMergeFanIn.load();
+        const size_t parallelism = gSorterMergeParallelism.load();
+
+        auto ranges = this->_iters;
+        for (size_t pass = 0; ranges.size() > fanIn; ++pass) {
+            const size_t numGroups = (ranges.size() + fanIn - 1) / fanIn;
+            std::vector<std::shared_ptr<Iterator>> merged(numGroups);
+
+            const size_t firstGroupFile = _mergeFileFullPaths.size();
+            for (size_t group = 0; group < numGroups; ++group) {
+                _mergeFileFullPaths.emplace_back(str::stream() << this->_fileFullPath << ".merge."
+                                                               << pass << "." << group);
+            }
+
+            auto mergeGroup = [&](size_t group) {
+                const auto begin = ranges.begin() + group * fanIn;
+                const auto end = ranges.begin() + std::min((group + 1) * fanIn, ranges.size());
+                std::unique_ptr<Iterator> input(
+                    Iterator::merge(std::vector<std::shared_ptr<Iterator>>(begin, end),
+                                    this->_opts,
+                                    _comp));
+
+                SortedFileWriter<Key, Value> writer(
+                    this->_opts, _mergeFileFullPaths[firstGroupFile + group], 0, _settings);
+                while (input->more()) {
+                    auto next = input->next();
+                    writer.addAlreadySorted(next.first, next.second);
+                }
+                merged[group].reset(writer.done());
+            };
+
+            for (size_t first = 0; first < numGroups; first += parallelism) {
+                const size_t last = std::min(first + parallelism, numGroups);
+                std::vector<Status> statuses(last - first, Status::OK());
+                std::vector<stdx::thread> workers;
+                for (size_t group = first + 1; group < last; ++group) {
+                    workers.emplace_back([&, group] {
+                        try {
+                            mergeGroup(group);
+                        } catch (...) {
+                            statuses[group - first] = exceptionToStatus();
+                        }
+                    });
+                }
+
+                try {
+                    mergeGroup(first);
+                } catch (...) {
+                    statuses[0] = exceptionToStatus();
+                }
+
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+                for (const auto& status : statuses) {
+                    uassertStatusOK(status);
+                }
+            }
+
+            ranges = std::move(merged);
+            sorterStats.intermediateMergePasses.increment();
+        }
+        return ranges;
+    }
+
     void sort() {
         STLComparator less(_comp);
         std::stable_sort(_data.begin(), _data.end(), less);
@@ -681,6 +851,9 @@ private:
     bool _done = false;
     size_t _memUsed = 0;
     std::deque<Data> _data;  // Data that has not been spilled.
+
+    // Files holding the output of intermediate merges, deleted along with the spill file.
+    std::vector<std::string> _mergeFileFullPaths;
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -1115,6 +1288,7 @@ void SortedFileWriter<Key, Value>::spill() {
                     str::stream() << "error writing to file \"" << _fileFullPath
                                   << "\": " << sorter::myErrnoWithDescription());
     }
+    sorter::sorterStats.spilledBytes.increment(sizeof(size) + std::abs(size));
 
     _buffer.reset();
 }
@@ -1132,6 +1306,7 @@ SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     // initialized on all systems upon opening the file.
     _fileEndOffset = currentFileOffset < _fileStartOffset ? _fileStartOffset : currentFileOffset;
     _file.close();
+    sorter::sorterStats.spilledRanges.increment();
 
     return new sorter::FileIterator<Key, Value>(
         _fileFullPath, _fileStartOffset, _fileEndOffset, _settings, _checksum);
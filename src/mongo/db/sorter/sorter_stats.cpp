@@ -0,0 +1,77 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter_stats.h"
+
+#include "mongo/db/commands/server_status_metric.h"
+
+namespace mongo {
+namespace sorter {
+
+SorterStats sorterStats;
+
+namespace {
+
+ServerStatusMetricField<Counter64> displaySpilledRanges("sorter.spilledRanges",
+                                                        &sorterStats.spilledRanges);
+ServerStatusMetricField<Counter64> displaySpilledBytes("sorter.spilledBytes",
+                                                       &sorterStats.spilledBytes);
+ServerStatusMetricField<Counter64> displayMerges("sorter.merges", &sorterStats.merges);
+ServerStatusMetricField<Counter64> displayMergedRanges("sorter.mergedRanges",
+                                                       &sorterStats.mergedRanges);
+ServerStatusMetricField<Counter64> displayIntermediateMergePasses(
+    "sorter.intermediateMergePasses", &sorterStats.intermediateMergePasses);
+ServerStatusMetricField<Counter64> displayReadAheadBlocks("sorter.readAheadBlocks",
+                                                          &sorterStats.readAheadBlocks);
+
+ThreadPool* makeReadAheadPool() {
+    ThreadPool::Options options;
+    options.poolName = "SorterReadAhead";
+    options.threadNamePrefix = "SorterReadAhead-";
+    // Threads are only kept while external sorts are reading spilled data.
+    options.minThreads = 0;
+    options.maxThreads = 8;
+    auto pool = new ThreadPool(options);
+    pool->startup();
+    return pool;
+}
+
+}  // namespace
+
+void scheduleReadAhead(ThreadPool::Task task) {
+    // Intentionally leaked so that sorts still in progress during process exit can drain safely.
+    static ThreadPool* const pool = makeReadAheadPool();
+    pool->schedule(std::move(task));
+}
+
+}  // namespace sorter
+}  // namespace mongo
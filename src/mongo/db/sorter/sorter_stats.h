@@ -0,0 +1,68 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/base/counter.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+namespace sorter {
+
+/**
+ * Process-wide counters describing external sort activity. These are reported under
+ * serverStatus().metrics.sorter.
+ */
+struct SorterStats {
+    // Number of sorted ranges written to spill files, including intermediate merge output.
+    Counter64 spilledRanges;
+    // Number of bytes written to spill files, after compression and encryption.
+    Counter64 spilledBytes;
+    // Number of merges over spilled ranges, and the total number of ranges they consumed. Their
+    // ratio is the average merge fan-in.
+    Counter64 merges;
+    Counter64 mergedRanges;
+    // Number of intermediate merge passes performed because a sort spilled more ranges than
+    // maxSorterMergeFanIn.
+    Counter64 intermediateMergePasses;
+    // Number of spilled blocks that were read and decompressed ahead of use.
+    Counter64 readAheadBlocks;
+};
+
+extern SorterStats sorterStats;
+
+/**
+ * Schedules 'task' on the process-wide pool used to read spilled blocks ahead of their use.
+ * Tasks run on this pool must never wait on other tasks scheduled on it.
+ */
+void scheduleReadAhead(ThreadPool::Task task);
+
+}  // namespace sorter
+}  // namespace mongo
@@ -45,6 +45,7 @@
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 
 namespace mongo {
@@ -604,6 +605,28 @@ public:
     PseudoRandom _random;
 };
 
+/**
+ * Spills many more ranges than the merge fan-in allows, so that done() merges groups of ranges in
+ * several passes, some groups concurrently, before the final merge.
+ */
+template <bool Random = true>
+class LotsOfDataMultiLevelMerge : public LotsOfDataLittleMemory<Random> {
+public:
+    void run() {
+        const auto originalFanIn = gMaxSorterMergeFanIn.load();
+        const auto originalParallelism = gSorterMergeParallelism.load();
+        ON_BLOCK_EXIT([&] {
+            gMaxSorterMergeFanIn.store(originalFanIn);
+            gSorterMergeParallelism.store(originalParallelism);
+        });
+        gMaxSorterMergeFanIn.store(4);
+        gSorterMergeParallelism.store(3);
+
+        const auto passesBefore = sorterStats.intermediateMergePasses.get();
+        LotsOfDataLittleMemory<Random>::run();
+        ASSERT_GT(sorterStats.intermediateMergePasses.get(), passesBefore);
+    }
+};
 
 template <long long Limit, bool Random = true>
 class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
@@ -651,6 +674,8 @@ public:
         add<SorterTests::Dupes>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/false>>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/true>>();
+        add<SorterTests::LotsOfDataMultiLevelMerge</*random=*/false>>();
+        add<SorterTests::LotsOfDataMultiLevelMerge</*random=*/true>>();
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/false>>();     // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/true>>();      // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/false>>();   // fits in mem
@@ -171,6 +171,15 @@ void JournalFlusher::triggerJournalFlush() {
     }
 }
 
+SharedSemiFuture<void> JournalFlusher::triggerJournalFlushAndGetFuture() {
+    stdx::lock_guard<Latch> lk(_stateMutex);
+    if (!_flushJournalNow) {
+        _flushJournalNow = true;
+        _flushJournalNowCV.notify_one();
+    }
+    return _nextSharedPromise->getFuture();
+}
+
 void JournalFlusher::waitForJournalFlush() {
     while (true) {
         try {
@@ -194,16 +203,8 @@ void JournalFlusher::interruptJournalFlusherForReplStateChange() {
 }
 
 void JournalFlusher::_waitForJournalFlushNoRetry() {
-    auto myFuture = [&]() {
-        stdx::unique_lock<Latch> lk(_stateMutex);
-        if (!_flushJournalNow) {
-            _flushJournalNow = true;
-            _flushJournalNowCV.notify_one();
-        }
-        return _nextSharedPromise->getFuture();
-    }();
     // Throws on error if the flusher round is interrupted or the flusher thread is shutdown.
-    myFuture.get();
+    triggerJournalFlushAndGetFuture().get();
 }
 
 }  // namespace mongo
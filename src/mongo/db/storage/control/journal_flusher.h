@@ -91,6 +91,17 @@ public:
      */
     void triggerJournalFlush();
 
+    /**
+     * Signals an immediate journal flush and returns a future that becomes ready once a flush
+     * round that started after this call completes, so that every write made before this call is
+     * durable. Unlike waitForJournalFlush(), does not block, and a caller that already triggered
+     * a flush does not need to wait for an additional round.
+     *
+     * The future is set with an error if the round is interrupted by a replication state change or
+     * the flusher thread is shut down.
+     */
+    SharedSemiFuture<void> triggerJournalFlushAndGetFuture();
+
     /**
      * Signals an immediate journal flush and waits for it to complete before returning.
      *
@@ -47,10 +47,12 @@
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/storage_engine_impl.h"
 #include "mongo/db/storage/storage_engine_test_fixture.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/storage/storage_repair_observer.h"
 #include "mongo/unittest/barrier.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/periodic_runner_factory.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -131,6 +133,39 @@ TEST_F(StorageEngineTest, LoadCatalogDropsOrphansAfterUncleanShutdown) {
     ASSERT(!collectionExists(opCtx.get(), collNs));
 }
 
+TEST_F(StorageEngineTest, LoadCatalogOpensCollectionsOnMultipleThreads) {
+    const auto originalThreadCount = gLoadCatalogThreadCount;
+    gLoadCatalogThreadCount = 4;
+    ON_BLOCK_EXIT([&] { gLoadCatalogThreadCount = originalThreadCount; });
+
+    auto opCtx = cc().makeOperationContext();
+
+    std::vector<NamespaceString> collNamespaces;
+    for (int i = 0; i < 10; ++i) {
+        collNamespaces.emplace_back("db.coll" + std::to_string(i));
+        ASSERT_OK(createCollection(opCtx.get(), collNamespaces.back()).getStatus());
+    }
+
+    {
+        Lock::GlobalWrite writeLock(opCtx.get(), Date_t::max(), Lock::InterruptBehavior::kThrow);
+        _storageEngine->closeCatalog(opCtx.get());
+        ASSERT_FALSE(CollectionCatalog::get(opCtx.get())
+                         .lookupCollectionByNamespace(opCtx.get(), collNamespaces.front()));
+
+        auto loadingFromUncleanShutdown = false;
+        _storageEngine->loadCatalog(opCtx.get(), loadingFromUncleanShutdown);
+    }
+
+    // Every collection is registered with an open record store.
+    Lock::GlobalLock lk(opCtx.get(), MODE_IS);
+    for (const auto& nss : collNamespaces) {
+        auto collection =
+            CollectionCatalog::get(opCtx.get()).lookupCollectionByNamespace(opCtx.get(), nss);
+        ASSERT(collection);
+        ASSERT(collection->getRecordStore());
+    }
+}
+
 TEST_F(StorageEngineTest, ReconcileDropsTemporary) {
     auto opCtx = cc().makeOperationContext();
 
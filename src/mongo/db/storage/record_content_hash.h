@@ -0,0 +1,51 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <third_party/murmurhash3/MurmurHash3.h>
+
+namespace mongo {
+
+/**
+ * Hashes the data of a single record. The content hash of a record store is the sum of this over
+ * all of its records, modulo 2^64. It does not depend on the order of the records, so two record
+ * stores with the same contents have the same content hash, and it is adjusted in constant time as
+ * records are inserted, updated and deleted.
+ */
+inline uint64_t hashRecordContent(const char* data, size_t size) {
+    uint64_t hash[2];
+    MurmurHash3_x64_128(data, static_cast<int>(size), 0, hash);
+    return hash[0];
+}
+
+}  // namespace mongo
@@ -504,6 +504,28 @@ public:
                                         long long numRecords,
                                         long long dataSize) = 0;
 
+    /**
+     * Returns true if this record store maintains a content hash as records are written, even if
+     * the hash is not currently trusted. Only then is it worth computing one during validation.
+     */
+    virtual bool maintainsContentHash() const {
+        return false;
+    }
+
+    /**
+     * Returns the content hash of this record store, as defined by hashRecordContent(), if it is
+     * maintained as records are written. Returns boost::none if it is not maintained, or if it has
+     * not been since the record store was empty or last validated.
+     */
+    virtual boost::optional<uint64_t> contentHash(OperationContext* opCtx) const {
+        return boost::none;
+    }
+
+    /**
+     * Called after a full validation with the content hash recomputed from every record.
+     */
+    virtual void updateContentHashAfterRepair(OperationContext* opCtx, uint64_t contentHash) {}
+
     /**
      * used to support online change oplog size.
      */
@@ -529,6 +551,14 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    /**
+     * Returns true if this oplog keeps entries in tables other than its own, which versions
+     * without partitioned oplogs do not read.
+     */
+    virtual bool hasOplogSegments() const {
+        return false;
+    }
+
     /**
      * This should only be called if StorageEngine::supportsOplogStones() is true.
      * Storage engines supporting oplog stones must implement this function.
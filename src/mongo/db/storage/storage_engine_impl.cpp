@@ -32,6 +32,7 @@
 #include "mongo/db/storage/storage_engine_impl.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "mongo/db/catalog/catalog_control.h"
 #include "mongo/db/catalog/collection_catalog.h"
@@ -44,15 +45,18 @@
 #include "mongo/db/storage/durable_catalog_feature_tracker.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/kv/temporary_kv_record_store.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/storage/storage_repair_observer.h"
 #include "mongo/db/storage/storage_util.h"
 #include "mongo/db/storage/two_phase_index_build_knobs_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 #define LOGV2_FOR_RECOVERY(ID, DLEVEL, MESSAGE, ...) \
     LOGV2_DEBUG_OPTIONS(ID, DLEVEL, {logv2::LogComponent::kStorageRecovery}, MESSAGE, ##__VA_ARGS__)
@@ -67,6 +71,7 @@ MONGO_FAIL_POINT_DEFINE(failToParseResumeIndexInfo);
 namespace {
 const std::string catalogInfo = "_mdb_catalog";
 const auto kCatalogLogLevel = logv2::LogSeverity::Debug(2);
+const auto kLoadCatalogProgressIntervalSecs = 10;
 }  // namespace
 
 StorageEngineImpl::StorageEngineImpl(OperationContext* opCtx,
@@ -206,7 +211,8 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx, bool loadingFromUnc
         }
     }
 
-    KVPrefix maxSeenPrefix = KVPrefix::kNotPrefixed;
+    std::vector<DurableCatalog::Entry> entriesToInit;
+    entriesToInit.reserve(catalogEntries.size());
     for (DurableCatalog::Entry entry : catalogEntries) {
         if (loadingFromUncleanShutdownOrRepair) {
             // If we are loading the catalog after an unclean shutdown or during repair, it's
@@ -245,9 +251,7 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx, bool loadingFromUnc
             }
         }
 
-        _initCollection(opCtx, entry.catalogId, entry.nss, _options.forRepair);
-        auto maxPrefixForCollection = _catalog->getMetaData(opCtx, entry.catalogId).getMaxPrefix();
-        maxSeenPrefix = std::max(maxSeenPrefix, maxPrefixForCollection);
+        entriesToInit.push_back(entry);
 
         if (entry.nss.isOrphanCollection()) {
             LOGV2(22248,
@@ -257,7 +261,7 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx, bool loadingFromUnc
         }
     }
 
-    KVPrefix::setLargestPrefix(maxSeenPrefix);
+    KVPrefix::setLargestPrefix(_initCollections(opCtx, entriesToInit));
     opCtx->recoveryUnit()->abandonSnapshot();
 }
 
@@ -271,7 +275,15 @@ void StorageEngineImpl::_initCollection(OperationContext* opCtx,
             md.options.uuid);
 
     auto ident = _catalog->getEntry(catalogId).ident;
+    _openCollection(opCtx, catalogId, nss, ident, md, forRepair);
+}
 
+void StorageEngineImpl::_openCollection(OperationContext* opCtx,
+                                        RecordId catalogId,
+                                        const NamespaceString& nss,
+                                        const std::string& ident,
+                                        const BSONCollectionCatalogEntry::MetaData& md,
+                                        bool forRepair) {
     std::unique_ptr<RecordStore> rs;
     if (forRepair) {
         // Using a NULL rs since we don't want to open this record store before it has been
@@ -282,7 +294,7 @@ void StorageEngineImpl::_initCollection(OperationContext* opCtx,
         invariant(rs);
     }
 
-    auto uuid = _catalog->getCollectionOptions(opCtx, catalogId).uuid.get();
+    auto uuid = md.options.uuid.get();
 
     auto collectionFactory = Collection::Factory::get(getGlobalServiceContext());
     auto collection = collectionFactory->make(opCtx, nss, catalogId, uuid, std::move(rs));
@@ -291,6 +303,120 @@ void StorageEngineImpl::_initCollection(OperationContext* opCtx,
     collectionCatalog.registerCollection(uuid, std::move(collection));
 }
 
+KVPrefix StorageEngineImpl::_initCollections(OperationContext* opCtx,
+                                             const std::vector<DurableCatalog::Entry>& entries) {
+    invariant(opCtx->lockState()->isW());
+
+    Timer timer;
+    Mutex mutex = MONGO_MAKE_LATCH("StorageEngineImpl::_initCollections::mutex");
+    size_t numInitialized = 0;
+    Timer progressTimer;
+    auto onCollectionInitialized = [&] {
+        stdx::lock_guard<Latch> lk(mutex);
+        if (++numInitialized < entries.size() &&
+            progressTimer.seconds() >= kLoadCatalogProgressIntervalSecs) {
+            LOGV2(4972508,
+                  "Loading catalog",
+                  "numCollectionsLoaded"_attr = numInitialized,
+                  "numCollections"_attr = entries.size(),
+                  "durationMillis"_attr = timer.millis());
+            progressTimer.reset();
+        }
+    };
+
+    // Reading the durable catalog needs the locks this thread holds, so the metadata of every
+    // collection is read here and only opening the record stores is spread across threads.
+    KVPrefix maxSeenPrefix = KVPrefix::kNotPrefixed;
+    std::vector<std::pair<const DurableCatalog::Entry*, BSONCollectionCatalogEntry::MetaData>>
+        remaining;
+    remaining.reserve(entries.size());
+    for (const auto& entry : entries) {
+        BSONCollectionCatalogEntry::MetaData md = _catalog->getMetaData(opCtx, entry.catalogId);
+        uassert(ErrorCodes::MustDowngrade,
+                str::stream() << "Collection does not have UUID in KVCatalog. Collection: "
+                              << entry.nss,
+                md.options.uuid);
+        maxSeenPrefix = std::max(maxSeenPrefix, md.getMaxPrefix());
+
+        // Opening the oplog also sets up its truncation and visibility machinery, so it is kept
+        // on this thread.
+        if (entry.nss.isOplog()) {
+            _openCollection(
+                opCtx, entry.catalogId, entry.nss, entry.ident, md, _options.forRepair);
+            onCollectionInitialized();
+        } else {
+            remaining.emplace_back(&entry, std::move(md));
+        }
+    }
+
+    const auto numThreads =
+        std::min(static_cast<size_t>(gLoadCatalogThreadCount), remaining.size());
+    if (numThreads <= 1 || _options.forRepair) {
+        for (const auto& [entry, md] : remaining) {
+            _openCollection(
+                opCtx, entry->catalogId, entry->nss, entry->ident, md, _options.forRepair);
+            onCollectionInitialized();
+        }
+    } else {
+        // Opening a record store and registering a collection do not read the durable catalog.
+        // The workers therefore take no locks, which they could not get while this thread holds
+        // the global lock exclusively. Once a collection fails to open, the workers skip the rest.
+        Status firstError = Status::OK();
+        auto hasFailed = [&] {
+            stdx::lock_guard<Latch> lk(mutex);
+            return !firstError.isOK();
+        };
+
+        ThreadPool::Options options;
+        options.threadNamePrefix = "LoadCatalog-";
+        options.poolName = "LoadCatalogThreadPool";
+        options.maxThreads = options.minThreads = numThreads;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName);
+        };
+        ThreadPool pool(options);
+        pool.startup();
+
+        for (const auto& collToOpen : remaining) {
+            pool.schedule([&, &collToOpen = collToOpen](auto status) {
+                invariant(status);
+                if (hasFailed()) {
+                    return;
+                }
+
+                const auto& [entry, md] = collToOpen;
+                try {
+                    auto workerOpCtx = cc().makeOperationContext();
+                    _openCollection(workerOpCtx.get(),
+                                    entry->catalogId,
+                                    entry->nss,
+                                    entry->ident,
+                                    md,
+                                    _options.forRepair);
+                } catch (const DBException& ex) {
+                    stdx::lock_guard<Latch> lk(mutex);
+                    if (firstError.isOK()) {
+                        firstError = ex.toStatus();
+                    }
+                    return;
+                }
+                onCollectionInitialized();
+            });
+        }
+
+        pool.shutdown();
+        pool.join();
+
+        uassertStatusOK(firstError);
+    }
+
+    LOGV2(4972509,
+          "Finished loading catalog",
+          "numCollections"_attr = entries.size(),
+          "durationMillis"_attr = timer.millis());
+    return maxSeenPrefix;
+}
+
 void StorageEngineImpl::closeCatalog(OperationContext* opCtx) {
     dassert(opCtx->lockState()->isLocked());
     if (shouldLog(::mongo::logv2::LogComponent::kStorageRecovery, kCatalogLogLevel)) {
@@ -33,6 +33,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/base/string_data.h"
@@ -369,6 +370,25 @@ private:
                          const NamespaceString& nss,
                          bool forRepair);
 
+    /**
+     * Opens the record store of a collection whose catalog metadata is 'md' and registers the
+     * collection in the CollectionCatalog. Does not read the durable catalog, so it needs no locks.
+     */
+    void _openCollection(OperationContext* opCtx,
+                         RecordId catalogId,
+                         const NamespaceString& nss,
+                         const std::string& ident,
+                         const BSONCollectionCatalogEntry::MetaData& md,
+                         bool forRepair);
+
+    /**
+     * Initializes the collections of 'entries', opening their record stores with up to
+     * 'loadCatalogThreadCount' threads, and returns the largest prefix any of them uses. Requires
+     * the global exclusive lock.
+     */
+    KVPrefix _initCollections(OperationContext* opCtx,
+                              const std::vector<DurableCatalog::Entry>& entries);
+
     Status _dropCollectionsNoTimestamp(OperationContext* opCtx,
                                        std::vector<NamespaceString>& toDrop);
 
@@ -114,6 +114,10 @@ public:
                                                  params.readOnly);
         kv->setRecordStoreExtraOptions(wiredTigerGlobalOptions.collectionConfig);
         kv->setSortedDataInterfaceExtraOptions(wiredTigerGlobalOptions.indexConfig);
+        if (lockFile && lockFile->createdByUncleanShutdown()) {
+            // The size storer may hold content hashes that miss the latest writes.
+            kv->discardContentHashes();
+        }
 
         // We must only add the server parameters to the global registry once during unit testing.
         static int setupCountForUnitTests = 0;
@@ -41,9 +41,11 @@
 #define NVALGRIND
 #endif
 
+#include <algorithm>
 #include <fmt/format.h>
 #include <iomanip>
 #include <memory>
+#include <set>
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 
@@ -83,6 +85,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_segments.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
@@ -301,6 +304,18 @@ Status OpenReadTransactionParam::setFromString(const std::string& str) {
     return _data->resize(num);
 }
 
+Status onUpdateConcurrentTransactionsPriorityOrder(const bool& enabled) {
+    openReadTransaction.setPriorityOrderEnabled(enabled);
+    openWriteTransaction.setPriorityOrderEnabled(enabled);
+    return Status::OK();
+}
+
+Status onUpdateConcurrentTransactionsMaxPriorityWait(const std::int32_t& maxWaitMillis) {
+    openReadTransaction.setMaxPriorityWait(Milliseconds(maxWaitMillis));
+    openWriteTransaction.setMaxPriorityWait(Milliseconds(maxWaitMillis));
+    return Status::OK();
+}
+
 StringData WiredTigerKVEngine::kTableUriPrefix = "table:"_sd;
 
 WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
@@ -517,6 +532,17 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
 
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+    openReadTransaction.setPriorityLaneEnabled(gWiredTigerConcurrentTransactionsPriorityLane);
+    openWriteTransaction.setPriorityLaneEnabled(gWiredTigerConcurrentTransactionsPriorityLane);
+    openReadTransaction.setSheddingEnabled(gWiredTigerConcurrentTransactionsShedLateOperations);
+    openWriteTransaction.setSheddingEnabled(gWiredTigerConcurrentTransactionsShedLateOperations);
+    onUpdateConcurrentTransactionsPriorityOrder(
+        gWiredTigerConcurrentTransactionsPriorityOrder.load()).ignore();
+    onUpdateConcurrentTransactionsMaxPriorityWait(
+        gWiredTigerConcurrentTransactionsMaxPriorityWaitMillis.load()).ignore();
+    if (gWiredTigerAdaptiveConcurrentTransactions) {
+        _startTicketControllers();
+    }
 
     _runTimeConfigParam.reset(new WiredTigerEngineRuntimeConfigParameter(
         "wiredTigerEngineRuntimeConfig", ServerParameterType::kRuntimeOnly));
@@ -533,6 +559,49 @@ WiredTigerKVEngine::~WiredTigerKVEngine() {
     _sessionCache.reset(nullptr);
 }
 
+void WiredTigerKVEngine::_startTicketControllers() {
+    auto runner = getGlobalServiceContext()->getPeriodicRunner();
+    if (!runner) {
+        // Standalone tools and unit tests run the storage engine without a PeriodicRunner.
+        return;
+    }
+
+    const int minTickets = gWiredTigerAdaptiveConcurrentTransactionsMin;
+    const int maxTickets = gWiredTigerAdaptiveConcurrentTransactionsMax;
+    uassert(ErrorCodes::BadValue,
+            str::stream() << "wiredTigerAdaptiveConcurrentTransactionsMin (" << minTickets
+                          << ") must not exceed wiredTigerAdaptiveConcurrentTransactionsMax ("
+                          << maxTickets << ")",
+            minTickets <= maxTickets);
+
+    AdaptiveTicketController::Options options;
+    options.minTickets = minTickets;
+    options.maxTickets = maxTickets;
+    for (auto holder : {&openReadTransaction, &openWriteTransaction}) {
+        uassertStatusOK(holder->resize(std::clamp(holder->outof(), minTickets, maxTickets)));
+    }
+    _readTicketController =
+        std::make_unique<AdaptiveTicketController>(&openReadTransaction, options);
+    _writeTicketController =
+        std::make_unique<AdaptiveTicketController>(&openWriteTransaction, options);
+
+    _ticketControllerJob = runner->makeJob(
+        {"AdaptiveConcurrentTransactions",
+         [this](Client* client) {
+             stdx::lock_guard<Latch> lk(_ticketControllerMutex);
+             const auto now = Date_t::now();
+             _readTicketController->adjust(now);
+             _writeTicketController->adjust(now);
+         },
+         Milliseconds(gWiredTigerAdaptiveConcurrentTransactionsIntervalMillis)});
+    _ticketControllerJob.start();
+
+    LOGV2(4972400,
+          "Sizing concurrent transactions to the workload",
+          "minTickets"_attr = minTickets,
+          "maxTickets"_attr = maxTickets);
+}
+
 void WiredTigerKVEngine::notifyStartupComplete() {
     WiredTigerUtil::notifyStartupComplete();
 }
@@ -544,6 +613,14 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openWriteTransaction.used());
         bbb.append("available", openWriteTransaction.available());
         bbb.append("totalTickets", openWriteTransaction.outof());
+        bbb.append("waiting", openWriteTransaction.waiting());
+        bbb.append("borrowed", openWriteTransaction.numBorrowed());
+        bbb.append("shed", openWriteTransaction.numShed());
+        stdx::lock_guard<Latch> lk(_ticketControllerMutex);
+        if (_writeTicketController) {
+            BSONObjBuilder adaptive(bbb.subobjStart("adaptive"));
+            _writeTicketController->appendStats(&adaptive);
+        }
         bbb.done();
     }
     {
@@ -551,6 +628,14 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openReadTransaction.used());
         bbb.append("available", openReadTransaction.available());
         bbb.append("totalTickets", openReadTransaction.outof());
+        bbb.append("waiting", openReadTransaction.waiting());
+        bbb.append("borrowed", openReadTransaction.numBorrowed());
+        bbb.append("shed", openReadTransaction.numShed());
+        stdx::lock_guard<Latch> lk(_ticketControllerMutex);
+        if (_readTicketController) {
+            BSONObjBuilder adaptive(bbb.subobjStart("adaptive"));
+            _readTicketController->appendStats(&adaptive);
+        }
         bbb.done();
     }
     bb.done();
@@ -648,6 +733,9 @@ void WiredTigerKVEngine::_openWiredTiger(const std::string& path, const std::str
 
 void WiredTigerKVEngine::cleanShutdown() {
     LOGV2(22317, "WiredTigerKVEngine shutting down");
+    if (_ticketControllerJob.isValid()) {
+        _ticketControllerJob.stop();
+    }
     WiredTigerUtil::resetTableLoggingInfo();
 
     if (!_readOnly)
@@ -1263,6 +1351,12 @@ void WiredTigerKVEngine::setOldestActiveTransactionTimestampCallback(
     _oldestActiveTransactionTimestampCallback = std::move(callback);
 };
 
+void WiredTigerKVEngine::discardContentHashes() {
+    if (_sizeStorer) {
+        _sizeStorer->discardContentHashes();
+    }
+}
+
 RecoveryUnit* WiredTigerKVEngine::newRecoveryUnit() {
     return new WiredTigerRecoveryUnit(_sessionCache.get());
 }
@@ -1856,6 +1950,18 @@ std::vector<std::string> WiredTigerKVEngine::getAllIdents(OperationContext* opCt
 
     fassert(50663, ret == WT_NOTFOUND);
 
+    // The segments of a partitioned oplog belong to the oplog's ident rather than being idents of
+    // their own.
+    const std::set<std::string> allIdents(all.begin(), all.end());
+    all.erase(std::remove_if(all.begin(),
+                             all.end(),
+                             [&](const std::string& ident) {
+                                 auto owner =
+                                     WiredTigerRecordStore::OplogSegments::getOwningIdent(ident);
+                                 return owner && allIdents.count(owner->toString());
+                             }),
+              all.end());
+
     return all;
 }
 
@@ -2108,6 +2214,9 @@ StatusWith<Timestamp> WiredTigerKVEngine::recoverToStableTimestamp(OperationCont
     }
 
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
+    // Rolling back reverts records without telling their record stores, so no stored content hash
+    // can be trusted, even for collections whose record counts rollback does not need to correct.
+    discardContentHashes();
 
     return {stableTimestamp};
 }
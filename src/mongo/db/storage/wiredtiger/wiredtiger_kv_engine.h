@@ -46,7 +46,9 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/platform/mutex.h"
+#include "mongo/util/concurrency/adaptive_ticket_controller.h"
 #include "mongo/util/elapsed_tracker.h"
+#include "mongo/util/periodic_runner.h"
 
 namespace mongo {
 
@@ -57,6 +59,13 @@ class WiredTigerSessionCache;
 class WiredTigerSizeStorer;
 class WiredTigerEngineRuntimeConfigParameter;
 
+/**
+ * Apply the ordering of the waiters for read and write transaction tickets when it is changed at
+ * runtime.
+ */
+Status onUpdateConcurrentTransactionsPriorityOrder(const bool& enabled);
+Status onUpdateConcurrentTransactionsMaxPriorityWait(const std::int32_t& maxWaitMillis);
+
 struct WiredTigerFileVersion {
     // MongoDB 4.4+ will not open on datafiles left behind by 4.2.5 and earlier. MongoDB 4.4
     // shutting down in FCV 4.2 will leave data files that 4.2.6+ will understand
@@ -130,6 +139,13 @@ public:
     void setOldestActiveTransactionTimestampCallback(
         StorageEngine::OldestActiveTransactionTimestampCallback callback) override;
 
+    /**
+     * Stops trusting the collection content hashes held by the size storer, including those of a
+     * size storer opened after rolling back to the stable timestamp. Must be called before any
+     * record store is opened. Rolling back to the stable timestamp calls this itself.
+     */
+    void discardContentHashes();
+
     RecoveryUnit* newRecoveryUnit() override;
 
     Status createRecordStore(OperationContext* opCtx,
@@ -430,6 +446,12 @@ private:
 
     std::uint64_t _getCheckpointTimestamp() const;
 
+    /**
+     * Starts the periodic job that sizes the read and write transaction ticket holders to the
+     * workload, when 'wiredTigerAdaptiveConcurrentTransactions' is enabled.
+     */
+    void _startTicketControllers();
+
     mutable Mutex _oldestActiveTransactionTimestampCallbackMutex =
         MONGO_MAKE_LATCH("::_oldestActiveTransactionTimestampCallbackMutex");
     StorageEngine::OldestActiveTransactionTimestampCallback
@@ -499,5 +521,13 @@ private:
     mutable Mutex _highestDurableTimestampMutex =
         MONGO_MAKE_LATCH("WiredTigerKVEngine::_highestDurableTimestampMutex");
     mutable unsigned long long _highestSeenDurableTimestamp = StorageEngine::kMinimumTimestamp;
+
+    // Protects the ticket controllers, which are adjusted by '_ticketControllerJob' and read by
+    // serverStatus.
+    mutable Mutex _ticketControllerMutex =
+        MONGO_MAKE_LATCH("WiredTigerKVEngine::_ticketControllerMutex");
+    std::unique_ptr<AdaptiveTicketController> _readTicketController;
+    std::unique_ptr<AdaptiveTicketController> _writeTicketController;
+    PeriodicJobAnchor _ticketControllerJob;
 };
 }  // namespace mongo
@@ -44,13 +44,16 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_test_fixture.h"
 #include "mongo/db/storage/checkpointer.h"
+#include "mongo/db/storage/record_content_hash.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/logv2/log.h"
 #include "mongo/unittest/log_test.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -391,6 +394,53 @@ TEST_F(WiredTigerKVEngineTest, IdentDrop) {
     ASSERT(boost::filesystem::exists(renamedFilePath));
 }
 
+TEST_F(WiredTigerKVEngineTest, RecoverToStableTimestampDiscardsContentHashes) {
+    gWiredTigerCollectionContentHashes = true;
+    ON_BLOCK_EXIT([] { gWiredTigerCollectionContentHashes = false; });
+
+    auto opCtxPtr = makeOperationContext();
+
+    NamespaceString nss("a.b");
+    std::string ident = "collection-content-hash";
+    CollectionOptions defaultCollectionOptions;
+    ASSERT_OK(
+        _engine->createRecordStore(opCtxPtr.get(), nss.ns(), ident, defaultCollectionOptions));
+    auto rs = _engine->getRecordStore(opCtxPtr.get(), nss.ns(), ident, defaultCollectionOptions);
+
+    _engine->setInitialDataTimestamp(Timestamp(1, 1));
+
+    RecordId id;
+    {
+        WriteUnitOfWork uow(opCtxPtr.get());
+        id = unittest::assertGet(rs->insertRecord(opCtxPtr.get(), "abc", 4, Timestamp(5, 1)));
+        uow.commit();
+    }
+    _engine->setStableTimestamp(Timestamp(10, 1), false);
+
+    // An update leaves the record count alone, so rollback does not correct the count of the
+    // record store it is rolled back from.
+    {
+        WriteUnitOfWork uow(opCtxPtr.get());
+        ASSERT_OK(opCtxPtr->recoveryUnit()->setTimestamp(Timestamp(20, 1)));
+        ASSERT_OK(rs->updateRecord(opCtxPtr.get(), id, "def", 4));
+        uow.commit();
+    }
+    ASSERT_EQ(hashRecordContent("def", 4), *rs->contentHash(opCtxPtr.get()));
+
+    rs.reset();
+    opCtxPtr = makeOperationContext();
+    ASSERT_OK(_engine->recoverToStableTimestamp(opCtxPtr.get()).getStatus());
+
+    opCtxPtr = makeOperationContext();
+    rs = _engine->getRecordStore(opCtxPtr.get(), nss.ns(), ident, defaultCollectionOptions);
+    ASSERT_EQ(std::string("abc"), rs->dataFor(opCtxPtr.get(), id).data());
+    ASSERT_FALSE(rs->contentHash(opCtxPtr.get()));
+
+    // Only a recomputed hash is trusted again.
+    rs->updateContentHashAfterRepair(opCtxPtr.get(), hashRecordContent("abc", 4));
+    ASSERT_EQ(hashRecordContent("abc", 4), *rs->contentHash(opCtxPtr.get()));
+}
+
 std::unique_ptr<KVHarnessHelper> makeHelper() {
     return std::make_unique<WiredTigerKVHarnessHelper>();
 }
@@ -36,6 +36,7 @@
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/mutex.h"
@@ -45,6 +46,7 @@
 namespace mongo {
 
 MONGO_FAIL_POINT_DEFINE(WTPauseOplogVisibilityUpdateLoop);
+MONGO_FAIL_POINT_DEFINE(WTPauseInlineOplogVisibilityUpdate);
 
 // Arbitrary. Using the storageGlobalParams.journalCommitIntervalMs default, which used to
 // dynamically control the visibility thread's delay back when the visibility thread also flushed
@@ -77,10 +79,10 @@ void WiredTigerOplogManager::startVisibilityThread(OperationContext* opCtx,
     // Need to obtain the mutex before starting the thread, as otherwise it may race ahead
     // see _shuttingDown as true and quit prematurely.
     stdx::lock_guard<Latch> lk(_oplogVisibilityStateMutex);
-    _oplogVisibilityThread = stdx::thread(&WiredTigerOplogManager::_updateOplogVisibilityLoop,
-                                          this,
-                                          WiredTigerRecoveryUnit::get(opCtx)->getSessionCache(),
-                                          oplogRecordStore);
+    _sessionCache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
+    _oplogRecordStore = oplogRecordStore;
+    _oplogVisibilityThread = stdx::thread(
+        &WiredTigerOplogManager::_updateOplogVisibilityLoop, this, _sessionCache, oplogRecordStore);
 
     _isRunning = true;
     _shuttingDown = false;
@@ -88,10 +90,15 @@ void WiredTigerOplogManager::startVisibilityThread(OperationContext* opCtx,
 
 void WiredTigerOplogManager::haltVisibilityThread() {
     {
-        stdx::lock_guard<Latch> lk(_oplogVisibilityStateMutex);
+        stdx::unique_lock<Latch> lk(_oplogVisibilityStateMutex);
         invariant(_isRunning);
         _shuttingDown = true;
         _isRunning = false;
+
+        // The oplog record store may be destroyed once we return, so let any inline update that
+        // is still notifying its capped waiters finish first.
+        _inlineVisibilityUpdateFinishedCV.wait(lk,
+                                               [&] { return !_inlineVisibilityUpdateInProgress; });
     }
 
     if (_oplogVisibilityThread.joinable()) {
@@ -101,6 +108,10 @@ void WiredTigerOplogManager::haltVisibilityThread() {
 }
 
 void WiredTigerOplogManager::triggerOplogVisibilityUpdate() {
+    if (gWiredTigerInlineOplogVisibility.load() && _tryUpdateOplogVisibilityInline()) {
+        return;
+    }
+
     stdx::lock_guard<Latch> lk(_oplogVisibilityStateMutex);
     if (!_triggerOplogVisibilityUpdate) {
         _triggerOplogVisibilityUpdate = true;
@@ -108,6 +119,42 @@ void WiredTigerOplogManager::triggerOplogVisibilityUpdate() {
     }
 }
 
+bool WiredTigerOplogManager::_tryUpdateOplogVisibilityInline() {
+    {
+        stdx::lock_guard<Latch> lk(_oplogVisibilityStateMutex);
+        if (!_isRunning || _shuttingDown || _inlineVisibilityUpdateInProgress ||
+            MONGO_unlikely(WTPauseOplogVisibilityUpdateLoop.shouldFail())) {
+            return false;
+        }
+        _inlineVisibilityUpdateInProgress = true;
+    }
+
+    WTPauseInlineOplogVisibilityUpdate.pauseWhileSet();
+
+    // The all_durable timestamp is queried after our commit, so it either covers our write or
+    // stops at a hole behind it. In the latter case, the commit that fills the hole will advance
+    // visibility past our write.
+    const uint64_t newTimestamp = _sessionCache->getKVEngine()->getAllDurableTimestamp().asULL();
+
+    bool advanced = false;
+    {
+        stdx::lock_guard<Latch> lk(_oplogVisibilityStateMutex);
+        if (newTimestamp > getOplogReadTimestamp()) {
+            _setOplogReadTimestamp(lk, newTimestamp);
+            advanced = true;
+        }
+    }
+
+    if (advanced) {
+        _oplogRecordStore->notifyCappedWaitersIfNeeded();
+    }
+
+    stdx::lock_guard<Latch> lk(_oplogVisibilityStateMutex);
+    _inlineVisibilityUpdateInProgress = false;
+    _inlineVisibilityUpdateFinishedCV.notify_all();
+    return true;
+}
+
 void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
     const WiredTigerRecordStore* oplogRecordStore, OperationContext* opCtx) {
     invariant(opCtx->lockState()->isNoop() || !opCtx->lockState()->inAWriteUnitOfWork());
@@ -44,7 +44,9 @@ class WiredTigerSessionCache;
  * Manages oplog visibility.
  *
  * On demand, queries WiredTiger's all_durable timestamp value and updates the oplog read timestamp.
- * This is done asynchronously on a thread that startVisibilityThread() will set up.
+ * This is done asynchronously on a thread that startVisibilityThread() will set up. When
+ * 'wiredTigerInlineOplogVisibility' is enabled, the committing thread performs the update itself
+ * instead, falling back to the visibility thread only if another inline update is in progress.
  *
  * The WT all_durable timestamp is the in-memory timestamp behind which there are no oplog holes
  * in-memory. Note, all_durable is the timestamp that has no holes in-memory, which may NOT be
@@ -75,7 +77,9 @@ public:
     }
 
     /**
-     * Signals the oplog visibility thread to update the oplog read timestamp.
+     * Updates the oplog read timestamp on the calling thread if inline visibility updates are
+     * enabled and no other inline update is in progress; otherwise signals the oplog visibility
+     * thread to do so.
      */
     void triggerOplogVisibilityUpdate();
 
@@ -106,18 +110,32 @@ private:
     void _updateOplogVisibilityLoop(WiredTigerSessionCache* sessionCache,
                                     WiredTigerRecordStore* oplogRecordStore);
 
+    /**
+     * Queries the all_durable timestamp and publishes it as the oplog read timestamp on the calling
+     * thread. Returns false without doing anything if the update must be left to the visibility
+     * thread instead.
+     */
+    bool _tryUpdateOplogVisibilityInline();
+
     void _setOplogReadTimestamp(WithLock, uint64_t newTimestamp);
 
     AtomicWord<unsigned long long> _oplogReadTimestamp{0};
 
     stdx::thread _oplogVisibilityThread;
 
+    // Set by startVisibilityThread() for the inline visibility updates.
+    WiredTigerSessionCache* _sessionCache = nullptr;
+    WiredTigerRecordStore* _oplogRecordStore = nullptr;
+
     // Signaled to trigger the oplog visibility thread to run.
     mutable stdx::condition_variable _oplogVisibilityThreadCV;
 
     // Signaled when oplog visibility has been updated.
     mutable stdx::condition_variable _oplogEntriesBecameVisibleCV;
 
+    // Signaled when an inline visibility update finishes, so that shutdown can wait for it.
+    stdx::condition_variable _inlineVisibilityUpdateFinishedCV;
+
     // Protects the state below.
     mutable Mutex _oplogVisibilityStateMutex =
         MONGO_MAKE_LATCH("WiredTigerOplogManager::_oplogVisibilityStateMutex");
@@ -129,6 +147,10 @@ private:
     // update, per the _opsWaitingForOplogVisibility counter.
     bool _triggerOplogVisibilityUpdate = false;
 
+    // Set while a committing thread is updating the oplog read timestamp inline. Only one thread
+    // does so at a time; concurrent commits defer to the visibility thread.
+    bool _inlineVisibilityUpdateInProgress = false;
+
     // Incremented when a caller is waiting for more of the oplog to become visible, to avoid update
     // delays for batching.
     int64_t _opsWaitingForOplogVisibilityUpdate = 0;
@@ -41,6 +41,7 @@
 #include <memory>
 
 #include "mongo/base/checked_cast.h"
+#include "mongo/base/parse_number.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/catalog/validate_results.h"
@@ -51,21 +52,26 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_options.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/resource_consumption_metrics.h"
 #include "mongo/db/storage/oplog_hack.h"
+#include "mongo/db/storage/record_content_hash.h"
 #include "mongo/db/storage/wiredtiger/oplog_stone_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor_helpers.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_segments.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/random.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/fail_point.h"
@@ -239,6 +245,10 @@ void WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead() {
     // Wait until kill() is called or there are too many oplog stones.
     stdx::unique_lock<Latch> lock(_oplogReclaimMutex);
     while (!_isDead) {
+        if (_segmentRotationRequested) {
+            // Starting the new segment is left to the caller, like reclaiming the excess stones.
+            break;
+        }
         {
             MONGO_IDLE_THREAD_BLOCK;
             stdx::lock_guard<Latch> lk(_mutex);
@@ -262,6 +272,11 @@ void WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead() {
     }
 }
 
+bool WiredTigerRecordStore::OplogStones::takeSegmentRotationRequest() {
+    stdx::lock_guard<Latch> lk(_oplogReclaimMutex);
+    return std::exchange(_segmentRotationRequested, false);
+}
+
 bool WiredTigerRecordStore::OplogStones::hasExcessStones_inlock() const {
     int64_t totalBytes = 0;
     for (auto&& stone : _stones) {
@@ -341,6 +356,12 @@ void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(OperationContext
     OplogStones::Stone stone(_currentRecords.swap(0), _currentBytes.swap(0), lastRecord, wallTime);
     _stones.push_back(stone);
 
+    if (_rs->_oplogSegments && gPartitionedOplog) {
+        // Start a new segment at this stone's boundary so that it can be dropped along with it.
+        _segmentRotationRequested = true;
+        _oplogReclaimCv.notify_one();
+    }
+
     _pokeReclaimThreadIfNeeded();
 }
 
@@ -625,6 +646,317 @@ void WiredTigerRecordStore::OplogStones::adjust(int64_t maxSize) {
     _pokeReclaimThreadIfNeeded();
 }
 
+namespace {
+const char kOplogSegmentInfix[] = "-oplogSegment-";
+
+std::string makeOplogSegmentIdent(StringData oplogIdent, uint64_t sequence) {
+    return str::stream() << oplogIdent << kOplogSegmentInfix << sequence;
+}
+
+/**
+ * Returns the sequence number and ident of each segment table of the oplog with ident 'oplogIdent'.
+ */
+std::vector<std::pair<uint64_t, std::string>> listOplogSegmentTables(OperationContext* opCtx,
+                                                                    StringData oplogIdent) {
+    std::vector<std::pair<uint64_t, std::string>> tables;
+    const std::string prefix = WiredTigerKVEngine::kTableUriPrefix + oplogIdent.toString() +
+        kOplogSegmentInfix;
+
+    WiredTigerCursor cursor("metadata:", WiredTigerSession::kMetadataTableId, false, opCtx);
+    WT_CURSOR* c = cursor.get();
+    c->set_key(c, prefix.c_str());
+    int cmp;
+    int ret = c->search_near(c, &cmp);
+    if (ret == 0 && cmp < 0)
+        ret = c->next(c);
+    for (; ret == 0; ret = c->next(c)) {
+        const char* raw;
+        invariantWTOK(c->get_key(c, &raw));
+        StringData key(raw);
+        if (!key.startsWith(prefix))
+            break;
+
+        uint64_t sequence;
+        if (!NumberParser{}(key.substr(prefix.size()), &sequence).isOK())
+            continue;
+        tables.emplace_back(sequence,
+                            key.substr(WiredTigerKVEngine::kTableUriPrefix.size()).toString());
+    }
+    if (ret != WT_NOTFOUND)
+        invariantWTOK(ret);
+    return tables;
+}
+}  // namespace
+
+WiredTigerRecordStore::OplogSegment::OplogSegment(RecordId start,
+                                                  std::string ident,
+                                                  uint64_t tableId,
+                                                  uint64_t sequence)
+    : start(std::move(start)),
+      ident(std::move(ident)),
+      uri(WiredTigerKVEngine::kTableUriPrefix + this->ident),
+      tableId(tableId),
+      sequence(sequence) {}
+
+boost::optional<StringData> WiredTigerRecordStore::OplogSegments::getOwningIdent(
+    StringData ident) {
+    auto pos = ident.rfind(kOplogSegmentInfix);
+    if (pos == std::string::npos)
+        return boost::none;
+
+    uint64_t sequence;
+    if (!NumberParser{}(ident.substr(pos + strlen(kOplogSegmentInfix)), &sequence).isOK())
+        return boost::none;
+    return ident.substr(0, pos);
+}
+
+bool WiredTigerRecordStore::OplogSegments::hasSegmentTables(OperationContext* opCtx,
+                                                            StringData oplogIdent) {
+    return !listOplogSegmentTables(opCtx, oplogIdent).empty();
+}
+
+WiredTigerRecordStore::OplogSegments::OplogSegments(OperationContext* opCtx,
+                                                    WiredTigerRecordStore* rs)
+    : _rs(rs) {
+    _segments.push_back(
+        std::make_shared<OplogSegment>(RecordId(), rs->getIdent(), rs->_tableId, 0));
+
+    for (auto&& [sequence, ident] : listOplogSegmentTables(opCtx, rs->getIdent())) {
+        _nextSequence = std::max(_nextSequence, sequence + 1);
+
+        // A segment's start is not persisted. Its first record is as good a start as any, since
+        // every later insert has a higher RecordId.
+        const uint64_t tableId = WiredTigerSession::genTableId();
+        boost::optional<RecordId> firstId;
+        {
+            WiredTigerCursor cursor(
+                WiredTigerKVEngine::kTableUriPrefix + ident, tableId, true, opCtx);
+            WT_CURSOR* c = cursor.get();
+            int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->next(c); });
+            if (ret != WT_NOTFOUND) {
+                invariantWTOK(ret);
+                firstId = rs->getKey(c);
+            }
+        }
+
+        if (!firstId) {
+            if (!storageGlobalParams.readOnly) {
+                uassertStatusOK(rs->_kvEngine->dropIdent(opCtx->recoveryUnit(), ident));
+            }
+            continue;
+        }
+        _segments.push_back(std::make_shared<OplogSegment>(*firstId, ident, tableId, sequence));
+    }
+
+    std::sort(_segments.begin(), _segments.end(), [](const SegmentPtr& a, const SegmentPtr& b) {
+        return a->start < b->start;
+    });
+
+    // All segments but the oplog's own table are non-empty, so the newest record, if any, is in
+    // the last one.
+    auto newest = _segments.back();
+    WiredTigerCursor cursor(newest->uri, newest->tableId, true, opCtx);
+    WT_CURSOR* c = cursor.get();
+    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->prev(c); });
+    if (ret != WT_NOTFOUND) {
+        invariantWTOK(ret);
+        _highestRoutedId = rs->getKey(c);
+    }
+
+    LOGV2(4972504,
+          "Loaded the segments of the partitioned oplog",
+          "ident"_attr = rs->getIdent(),
+          "numSegments"_attr = _segments.size());
+}
+
+WiredTigerRecordStore::OplogSegments::SegmentPtr
+WiredTigerRecordStore::OplogSegments::segmentFor(const RecordId& id) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _segmentFor_inlock(lk, id);
+}
+
+WiredTigerRecordStore::OplogSegments::SegmentPtr WiredTigerRecordStore::OplogSegments::first()
+    const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _segments.front();
+}
+
+WiredTigerRecordStore::OplogSegments::SegmentPtr WiredTigerRecordStore::OplogSegments::last()
+    const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _segments.back();
+}
+
+WiredTigerRecordStore::OplogSegments::SegmentPtr WiredTigerRecordStore::OplogSegments::next(
+    const SegmentPtr& segment) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = std::find_if(_segments.begin(), _segments.end(), [&](const SegmentPtr& other) {
+        return segment->start < other->start;
+    });
+    return it == _segments.end() ? nullptr : *it;
+}
+
+WiredTigerRecordStore::OplogSegments::SegmentPtr WiredTigerRecordStore::OplogSegments::prev(
+    const SegmentPtr& segment) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = std::find_if(_segments.rbegin(), _segments.rend(), [&](const SegmentPtr& other) {
+        return other->start < segment->start;
+    });
+    return it == _segments.rend() ? nullptr : *it;
+}
+
+std::vector<WiredTigerRecordStore::OplogSegments::SegmentPtr>
+WiredTigerRecordStore::OplogSegments::getAll() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _segments;
+}
+
+WiredTigerRecordStore::OplogSegments::SegmentPtr WiredTigerRecordStore::OplogSegments::routeInsert(
+    const RecordId& id) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_highestRoutedId < id) {
+        _highestRoutedId = id;
+    }
+    return _segmentFor_inlock(lk, id);
+}
+
+void WiredTigerRecordStore::OplogSegments::rotate(OperationContext* opCtx) {
+    uint64_t sequence;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_highestRoutedId < _segments.back()->start) {
+            // Nothing has been inserted into the newest segment yet.
+            return;
+        }
+        sequence = _nextSequence++;
+    }
+
+    const std::string ident = makeOplogSegmentIdent(_rs->getIdent(), sequence);
+    const std::string uri = WiredTigerKVEngine::kTableUriPrefix + ident;
+    {
+        // Create the segment with the same configuration as the oplog's own table.
+        WiredTigerSession session(_rs->_kvEngine->getConnection());
+        WT_SESSION* s = session.getSession();
+        auto config = uassertStatusOK(WiredTigerUtil::getMetadataCreate(s, _rs->_uri));
+        invariantWTOK(s->create(s, uri.c_str(), config.c_str()));
+    }
+
+    // Inserts routed after this point land in the new segment if they sort after every insert
+    // routed before it, so no record ever moves to a different segment.
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto segment = std::make_shared<OplogSegment>(RecordId(_highestRoutedId.repr() + 1),
+                                                  ident,
+                                                  WiredTigerSession::genTableId(),
+                                                  sequence);
+    _segments.push_back(segment);
+
+    LOGV2_DEBUG(4972505,
+                1,
+                "Started a new oplog segment",
+                "ident"_attr = ident,
+                "start"_attr = segment->start,
+                "numSegments"_attr = _segments.size());
+}
+
+std::vector<WiredTigerRecordStore::OplogSegments::SegmentPtr>
+WiredTigerRecordStore::OplogSegments::getDroppableSegments(const RecordId& lastRecord) const {
+    std::vector<SegmentPtr> droppable;
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (size_t i = 1; i + 1 < _segments.size(); ++i) {
+        // Every RecordId in a segment is below the start of the one after it.
+        if (_segments[i + 1]->start.repr() > lastRecord.repr() + 1) {
+            break;
+        }
+        droppable.push_back(_segments[i]);
+    }
+    return droppable;
+}
+
+WiredTigerRecordStore::OplogSegments::SegmentPtr
+WiredTigerRecordStore::OplogSegments::_segmentFor_inlock(WithLock, const RecordId& id) const {
+    // The oplog's own table starts at the null RecordId, so some segment always covers 'id'.
+    auto it = std::upper_bound(_segments.begin(),
+                               _segments.end(),
+                               id,
+                               [](const RecordId& lhs, const SegmentPtr& segment) {
+                                   return lhs < segment->start;
+                               });
+    invariant(it != _segments.begin());
+    return *std::prev(it);
+}
+
+void WiredTigerRecordStore::OplogSegments::drop(OperationContext* opCtx,
+                                                const std::vector<SegmentPtr>& segments) {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (auto&& segment : segments) {
+            invariant(segment->sequence != 0);
+            _segments.erase(std::remove(_segments.begin(), _segments.end(), segment),
+                            _segments.end());
+        }
+    }
+
+    for (auto&& segment : segments) {
+        LOGV2_DEBUG(4972506, 1, "Dropping oplog segment", "ident"_attr = segment->ident);
+        // Cursors still open on the segment make WiredTiger refuse the drop, which is then
+        // retried in the background.
+        uassertStatusOK(_rs->_kvEngine->dropIdent(opCtx->recoveryUnit(), segment->ident));
+    }
+}
+
+void WiredTigerRecordStore::OplogSegments::mergeIntoOplogTable(OperationContext* opCtx) {
+    // Copied in batches so that no transaction grows with the size of a segment.
+    const size_t kBatchSize = 1000;
+
+    auto segments = getAll();
+    for (auto it = std::next(segments.begin()); it != segments.end(); ++it) {
+        const auto& segment = *it;
+        boost::optional<RecordId> lastCopied;
+        long long numCopied = 0;
+        for (bool done = false; !done;) {
+            WriteUnitOfWork wuow(opCtx);
+            WiredTigerCursor from(segment->uri, segment->tableId, true, opCtx);
+            WiredTigerCursor to(_rs->_uri, _rs->_tableId, true, opCtx);
+            WT_CURSOR* src = from.get();
+            WT_CURSOR* dst = to.get();
+
+            int ret;
+            if (lastCopied) {
+                _rs->setKey(src, *lastCopied);
+                int cmp;
+                ret = src->search_near(src, &cmp);
+                if (ret == 0 && cmp <= 0)
+                    ret = src->next(src);
+            } else {
+                ret = src->next(src);
+            }
+
+            size_t batchSize = 0;
+            for (; ret == 0 && batchSize < kBatchSize; ++batchSize, ret = src->next(src)) {
+                WT_ITEM value;
+                invariantWTOK(src->get_value(src, &value));
+                lastCopied = _rs->getKey(src);
+                _rs->setKey(dst, *lastCopied);
+                dst->set_value(dst, &value);
+                invariantWTOK(dst->insert(dst));
+            }
+            if (ret == WT_NOTFOUND) {
+                done = true;
+            } else {
+                invariantWTOK(ret);
+            }
+            numCopied += batchSize;
+            wuow.commit();
+        }
+
+        drop(opCtx, {segment});
+        LOGV2(4972515,
+              "Merged oplog segment into the oplog table",
+              "ident"_attr = segment->ident,
+              "numRecords"_attr = numCopied);
+    }
+}
+
 StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj options) {
     StringBuilder ss;
     BSONForEach(elem, options) {
@@ -647,28 +979,41 @@ StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj o
 class WiredTigerRecordStore::RandomCursor final : public RecordCursor {
 public:
     RandomCursor(OperationContext* opCtx, const WiredTigerRecordStore& rs, StringData config)
-        : _cursor(nullptr), _rs(&rs), _opCtx(opCtx), _config(config.toString() + ",next_random") {
+        : _rs(&rs),
+          _opCtx(opCtx),
+          _config(config.toString() + ",next_random"),
+          _random(SecureRandom().nextInt64()) {
         restore();
     }
 
     ~RandomCursor() {
-        if (_cursor)
+        if (!_cursors.empty())
             detachFromOperationContext();
     }
 
     boost::optional<Record> next() final {
-        int advanceRet =
-            wiredTigerPrepareConflictRetry(_opCtx, [&] { return _cursor->next(_cursor); });
-        if (advanceRet == WT_NOTFOUND)
+        // Each segment of a partitioned oplog holds about one oplog stone's worth of entries, so
+        // sampling from a segment picked uniformly is close to sampling the oplog uniformly.
+        const size_t firstIndex = _cursors.size() == 1 ? 0 : _random.nextInt64(_cursors.size());
+        WT_CURSOR* cursor = nullptr;
+        for (size_t i = 0; i < _cursors.size() && !cursor; ++i) {
+            WT_CURSOR* candidate = _cursors[(firstIndex + i) % _cursors.size()];
+            int advanceRet = wiredTigerPrepareConflictRetry(
+                _opCtx, [&] { return candidate->next(candidate); });
+            if (advanceRet == WT_NOTFOUND)
+                continue;
+            invariantWTOK(advanceRet);
+            cursor = candidate;
+        }
+        if (!cursor)
             return {};
-        invariantWTOK(advanceRet);
 
         int64_t key;
-        invariantWTOK(_cursor->get_key(_cursor, &key));
+        invariantWTOK(cursor->get_key(cursor, &key));
         const RecordId id = RecordId(key);
 
         WT_ITEM value;
-        invariantWTOK(_cursor->get_value(_cursor, &value));
+        invariantWTOK(cursor->get_value(cursor, &value));
 
         auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
         metricsCollector.incrementOneDocRead(_opCtx, value.size);
@@ -677,9 +1022,9 @@ public:
     }
 
     void save() final {
-        if (_cursor) {
+        for (auto cursor : _cursors) {
             try {
-                _cursor->reset(_cursor);
+                cursor->reset(cursor);
             } catch (const WriteConflictException&) {
                 // Ignore since this is only called when we are about to kill our transaction
                 // anyway.
@@ -688,21 +1033,16 @@ public:
     }
 
     bool restore() final {
-        // We can't use the CursorCache since this cursor needs a special config string.
-        WT_SESSION* session = WiredTigerRecoveryUnit::get(_opCtx)->getSession()->getSession();
+        if (!_cursors.empty()) {
+            return true;
+        }
 
-        if (!_cursor) {
-            auto status = wtRCToStatus(session->open_cursor(
-                session, _rs->_uri.c_str(), nullptr, _config.c_str(), &_cursor));
-            if (status == ErrorCodes::ObjectIsBusy) {
-                // This can happen if you try to open a cursor on the oplog table and a verify is
-                // currently running on it.
-                uasserted(
-                    4820000,
-                    "Failed to open a cursor on a collection because it was locked by WiredTiger.");
+        if (_rs->_oplogSegments) {
+            for (auto&& segment : _rs->_oplogSegments->getAll()) {
+                _openCursor(segment->uri);
             }
-            invariantStatusOK(status);
-            invariant(_cursor);
+        } else {
+            _openCursor(_rs->_uri);
         }
         return true;
     }
@@ -710,10 +1050,10 @@ public:
     void detachFromOperationContext() final {
         invariant(_opCtx);
         _opCtx = nullptr;
-        if (_cursor) {
-            invariantWTOK(_cursor->close(_cursor));
+        for (auto cursor : _cursors) {
+            invariantWTOK(cursor->close(cursor));
         }
-        _cursor = nullptr;
+        _cursors.clear();
     }
 
     void reattachToOperationContext(OperationContext* opCtx) final {
@@ -722,10 +1062,31 @@ public:
     }
 
 private:
-    WT_CURSOR* _cursor;
+    void _openCursor(const std::string& uri) {
+        // We can't use the CursorCache since this cursor needs a special config string.
+        WT_SESSION* session = WiredTigerRecoveryUnit::get(_opCtx)->getSession()->getSession();
+
+        WT_CURSOR* cursor = nullptr;
+        auto status = wtRCToStatus(
+            session->open_cursor(session, uri.c_str(), nullptr, _config.c_str(), &cursor));
+        if (status == ErrorCodes::ObjectIsBusy) {
+            // This can happen if you try to open a cursor on the oplog table and a verify is
+            // currently running on it.
+            uasserted(
+                4820000,
+                "Failed to open a cursor on a collection because it was locked by WiredTiger.");
+        }
+        invariantStatusOK(status);
+        invariant(cursor);
+        _cursors.push_back(cursor);
+    }
+
+    // One cursor for each segment of a partitioned oplog, otherwise a single cursor.
+    std::vector<WT_CURSOR*> _cursors;
     const WiredTigerRecordStore* _rs;
     OperationContext* _opCtx;
     const std::string _config;
+    PseudoRandom _random;
 };
 
 
@@ -827,6 +1188,8 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
       _cappedDeleteCheckCount(0),
       _sizeStorer(params.sizeStorer),
       _tracksSizeAdjustments(params.tracksSizeAdjustments),
+      _maintainsContentHash(gWiredTigerCollectionContentHashes && !_isCapped &&
+                            _tracksSizeAdjustments && _sizeStorer),
       _kvEngine(kvEngine) {
     invariant(getIdent().size() > 0);
 
@@ -869,6 +1232,14 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
     // persistent size information, we require it to use a SizeStorer.
     _sizeInfo = _sizeStorer ? _sizeStorer->load(_uri)
                             : std::make_shared<WiredTigerSizeStorer::SizeInfo>(0, 0);
+
+    // A content hash that was not kept up to date by every write since it was last set can no
+    // longer be trusted. Dropping it here makes the next flush remove it from the table.
+    if (_sizeInfo->hasContentHash.load() && !_maintainsContentHash) {
+        _sizeInfo->hasContentHash.store(false);
+        if (_sizeStorer)
+            _sizeStorer->store(_uri, _sizeInfo);
+    }
 }
 
 WiredTigerRecordStore::~WiredTigerRecordStore() {
@@ -921,6 +1292,10 @@ void WiredTigerRecordStore::checkSize(OperationContext* opCtx) {
             .markCollectionAsAlwaysNeedsSizeAdjustment(getIdent());
         _sizeInfo->dataSize.store(0);
         _sizeInfo->numRecords.store(0);
+        if (_maintainsContentHash) {
+            _sizeInfo->contentHash.store(0);
+            _sizeInfo->hasContentHash.store(true);
+        }
     }
 
     if (_sizeStorer)
@@ -928,6 +1303,18 @@ void WiredTigerRecordStore::checkSize(OperationContext* opCtx) {
 }
 
 void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
+    // Only oplogs with standard keys are partitioned. Segments created while the oplog was
+    // partitioned are merged back into the oplog's own table once it no longer is, which is what
+    // allows downgrading to a version that only reads that table.
+    if (_isOplog && !getPrefix().isPrefixed() &&
+        (gPartitionedOplog || OplogSegments::hasSegmentTables(opCtx, getIdent()))) {
+        _oplogSegments = std::make_shared<OplogSegments>(opCtx, this);
+        if (!gPartitionedOplog && !storageGlobalParams.readOnly) {
+            _oplogSegments->mergeIntoOplogTable(opCtx);
+            _oplogSegments.reset();
+        }
+    }
+
     if (NamespaceString::oplog(ns()) &&
         !(storageGlobalParams.repair || storageGlobalParams.readOnly)) {
         _oplogStones = std::make_shared<OplogStones>(opCtx, this);
@@ -939,10 +1326,17 @@ void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
     }
 }
 
+bool WiredTigerRecordStore::hasOplogSegments() const {
+    return _oplogSegments && _oplogSegments->numSegments() > 1;
+}
+
 void WiredTigerRecordStore::getOplogTruncateStats(BSONObjBuilder& builder) const {
     if (_oplogStones) {
         _oplogStones->getOplogStonesStats(builder);
     }
+    if (_oplogSegments) {
+        builder.append("numSegments", static_cast<long long>(_oplogSegments->numSegments()));
+    }
     builder.append("totalTimeTruncatingMicros", _totalTimeTruncating.load());
     builder.append("truncateCount", _truncateCount.load());
 }
@@ -987,13 +1381,23 @@ int64_t WiredTigerRecordStore::storageSize(OperationContext* opCtx,
         return dataSize(opCtx);
     }
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn();
-    auto result = WiredTigerUtil::getStatisticsValue(session->getSession(),
-                                                     "statistics:" + getURI(),
-                                                     "statistics=(size)",
-                                                     WT_STAT_DSRC_BLOCK_SIZE);
-    uassertStatusOK(result.getStatus());
-
-    int64_t size = result.getValue();
+    auto tableSize = [&](const std::string& uri) -> int64_t {
+        auto result = WiredTigerUtil::getStatisticsValue(session->getSession(),
+                                                         "statistics:" + uri,
+                                                         "statistics=(size)",
+                                                         WT_STAT_DSRC_BLOCK_SIZE);
+        uassertStatusOK(result.getStatus());
+        return result.getValue();
+    };
+
+    int64_t size = 0;
+    if (_oplogSegments) {
+        for (auto&& segment : _oplogSegments->getAll()) {
+            size += tableSize(segment->uri);
+        }
+    } else {
+        size = tableSize(getURI());
+    }
 
     if (size == 0 && _isCapped) {
         // Many things assume an empty capped collection still takes up space.
@@ -1006,6 +1410,13 @@ int64_t WiredTigerRecordStore::freeStorageSize(OperationContext* opCtx) const {
     invariant(opCtx->lockState()->isReadLocked());
 
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn();
+    if (_oplogSegments) {
+        int64_t size = 0;
+        for (auto&& segment : _oplogSegments->getAll()) {
+            size += WiredTigerUtil::getIdentReuseSize(session->getSession(), segment->uri);
+        }
+        return size;
+    }
     return WiredTigerUtil::getIdentReuseSize(session->getSession(), getURI());
 }
 
@@ -1021,7 +1432,7 @@ bool WiredTigerRecordStore::findRecord(OperationContext* opCtx,
                                        RecordData* out) const {
     dassert(opCtx->lockState()->isReadLocked());
 
-    WiredTigerCursor curwrap(_uri, _tableId, true, opCtx);
+    WiredTigerCursor curwrap = _getCursorFor(opCtx, id);
     WT_CURSOR* c = curwrap.get();
     invariant(c);
     setKey(c, id);
@@ -1061,6 +1472,9 @@ void WiredTigerRecordStore::deleteRecord(OperationContext* opCtx, const RecordId
     invariantWTOK(ret);
 
     int64_t old_length = old_value.size;
+    uint64_t oldHash = _maintainsContentHash
+        ? hashRecordContent(static_cast<const char*>(old_value.data), old_value.size)
+        : 0;
 
     ret = WT_OP_CHECK(wiredTigerCursorRemove(opCtx, c));
     invariantWTOK(ret);
@@ -1070,6 +1484,7 @@ void WiredTigerRecordStore::deleteRecord(OperationContext* opCtx, const RecordId
 
     _changeNumRecords(opCtx, -1);
     _increaseDataSize(opCtx, -old_length);
+    _changeContentHash(opCtx, -oldHash);
 }
 
 bool WiredTigerRecordStore::cappedAndNeedDelete() const {
@@ -1113,6 +1528,11 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded(OperationContext* opCtx,
 
     invariant(!_oplogStones);
 
+    // A partitioned oplog is only ever truncated by reclaiming oplog stones.
+    if (_oplogSegments) {
+        return 0;
+    }
+
     // We only want to do the checks occasionally as they are expensive.
     // This variable isn't thread safe, but has loose semantics anyway.
     dassert(!_isOplog || _cappedMaxDocs == -1);
@@ -1363,6 +1783,17 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
 }
 
 void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayTruncateUpTo) {
+    // Older versions only read the oplog's own table, so no segment is started unless the feature
+    // compatibility version is fully upgraded. A pending request is kept until then. The caller's
+    // global lock orders this check with setFeatureCompatibilityVersion, which refuses to downgrade
+    // while segments exist.
+    if (_oplogSegments && serverGlobalParams.featureCompatibility.isVersionInitialized() &&
+        serverGlobalParams.featureCompatibility.isGreaterThanOrEqualTo(
+            ServerGlobalParams::FeatureCompatibility::Version::kVersion49) &&
+        _oplogStones->takeSegmentRotationRequest()) {
+        _oplogSegments->rotate(opCtx);
+    }
+
     Timer timer;
     while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
         invariant(stone->lastRecord.isValid());
@@ -1388,29 +1819,40 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
         try {
             WriteUnitOfWork wuow(opCtx);
 
-            WiredTigerCursor cwrap(_uri, _tableId, true, opCtx);
-            WT_CURSOR* cursor = cwrap.get();
+            std::vector<std::shared_ptr<const OplogSegment>> segmentsToDrop;
+            if (_oplogSegments) {
+                segmentsToDrop = _truncateOplogSegmentsUpTo(opCtx, stone->lastRecord);
+            } else {
+                WiredTigerCursor cwrap(_uri, _tableId, true, opCtx);
+                WT_CURSOR* cursor = cwrap.get();
 
-            // The first record in the oplog should be within the truncate range.
-            int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return cursor->next(cursor); });
-            invariantWTOK(ret);
-            RecordId firstRecord = getKey(cursor);
-            if (firstRecord < _oplogStones->firstRecord || firstRecord > stone->lastRecord) {
-                LOGV2_WARNING(22407,
-                              "First oplog record {firstRecord} is not in truncation range "
-                              "({oplogStones_firstRecord}, {stone_lastRecord})",
-                              "firstRecord"_attr = firstRecord,
-                              "oplogStones_firstRecord"_attr = _oplogStones->firstRecord,
-                              "stone_lastRecord"_attr = stone->lastRecord);
-            }
+                // The first record in the oplog should be within the truncate range.
+                int ret =
+                    wiredTigerPrepareConflictRetry(opCtx, [&] { return cursor->next(cursor); });
+                invariantWTOK(ret);
+                RecordId firstRecord = getKey(cursor);
+                if (firstRecord < _oplogStones->firstRecord || firstRecord > stone->lastRecord) {
+                    LOGV2_WARNING(22407,
+                                  "First oplog record {firstRecord} is not in truncation range "
+                                  "({oplogStones_firstRecord}, {stone_lastRecord})",
+                                  "firstRecord"_attr = firstRecord,
+                                  "oplogStones_firstRecord"_attr = _oplogStones->firstRecord,
+                                  "stone_lastRecord"_attr = stone->lastRecord);
+                }
 
-            setKey(cursor, stone->lastRecord);
-            invariantWTOK(session->truncate(session, nullptr, nullptr, cursor, nullptr));
+                setKey(cursor, stone->lastRecord);
+                invariantWTOK(session->truncate(session, nullptr, nullptr, cursor, nullptr));
+            }
             _changeNumRecords(opCtx, -stone->records);
             _increaseDataSize(opCtx, -stone->bytes);
 
             wuow.commit();
 
+            // The records of these segments are accounted for by the truncation above.
+            if (!segmentsToDrop.empty()) {
+                _oplogSegments->drop(opCtx, segmentsToDrop);
+            }
+
             // Remove the stone after a successful truncation.
             _oplogStones->popOldestStone();
 
@@ -1455,20 +1897,22 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
     // We are kind of cheating on capped collections since we write all of them at once ....
     // Simplest way out would be to just block vector writes for everything except oplog ?
     int64_t totalLength = 0;
-    for (size_t i = 0; i < nRecords; i++)
+    uint64_t totalHash = 0;
+    for (size_t i = 0; i < nRecords; i++) {
         totalLength += records[i].data.size();
+        if (_maintainsContentHash)
+            totalHash += hashRecordContent(records[i].data.data(), records[i].data.size());
+    }
 
     // caller will retry one element at a time
     if (_isCapped && totalLength > _cappedMaxSize)
         return Status(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
 
-    WiredTigerCursor curwrap(_uri, _tableId, true, opCtx);
-    curwrap.assertInActiveTxn();
-    WT_CURSOR* c = curwrap.get();
-    invariant(c);
-
     Record highestIdRecord;
     invariant(nRecords != 0);
+    // Reserve a contiguous block of RecordIds for the whole batch up front rather than bumping the
+    // shared counter once per record.
+    const long long firstId = _isOplog ? 0 : _reserveIds(opCtx, nRecords).repr();
     for (size_t i = 0; i < nRecords; i++) {
         auto& record = records[i];
         if (_isOplog) {
@@ -1478,14 +1922,33 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
                 return status.getStatus();
             record.id = status.getValue();
         } else {
-            record.id = _nextId(opCtx);
+            record.id = RecordId(firstId + static_cast<long long>(i));
         }
         dassert(record.id > highestIdRecord.id);
         highestIdRecord = record;
     }
 
+    // A partitioned oplog inserts each record into the segment covering its RecordId.
+    boost::optional<WiredTigerCursor> curwrap;
+    std::shared_ptr<const OplogSegment> segment;
+    if (!_oplogSegments) {
+        curwrap.emplace(_uri, _tableId, true, opCtx);
+        curwrap->assertInActiveTxn();
+    }
+
     for (size_t i = 0; i < nRecords; i++) {
         auto& record = records[i];
+        if (_oplogSegments) {
+            auto recordSegment = _oplogSegments->routeInsert(record.id);
+            if (recordSegment != segment) {
+                segment = std::move(recordSegment);
+                curwrap.emplace(segment->uri, segment->tableId, true, opCtx);
+                curwrap->assertInActiveTxn();
+            }
+        }
+        WT_CURSOR* c = curwrap->get();
+        invariant(c);
+
         Timestamp ts;
         if (timestamps[i].isNull() && _isOplog) {
             // If the timestamp is 0, that probably means someone inserted a document directly
@@ -1518,6 +1981,7 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
 
     _changeNumRecords(opCtx, nRecords);
     _increaseDataSize(opCtx, totalLength);
+    _changeContentHash(opCtx, totalHash);
 
     if (_oplogStones) {
         _oplogStones->updateCurrentStoneAfterInsertOnCommit(
@@ -1556,20 +2020,37 @@ StatusWith<Timestamp> WiredTigerRecordStore::getLatestOplogTimestamp(
 
     WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
     auto sessRaii = cache->getSession();
-    WT_CURSOR* cursor = writeConflictRetry(opCtx, "getLatestOplogTimestamp", "local.oplog.rs", [&] {
-        auto cachedCursor = sessRaii->getCachedCursor(_uri, _tableId);
-        return cachedCursor ? cachedCursor : sessRaii->getNewCursor(_uri);
-    });
-    ON_BLOCK_EXIT([&] { sessRaii->releaseCursor(_tableId, cursor); });
-    int ret = cursor->prev(cursor);
-    if (ret == WT_NOTFOUND) {
+    auto getLastRecordId = [&](const std::string& uri,
+                               uint64_t tableId) -> boost::optional<RecordId> {
+        WT_CURSOR* cursor =
+            writeConflictRetry(opCtx, "getLatestOplogTimestamp", "local.oplog.rs", [&] {
+                auto cachedCursor = sessRaii->getCachedCursor(uri, tableId);
+                return cachedCursor ? cachedCursor : sessRaii->getNewCursor(uri);
+            });
+        ON_BLOCK_EXIT([&] { sessRaii->releaseCursor(tableId, cursor); });
+        int ret = cursor->prev(cursor);
+        if (ret == WT_NOTFOUND) {
+            return boost::none;
+        }
+        invariantWTOK(ret);
+        return getKey(cursor);
+    };
+
+    boost::optional<RecordId> recordId;
+    if (_oplogSegments) {
+        // The newest entry is in the newest segment that is not empty.
+        for (auto segment = _oplogSegments->last(); segment && !recordId;
+             segment = _oplogSegments->prev(segment)) {
+            recordId = getLastRecordId(segment->uri, segment->tableId);
+        }
+    } else {
+        recordId = getLastRecordId(_uri, _tableId);
+    }
+    if (!recordId) {
         return Status(ErrorCodes::CollectionIsEmpty, "oplog is empty");
     }
-    invariantWTOK(ret);
-
-    RecordId recordId = getKey(cursor);
 
-    return {Timestamp(static_cast<unsigned long long>(recordId.repr()))};
+    return {Timestamp(static_cast<unsigned long long>(recordId->repr()))};
 }
 
 StatusWith<Timestamp> WiredTigerRecordStore::getEarliestOplogTimestamp(OperationContext* opCtx) {
@@ -1581,19 +2062,37 @@ StatusWith<Timestamp> WiredTigerRecordStore::getEarliestOplogTimestamp(Operation
     if (_cappedFirstRecord == RecordId()) {
         WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
         auto sessRaii = cache->getSession();
-        WT_CURSOR* cursor =
-            writeConflictRetry(opCtx, "getEarliestOplogTimestamp", "local.oplog.rs", [&] {
-                auto cachedCursor = sessRaii->getCachedCursor(_uri, _tableId);
-                return cachedCursor ? cachedCursor : sessRaii->getNewCursor(_uri);
-            });
-        ON_BLOCK_EXIT([&] { sessRaii->releaseCursor(_tableId, cursor); });
-        auto ret = cursor->next(cursor);
-        if (ret == WT_NOTFOUND) {
+        auto getFirstRecordId = [&](const std::string& uri,
+                                    uint64_t tableId) -> boost::optional<RecordId> {
+            WT_CURSOR* cursor =
+                writeConflictRetry(opCtx, "getEarliestOplogTimestamp", "local.oplog.rs", [&] {
+                    auto cachedCursor = sessRaii->getCachedCursor(uri, tableId);
+                    return cachedCursor ? cachedCursor : sessRaii->getNewCursor(uri);
+                });
+            ON_BLOCK_EXIT([&] { sessRaii->releaseCursor(tableId, cursor); });
+            auto ret = cursor->next(cursor);
+            if (ret == WT_NOTFOUND) {
+                return boost::none;
+            }
+            invariantWTOK(ret);
+            return getKey(cursor);
+        };
+
+        boost::optional<RecordId> recordId;
+        if (_oplogSegments) {
+            // The oldest entry is in the oldest segment that is not empty.
+            for (auto segment = _oplogSegments->first(); segment && !recordId;
+                 segment = _oplogSegments->next(segment)) {
+                recordId = getFirstRecordId(segment->uri, segment->tableId);
+            }
+        } else {
+            recordId = getFirstRecordId(_uri, _tableId);
+        }
+        if (!recordId) {
             return Status(ErrorCodes::CollectionIsEmpty, "oplog is empty");
         }
-        invariantWTOK(ret);
 
-        _cappedFirstRecord = getKey(cursor);
+        _cappedFirstRecord = *recordId;
     }
 
     return {Timestamp(static_cast<unsigned long long>(_cappedFirstRecord.repr()))};
@@ -1606,7 +2105,7 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
     dassert(opCtx->lockState()->isWriteLocked());
     invariant(opCtx->lockState()->inAWriteUnitOfWork() || opCtx->lockState()->isNoop());
 
-    WiredTigerCursor curwrap(_uri, _tableId, true, opCtx);
+    WiredTigerCursor curwrap = _getCursorFor(opCtx, id);
     curwrap.assertInActiveTxn();
     WT_CURSOR* c = curwrap.get();
     invariant(c);
@@ -1619,6 +2118,10 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
     invariantWTOK(ret);
 
     int64_t old_length = old_value.size;
+    // The old value is only valid until the cursor is modified.
+    uint64_t oldHash = _maintainsContentHash
+        ? hashRecordContent(static_cast<const char*>(old_value.data), old_value.size)
+        : 0;
 
     if (_oplogStones && len != old_length) {
         return {ErrorCodes::IllegalOperation, "Cannot change the size of a document in the oplog"};
@@ -1676,6 +2179,8 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
     invariantWTOK(ret);
 
     _increaseDataSize(opCtx, len - old_length);
+    if (_maintainsContentHash)
+        _changeContentHash(opCtx, hashRecordContent(data, len) - oldHash);
     if (!_oplogStones) {
         _cappedDeleteAsNeeded(opCtx, id);
     }
@@ -1710,7 +2215,7 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
         modifiedDataSize += entries[i].data.size;
     }
 
-    WiredTigerCursor curwrap(_uri, _tableId, true, opCtx);
+    WiredTigerCursor curwrap = _getCursorFor(opCtx, id);
     curwrap.assertInActiveTxn();
     WT_CURSOR* c = curwrap.get();
     invariant(c);
@@ -1728,6 +2233,13 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
     WT_ITEM value;
     invariantWTOK(c->get_value(c, &value));
 
+    if (_maintainsContentHash) {
+        _changeContentHash(
+            opCtx,
+            hashRecordContent(static_cast<const char*>(value.data), value.size) -
+                hashRecordContent(oldRec.data(), oldRec.size()));
+    }
+
     return RecordData(static_cast<const char*>(value.data), value.size).getOwned();
 }
 
@@ -1738,19 +2250,39 @@ std::unique_ptr<RecordCursor> WiredTigerRecordStore::getRandomCursor(
 }
 
 Status WiredTigerRecordStore::truncate(OperationContext* opCtx) {
-    WiredTigerCursor startWrap(_uri, _tableId, true, opCtx);
-    WT_CURSOR* start = startWrap.get();
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return start->next(start); });
+    // Returns false if the table was already empty.
+    auto truncateTable = [&](const std::string& uri, uint64_t tableId) {
+        WiredTigerCursor startWrap(uri, tableId, true, opCtx);
+        WT_CURSOR* start = startWrap.get();
+        int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return start->next(start); });
+        if (ret == WT_NOTFOUND) {
+            return false;
+        }
+        invariantWTOK(ret);
+
+        WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+        invariantWTOK(WT_OP_CHECK(session->truncate(session, nullptr, start, nullptr, nullptr)));
+        return true;
+    };
+
+    bool truncated = false;
+    if (_oplogSegments) {
+        for (auto&& segment : _oplogSegments->getAll()) {
+            if (truncateTable(segment->uri, segment->tableId)) {
+                truncated = true;
+            }
+        }
+    } else {
+        truncated = truncateTable(_uri, _tableId);
+    }
     // Empty collections don't have anything to truncate.
-    if (ret == WT_NOTFOUND) {
+    if (!truncated) {
         return Status::OK();
     }
-    invariantWTOK(ret);
 
-    WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
-    invariantWTOK(WT_OP_CHECK(session->truncate(session, nullptr, start, nullptr, nullptr)));
     _changeNumRecords(opCtx, -numRecords(opCtx));
     _increaseDataSize(opCtx, -dataSize(opCtx));
+    _changeContentHash(opCtx, -_sizeInfo->contentHash.load());
 
     if (_oplogStones) {
         _oplogStones->clearStonesOnCommit(opCtx);
@@ -1766,8 +2298,14 @@ Status WiredTigerRecordStore::compact(OperationContext* opCtx) {
     if (!cache->isEphemeral()) {
         WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
         opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, getURI().c_str(), "timeout=0");
-        invariantWTOK(ret);
+        if (_oplogSegments) {
+            for (auto&& segment : _oplogSegments->getAll()) {
+                invariantWTOK(s->compact(s, segment->uri.c_str(), "timeout=0"));
+            }
+        } else {
+            int ret = s->compact(s, getURI().c_str(), "timeout=0");
+            invariantWTOK(ret);
+        }
     }
     return Status::OK();
 }
@@ -1781,26 +2319,50 @@ void WiredTigerRecordStore::validate(OperationContext* opCtx,
         return;
     }
 
+    if (_oplogSegments) {
+        // Inserts keep the newest segment of a partitioned oplog busy, but the older ones are
+        // only truncated or dropped whole.
+        results->warnings.push_back(
+            "Skipping verification of the newest WiredTiger table for the oplog.");
+        auto segments = _oplogSegments->getAll();
+        segments.pop_back();
+        for (auto&& segment : segments) {
+            _verifyTable(opCtx, segment->uri, results);
+        }
+        return;
+    }
+
     if (_isOplog) {
         results->warnings.push_back("Skipping verification of the WiredTiger table for the oplog.");
         return;
     }
 
-    int err = WiredTigerUtil::verifyTable(opCtx, _uri, &results->errors);
+    _verifyTable(opCtx, _uri, results);
+}
+
+void WiredTigerRecordStore::_verifyTable(OperationContext* opCtx,
+                                         const std::string& uri,
+                                         ValidateResults* results) const {
+    int err = WiredTigerUtil::verifyTable(opCtx, uri, &results->errors);
     if (!err) {
         return;
     }
 
+    if (err == ENOENT && _oplogSegments) {
+        // Oplog truncation dropped the segment after it was listed.
+        return;
+    }
+
     if (err == EBUSY) {
         std::string msg = str::stream()
-            << "Could not complete validation of " << _uri << ". "
+            << "Could not complete validation of " << uri << ". "
             << "This is a transient issue as the collection was actively "
                "in use by other operations.";
 
         LOGV2_WARNING(22408,
                       "Could not complete validation, This is a transient issue as the collection "
                       "was actively in use by other operations",
-                      "uri"_attr = _uri);
+                      "uri"_attr = uri);
         results->warnings.push_back(msg);
         return;
     }
@@ -1812,6 +2374,7 @@ void WiredTigerRecordStore::validate(OperationContext* opCtx,
     LOGV2_ERROR(22409,
                 "Verification returned error. This indicates structural damage. Not examining "
                 "individual documents",
+                "uri"_attr = uri,
                 "error"_attr = errorStr);
     results->errors.push_back(msg);
     results->valid = false;
@@ -1862,6 +2425,24 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* opCtx,
         bob.append("code", static_cast<int>(status.code()));
         bob.append("reason", status.reason());
     }
+
+    if (_oplogSegments) {
+        // The statistics above only cover the oplog's own table.
+        BSONObjBuilder segmentsBuilder(bob.subobjStart("oplogSegments"));
+        for (auto&& segment : _oplogSegments->getAll()) {
+            if (segment->uri == getURI()) {
+                continue;
+            }
+            BSONObjBuilder segmentBuilder(segmentsBuilder.subobjStart(segment->ident));
+            Status segmentStatus = WiredTigerUtil::exportTableToBSON(
+                s, "statistics:" + segment->uri, "statistics=(fast)", &segmentBuilder);
+            if (!segmentStatus.isOK()) {
+                segmentBuilder.append("error", "unable to retrieve statistics");
+                segmentBuilder.append("code", static_cast<int>(segmentStatus.code()));
+                segmentBuilder.append("reason", segmentStatus.reason());
+            }
+        }
+    }
 }
 
 void WiredTigerRecordStore::waitForAllEarlierOplogWritesToBeVisible(OperationContext* opCtx) const {
@@ -1891,7 +2472,7 @@ boost::optional<RecordId> WiredTigerRecordStore::oplogStartHack(
         searchFor = RecordId(*visibilityTs);
     }
 
-    WiredTigerCursor cursor(_uri, _tableId, true, opCtx);
+    WiredTigerCursor cursor = _getCursorFor(opCtx, searchFor);
     WT_CURSOR* c = cursor.get();
 
     int cmp;
@@ -1899,6 +2480,20 @@ boost::optional<RecordId> WiredTigerRecordStore::oplogStartHack(
     int ret = c->search_near(c, &cmp);
     if (ret == 0 && cmp > 0)
         ret = c->prev(c);  // landed one higher than startingPosition
+    if (ret == WT_NOTFOUND && _oplogSegments) {
+        // Nothing <= startingPosition in its segment, so look for the newest entry of an older one.
+        for (auto segment = _oplogSegments->prev(_oplogSegments->segmentFor(searchFor)); segment;
+             segment = _oplogSegments->prev(segment)) {
+            WiredTigerCursor segmentCursor(segment->uri, segment->tableId, true, opCtx);
+            WT_CURSOR* sc = segmentCursor.get();
+            ret = sc->prev(sc);
+            if (ret != WT_NOTFOUND) {
+                invariant(ret != WT_PREPARE_CONFLICT);
+                invariantWTOK(ret);
+                return getKey(sc);
+            }
+        }
+    }
     if (ret == WT_NOTFOUND)
         return RecordId();  // nothing <= startingPosition
     // It's illegal for oplog documents to be in a prepare state.
@@ -1917,12 +2512,36 @@ void WiredTigerRecordStore::updateStatsAfterRepair(OperationContext* opCtx,
 
     _sizeInfo->numRecords.store(numRecords);
     _sizeInfo->dataSize.store(dataSize);
+    // The caller only knows the sizes. The content hash is restored separately, if at all.
+    _sizeInfo->hasContentHash.store(false);
 
     // If we have a WiredTigerSizeStorer, but our size info is not currently cached, add it.
     if (_sizeStorer)
         _sizeStorer->store(_uri, _sizeInfo);
 }
 
+boost::optional<uint64_t> WiredTigerRecordStore::contentHash(OperationContext* opCtx) const {
+    if (!_maintainsContentHash || !_sizeInfo->hasContentHash.load()) {
+        return boost::none;
+    }
+    return static_cast<uint64_t>(_sizeInfo->contentHash.load());
+}
+
+void WiredTigerRecordStore::updateContentHashAfterRepair(OperationContext* opCtx,
+                                                         uint64_t contentHash) {
+    if (!_maintainsContentHash) {
+        return;
+    }
+
+    // As with updateStatsAfterRepair(), future writes must be tracked from here on.
+    sizeRecoveryState(getGlobalServiceContext())
+        .markCollectionAsAlwaysNeedsSizeAdjustment(getIdent());
+
+    _sizeInfo->contentHash.store(contentHash);
+    _sizeInfo->hasContentHash.store(true);
+    _sizeStorer->store(_uri, _sizeInfo);
+}
+
 void WiredTigerRecordStore::_initNextIdIfNeeded(OperationContext* opCtx) {
     // In the normal case, this will already be initialized, so use a weak load. Since this value
     // will only change from 0 to a positive integer, the only risk is reading an outdated value, 0,
@@ -1949,12 +2568,13 @@ void WiredTigerRecordStore::_initNextIdIfNeeded(OperationContext* opCtx) {
     _nextIdNum.store(nextId);
 }
 
-RecordId WiredTigerRecordStore::_nextId(OperationContext* opCtx) {
+RecordId WiredTigerRecordStore::_reserveIds(OperationContext* opCtx, size_t nRecords) {
     invariant(!_isOplog);
     _initNextIdIfNeeded(opCtx);
-    RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
-    invariant(out.isNormal());
-    return out;
+    RecordId first = RecordId(_nextIdNum.fetchAndAdd(nRecords));
+    invariant(first.isNormal());
+    invariant(RecordId(first.repr() + nRecords - 1).isNormal());
+    return first;
 }
 
 WiredTigerRecoveryUnit* WiredTigerRecordStore::_getRecoveryUnit(OperationContext* opCtx) {
@@ -2024,6 +2644,36 @@ void WiredTigerRecordStore::_increaseDataSize(OperationContext* opCtx, int64_t a
         _sizeStorer->store(_uri, _sizeInfo);
 }
 
+class WiredTigerRecordStore::ContentHashChange : public RecoveryUnit::Change {
+public:
+    ContentHashChange(WiredTigerRecordStore* rs, uint64_t diff) : _rs(rs), _diff(diff) {}
+    virtual void commit(boost::optional<Timestamp>) {}
+    virtual void rollback() {
+        _rs->_sizeInfo->contentHash.fetchAndAdd(-_diff);
+    }
+
+private:
+    WiredTigerRecordStore* _rs;
+    uint64_t _diff;
+};
+
+void WiredTigerRecordStore::_changeContentHash(OperationContext* opCtx, uint64_t diff) {
+    if (!_maintainsContentHash) {
+        return;
+    }
+
+    if (!sizeRecoveryState(getGlobalServiceContext()).collectionNeedsSizeAdjustment(getIdent())) {
+        return;
+    }
+
+    // The sum is kept up to date even while it is not trusted, since it only becomes trusted again
+    // by being replaced.
+    opCtx->recoveryUnit()->registerChange(std::make_unique<ContentHashChange>(this, diff));
+    _sizeInfo->contentHash.fetchAndAdd(diff);
+
+    _sizeStorer->store(_uri, _sizeInfo);
+}
+
 void WiredTigerRecordStore::setNumRecords(long long numRecords) {
     _sizeInfo->numRecords.store(numRecords);
 
@@ -2097,12 +2747,16 @@ void WiredTigerRecordStore::cappedTruncateAfter(OperationContext* opCtx,
     // the collection.
     WriteUnitOfWork wuow(opCtx);
 
-    WiredTigerCursor startwrap(_uri, _tableId, true, opCtx);
-    WT_CURSOR* start = startwrap.get();
-    setKey(start, firstRemovedId);
+    if (_oplogSegments) {
+        _truncateOplogSegmentsFrom(opCtx, firstRemovedId);
+    } else {
+        WiredTigerCursor startwrap(_uri, _tableId, true, opCtx);
+        WT_CURSOR* start = startwrap.get();
+        setKey(start, firstRemovedId);
 
-    WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
-    invariantWTOK(session->truncate(session, nullptr, start, nullptr, nullptr));
+        WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+        invariantWTOK(session->truncate(session, nullptr, start, nullptr, nullptr));
+    }
 
     _changeNumRecords(opCtx, -recordsRemoved);
     _increaseDataSize(opCtx, -bytesRemoved);
@@ -2138,6 +2792,70 @@ void WiredTigerRecordStore::cappedTruncateAfter(OperationContext* opCtx,
     }
 }
 
+WiredTigerCursor WiredTigerRecordStore::_getCursorFor(OperationContext* opCtx,
+                                                      const RecordId& id) const {
+    if (_oplogSegments) {
+        auto segment = _oplogSegments->segmentFor(id);
+        return WiredTigerCursor(segment->uri, segment->tableId, true, opCtx);
+    }
+    return WiredTigerCursor(_uri, _tableId, true, opCtx);
+}
+
+std::vector<std::shared_ptr<const WiredTigerRecordStore::OplogSegment>>
+WiredTigerRecordStore::_truncateOplogSegmentsUpTo(OperationContext* opCtx,
+                                                  const RecordId& lastRecord) {
+    auto droppable = _oplogSegments->getDroppableSegments(lastRecord);
+
+    // Segments that also hold records after 'lastRecord', and the oplog's own table, are range
+    // truncated. Truncation does not need 'lastRecord' to exist in the table.
+    WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+    for (auto&& segment : _oplogSegments->getAll()) {
+        if (lastRecord < segment->start) {
+            break;
+        }
+        if (std::find(droppable.begin(), droppable.end(), segment) != droppable.end()) {
+            continue;
+        }
+
+        WiredTigerCursor cwrap(segment->uri, segment->tableId, true, opCtx);
+        WT_CURSOR* cursor = cwrap.get();
+        int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return cursor->next(cursor); });
+        if (ret == WT_NOTFOUND) {
+            continue;
+        }
+        invariantWTOK(ret);
+
+        setKey(cursor, lastRecord);
+        invariantWTOK(session->truncate(session, nullptr, nullptr, cursor, nullptr));
+    }
+    return droppable;
+}
+
+void WiredTigerRecordStore::_truncateOplogSegmentsFrom(OperationContext* opCtx,
+                                                       const RecordId& firstRemovedId) {
+    WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+
+    auto segment = _oplogSegments->segmentFor(firstRemovedId);
+    {
+        WiredTigerCursor startwrap(segment->uri, segment->tableId, true, opCtx);
+        WT_CURSOR* start = startwrap.get();
+        setKey(start, firstRemovedId);
+        invariantWTOK(session->truncate(session, nullptr, start, nullptr, nullptr));
+    }
+
+    // Later segments are emptied but kept, since inserts are still routed to them by RecordId.
+    while ((segment = _oplogSegments->next(segment))) {
+        WiredTigerCursor startwrap(segment->uri, segment->tableId, true, opCtx);
+        WT_CURSOR* start = startwrap.get();
+        int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return start->next(start); });
+        if (ret == WT_NOTFOUND) {
+            continue;
+        }
+        invariantWTOK(ret);
+        invariantWTOK(session->truncate(session, nullptr, start, nullptr, nullptr));
+    }
+}
+
 Status WiredTigerRecordStore::oplogDiskLocRegister(OperationContext* opCtx,
                                                    const Timestamp& ts,
                                                    bool orderedCommit) {
@@ -2170,7 +2888,11 @@ WiredTigerRecordStoreCursorBase::WiredTigerRecordStoreCursorBase(OperationContex
     if (_rs._isOplog) {
         _oplogVisibleTs = WiredTigerRecoveryUnit::get(opCtx)->getOplogVisibilityTs();
     }
-    _cursor.emplace(rs.getURI(), rs.tableId(), true, opCtx);
+    if (_rs._oplogSegments) {
+        _openSegmentCursor(RecordId());
+    } else {
+        _cursor.emplace(rs.getURI(), rs.tableId(), true, opCtx);
+    }
 }
 
 boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
@@ -2192,6 +2914,11 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
         // table when you call next/prev.
         int advanceRet = wiredTigerPrepareConflictRetry(
             _opCtx, [&] { return _forward ? c->next(c) : c->prev(c); });
+        while (advanceRet == WT_NOTFOUND && _advanceToNextSegment()) {
+            c = _cursor->get();
+            advanceRet = wiredTigerPrepareConflictRetry(
+                _opCtx, [&] { return _forward ? c->next(c) : c->prev(c); });
+        }
         if (advanceRet == WT_NOTFOUND) {
             _eof = true;
             return {};
@@ -2252,6 +2979,9 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
     WiredTigerRecoveryUnit::get(_opCtx)->getSession();
 
     _skipNextAdvance = false;
+    if (_rs._oplogSegments) {
+        _openSegmentCursor(id);
+    }
     WT_CURSOR* c = _cursor->get();
     setKey(c, id);
     // Nothing after the next line can throw WCEs.
@@ -2299,8 +3029,12 @@ bool WiredTigerRecordStoreCursorBase::restore() {
         _oplogVisibleTs = wtRu->getOplogVisibilityTs();
     }
 
-    if (!_cursor)
+    if (_rs._oplogSegments) {
+        // The segment the cursor was on may have been dropped since.
+        _openSegmentCursor(_lastReturnedId);
+    } else if (!_cursor) {
         _cursor.emplace(_rs.getURI(), _rs.tableId(), true, _opCtx);
+    }
 
     // This will ensure an active session exists, so any restored cursors will bind to it
     invariant(WiredTigerRecoveryUnit::get(_opCtx)->getSession() == _cursor->getSession());
@@ -2354,6 +3088,31 @@ bool WiredTigerRecordStoreCursorBase::restore() {
     return true;
 }
 
+void WiredTigerRecordStoreCursorBase::_openSegmentCursor(const RecordId& id) {
+    auto& segments = *_rs._oplogSegments;
+    auto segment = !id.isNull() ? segments.segmentFor(id)
+                                : (_forward ? segments.first() : segments.last());
+    if (!_cursor || segment != _segment) {
+        _segment = std::move(segment);
+        _cursor.emplace(_segment->uri, _segment->tableId, true, _opCtx);
+    }
+}
+
+bool WiredTigerRecordStoreCursorBase::_advanceToNextSegment() {
+    if (!_rs._oplogSegments) {
+        return false;
+    }
+
+    auto segment =
+        _forward ? _rs._oplogSegments->next(_segment) : _rs._oplogSegments->prev(_segment);
+    if (!segment) {
+        return false;
+    }
+    _segment = std::move(segment);
+    _cursor.emplace(_segment->uri, _segment->tableId, true, _opCtx);
+    return true;
+}
+
 void WiredTigerRecordStoreCursorBase::detachFromOperationContext() {
     _opCtx = nullptr;
     _cursor = boost::none;
@@ -32,6 +32,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 #include <wiredtiger.h>
 
 #include "mongo/db/catalog/collection_options.h"
@@ -118,6 +119,8 @@ public:
 
     WiredTigerRecordStore(WiredTigerKVEngine* kvEngine, OperationContext* opCtx, Params params);
 
+    bool hasOplogSegments() const override;
+
     virtual void getOplogTruncateStats(BSONObjBuilder& builder) const;
 
     virtual ~WiredTigerRecordStore();
@@ -208,6 +211,14 @@ public:
                                         long long numRecords,
                                         long long dataSize);
 
+    bool maintainsContentHash() const override {
+        return _maintainsContentHash;
+    }
+
+    boost::optional<uint64_t> contentHash(OperationContext* opCtx) const override;
+
+    void updateContentHashAfterRepair(OperationContext* opCtx, uint64_t contentHash) override;
+
 
     void waitForAllEarlierOplogWritesToBeVisible(OperationContext* opCtx) const override;
 
@@ -273,12 +284,19 @@ public:
     void notifyCappedWaitersIfNeeded();
 
     class OplogStones;
+    struct OplogSegment;
+    class OplogSegments;
 
     // Exposed only for testing.
     OplogStones* oplogStones() {
         return _oplogStones.get();
     };
 
+    // Exposed only for testing.
+    OplogSegments* oplogSegments() {
+        return _oplogSegments.get();
+    };
+
 protected:
     virtual RecordId getKey(WT_CURSOR* cursor) const = 0;
 
@@ -289,6 +307,7 @@ private:
 
     class NumRecordsChange;
     class DataSizeChange;
+    class ContentHashChange;
 
     static WiredTigerRecoveryUnit* _getRecoveryUnit(OperationContext* opCtx);
 
@@ -297,10 +316,39 @@ private:
                           const Timestamp* timestamps,
                           size_t nRecords);
 
-    RecordId _nextId(OperationContext* opCtx);
+    /**
+     * Reserves 'nRecords' consecutive RecordIds and returns the first of them.
+     */
+    RecordId _reserveIds(OperationContext* opCtx, size_t nRecords);
     bool cappedAndNeedDelete() const;
     RecordData _getData(const WiredTigerCursor& cursor) const;
 
+    /**
+     * Verifies the WiredTiger table 'uri' of this record store, adding any problems to 'results'.
+     */
+    void _verifyTable(OperationContext* opCtx,
+                      const std::string& uri,
+                      ValidateResults* results) const;
+
+    /**
+     * Returns a cursor on the table holding 'id'. That is the record store's own table unless the
+     * oplog is partitioned into segments.
+     */
+    WiredTigerCursor _getCursorFor(OperationContext* opCtx, const RecordId& id) const;
+
+    /**
+     * Truncates a partitioned oplog up to and including 'lastRecord', except for the segments
+     * lying entirely within that range, which are returned so they can be dropped instead once the
+     * truncation commits.
+     */
+    std::vector<std::shared_ptr<const OplogSegment>> _truncateOplogSegmentsUpTo(
+        OperationContext* opCtx, const RecordId& lastRecord);
+
+    /**
+     * Truncates a partitioned oplog from 'firstRemovedId' to its end.
+     */
+    void _truncateOplogSegmentsFrom(OperationContext* opCtx, const RecordId& firstRemovedId);
+
 
     /**
      * Initialize the largest known RecordId if it is not already. This is designed to be called
@@ -339,6 +387,12 @@ private:
     void _changeNumRecords(OperationContext* opCtx, int64_t diff);
     void _increaseDataSize(OperationContext* opCtx, int64_t amount);
 
+    /**
+     * Adds 'diff' to the content hash, modulo 2^64, under the same rules as the size metadata.
+     * Does nothing if this record store has no content hash.
+     */
+    void _changeContentHash(OperationContext* opCtx, uint64_t diff);
+
     /**
      * Delete records from this record store as needed while _cappedMaxSize or _cappedMaxDocs is
      * exceeded.
@@ -385,11 +439,17 @@ private:
     WiredTigerSizeStorer* _sizeStorer;  // not owned, can be NULL
     std::shared_ptr<WiredTigerSizeStorer::SizeInfo> _sizeInfo;
     bool _tracksSizeAdjustments;
+    // True if the content hash in '_sizeInfo' is kept up to date while it is present. Never true
+    // for capped collections, which delete documents without reading them.
+    bool _maintainsContentHash;
     WiredTigerKVEngine* _kvEngine;  // not owned.
 
     // Non-null if this record store is underlying the active oplog.
     std::shared_ptr<OplogStones> _oplogStones;
 
+    // Non-null if this record store is underlying an oplog that is partitioned into segments.
+    std::shared_ptr<OplogSegments> _oplogSegments;
+
     AtomicWord<int64_t>
         _totalTimeTruncating;            // Cumulative amount of time spent truncating the oplog.
     AtomicWord<int64_t> _truncateCount;  // Cumulative number of truncates of the oplog.
@@ -491,6 +551,21 @@ protected:
 private:
     bool isVisible(const RecordId& id);
 
+    /**
+     * Opens '_cursor' on the segment of a partitioned oplog holding 'id', or on the first segment
+     * in the direction of the scan if 'id' is null.
+     */
+    void _openSegmentCursor(const RecordId& id);
+
+    /**
+     * Moves '_cursor' to the next segment of a partitioned oplog in the direction of the scan.
+     * Returns false if there is none.
+     */
+    bool _advanceToNextSegment();
+
+    // The segment '_cursor' is on, if the oplog is partitioned.
+    std::shared_ptr<const WiredTigerRecordStore::OplogSegment> _segment;
+
     /**
      * This value is used for visibility calculations on what oplog entries can be returned to a
      * client. This value *must* be initialized/updated *before* a WiredTiger snapshot is
@@ -557,4 +632,8 @@ extern FailPoint WTWriteConflictExceptionForReads;
 // be seen by regular readers until deactivated. It is unspecified whether writes that commit before
 // activation will become visible while active.
 extern FailPoint WTPauseOplogVisibilityUpdateLoop;
+
+// Pauses a committing thread in the middle of an inline oplog visibility update, after it has
+// claimed the update but before it queries the all_durable timestamp.
+extern FailPoint WTPauseInlineOplogVisibilityUpdate;
 }  // namespace mongo
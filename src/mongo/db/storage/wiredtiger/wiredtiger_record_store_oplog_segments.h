@@ -0,0 +1,148 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class OperationContext;
+
+// A WiredTiger table holding a contiguous range of the oplog's RecordIds.
+struct WiredTigerRecordStore::OplogSegment {
+    OplogSegment(RecordId start, std::string ident, uint64_t tableId, uint64_t sequence);
+
+    const RecordId start;  // Lowest RecordId that belongs to this segment.
+    const std::string ident;
+    const std::string uri;
+    const uint64_t tableId;   // not persisted
+    const uint64_t sequence;  // 0 for the oplog's own table, increasing for later segments.
+};
+
+// Splits the oplog across several WiredTiger tables, or "segments", each covering a range of
+// RecordIds that ends where the next segment starts. Inserts go to the segment covering their
+// RecordId, which is the newest one outside of out-of-order primary writes. Truncation drops the
+// oldest segments whole instead of range truncating the head of a single table. The oplog's own
+// table is always the first segment and is never dropped.
+class WiredTigerRecordStore::OplogSegments {
+public:
+    using SegmentPtr = std::shared_ptr<const OplogSegment>;
+
+    /**
+     * Returns the ident of the oplog that 'ident' is a segment of, or boost::none if 'ident' does
+     * not name an oplog segment.
+     */
+    static boost::optional<StringData> getOwningIdent(StringData ident);
+
+    /**
+     * Returns true if any segment tables exist for the oplog with ident 'oplogIdent'.
+     */
+    static bool hasSegmentTables(OperationContext* opCtx, StringData oplogIdent);
+
+    /**
+     * Loads the existing segments of 'rs'. Empty segments are dropped, as their ranges are only
+     * meaningful to inserts that have not happened yet.
+     */
+    OplogSegments(OperationContext* opCtx, WiredTigerRecordStore* rs);
+
+    SegmentPtr segmentFor(const RecordId& id) const;
+
+    SegmentPtr first() const;
+
+    SegmentPtr last() const;
+
+    /**
+     * Return the segment following or preceding 'segment' in RecordId order, or nullptr if there is
+     * none. 'segment' need not still be part of the oplog.
+     */
+    SegmentPtr next(const SegmentPtr& segment) const;
+    SegmentPtr prev(const SegmentPtr& segment) const;
+
+    std::vector<SegmentPtr> getAll() const;
+
+    /**
+     * Returns the segment an insert of 'id' goes to, and guarantees that no segment created later
+     * starts at or below 'id'.
+     */
+    SegmentPtr routeInsert(const RecordId& id);
+
+    /**
+     * Creates a new segment starting after every RecordId routed so far, unless no insert has been
+     * routed to the newest segment yet. Must not be called concurrently with itself.
+     */
+    void rotate(OperationContext* opCtx);
+
+    /**
+     * Returns the segments that only hold RecordIds up to and including 'lastRecord', other than
+     * the oplog's own table and the newest segment.
+     */
+    std::vector<SegmentPtr> getDroppableSegments(const RecordId& lastRecord) const;
+
+    /**
+     * Removes 'segments' from the oplog and drops their tables.
+     */
+    void drop(OperationContext* opCtx, const std::vector<SegmentPtr>& segments);
+
+    /**
+     * Copies the records of every segment into the oplog's own table and drops the segment, so
+     * that the oplog is no longer partitioned. A segment is only dropped once all of its records
+     * are copied, and copying a record again is harmless, so this can be retried after a crash.
+     * Must not run concurrently with any other use of the oplog.
+     */
+    void mergeIntoOplogTable(OperationContext* opCtx);
+
+    size_t numSegments() const {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _segments.size();
+    }
+
+private:
+    SegmentPtr _segmentFor_inlock(WithLock, const RecordId& id) const;
+
+    WiredTigerRecordStore* _rs;
+
+    // Protects the state below.
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("OplogSegments::_mutex");
+    std::vector<SegmentPtr> _segments;  // front = oldest, back = newest.
+
+    // Highest RecordId an insert has been routed for. New segments start after it.
+    RecordId _highestRoutedId;
+    uint64_t _nextSequence = 1;
+};
+
+}  // namespace mongo
@@ -65,6 +65,10 @@ public:
 
     void awaitHasExcessStonesOrDead();
 
+    // Returns true, and clears the request, if a stone was created since the last call on an oplog
+    // partitioned into segments, meaning a new segment should be started.
+    bool takeSegmentRotationRequest();
+
     void getOplogStonesStats(BSONObjBuilder& builder) const {
         builder.append("totalTimeProcessingMicros", _totalTimeProcessing.load());
         builder.append("processingMethod", _processBySampling.load() ? "sampling" : "scanning");
@@ -140,6 +144,9 @@ private:
     // database, and false otherwise.
     bool _isDead = false;
 
+    // True if a stone was created on a partitioned oplog and no new segment has been started since.
+    bool _segmentRotationRequested = false;
+
     // Minimum number of bytes the stone being filled should contain before it gets added to the
     // deque of oplog stones.
     int64_t _minBytesPerStone;
@@ -39,15 +39,22 @@
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/client.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/fail_point.h"
@@ -350,6 +357,158 @@ TEST(WiredTigerRecordStoreTest, OplogDurableVisibilityOutOfOrder) {
     ASSERT(!wtrs->isOpHidden_forTest(id2));
 }
 
+// Test that with inline oplog visibility, a commit that leaves no hole behind it makes its entry
+// visible before the commit returns, without any help from the visibility thread.
+TEST(WiredTigerRecordStoreTest, OplogInlineVisibilityInOrder) {
+    gWiredTigerInlineOplogVisibility.store(true);
+    ON_BLOCK_EXIT([] { gWiredTigerInlineOplogVisibility.store(false); });
+
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("local.oplog.rs", 100000, -1));
+    auto wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+
+    for (int inc = 1; inc <= 3; ++inc) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        RecordId id = _oplogOrderInsertOplog(opCtx.get(), rs, inc);
+        ASSERT(wtrs->isOpHidden_forTest(id));
+        uow.commit();
+        ASSERT(!wtrs->isOpHidden_forTest(id));
+    }
+}
+
+// Test that an inline visibility update stops at an oplog hole, and that the commit filling the
+// hole makes every entry behind it visible.
+TEST(WiredTigerRecordStoreTest, OplogInlineVisibilityOutOfOrder) {
+    gWiredTigerInlineOplogVisibility.store(true);
+    ON_BLOCK_EXIT([] { gWiredTigerInlineOplogVisibility.store(false); });
+
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("local.oplog.rs", 100000, -1));
+    auto wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+
+    ServiceContext::UniqueOperationContext longLivedOp(harnessHelper->newOperationContext());
+    WriteUnitOfWork uow(longLivedOp.get());
+    RecordId id1 = _oplogOrderInsertOplog(longLivedOp.get(), rs, 1);
+
+    RecordId id2;
+    {
+        auto innerClient = harnessHelper->serviceContext()->makeClient("inner");
+        ServiceContext::UniqueOperationContext opCtx(
+            harnessHelper->newOperationContext(innerClient.get()));
+        WriteUnitOfWork uow(opCtx.get());
+        id2 = _oplogOrderInsertOplog(opCtx.get(), rs, 2);
+        uow.commit();
+    }
+
+    // The uncommitted write at 'id1' is a hole behind 'id2'.
+    ASSERT(wtrs->isOpHidden_forTest(id1));
+    ASSERT(wtrs->isOpHidden_forTest(id2));
+
+    uow.commit();
+
+    ASSERT(!wtrs->isOpHidden_forTest(id1));
+    ASSERT(!wtrs->isOpHidden_forTest(id2));
+}
+
+// Test that concurrent committers, most of which find another inline update in progress and fall
+// back to the visibility thread, never move the oplog read timestamp backwards and eventually make
+// every entry visible.
+TEST(WiredTigerRecordStoreTest, OplogInlineVisibilityConcurrentCommits) {
+    gWiredTigerInlineOplogVisibility.store(true);
+    ON_BLOCK_EXIT([] { gWiredTigerInlineOplogVisibility.store(false); });
+
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("local.oplog.rs", 100000, -1));
+    auto wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto oplogManager = WiredTigerRecoveryUnit::get(opCtx.get())
+                            ->getSessionCache()
+                            ->getKVEngine()
+                            ->getOplogManager();
+
+    const int kNumThreads = 4;
+    const int kCommitsPerThread = 25;
+    AtomicWord<int> nextInc{1};
+    AtomicWord<int> finishedThreads{0};
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&, i] {
+            ThreadClient tc("oplogCommitter" + std::to_string(i), harnessHelper->serviceContext());
+            for (int j = 0; j < kCommitsPerThread; ++j) {
+                auto committerOpCtx = harnessHelper->newOperationContext();
+                WriteUnitOfWork uow(committerOpCtx.get());
+                _oplogOrderInsertOplog(committerOpCtx.get(), rs, nextInc.fetchAndAdd(1));
+                uow.commit();
+            }
+            finishedThreads.fetchAndAdd(1);
+        });
+    }
+
+    bool wentBackwards = false;
+    std::uint64_t lastReadTimestamp = oplogManager->getOplogReadTimestamp();
+    while (finishedThreads.load() < kNumThreads) {
+        auto readTimestamp = oplogManager->getOplogReadTimestamp();
+        wentBackwards = wentBackwards || readTimestamp < lastReadTimestamp;
+        lastReadTimestamp = readTimestamp;
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_FALSE(wentBackwards);
+
+    rs->waitForAllEarlierOplogWritesToBeVisible(opCtx.get());
+    auto lastId = RecordId(Timestamp(5, kNumThreads * kCommitsPerThread).asULL());
+    ASSERT(!wtrs->isOpHidden_forTest(lastId));
+}
+
+// Test that halting the oplog manager waits for an inline visibility update that is in progress,
+// since the committing thread still uses the oplog record store to notify capped waiters.
+TEST(WiredTigerRecordStoreTest, OplogInlineVisibilityHaltWaitsForInlineUpdate) {
+    gWiredTigerInlineOplogVisibility.store(true);
+    ON_BLOCK_EXIT([] { gWiredTigerInlineOplogVisibility.store(false); });
+
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("local.oplog.rs", 100000, -1));
+    auto wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto kvEngine = WiredTigerRecoveryUnit::get(opCtx.get())->getSessionCache()->getKVEngine();
+    auto oplogManager = kvEngine->getOplogManager();
+
+    ON_BLOCK_EXIT([] { WTPauseInlineOplogVisibilityUpdate.setMode(FailPoint::off); });
+    auto timesEntered = WTPauseInlineOplogVisibilityUpdate.setMode(FailPoint::alwaysOn);
+
+    RecordId id;
+    stdx::thread committer([&] {
+        ThreadClient tc("inlineCommitter", harnessHelper->serviceContext());
+        auto committerOpCtx = harnessHelper->newOperationContext();
+        WriteUnitOfWork uow(committerOpCtx.get());
+        id = _oplogOrderInsertOplog(committerOpCtx.get(), rs, 1);
+        uow.commit();
+    });
+    WTPauseInlineOplogVisibilityUpdate.waitForTimesEntered(timesEntered + 1);
+
+    AtomicWord<bool> halted{false};
+    stdx::thread halter([&] {
+        kvEngine->haltOplogManager(wtrs);
+        halted.store(true);
+    });
+
+    // Wait a bit and check that the halt is still blocked behind the inline update.
+    sleepmillis(100);
+    ASSERT_FALSE(halted.load());
+
+    WTPauseInlineOplogVisibilityUpdate.setMode(FailPoint::off);
+    committer.join();
+    halter.join();
+
+    ASSERT_TRUE(halted.load());
+    ASSERT_FALSE(oplogManager->isRunning());
+    ASSERT_GTE(oplogManager->getOplogReadTimestamp(), static_cast<std::uint64_t>(id.repr()));
+}
+
 TEST(WiredTigerRecordStoreTest, AppendCustomStatsMetadata) {
     std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore("a.b"));
@@ -995,5 +1154,95 @@ TEST(WiredTigerRecordStoreTest, CursorInActiveTxnAfterSeek) {
     }
 }
 
+// Inserts 'nRecords' small records in one insertRecords() call and returns their RecordIds.
+std::vector<RecordId> insertRecordBatch(OperationContext* opCtx,
+                                        RecordStore* rs,
+                                        size_t nRecords) {
+    const std::string data = "a";
+    std::vector<Record> records(nRecords,
+                                Record{RecordId(), RecordData(data.c_str(), data.size() + 1)});
+    std::vector<Timestamp> timestamps(nRecords);
+    ASSERT_OK(rs->insertRecords(opCtx, &records, timestamps));
+
+    std::vector<RecordId> ids;
+    for (const auto& record : records) {
+        ids.push_back(record.id);
+    }
+    return ids;
+}
+
+void assertContiguous(const std::vector<RecordId>& ids) {
+    for (size_t i = 1; i < ids.size(); ++i) {
+        ASSERT_EQ(ids[i - 1].repr() + 1, ids[i].repr());
+    }
+}
+
+TEST(WiredTigerRecordStoreTest, InsertRecordsReservesContiguousIdsThatAreNeverReused) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+    std::vector<RecordId> first;
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        first = insertRecordBatch(opCtx.get(), rs.get(), 5);
+        uow.commit();
+    }
+    assertContiguous(first);
+
+    // A single insert takes the id right after the batch.
+    RecordId single;
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "b", 2, Timestamp());
+        ASSERT_OK(res.getStatus());
+        single = res.getValue();
+        uow.commit();
+    }
+    ASSERT_EQ(first.back().repr() + 1, single.repr());
+
+    // Ids reserved by a batch that rolls back are not handed out again.
+    std::vector<RecordId> aborted;
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        aborted = insertRecordBatch(opCtx.get(), rs.get(), 3);
+    }
+    assertContiguous(aborted);
+    ASSERT_GT(aborted.front(), single);
+
+    std::vector<RecordId> last;
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        last = insertRecordBatch(opCtx.get(), rs.get(), 4);
+        uow.commit();
+    }
+    assertContiguous(last);
+    ASSERT_GT(last.front(), aborted.back());
+
+    ASSERT_EQ(10, rs->numRecords(opCtx.get()));
+}
+
+TEST(WiredTigerRecordStoreTest, ConcurrentInsertRecordsReserveDisjointIdRanges) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    ServiceContext::UniqueOperationContext t1(harnessHelper->newOperationContext());
+    auto client2 = harnessHelper->serviceContext()->makeClient("c2");
+    auto t2 = harnessHelper->newOperationContext(client2.get());
+
+    // Both batches reserve their ids before either transaction commits.
+    WriteUnitOfWork w1(t1.get());
+    WriteUnitOfWork w2(t2.get());
+    auto ids1 = insertRecordBatch(t1.get(), rs.get(), 4);
+    auto ids2 = insertRecordBatch(t2.get(), rs.get(), 4);
+    assertContiguous(ids1);
+    assertContiguous(ids2);
+    ASSERT_EQ(ids1.back().repr() + 1, ids2.front().repr());
+
+    w2.commit();
+    w1.commit();
+    ASSERT_EQ(8, rs->numRecords(t1.get()));
+}
+
 }  // namespace
 }  // namespace mongo
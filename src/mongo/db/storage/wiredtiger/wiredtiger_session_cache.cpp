@@ -36,6 +36,7 @@
 #include <memory>
 
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
@@ -45,6 +46,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/logv2/log.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -197,19 +199,51 @@ uint64_t WiredTigerSession::genTableId() {
 
 // -----------------------
 
-WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
+namespace {
+// Upper bound on the number of shards derived from the core count. Beyond this the cost of
+// scanning shards for idle sessions outweighs the reduction in latch contention.
+constexpr size_t kMaxDefaultSessionCacheShards = 64;
+
+size_t numSessionCacheShards(size_t requested) {
+    if (requested == 0) {
+        requested = static_cast<size_t>(gWiredTigerSessionCacheShards);
+    }
+    if (requested == 0) {
+        requested = std::min(static_cast<size_t>(ProcessInfo::getNumAvailableCores()),
+                             kMaxDefaultSessionCacheShards);
+    }
+    return std::max(requested, size_t(1));
+}
+
+// Threads are assigned home shards round-robin in the order in which they first use a session
+// cache, which spreads concurrently running threads evenly over the shards.
+AtomicWord<unsigned> nextHomeShardSeed{0};
+thread_local boost::optional<unsigned> homeShardSeed;
+}  // namespace
+
+WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine, size_t numShards)
     : _engine(engine),
       _conn(engine->getConnection()),
       _clockSource(_engine->getClockSource()),
       _shuttingDown(0),
-      _prepareCommitOrAbortCounter(0) {}
+      _prepareCommitOrAbortCounter(0) {
+    for (size_t i = 0; i < numSessionCacheShards(numShards); ++i) {
+        _shards.push_back(std::make_unique<AlignedShard>());
+    }
+}
 
-WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource* cs)
+WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn,
+                                               ClockSource* cs,
+                                               size_t numShards)
     : _engine(nullptr),
       _conn(conn),
       _clockSource(cs),
       _shuttingDown(0),
-      _prepareCommitOrAbortCounter(0) {}
+      _prepareCommitOrAbortCounter(0) {
+    for (size_t i = 0; i < numSessionCacheShards(numShards); ++i) {
+        _shards.push_back(std::make_unique<AlignedShard>());
+    }
+}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
@@ -374,9 +408,11 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<Latch> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<Latch> lock(shard->mutex);
+        for (SessionCache::iterator i = shard->sessions.begin(); i != shard->sessions.end(); i++) {
+            (*i)->closeAllCursors(uri);
+        }
     }
 }
 
@@ -384,15 +420,32 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<Latch> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<Latch> lock(shard->mutex);
+        for (SessionCache::iterator i = shard->sessions.begin(); i != shard->sessions.end(); i++) {
+            (*i)->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 size_t WiredTigerSessionCache::getIdleSessionsCount() {
-    stdx::lock_guard<Latch> lock(_cacheLock);
-    return _sessions.size();
+    size_t count = 0;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<Latch> lock(shard->mutex);
+        count += shard->sessions.size();
+    }
+    return count;
+}
+
+void WiredTigerSessionCache::appendStats(BSONObjBuilder* builder) {
+    BSONObjBuilder bob(builder->subobjStart("session cache"));
+    bob.append("shards", static_cast<long long>(_shards.size()));
+    bob.append("idle sessions", static_cast<long long>(getIdleSessionsCount()));
+    bob.append("sessions reused from home shard", _sessionsFromHomeShard.load());
+    bob.append("sessions stolen from other shards", _sessionsStolen.load());
+    bob.append("sessions opened", _sessionsOpened.load());
+    bob.append("contended shard acquisitions", _contendedShardAcquisitions.load());
+    bob.done();
 }
 
 void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
@@ -402,30 +455,41 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
     }
 
     auto cutoffTime = _clockSource->now() - Milliseconds(idleTimeMillis);
-    {
-        stdx::lock_guard<Latch> lock(_cacheLock);
-        // Discard all sessions that became idle before the cutoff time
-        for (auto it = _sessions.begin(); it != _sessions.end();) {
-            auto session = *it;
-            invariant(session->getIdleExpireTime() != Date_t::min());
-            if (session->getIdleExpireTime() < cutoffTime) {
-                it = _sessions.erase(it);
-                delete (session);
-            } else {
-                ++it;
+    for (auto&& shard : _shards) {
+        SessionCache expired;
+        {
+            stdx::lock_guard<Latch> lock(shard->mutex);
+            // Discard all sessions that became idle before the cutoff time
+            for (auto it = shard->sessions.begin(); it != shard->sessions.end();) {
+                auto session = *it;
+                invariant(session->getIdleExpireTime() != Date_t::min());
+                if (session->getIdleExpireTime() < cutoffTime) {
+                    it = shard->sessions.erase(it);
+                    expired.push_back(session);
+                } else {
+                    ++it;
+                }
             }
         }
+
+        // Close the expired sessions outside of the shard latch.
+        for (auto session : expired) {
+            delete session;
+        }
     }
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. Sessions released
+    // concurrently recheck the epoch under their shard latch, so any session pushed onto a shard
+    // before we visit it below is collected by the swap.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<Latch> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+    SessionCache swap;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<Latch> lock(shard->mutex);
+        swap.insert(swap.end(), shard->sessions.begin(), shard->sessions.end());
+        shard->sessions.clear();
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -437,25 +501,76 @@ bool WiredTigerSessionCache::isEphemeral() {
     return _engine && _engine->isEphemeral();
 }
 
+size_t WiredTigerSessionCache::_homeShardIndex() const {
+    if (!homeShardSeed) {
+        homeShardSeed = nextHomeShardSeed.fetchAndAdd(1);
+    }
+    return *homeShardSeed % _shards.size();
+}
+
+stdx::unique_lock<Latch> WiredTigerSessionCache::_lockShard(Shard& shard) {
+    stdx::unique_lock<Latch> lock(shard.mutex, stdx::try_to_lock);
+    if (!lock.owns_lock()) {
+        _contendedShardAcquisitions.fetchAndAdd(1);
+        lock.lock();
+    }
+    return lock;
+}
+
+WiredTigerSession* WiredTigerSessionCache::_stealSession(size_t homeIndex) {
+    // Start scanning at the shard after the home shard so that threads with different home shards
+    // do not all converge on the same victim.
+    for (size_t offset = 1; offset < _shards.size(); ++offset) {
+        Shard& victim = *_shards[(homeIndex + offset) % _shards.size()];
+        stdx::unique_lock<Latch> lock(victim.mutex, stdx::try_to_lock);
+        if (!lock.owns_lock()) {
+            // Another thread is working on this shard; don't wait for it when we can open a new
+            // session instead.
+            _contendedShardAcquisitions.fetchAndAdd(1);
+            continue;
+        }
+        if (!victim.sessions.empty()) {
+            WiredTigerSession* session = victim.sessions.back();
+            victim.sessions.pop_back();
+            return session;
+        }
+    }
+    return nullptr;
+}
+
 UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // We should never be able to get here after _shuttingDown is set, because no new
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
+    const size_t homeIndex = _homeShardIndex();
+    Shard& homeShard = *_shards[homeIndex];
     {
-        stdx::lock_guard<Latch> lock(_cacheLock);
-        if (!_sessions.empty()) {
+        auto lock = _lockShard(homeShard);
+        if (!homeShard.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+            WiredTigerSession* cachedSession = homeShard.sessions.back();
+            homeShard.sessions.pop_back();
+            lock.unlock();
+
+            _sessionsFromHomeShard.fetchAndAdd(1);
             // Reset the idle time
             cachedSession->setIdleExpireTime(Date_t::min());
             return UniqueWiredTigerSession(cachedSession);
         }
     }
 
+    // The home shard is empty. Rebalance by taking an idle session from another shard; it will be
+    // released back to our home shard.
+    if (WiredTigerSession* stolenSession = _stealSession(homeIndex)) {
+        _sessionsStolen.fetchAndAdd(1);
+        stolenSession->setIdleExpireTime(Date_t::min());
+        return UniqueWiredTigerSession(stolenSession);
+    }
+
     // Outside of the cache partition lock, but on release will be put back on the cache
+    _sessionsOpened.fetchAndAdd(1);
     return UniqueWiredTigerSession(
         new WiredTigerSession(_conn, this, _epoch.load(), _cursorEpoch.load()));
 }
@@ -510,10 +625,11 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->setIdleExpireTime(_clockSource->now());
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<Latch> lock(_cacheLock);
+        Shard& homeShard = *_shards[_homeShardIndex()];
+        auto lock = _lockShard(homeShard);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            homeShard.sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
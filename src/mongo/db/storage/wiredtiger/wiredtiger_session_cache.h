@@ -39,9 +39,11 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -206,11 +208,21 @@ private:
 /**
  *  This cache implements a shared pool of WiredTiger sessions with the goal to amortize the
  *  cost of session creation and destruction over multiple uses.
+ *
+ *  Idle sessions are partitioned into shards, each guarded by its own latch. Every thread is
+ *  assigned a home shard which it uses for both getSession() and releaseSession(), so that threads
+ *  running on different cores do not contend on a single latch. When the home shard is empty,
+ *  getSession() steals an idle session from another shard before opening a new one.
  */
 class WiredTigerSessionCache {
 public:
-    WiredTigerSessionCache(WiredTigerKVEngine* engine);
-    WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource* cs);
+    /**
+     * 'numShards' controls how many partitions the idle session pool is split into. A value of 0
+     * derives the number of shards from the wiredTigerSessionCacheShards server parameter and the
+     * number of available cores.
+     */
+    WiredTigerSessionCache(WiredTigerKVEngine* engine, size_t numShards = 0);
+    WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource* cs, size_t numShards = 0);
     ~WiredTigerSessionCache();
 
     /**
@@ -259,6 +271,18 @@ public:
      */
     size_t getIdleSessionsCount();
 
+    /**
+     * Returns the number of shards the idle sessions are partitioned into.
+     */
+    size_t getShardCount() const {
+        return _shards.size();
+    }
+
+    /**
+     * Appends statistics about session reuse and shard latch contention to 'builder'.
+     */
+    void appendStats(BSONObjBuilder* builder);
+
     /**
      * Closes all cached sessions whose idle expiration time has been reached.
      */
@@ -376,9 +400,22 @@ private:
     AtomicWord<unsigned> _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    Mutex _cacheLock = MONGO_MAKE_LATCH("WiredTigerSessionCache::_cacheLock");
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+
+    // A partition of the idle session pool. Aligned to avoid false sharing between the latches of
+    // neighbouring shards.
+    struct Shard {
+        Mutex mutex = MONGO_MAKE_LATCH("WiredTigerSessionCache::Shard::mutex");
+        SessionCache sessions;
+    };
+    using AlignedShard = CacheAligned<Shard>;
+    std::vector<std::unique_ptr<AlignedShard>> _shards;
+
+    // Statistics reported through appendStats().
+    AtomicWord<long long> _sessionsFromHomeShard{0};
+    AtomicWord<long long> _sessionsStolen{0};
+    AtomicWord<long long> _sessionsOpened{0};
+    AtomicWord<long long> _contendedShardAcquisitions{0};
 
     // Bumped when all open sessions need to be closed
     AtomicWord<unsigned long long> _epoch;  // atomic so we can check it outside of the lock
@@ -415,6 +452,24 @@ private:
      * session and releasing it, the session is directly released. This method is thread safe.
      */
     void releaseSession(WiredTigerSession* session);
+
+    /**
+     * Returns the index of the shard the calling thread should prefer when getting and releasing
+     * sessions.
+     */
+    size_t _homeShardIndex() const;
+
+    /**
+     * Locks 'shard', recording whether the latch was already held by another thread.
+     */
+    stdx::unique_lock<Latch> _lockShard(Shard& shard);
+
+    /**
+     * Takes the most recently released session from any shard other than the one at 'homeIndex'.
+     * Shards whose latch is currently held are skipped. Returns nullptr if no idle session was
+     * found.
+     */
+    WiredTigerSession* _stealSession(size_t homeIndex);
 };
 
 /**
@@ -33,8 +33,10 @@
 #include <string>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/system_clock_source.h"
@@ -73,10 +75,10 @@ private:
 
 class WiredTigerSessionCacheHarnessHelper {
 public:
-    WiredTigerSessionCacheHarnessHelper(StringData extraStrings)
+    WiredTigerSessionCacheHarnessHelper(StringData extraStrings, size_t numShards = 0)
         : _dbpath("wt_test"),
           _connection(_dbpath.path(), extraStrings),
-          _sessionCache(_connection.getConnection(), _connection.getClockSource()) {}
+          _sessionCache(_connection.getConnection(), _connection.getClockSource(), numShards) {}
 
 
     WiredTigerSessionCache* getSessionCache() {
@@ -113,4 +115,47 @@ TEST(WiredTigerSessionCacheTest, CheckSessionCacheCleanup) {
     ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
 }
 
+TEST(WiredTigerSessionCacheTest, SessionsAreStolenFromOtherShards) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("", 4);
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+    ASSERT_EQUALS(sessionCache->getShardCount(), 4U);
+
+    // Release a session on another thread so that it is cached on that thread's home shard.
+    stdx::thread([&] { sessionCache->getSession(); }).join();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+
+    // This thread has a different home shard, but reuses the idle session rather than opening one.
+    {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+
+    BSONObjBuilder bob;
+    sessionCache->appendStats(&bob);
+    BSONObj stats = bob.obj()["session cache"].Obj();
+    ASSERT_EQUALS(stats["shards"].numberLong(), 4);
+    ASSERT_EQUALS(stats["sessions opened"].numberLong(), 1);
+    ASSERT_EQUALS(stats["sessions reused from home shard"].numberLong() +
+                      stats["sessions stolen from other shards"].numberLong(),
+                  1);
+}
+
+TEST(WiredTigerSessionCacheTest, CloseAllEmptiesEveryShard) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("", 4);
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&] { sessionCache->getSession(); });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_GTE(sessionCache->getIdleSessionsCount(), 1U);
+
+    sessionCache->closeAll();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+}
+
 }  // namespace mongo
@@ -112,8 +112,12 @@ std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(Strin
         WT_ITEM key = {uri.rawData(), uri.size()};
         _cursor->set_key(_cursor, &key);
         int ret = _cursor->search(_cursor);
-        if (ret == WT_NOTFOUND)
-            return std::make_shared<SizeInfo>();
+        if (ret == WT_NOTFOUND) {
+            // The record store is new, and so empty.
+            auto sizeInfo = std::make_shared<SizeInfo>();
+            sizeInfo->hasContentHash.store(!_contentHashesDiscarded.load());
+            return sizeInfo;
+        }
         invariantWTOK(ret);
     }
 
@@ -126,8 +130,13 @@ std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(Strin
                 "WiredTigerSizeStorer::load {uri} -> {data}",
                 "uri"_attr = uri,
                 "data"_attr = redact(data));
-    return std::make_shared<SizeInfo>(data["numRecords"].safeNumberLong(),
-                                      data["dataSize"].safeNumberLong());
+    auto sizeInfo = std::make_shared<SizeInfo>(data["numRecords"].safeNumberLong(),
+                                               data["dataSize"].safeNumberLong());
+    if (auto contentHash = data["contentHash"]; contentHash && !_contentHashesDiscarded.load()) {
+        sizeInfo->contentHash.store(static_cast<unsigned long long>(contentHash.safeNumberLong()));
+        sizeInfo->hasContentHash.store(true);
+    }
+    return sizeInfo;
 }
 
 void WiredTigerSizeStorer::flush(bool syncToDisk) {
@@ -163,8 +172,14 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
             // still be written back. So, the required order is to clear the dirty flag first.
             SizeInfo& sizeInfo = *it->second;
             sizeInfo._dirty.store(false);
-            BSONObj data = BSON("numRecords" << sizeInfo.numRecords.load() << "dataSize"
-                                             << sizeInfo.dataSize.load());
+            BSONObjBuilder dataBuilder;
+            dataBuilder.append("numRecords", sizeInfo.numRecords.load());
+            dataBuilder.append("dataSize", sizeInfo.dataSize.load());
+            if (sizeInfo.hasContentHash.load()) {
+                dataBuilder.append("contentHash",
+                                   static_cast<long long>(sizeInfo.contentHash.load()));
+            }
+            BSONObj data = dataBuilder.obj();
 
             auto& uri = it->first;
             LOGV2_DEBUG(22425,
@@ -44,7 +44,8 @@ namespace mongo {
 /**
  * The WiredTigerSizeStorer class serves as a write buffer to durably store size information for
  * MongoDB collections. The size storer uses a separate WiredTiger table as key-value store, where
- * the URI serves as key and the value is a BSON document with `numRecords` and `dataSize` fields.
+ * the URI serves as key and the value is a BSON document with `numRecords` and `dataSize` fields,
+ * and a `contentHash` field for record stores that maintain one.
  * This buffering is neccessary to allow concurrent updates of size information without causing
  * write conflicts. The dirty size information is periodically stored written back to the table,
  * including on clean shutdown and/or catalog reload. Crashes or replica-set fail-overs may result
@@ -55,9 +56,10 @@ namespace mongo {
 class WiredTigerSizeStorer {
 public:
     /**
-     * SizeInfo is a thread-safe buffer for keeping track of the number of documents in a collection
-     * and their data size. Storing a SizeInfo in the WiredTigerSizeStorer results in shared
-     * ownership. The SizeInfo may still be updated after it is stored in the SizeStorer.
+     * SizeInfo is a thread-safe buffer for keeping track of the number of documents in a collection,
+     * their data size and optionally their content hash. Storing a SizeInfo in the
+     * WiredTigerSizeStorer results in shared ownership. The SizeInfo may still be updated after it
+     * is stored in the SizeStorer.
      * The 'dirty' field is used by the size storer to cheaply merge duplicate stores of the same
      * SizeInfo.
      */
@@ -71,6 +73,10 @@ public:
         AtomicWord<long long> numRecords;
         AtomicWord<long long> dataSize;
 
+        // Only meaningful while 'hasContentHash' is true.
+        AtomicWord<unsigned long long> contentHash;
+        AtomicWord<bool> hasContentHash;
+
     private:
         friend WiredTigerSizeStorer;
         AtomicWord<bool> _dirty;
@@ -89,6 +95,14 @@ public:
 
     std::shared_ptr<SizeInfo> load(StringData uri) const;
 
+    /**
+     * Makes load() return SizeInfos without a content hash from now on, for use when the stored
+     * hashes may not reflect the latest writes, such as after an unclean shutdown.
+     */
+    void discardContentHashes() {
+        _contentHashesDiscarded.store(true);
+    }
+
     /**
      * Writes all changes to the underlying table.
      */
@@ -97,6 +111,7 @@ public:
 private:
     const WiredTigerSession _session;
     const bool _readOnly;
+    AtomicWord<bool> _contentHashesDiscarded{false};
     // Guards _cursor. Acquire *before* _bufferMutex.
     mutable Mutex _cursorMutex = MONGO_MAKE_LATCH("WiredTigerSessionStorer::_cursorMutex");
     WT_CURSOR* _cursor;  // pointer is const after constructor
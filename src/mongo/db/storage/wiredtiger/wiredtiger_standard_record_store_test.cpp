@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include <memory>
+#include <set>
 #include <sstream>
 #include <string>
 #include <time.h>
@@ -43,12 +44,18 @@
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/kv/kv_engine_test_harness.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
+#include "mongo/db/storage/record_content_hash.h"
 #include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/wiredtiger/oplog_stone_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_segments.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
@@ -186,6 +193,10 @@ public:
         return _engine.getConnection();
     }
 
+    WiredTigerKVEngine* getEngine() {
+        return &_engine;
+    }
+
 private:
     unittest::TempDir _dbpath;
     ClockSourceMock _cs;
@@ -344,5 +355,505 @@ TEST_F(SizeStorerUpdateTest, Basic) {
     ASSERT_EQUALS(getDataSize(), val);
 }
 
+TEST(WiredTigerRecordStoreTest, ContentHash) {
+    gWiredTigerCollectionContentHashes = true;
+    ON_BLOCK_EXIT([] { gWiredTigerCollectionContentHashes = false; });
+
+    WiredTigerHarnessHelper harnessHelper;
+    unique_ptr<RecordStore> rs(harnessHelper.newNonCappedRecordStore());
+    const string ident = rs->getIdent();
+    const string uri = checked_cast<WiredTigerRecordStore*>(rs.get())->getURI();
+
+    const bool enableWtLogging = false;
+    WiredTigerSizeStorer ss(
+        harnessHelper.conn(), WiredTigerKVEngine::kTableUriPrefix + "sizeStorer", enableWtLogging);
+
+    auto openRecordStore = [&] {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+        WiredTigerRecordStore::Params params;
+        params.ns = "a.b"_sd;
+        params.ident = ident;
+        params.engineName = kWiredTigerEngineName;
+        params.isCapped = false;
+        params.isEphemeral = false;
+        params.cappedMaxSize = -1;
+        params.cappedMaxDocs = -1;
+        params.cappedCallback = nullptr;
+        params.sizeStorer = &ss;
+        params.tracksSizeAdjustments = true;
+
+        rs.reset();
+        auto ret = new StandardWiredTigerRecordStore(nullptr, opCtx.get(), params);
+        ret->postConstructorInit(opCtx.get());
+        rs.reset(ret);
+    };
+    auto hash = [](StringData data) { return hashRecordContent(data.rawData(), data.size()); };
+
+    // A record store without size information is empty, so starts with a valid hash.
+    openRecordStore();
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+    ASSERT_EQ(uint64_t(0), *rs->contentHash(opCtx.get()));
+
+    RecordId first, second;
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        first = unittest::assertGet(rs->insertRecord(opCtx.get(), "abc", 4, Timestamp()));
+        second = unittest::assertGet(rs->insertRecord(opCtx.get(), "def", 4, Timestamp()));
+        uow.commit();
+    }
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->updateRecord(opCtx.get(), first, "ghi", 4));
+        rs->deleteRecord(opCtx.get(), second);
+        uow.commit();
+    }
+    {
+        // Rolled back writes leave the hash unchanged.
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecord(opCtx.get(), "jkl", 4, Timestamp()).getStatus());
+    }
+    const uint64_t expected = hash(StringData("ghi", 4));
+    ASSERT_EQ(expected, *rs->contentHash(opCtx.get()));
+
+    // The hash is persisted.
+    ss.flush(true);
+    openRecordStore();
+    ASSERT_EQ(expected, *rs->contentHash(opCtx.get()));
+
+    // Discarded hashes are not trusted until replaced.
+    ss.discardContentHashes();
+    openRecordStore();
+    ASSERT_FALSE(rs->contentHash(opCtx.get()));
+    rs->updateContentHashAfterRepair(opCtx.get(), expected);
+    ASSERT_EQ(expected, *rs->contentHash(opCtx.get()));
+
+    rs->updateStatsAfterRepair(opCtx.get(), 1, 4);
+    ASSERT_FALSE(rs->contentHash(opCtx.get()));
+
+    rs.reset();  // this has to be deleted before ss
+}
+
+// Only oplogs with standard keys are partitioned, so these tests are not shared with the prefixed
+// record store.
+class PartitionedOplogTest : public unittest::Test {
+protected:
+    using SegmentPtr = WiredTigerRecordStore::OplogSegments::SegmentPtr;
+
+    void setUp() override {
+        gPartitionedOplog = true;
+        serverGlobalParams.mutableFeatureCompatibility.setVersion(
+            ServerGlobalParams::FeatureCompatibility::kLatest);
+
+        harnessHelper = std::make_unique<WiredTigerHarnessHelper>();
+        rs = harnessHelper->newCappedRecordStore(kNs.toString(), kCappedMaxSize, -1);
+        wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+        ASSERT(wtrs->oplogSegments());
+    }
+
+    void tearDown() override {
+        rs.reset();
+        harnessHelper.reset();
+        serverGlobalParams.mutableFeatureCompatibility.reset();
+        gPartitionedOplog = false;
+    }
+
+    /**
+     * Closes the oplog and opens it again, as a restart would, with 'partitioned' as the value of
+     * the partitionedOplog parameter.
+     */
+    void reopen(bool partitioned) {
+        const std::string ident = rs->getIdent();
+        rs.reset();
+        gPartitionedOplog = partitioned;
+
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WiredTigerRecordStore::Params params;
+        params.ns = kNs;
+        params.ident = ident;
+        params.engineName = kWiredTigerEngineName;
+        params.isCapped = true;
+        params.isEphemeral = false;
+        params.cappedMaxSize = kCappedMaxSize;
+        params.cappedMaxDocs = -1;
+        params.cappedCallback = nullptr;
+        params.sizeStorer = nullptr;
+        params.tracksSizeAdjustments = true;
+
+        auto ret = std::make_unique<StandardWiredTigerRecordStore>(
+            harnessHelper->getEngine(), opCtx.get(), params);
+        ret->postConstructorInit(opCtx.get());
+        wtrs = ret.get();
+        rs = std::move(ret);
+    }
+
+    RecordId insert(OperationContext* opCtx, const Timestamp& ts, int size = 100) {
+        BSONObj objTemplate = BSON("ts" << ts << "str"
+                                        << "");
+        BSONObj obj = BSON("ts" << ts << "str" << std::string(size - objTemplate.objsize(), 'x'));
+
+        WriteUnitOfWork wuow(opCtx);
+        ASSERT_OK(rs->oplogDiskLocRegister(opCtx, ts, false));
+        auto id = unittest::assertGet(rs->insertRecord(opCtx, obj.objdata(), obj.objsize(), ts));
+        wuow.commit();
+        return id;
+    }
+
+    // Inserts one record for each of 'timestamps' and makes them visible to oplog readers.
+    void insert(const std::vector<Timestamp>& timestamps) {
+        {
+            ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+            for (auto&& ts : timestamps) {
+                ASSERT_EQ(RecordId(ts.asLL()), insert(opCtx.get(), ts));
+            }
+        }
+        rs->waitForAllEarlierOplogWritesToBeVisible(harnessHelper->newOperationContext().get());
+    }
+
+    void rotate() {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        wtrs->oplogSegments()->rotate(opCtx.get());
+    }
+
+    std::vector<SegmentPtr> segments() {
+        return wtrs->oplogSegments()->getAll();
+    }
+
+    // Returns the RecordIds stored in the table of 'segment'.
+    std::vector<RecordId> recordsIn(const SegmentPtr& segment) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WiredTigerCursor cursor(segment->uri, segment->tableId, true, opCtx.get());
+        WT_CURSOR* c = cursor.get();
+
+        std::vector<RecordId> ids;
+        int ret;
+        while ((ret = c->next(c)) == 0) {
+            int64_t key;
+            invariantWTOK(c->get_key(c, &key));
+            ids.push_back(RecordId(key));
+        }
+        ASSERT_EQ(WT_NOTFOUND, ret);
+        return ids;
+    }
+
+    std::vector<RecordId> scan(bool forward) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        auto cursor = rs->getCursor(opCtx.get(), forward);
+
+        std::vector<RecordId> ids;
+        while (auto record = cursor->next()) {
+            ids.push_back(record->id);
+        }
+        return ids;
+    }
+
+    // Sets up three segments holding (1, 1) and (1, 2), (1, 3) and (1, 4), and (1, 5) and (1, 6).
+    void makeThreeSegments() {
+        insert({Timestamp(1, 1), Timestamp(1, 2)});
+        rotate();
+        insert({Timestamp(1, 3), Timestamp(1, 4)});
+        rotate();
+        insert({Timestamp(1, 5), Timestamp(1, 6)});
+        ASSERT_EQ(3U, wtrs->oplogSegments()->numSegments());
+    }
+
+    static std::vector<RecordId> ids(const std::vector<int>& increments) {
+        std::vector<RecordId> ids;
+        for (int i : increments) {
+            ids.push_back(RecordId(1, i));
+        }
+        return ids;
+    }
+
+    static constexpr auto kNs = "local.oplog.stones"_sd;
+    static constexpr int64_t kCappedMaxSize = 1024 * 1024;
+
+    std::unique_ptr<WiredTigerHarnessHelper> harnessHelper;
+    std::unique_ptr<RecordStore> rs;
+    WiredTigerRecordStore* wtrs = nullptr;
+};
+
+TEST_F(PartitionedOplogTest, RotateStartsSegmentAfterHighestRoutedInsert) {
+    ASSERT_FALSE(rs->hasOplogSegments());
+
+    insert({Timestamp(1, 1), Timestamp(1, 3)});
+    rotate();
+    ASSERT_EQ(2U, wtrs->oplogSegments()->numSegments());
+    ASSERT_TRUE(rs->hasOplogSegments());
+    ASSERT_EQ(RecordId(1, 4), segments()[1]->start);
+
+    // Nothing has been inserted into the newest segment yet.
+    rotate();
+    ASSERT_EQ(2U, wtrs->oplogSegments()->numSegments());
+
+    // An out-of-order insert below the start of the newest segment goes to the segment covering
+    // it, and a scan still returns every record in order.
+    insert({Timestamp(1, 5), Timestamp(1, 2)});
+    ASSERT_EQ(ids({1, 2, 3}), recordsIn(segments()[0]));
+    ASSERT_EQ(ids({5}), recordsIn(segments()[1]));
+    ASSERT_EQ(ids({1, 2, 3, 5}), scan(true));
+    ASSERT_EQ(ids({5, 3, 2, 1}), scan(false));
+
+    // The next segment starts after the highest insert routed, not the last one.
+    rotate();
+    ASSERT_EQ(RecordId(1, 6), segments()[2]->start);
+}
+
+TEST_F(PartitionedOplogTest, CursorsCrossSegmentBoundaries) {
+    makeThreeSegments();
+    ASSERT_EQ(ids({1, 2, 3, 4, 5, 6}), scan(true));
+    ASSERT_EQ(ids({6, 5, 4, 3, 2, 1}), scan(false));
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    RecordData data;
+    for (int i = 1; i <= 6; ++i) {
+        ASSERT_TRUE(rs->findRecord(opCtx.get(), RecordId(1, i), &data));
+    }
+
+    // Seeking positions a cursor in the segment of the record it finds.
+    auto reverse = rs->getCursor(opCtx.get(), false);
+    ASSERT_EQ(RecordId(1, 3), reverse->seekExact(RecordId(1, 3))->id);
+    ASSERT_EQ(RecordId(1, 2), reverse->next()->id);
+
+    auto forward = rs->getCursor(opCtx.get(), true);
+    ASSERT_EQ(RecordId(1, 4), forward->seekExact(RecordId(1, 4))->id);
+    ASSERT_EQ(RecordId(1, 5), forward->next()->id);
+}
+
+TEST_F(PartitionedOplogTest, OplogStartHackSearchesOlderSegments) {
+    insert({Timestamp(1, 1), Timestamp(1, 2)});
+    rotate();
+    insert({Timestamp(1, 10)});
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    // Nothing at or below (1, 5) is in the segment covering it, which starts at (1, 3).
+    ASSERT_EQ(RecordId(1, 2), rs->oplogStartHack(opCtx.get(), RecordId(1, 5)));
+    ASSERT_EQ(RecordId(1, 10), rs->oplogStartHack(opCtx.get(), RecordId(1, 10)));
+    ASSERT_EQ(RecordId(1, 10), rs->oplogStartHack(opCtx.get(), RecordId(1, 11)));
+    ASSERT_EQ(RecordId(1, 1), rs->oplogStartHack(opCtx.get(), RecordId(1, 1)));
+    ASSERT_EQ(RecordId(), rs->oplogStartHack(opCtx.get(), RecordId(1, 0)));
+}
+
+TEST_F(PartitionedOplogTest, CappedTruncateAfterEmptiesLaterSegments) {
+    makeThreeSegments();
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        rs->cappedTruncateAfter(opCtx.get(), RecordId(1, 3), false);
+    }
+
+    // The emptied segment is kept, since inserts are still routed to it.
+    ASSERT_EQ(3U, wtrs->oplogSegments()->numSegments());
+    ASSERT_EQ(ids({3}), recordsIn(segments()[1]));
+    ASSERT(recordsIn(segments()[2]).empty());
+    ASSERT_EQ(ids({1, 2, 3}), scan(true));
+    ASSERT_EQ(ids({3, 2, 1}), scan(false));
+
+    insert({Timestamp(1, 4), Timestamp(1, 5)});
+    ASSERT_EQ(ids({3, 4}), recordsIn(segments()[1]));
+    ASSERT_EQ(ids({5}), recordsIn(segments()[2]));
+    ASSERT_EQ(ids({1, 2, 3, 4, 5}), scan(true));
+
+    // Truncating from the start of a segment empties it and every later one.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        rs->cappedTruncateAfter(opCtx.get(), RecordId(1, 3), true);
+    }
+    ASSERT_EQ(ids({1, 2}), recordsIn(segments()[0]));
+    ASSERT(recordsIn(segments()[1]).empty());
+    ASSERT(recordsIn(segments()[2]).empty());
+    ASSERT_EQ(ids({1, 2}), scan(true));
+    ASSERT_EQ(ids({2, 1}), scan(false));
+}
+
+TEST_F(PartitionedOplogTest, CursorRestoreAfterSegmentDrop) {
+    makeThreeSegments();
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto inDropped = rs->getCursor(opCtx.get(), true);
+    ASSERT_EQ(RecordId(1, 1), inDropped->next()->id);
+    ASSERT_EQ(RecordId(1, 2), inDropped->next()->id);
+    ASSERT_EQ(RecordId(1, 3), inDropped->next()->id);
+
+    auto inKept = rs->getCursor(opCtx.get(), true);
+    ASSERT_EQ(RecordId(1, 5), inKept->seekExact(RecordId(1, 5))->id);
+
+    inDropped->save();
+    inKept->save();
+    opCtx->recoveryUnit()->abandonSnapshot();
+
+    wtrs->oplogSegments()->drop(opCtx.get(), {segments()[1]});
+    ASSERT_EQ(2U, wtrs->oplogSegments()->numSegments());
+
+    // The record the first cursor was on is gone, which a capped cursor reports.
+    ASSERT_FALSE(inDropped->restore());
+
+    ASSERT_TRUE(inKept->restore());
+    ASSERT_EQ(RecordId(1, 6), inKept->next()->id);
+    ASSERT_FALSE(inKept->next());
+}
+
+TEST_F(PartitionedOplogTest, RandomCursorSamplesEverySegment) {
+    makeThreeSegments();
+
+    // Empty the newest segment, which the random cursor must skip.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        rs->cappedTruncateAfter(opCtx.get(), RecordId(1, 4), false);
+    }
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto cursor = rs->getRandomCursor(opCtx.get());
+    std::set<RecordId> seen;
+    for (int i = 0; i < 200; ++i) {
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT_GTE(record->id, RecordId(1, 1));
+        ASSERT_LTE(record->id, RecordId(1, 4));
+        seen.insert(record->id);
+    }
+
+    // Each sample picks one of the two non-empty segments, so both are all but certain to be
+    // sampled.
+    ASSERT(seen.count(RecordId(1, 1)) || seen.count(RecordId(1, 2)));
+    ASSERT(seen.count(RecordId(1, 3)) || seen.count(RecordId(1, 4)));
+}
+
+TEST_F(PartitionedOplogTest, SegmentsAreReloadedOnRestart) {
+    makeThreeSegments();
+    // A segment that nothing was inserted into yet is dropped on restart.
+    rotate();
+    ASSERT_EQ(4U, wtrs->oplogSegments()->numSegments());
+    const auto oldSegments = segments();
+
+    reopen(true);
+    ASSERT(wtrs->oplogSegments());
+    ASSERT_EQ(3U, wtrs->oplogSegments()->numSegments());
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(oldSegments[i]->ident, segments()[i]->ident);
+    }
+    ASSERT_EQ(ids({1, 2, 3, 4, 5, 6}), scan(true));
+    ASSERT_EQ(ids({6, 5, 4, 3, 2, 1}), scan(false));
+
+    // Inserts keep going to the newest segment, and the next one starts after them.
+    insert({Timestamp(1, 7)});
+    ASSERT_EQ(ids({5, 6, 7}), recordsIn(segments()[2]));
+    rotate();
+    ASSERT_EQ(4U, wtrs->oplogSegments()->numSegments());
+    ASSERT_EQ(RecordId(1, 8), segments()[3]->start);
+    ASSERT_NOT_EQUALS(oldSegments[3]->ident, segments()[3]->ident);
+}
+
+TEST_F(PartitionedOplogTest, SegmentsAreMergedWhenDisabled) {
+    makeThreeSegments();
+    const auto oldSegments = segments();
+
+    reopen(false);
+    ASSERT_FALSE(wtrs->oplogSegments());
+    ASSERT_FALSE(rs->hasOplogSegments());
+    ASSERT_EQ(ids({1, 2, 3, 4, 5, 6}), scan(true));
+    ASSERT_EQ(ids({6, 5, 4, 3, 2, 1}), scan(false));
+    ASSERT_EQ(ids({1, 2, 3, 4, 5, 6}), recordsIn(oldSegments[0]));
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    ASSERT_FALSE(
+        WiredTigerRecordStore::OplogSegments::hasSegmentTables(opCtx.get(), rs->getIdent()));
+}
+
+// Truncate a partitioned oplog by reclaiming stones, and verify that segments holding only
+// truncated records are dropped.
+TEST_F(PartitionedOplogTest, ReclaimStones) {
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+    WiredTigerRecordStore::OplogSegments* oplogSegments = wtrs->oplogSegments();
+    ASSERT_EQ(1U, oplogSegments->numSegments());
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_OK(wtrs->updateCappedSize(opCtx.get(), 230U));
+    }
+
+    oplogStones->setMinBytesPerStone(100);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insert(opCtx.get(), Timestamp(1, 1), 100), RecordId(1, 1));
+        ASSERT_EQ(insert(opCtx.get(), Timestamp(1, 2), 110), RecordId(1, 2));
+        ASSERT_EQ(insert(opCtx.get(), Timestamp(1, 3), 120), RecordId(1, 3));
+
+        // Stones were created, so the next reclaim starts a segment for the records that follow.
+        wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 3));
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(230, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, oplogSegments->numSegments());
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insert(opCtx.get(), Timestamp(1, 4), 130), RecordId(1, 4));
+        ASSERT_EQ(insert(opCtx.get(), Timestamp(1, 5), 140), RecordId(1, 5));
+        ASSERT_EQ(insert(opCtx.get(), Timestamp(1, 6), 50), RecordId(1, 6));
+
+        // The oplog's own table is emptied by range truncation, as is the start of the second
+        // segment.
+        wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 6));
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(190, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(3U, oplogSegments->numSegments());
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insert(opCtx.get(), Timestamp(1, 7), 100), RecordId(1, 7));
+        wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 8));
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(150, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(4U, oplogSegments->numSegments());
+
+        ASSERT_EQ(insert(opCtx.get(), Timestamp(1, 8), 100), RecordId(1, 8));
+
+        // The second and third segments only hold records up to the stone being reclaimed, so
+        // they are dropped instead of truncated.
+        wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 9));
+
+        ASSERT_EQ(1, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(100, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(1U, oplogStones->numStones());
+        ASSERT_EQ(3U, oplogSegments->numSegments());
+    }
+
+    // A scan crosses the empty segments on either side of the remaining record.
+    ASSERT_EQ(ids({8}), scan(true));
+    ASSERT_EQ(ids({8}), scan(false));
+}
+
+TEST_F(PartitionedOplogTest, NoSegmentIsStartedUnlessFullyUpgraded) {
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+    oplogStones->setMinBytesPerStone(100);
+
+    serverGlobalParams.mutableFeatureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::Version::kDowngradingFrom49To48);
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    insert(opCtx.get(), Timestamp(1, 1), 100);
+    insert(opCtx.get(), Timestamp(1, 2), 50);
+    ASSERT_EQ(1U, oplogStones->numStones());
+
+    wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 2));
+    ASSERT_EQ(1U, wtrs->oplogSegments()->numSegments());
+    ASSERT_FALSE(rs->hasOplogSegments());
+
+    // The request to start a segment is kept until the upgrade completes.
+    serverGlobalParams.mutableFeatureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::kLatest);
+    wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 2));
+    ASSERT_EQ(2U, wtrs->oplogSegments()->numSegments());
+    ASSERT_TRUE(rs->hasOplogSegments());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -163,9 +163,12 @@ public:
                     Date_t now,
                     const uint64_t order,
                     const Message& message) {
+        // Recordings are written from a single buffer, so gathered replies are copied out here.
+        Message flat = message;
+        flat.flatten();
         try {
             _pcqPipe.producer.push(
-                {ts->id(), ts->local().toString(), ts->remote().toString(), now, order, message});
+                {ts->id(), ts->local().toString(), ts->remote().toString(), now, order, flat});
             return true;
         } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueProducerQueueDepthExceeded>&) {
             invariant(!shouldAlwaysRecordTraffic);
@@ -226,7 +226,8 @@ class ConnectionPool::SpecificPool final
 
 public:
     /**
-     * Whenever a function enters a specific pool, the function needs to be guarded by the lock.
+     * Whenever a function enters a specific pool, the function needs to be guarded by the pool's
+     * lock.
      *
      * This callback also (perhaps overly aggressively) binds a shared pointer to the guard.
      * It is *always* safe to reference the original specific pool in the guarded function object.
@@ -241,7 +242,7 @@ public:
     auto guardCallback(Callback&& cb) {
         return
             [this, cb = std::forward<Callback>(cb), anchor = shared_from_this()](auto&&... args) {
-                stdx::lock_guard lk(_parent->_mutex);
+                stdx::lock_guard lk(_mutex);
                 cb(std::forward<decltype(args)>(args)...);
                 updateState();
             };
@@ -268,8 +269,7 @@ public:
     void updateState();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Gets a connection from the specific pool. The caller must hold the pool's lock.
      */
     Future<ConnectionHandle> getConnection(Milliseconds timeout);
 
@@ -288,6 +288,26 @@ public:
      */
     void processFailure(const Status& status);
 
+    /**
+     * Shuts the pool down if it has expired. Used when the controller allows a host group to
+     * shut down.
+     */
+    void shutdownIfExpired();
+
+    /**
+     * Acquires the lock that guards this pool's connections, requests and timers.
+     */
+    stdx::unique_lock<Latch> lock() const {
+        return stdx::unique_lock<Latch>(_mutex);
+    }
+
+    /**
+     * Returns true once the pool has been delisted from its parent.
+     */
+    bool isShutdown() const {
+        return _health.isShutdown;
+    }
+
     /**
      * Returns the number of connections currently checked out of the pool.
      */
@@ -390,12 +410,16 @@ private:
     // Update the event timer for this host pool
     void updateEventTimer();
 
-    // Update the controller and potentially change the controls
-    void updateController();
+    // Update the controller and potentially change the controls. Returns the host group the
+    // controller placed us in, which the caller applies once it has released our lock.
+    HostGroupState updateController();
 
 private:
     const std::shared_ptr<ConnectionPool> _parent;
 
+    mutable Mutex _mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1),
+                                            "ExecutorConnectionPool::SpecificPool::_mutex");
+
     const transport::ConnectSSLMode _sslMode;
     const HostAndPort _hostAndPort;
 
@@ -437,6 +461,7 @@ auto ConnectionPool::SpecificPool::make(std::shared_ptr<ConnectionPool> parent,
     auto& controller = *parent->_controller;
 
     auto pool = std::make_shared<SpecificPool>(std::move(parent), hostAndPort, sslMode);
+    stdx::lock_guard lk(pool->_mutex);
 
     // Inform the controller that we exist
     controller.addHost(pool->_id, hostAndPort);
@@ -479,37 +504,27 @@ ConnectionPool::~ConnectionPool() {
 void ConnectionPool::shutdown() {
     _factory->shutdown();
 
-    // Grab all current pools (under the lock)
-    auto pools = [&] {
-        stdx::lock_guard lk(_mutex);
-        return _pools;
-    }();
-
-    for (const auto& pair : pools) {
-        stdx::lock_guard lk(_mutex);
-        pair.second->triggerShutdown(
+    for (const auto& pool : _getAllPools()) {
+        auto lk = pool->lock();
+        pool->triggerShutdown(
             Status(ErrorCodes::ShutdownInProgress, "Shutting down the connection pool"));
     }
 }
 
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::lock_guard lk(_mutex);
-
-    auto iter = _pools.find(hostAndPort);
+    auto pool = _findPool(hostAndPort);
 
-    if (iter == _pools.end())
+    if (!pool)
         return;
 
-    auto& pool = iter->second;
+    auto lk = pool->lock();
     pool->triggerShutdown(
         Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"));
 }
 
 void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
-    stdx::lock_guard lk(_mutex);
-
-    for (const auto& pair : _pools) {
-        auto& pool = pair.second;
+    for (const auto& pool : _getAllPools()) {
+        auto lk = pool->lock();
 
         if (pool->matchesTags(tags))
             continue;
@@ -522,14 +537,12 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
 void ConnectionPool::mutateTags(
     const HostAndPort& hostAndPort,
     const std::function<transport::Session::TagMask(transport::Session::TagMask)>& mutateFunc) {
-    stdx::lock_guard lk(_mutex);
-
-    auto iter = _pools.find(hostAndPort);
+    auto pool = _findPool(hostAndPort);
 
-    if (iter == _pools.end())
+    if (!pool)
         return;
 
-    auto pool = iter->second;
+    auto lk = pool->lock();
     pool->mutateTags(mutateFunc);
 }
 
@@ -548,46 +561,117 @@ void ConnectionPool::get_forTest(const HostAndPort& hostAndPort,
 SemiFuture<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort& hostAndPort,
                                                                  transport::ConnectSSLMode sslMode,
                                                                  Milliseconds timeout) {
-    stdx::lock_guard lk(_mutex);
+    while (true) {
+        auto pool = _getOrMakePool(hostAndPort, sslMode);
+        auto lk = pool->lock();
 
-    auto& pool = _pools[hostAndPort];
-    if (!pool) {
-        pool = SpecificPool::make(shared_from_this(), hostAndPort, sslMode);
-    } else {
-        pool->fassertSSLModeIs(sslMode);
+        // The pool may have been shut down between the lookup and acquiring its lock. It is
+        // delisted by then, so the next lookup makes a fresh one.
+        if (pool->isShutdown()) {
+            continue;
+        }
+
+        auto connFuture = pool->getConnection(timeout);
+        pool->updateState();
+
+        return std::move(connFuture).semi();
     }
+}
 
-    invariant(pool);
+void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
+    for (const auto& pool : _getAllPools()) {
+        auto hostStats = [&] {
+            auto lk = pool->lock();
+            return ConnectionStatsPer{pool->inUseConnections(),
+                                      pool->availableConnections(),
+                                      pool->createdConnections(),
+                                      pool->refreshingConnections()};
+        }();
+        stats->updateStatsForHost(_name, pool->host(), hostStats);
+    }
+}
 
-    auto connFuture = pool->getConnection(timeout);
-    pool->updateState();
+size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
+    if (auto pool = _findPool(hostAndPort)) {
+        auto lk = pool->lock();
+        return pool->openConnections();
+    }
 
-    return std::move(connFuture).semi();
+    return 0;
 }
 
-void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
+auto ConnectionPool::_findPool(const HostAndPort& hostAndPort) const
+    -> std::shared_ptr<SpecificPool> {
     stdx::lock_guard lk(_mutex);
+    auto iter = _pools.find(hostAndPort);
+    if (iter == _pools.end()) {
+        return nullptr;
+    }
 
-    for (const auto& kv : _pools) {
-        HostAndPort host = kv.first;
+    return iter->second;
+}
 
-        auto& pool = kv.second;
-        ConnectionStatsPer hostStats{pool->inUseConnections(),
-                                     pool->availableConnections(),
-                                     pool->createdConnections(),
-                                     pool->refreshingConnections()};
-        stats->updateStatsForHost(_name, host, hostStats);
+auto ConnectionPool::_getOrMakePool(const HostAndPort& hostAndPort,
+                                    transport::ConnectSSLMode sslMode)
+    -> std::shared_ptr<SpecificPool> {
+    if (auto pool = _findPool(hostAndPort)) {
+        pool->fassertSSLModeIs(sslMode);
+        return pool;
     }
+
+    // Making a pool takes the factory's and the controller's locks, so it happens before we list
+    // it under _mutex.
+    auto pool = SpecificPool::make(shared_from_this(), hostAndPort, sslMode);
+    auto existing = [&]() -> std::shared_ptr<SpecificPool> {
+        stdx::lock_guard lk(_mutex);
+        auto [iter, inserted] = _pools.try_emplace(hostAndPort, pool);
+        if (inserted) {
+            return nullptr;
+        }
+        return iter->second;
+    }();
+
+    if (!existing) {
+        return pool;
+    }
+
+    // Another thread listed a pool for this host first. Ours never had a request, so shutting it
+    // down only tells the controller to forget it.
+    {
+        auto lk = pool->lock();
+        pool->triggerShutdown(
+            Status(ErrorCodes::PooledConnectionsDropped, "Pool was created concurrently"));
+    }
+
+    existing->fassertSSLModeIs(sslMode);
+    return existing;
 }
 
-size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
+auto ConnectionPool::_getAllPools() const -> std::vector<std::shared_ptr<SpecificPool>> {
     stdx::lock_guard lk(_mutex);
-    auto iter = _pools.find(hostAndPort);
-    if (iter != _pools.end()) {
-        return iter->second->openConnections();
+
+    std::vector<std::shared_ptr<SpecificPool>> pools;
+    pools.reserve(_pools.size());
+    for (const auto& kv : _pools) {
+        pools.push_back(kv.second);
     }
+    return pools;
+}
 
-    return 0;
+void ConnectionPool::_updateHostGroup(const HostGroupState& hostGroup,
+                                      transport::ConnectSSLMode sslMode) {
+    for (const auto& host : hostGroup.hosts) {
+        if (!hostGroup.canShutdown) {
+            // Make sure all related hosts exist
+            _getOrMakePool(host, sslMode);
+            continue;
+        }
+
+        if (auto pool = _findPool(host)) {
+            auto lk = pool->lock();
+            pool->shutdownIfExpired();
+        }
+    }
 }
 
 ConnectionPool::SpecificPool::SpecificPool(std::shared_ptr<ConnectionPool> parent,
@@ -596,7 +680,7 @@ ConnectionPool::SpecificPool::SpecificPool(std::shared_ptr<ConnectionPool> paren
     : _parent(std::move(parent)),
       _sslMode(sslMode),
       _hostAndPort(hostAndPort),
-      _id(_parent->_nextPoolId++),
+      _id(_parent->_nextPoolId.fetchAndAdd(1)),
       _readyPool(std::numeric_limits<size_t>::max()) {
     invariant(_parent);
     _eventTimer = _parent->_factory->makeTimer();
@@ -678,7 +762,7 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
 
 auto ConnectionPool::SpecificPool::makeHandle(ConnectionInterface* connection) -> ConnectionHandle {
     auto deleter = [this, anchor = shared_from_this()](ConnectionInterface* connection) {
-        stdx::lock_guard lk(_parent->_mutex);
+        stdx::lock_guard lk(_mutex);
         returnConnection(connection);
         _lastActiveTime = _parent->_factory->now();
         updateState();
@@ -902,7 +986,14 @@ void ConnectionPool::SpecificPool::triggerShutdown(const Status& status) {
     // it could be only in the map of pools
     auto anchor = shared_from_this();
     _parent->_controller->removeHost(_id);
-    _parent->_pools.erase(_hostAndPort);
+    {
+        // Only delist ourselves; the parent may already list a newer pool for this host.
+        stdx::lock_guard lk(_parent->_mutex);
+        if (auto it = _parent->_pools.find(_hostAndPort);
+            it != _parent->_pools.end() && it->second == anchor) {
+            _parent->_pools.erase(it);
+        }
+    }
 
     processFailure(status);
 
@@ -1144,9 +1235,9 @@ void ConnectionPool::SpecificPool::updateEventTimer() {
     _eventTimer->setTimeout(timeout, std::move(deferredStateUpdateFunc));
 }
 
-void ConnectionPool::SpecificPool::updateController() {
+auto ConnectionPool::SpecificPool::updateController() -> HostGroupState {
     if (_health.isShutdown) {
-        return;
+        return {};
     }
 
     auto& controller = *_parent->_controller;
@@ -1167,52 +1258,43 @@ void ConnectionPool::SpecificPool::updateController() {
                 "poolState"_attr = state);
     auto hostGroup = controller.updateHost(_id, std::move(state));
 
-    // If we can shutdown, then do so
-    if (hostGroup.canShutdown) {
-        for (const auto& host : hostGroup.hosts) {
-            auto it = _parent->_pools.find(host);
-            if (it == _parent->_pools.end()) {
-                continue;
-            }
-
-            auto& pool = it->second;
-            if (!pool->_health.isExpired) {
-                // Just because a HostGroup "canShutdown" doesn't mean that a SpecificPool should
-                // shutdown. For example, it is always inappropriate to shutdown a SpecificPool with
-                // connections in use or requests outstanding unless its parent ConnectionPool is
-                // also shutting down.
-                LOGV2_WARNING(4293001,
-                              "Controller requested shutdown but connections still in use, "
-                              "connection pool will stay active.",
-                              "hostAndPort"_attr = pool->_hostAndPort);
-                continue;
-            }
-
-            // At the moment, controllers will never mark for shutdown a pool with active
-            // connections or pending requests. isExpired is never true if these invariants are
-            // false. That's not to say that it's a terrible idea, but if this happens then we
-            // should review what it means to be expired.
-
-            if (shouldInvariantOnPoolCorrectness()) {
-                invariant(pool->_checkedOutPool.empty());
-                invariant(pool->_requests.empty());
-            }
-
-            pool->triggerShutdown(Status(ErrorCodes::ConnectionPoolExpired,
-                                         str::stream() << "Pool for " << host << " has expired."));
-        }
+    // If we can shutdown, our caller shuts down the expired pools of the group
+    if (!hostGroup.canShutdown) {
+        spawnConnections();
+    }
+
+    return hostGroup;
+}
+
+void ConnectionPool::SpecificPool::shutdownIfExpired() {
+    if (_health.isShutdown) {
         return;
     }
 
+    if (!_health.isExpired) {
+        // Just because a HostGroup "canShutdown" doesn't mean that a SpecificPool should
+        // shutdown. For example, it is always inappropriate to shutdown a SpecificPool with
+        // connections in use or requests outstanding unless its parent ConnectionPool is
+        // also shutting down.
+        LOGV2_WARNING(4293001,
+                      "Controller requested shutdown but connections still in use, "
+                      "connection pool will stay active.",
+                      "hostAndPort"_attr = _hostAndPort);
+        return;
+    }
 
-    // Make sure all related hosts exist
-    for (const auto& host : hostGroup.hosts) {
-        if (auto& pool = _parent->_pools[host]; !pool) {
-            pool = SpecificPool::make(_parent, host, _sslMode);
-        }
+    // At the moment, controllers will never mark for shutdown a pool with active
+    // connections or pending requests. isExpired is never true if these invariants are
+    // false. That's not to say that it's a terrible idea, but if this happens then we
+    // should review what it means to be expired.
+
+    if (shouldInvariantOnPoolCorrectness()) {
+        invariant(_checkedOutPool.empty());
+        invariant(_requests.empty());
     }
 
-    spawnConnections();
+    triggerShutdown(Status(ErrorCodes::ConnectionPoolExpired,
+                           str::stream() << "Pool for " << _hostAndPort << " has expired."));
 }
 
 // Updates our state and manages the request timer
@@ -1238,9 +1320,14 @@ void ConnectionPool::SpecificPool::updateState() {
         .getAsync([this, anchor = shared_from_this()](Status&& status) mutable {
             invariant(status);
 
-            stdx::lock_guard lk(_parent->_mutex);
-            _updateScheduled = false;
-            updateController();
+            auto hostGroup = [&] {
+                stdx::lock_guard lk(_mutex);
+                _updateScheduled = false;
+                return updateController();
+            }();
+
+            // Other pools in the group take their own locks, which we may not hold ours across.
+            _parent->_updateHostGroup(hostGroup, _sslMode);
         });
 }
 
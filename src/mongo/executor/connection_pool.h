@@ -35,6 +35,7 @@
 
 #include "mongo/executor/egress_tag_closer.h"
 #include "mongo/executor/egress_tag_closer_manager.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/transport/session.h"
@@ -150,6 +151,13 @@ public:
          */
         bool skipAuthentication = false;
 
+        /**
+         * The maximum number of requests a NetworkInterfaceTL pipelines on one connection. With
+         * more than one, concurrent requests to a host share checked out connections and are
+         * matched to their responses by responseTo.
+         */
+        size_t maxPipelinedRequestsPerConnection = 1;
+
         std::function<std::shared_ptr<ControllerInterface>(void)> controllerFactory =
             &ConnectionPool::makeLimitController;
     };
@@ -254,6 +262,28 @@ public:
     size_t getNumConnectionsPerHost(const HostAndPort& hostAndPort) const;
 
 private:
+    /**
+     * Returns the pool for 'hostAndPort', or nullptr if there is none.
+     */
+    std::shared_ptr<SpecificPool> _findPool(const HostAndPort& hostAndPort) const;
+
+    /**
+     * Returns the pool for 'hostAndPort', creating and listing it if there is none.
+     */
+    std::shared_ptr<SpecificPool> _getOrMakePool(const HostAndPort& hostAndPort,
+                                                 transport::ConnectSSLMode sslMode);
+
+    /**
+     * Returns a snapshot of every listed pool.
+     */
+    std::vector<std::shared_ptr<SpecificPool>> _getAllPools() const;
+
+    /**
+     * Applies a controller decision about a group of hosts. This must be called without holding
+     * any SpecificPool's lock, since it acquires the locks of the pools in the group.
+     */
+    void _updateHostGroup(const HostGroupState& hostGroup, transport::ConnectSSLMode sslMode);
+
     std::string _name;
 
     const std::shared_ptr<DependentTypeFactoryInterface> _factory;
@@ -261,10 +291,12 @@ private:
 
     std::shared_ptr<ControllerInterface> _controller;
 
-    // The global mutex for specific pool access and the generation counter
+    // Guards the set of specific pools only. Each SpecificPool has its own mutex for its
+    // connections and requests, so checkouts to different hosts do not contend. A SpecificPool's
+    // mutex may be held while acquiring this one, never the reverse.
     mutable Mutex _mutex =
-        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1), "ExecutorConnectionPool::_mutex");
-    PoolId _nextPoolId = 0;
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "ExecutorConnectionPool::_mutex");
+    AtomicWord<PoolId> _nextPoolId{0};
     stdx::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>> _pools;
 
     EgressTagCloserManager* _manager;
@@ -0,0 +1,204 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/executor/connection_pool.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+namespace executor {
+namespace {
+
+const int kMaxPerfThreads = 16;
+
+/**
+ * A timer that never fires. Nothing in the benchmark runs long enough to need one.
+ */
+class NoopTimer final : public ConnectionPool::TimerInterface {
+public:
+    void setTimeout(Milliseconds timeout, TimeoutCallback cb) override {}
+
+    void cancelTimeout() override {}
+
+    Date_t now() override {
+        return Date_t::now();
+    }
+};
+
+/**
+ * A connection that finishes setup and refresh on the pool's executor, without any networking.
+ */
+class NoopConnection final : public ConnectionPool::ConnectionInterface {
+public:
+    NoopConnection(const HostAndPort& hostAndPort,
+                   size_t generation,
+                   std::shared_ptr<OutOfLineExecutor> executor)
+        : ConnectionInterface(generation),
+          _hostAndPort(hostAndPort),
+          _executor(std::move(executor)) {}
+
+    const HostAndPort& getHostAndPort() const override {
+        return _hostAndPort;
+    }
+
+    transport::ConnectSSLMode getSslMode() const override {
+        return transport::kGlobalSSLMode;
+    }
+
+    bool isHealthy() override {
+        return true;
+    }
+
+    void setTimeout(Milliseconds timeout, TimeoutCallback cb) override {}
+
+    void cancelTimeout() override {}
+
+    Date_t now() override {
+        return Date_t::now();
+    }
+
+private:
+    void setup(Milliseconds timeout, SetupCallback cb) override {
+        // The pool holds its lock while calling setup(), so the callback has to run out of line.
+        _executor->schedule(
+            [this, cb = std::move(cb)](Status) mutable { cb(this, Status::OK()); });
+    }
+
+    void refresh(Milliseconds timeout, RefreshCallback cb) override {
+        _executor->schedule(
+            [this, cb = std::move(cb)](Status) mutable { cb(this, Status::OK()); });
+    }
+
+    const HostAndPort _hostAndPort;
+    const std::shared_ptr<OutOfLineExecutor> _executor;
+};
+
+class NoopTypeFactory final : public ConnectionPool::DependentTypeFactoryInterface {
+public:
+    explicit NoopTypeFactory(std::shared_ptr<OutOfLineExecutor> executor)
+        : _executor(std::move(executor)) {}
+
+    std::shared_ptr<ConnectionPool::ConnectionInterface> makeConnection(
+        const HostAndPort& hostAndPort,
+        transport::ConnectSSLMode sslMode,
+        size_t generation) override {
+        return std::make_shared<NoopConnection>(hostAndPort, generation, _executor);
+    }
+
+    std::shared_ptr<ConnectionPool::TimerInterface> makeTimer() override {
+        return std::make_shared<NoopTimer>();
+    }
+
+    const std::shared_ptr<OutOfLineExecutor>& getExecutor() override {
+        return _executor;
+    }
+
+    Date_t now() override {
+        return Date_t::now();
+    }
+
+    void shutdown() override {
+        // The benchmark fixture owns the executor and stops it once the pool is gone.
+    }
+
+private:
+    std::shared_ptr<OutOfLineExecutor> _executor;
+};
+
+class ConnectionPoolBenchmark : public benchmark::Fixture {
+protected:
+    void makePool(size_t numHosts) {
+        ThreadPool::Options threadPoolOptions;
+        threadPoolOptions.poolName = "ConnectionPoolBenchmark";
+        threadPoolOptions.maxThreads = 1;
+        executor = std::make_shared<ThreadPool>(std::move(threadPoolOptions));
+        executor->startup();
+
+        ConnectionPool::Options options;
+        options.hostTimeout = Hours(1);
+        options.refreshRequirement = Hours(1);
+        pool = std::make_shared<ConnectionPool>(
+            std::make_shared<NoopTypeFactory>(executor), "ConnectionPoolBenchmark", options);
+
+        hosts.clear();
+        for (size_t i = 0; i < numHosts; ++i) {
+            hosts.emplace_back("shard", 27018 + i);
+        }
+    }
+
+    void destroyPool() {
+        pool->shutdown();
+        pool.reset();
+
+        executor->shutdown();
+        executor->join();
+        executor.reset();
+    }
+
+    std::shared_ptr<ThreadPool> executor;
+    std::shared_ptr<ConnectionPool> pool;
+    std::vector<HostAndPort> hosts;
+};
+
+/**
+ * Each thread checks out and returns connections, cycling through state.range(0) hosts from its
+ * own starting point. With one host every thread contends on the same SpecificPool; with many,
+ * threads mostly touch different ones.
+ */
+BENCHMARK_DEFINE_F(ConnectionPoolBenchmark, BM_CheckoutAndReturn)(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        makePool(state.range(0));
+    }
+
+    size_t next = state.thread_index;
+    for (auto keepRunning : state) {
+        auto& host = hosts[next++ % hosts.size()];
+        auto conn = pool->get(host, transport::kGlobalSSLMode, Seconds(30)).get();
+        conn->indicateUsed();
+        conn->indicateSuccess();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index == 0) {
+        destroyPool();
+    }
+}
+
+BENCHMARK_REGISTER_F(ConnectionPoolBenchmark, BM_CheckoutAndReturn)
+    ->Arg(1)
+    ->Arg(128)
+    ->ThreadRange(1, kMaxPerfThreads);
+
+}  // namespace
+}  // namespace executor
+}  // namespace mongo
@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/host_latency_histogram.h"
+
+#include <cmath>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace executor {
+
+void HostLatencyHistogram::record(Microseconds latency) {
+    ++_buckets[_bucketFor(latency)];
+    _onRecorded();
+}
+
+void HostLatencyHistogram::recordAtLeast(Microseconds latency) {
+    ++_lowerBounds[_bucketFor(latency)];
+    _onRecorded();
+}
+
+void HostLatencyHistogram::_onRecorded() {
+    ++_count;
+
+    if (++_recordedSinceDecay < kDecayInterval) {
+        return;
+    }
+
+    _recordedSinceDecay = 0;
+    _count = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        _buckets[i] /= 2;
+        _lowerBounds[i] /= 2;
+        _count += _buckets[i] + _lowerBounds[i];
+    }
+}
+
+boost::optional<Microseconds> HostLatencyHistogram::percentile(double p) const {
+    invariant(p > 0 && p <= 100);
+
+    if (_count < kMinSamples) {
+        return boost::none;
+    }
+
+    // The fraction of requests estimated to take longer than the buckets seen so far, which only
+    // completed requests reduce. A tolerance keeps an exact rank from being missed to rounding.
+    const double target = 1 - p / 100 + 1e-9;
+    double remaining = 1;
+    uint64_t atRisk = _count;
+    size_t slowest = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        if (_buckets[i] > 0) {
+            remaining *= 1 - static_cast<double>(_buckets[i]) / atRisk;
+            if (remaining <= target) {
+                return _upperBound(i);
+            }
+        }
+        if (_buckets[i] + _lowerBounds[i] > 0) {
+            slowest = i;
+        }
+        atRisk -= _buckets[i] + _lowerBounds[i];
+    }
+
+    // Too many requests were cut short to place the percentile, which is at least as slow as the
+    // slowest of them.
+    return _upperBound(slowest);
+}
+
+size_t HostLatencyHistogram::_bucketFor(Microseconds latency) {
+    if (latency <= Microseconds(1)) {
+        return 0;
+    }
+
+    auto bucket = static_cast<size_t>(std::log2(durationCount<Microseconds>(latency)) *
+                                      kBucketsPerDoubling);
+    return std::min(bucket, kNumBuckets - 1);
+}
+
+Microseconds HostLatencyHistogram::_upperBound(size_t bucket) {
+    return Microseconds(static_cast<long long>(
+        std::ceil(std::exp2(static_cast<double>(bucket + 1) / kBucketsPerDoubling))));
+}
+
+}  // namespace executor
+}  // namespace mongo
@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <boost/optional.hpp>
+#include <cstdint>
+
+#include "mongo/util/duration.h"
+
+namespace mongo {
+namespace executor {
+
+/**
+ * A histogram of the latencies of requests to a single host, used to decide when a hedged read is
+ * worth sending.
+ *
+ * Buckets grow geometrically, with kBucketsPerDoubling buckets per power of two microseconds, so a
+ * percentile is accurate to within about 20%. Every kDecayInterval samples the counts are halved,
+ * which lets the histogram follow the host's recent latency rather than its whole history.
+ *
+ * Requests that were cut short, for instance because a hedge answered first, are recorded as lower
+ * bounds. Percentiles are then estimated as by Kaplan-Meier: a lower bound does not count as a
+ * completion, but keeps weighing in the buckets below it.
+ *
+ * This class is not thread safe.
+ */
+class HostLatencyHistogram {
+public:
+    static constexpr size_t kBucketsPerDoubling = 4;
+
+    // Enough buckets to cover about 67 seconds; slower samples land in the last bucket.
+    static constexpr size_t kNumBuckets = 26 * kBucketsPerDoubling;
+
+    // Percentiles are not reported until this many samples have been recorded.
+    static constexpr uint64_t kMinSamples = 20;
+
+    static constexpr uint64_t kDecayInterval = 1024;
+
+    /**
+     * Records the latency of one request.
+     */
+    void record(Microseconds latency);
+
+    /**
+     * Records a request that was abandoned after 'latency', which is a lower bound for how long it
+     * would have taken.
+     */
+    void recordAtLeast(Microseconds latency);
+
+    /**
+     * Returns an upper bound for the given percentile, which must be in (0, 100], or boost::none if
+     * there are too few samples to tell.
+     */
+    boost::optional<Microseconds> percentile(double p) const;
+
+    /**
+     * Returns the number of samples currently weighing in the histogram.
+     */
+    uint64_t count() const {
+        return _count;
+    }
+
+private:
+    static size_t _bucketFor(Microseconds latency);
+    static Microseconds _upperBound(size_t bucket);
+
+    void _onRecorded();
+
+    std::array<uint64_t, kNumBuckets> _buckets{};
+    std::array<uint64_t, kNumBuckets> _lowerBounds{};
+    uint64_t _count = 0;
+    uint64_t _recordedSinceDecay = 0;
+};
+
+}  // namespace executor
+}  // namespace mongo
@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/host_latency_histogram.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace executor {
+namespace {
+
+TEST(HostLatencyHistogramTest, NoPercentileUntilEnoughSamples) {
+    HostLatencyHistogram histogram;
+    for (uint64_t i = 0; i + 1 < HostLatencyHistogram::kMinSamples; ++i) {
+        histogram.record(Milliseconds(1));
+    }
+    ASSERT_FALSE(histogram.percentile(95));
+
+    histogram.record(Milliseconds(1));
+    ASSERT_TRUE(histogram.percentile(95));
+}
+
+TEST(HostLatencyHistogramTest, PercentileIsATightUpperBound) {
+    HostLatencyHistogram histogram;
+    for (int i = 0; i < 95; ++i) {
+        histogram.record(Milliseconds(1));
+    }
+    for (int i = 0; i < 5; ++i) {
+        histogram.record(Milliseconds(100));
+    }
+
+    auto p95 = *histogram.percentile(95);
+    ASSERT_GTE(p95, Milliseconds(1));
+    ASSERT_LT(p95, Microseconds(1200));
+
+    auto p99 = *histogram.percentile(99);
+    ASSERT_GTE(p99, Milliseconds(100));
+    ASSERT_LT(p99, Milliseconds(120));
+}
+
+TEST(HostLatencyHistogramTest, VerySlowSamplesLandInTheLastBucket) {
+    HostLatencyHistogram histogram;
+    for (uint64_t i = 0; i < HostLatencyHistogram::kMinSamples; ++i) {
+        histogram.record(Hours(1));
+    }
+    ASSERT_GTE(*histogram.percentile(100), Seconds(60));
+}
+
+TEST(HostLatencyHistogramTest, LowerBoundsRaisePercentiles) {
+    HostLatencyHistogram histogram;
+    for (int i = 0; i < 80; ++i) {
+        histogram.record(Milliseconds(1));
+    }
+    for (int i = 0; i < 20; ++i) {
+        histogram.recordAtLeast(Milliseconds(50));
+    }
+
+    // The requests that were cut short would have been slower than every completed one.
+    ASSERT_LT(*histogram.percentile(50), Microseconds(1200));
+    ASSERT_GTE(*histogram.percentile(95), Milliseconds(50));
+
+    for (int i = 0; i < 20; ++i) {
+        histogram.record(Milliseconds(100));
+    }
+    ASSERT_GTE(*histogram.percentile(95), Milliseconds(100));
+    ASSERT_LT(*histogram.percentile(95), Milliseconds(120));
+}
+
+TEST(HostLatencyHistogramTest, DecayFollowsRecentLatency) {
+    HostLatencyHistogram histogram;
+    for (uint64_t i = 0; i < HostLatencyHistogram::kDecayInterval; ++i) {
+        histogram.record(Milliseconds(100));
+    }
+    ASSERT_GTE(*histogram.percentile(95), Milliseconds(100));
+
+    for (uint64_t i = 0; i < 4 * HostLatencyHistogram::kDecayInterval; ++i) {
+        histogram.record(Milliseconds(1));
+    }
+    ASSERT_LT(*histogram.percentile(95), Milliseconds(2));
+    ASSERT_LT(histogram.count(), 2 * HostLatencyHistogram::kDecayInterval);
+}
+
+}  // namespace
+}  // namespace executor
+}  // namespace mongo
@@ -47,8 +47,7 @@
 namespace mongo {
 namespace executor {
 
-void NetworkInterfaceIntegrationFixture::createNet(
-    std::unique_ptr<NetworkConnectionHook> connectHook) {
+ConnectionPool::Options NetworkInterfaceIntegrationFixture::makeConnectionPoolOptions() {
     ConnectionPool::Options options;
 
     options.minConnections = 0u;
@@ -60,8 +59,15 @@ void NetworkInterfaceIntegrationFixture::createNet(
 #else
     options.maxConnections = 256u;
 #endif
-    _net = makeNetworkInterface(
-        "NetworkInterfaceIntegrationFixture", std::move(connectHook), nullptr, std::move(options));
+    return options;
+}
+
+void NetworkInterfaceIntegrationFixture::createNet(
+    std::unique_ptr<NetworkConnectionHook> connectHook) {
+    _net = makeNetworkInterface("NetworkInterfaceIntegrationFixture",
+                                std::move(connectHook),
+                                nullptr,
+                                makeConnectionPoolOptions());
 }
 
 void NetworkInterfaceIntegrationFixture::startNet(
@@ -31,6 +31,7 @@
 #include "mongo/unittest/unittest.h"
 
 #include "mongo/client/connection_string.h"
+#include "mongo/executor/connection_pool.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface.h"
 #include "mongo/executor/task_executor.h"
@@ -111,6 +112,12 @@ public:
                           ErrorCodes::Error reason,
                           Milliseconds timeoutMillis = Minutes(5));
 
+protected:
+    /**
+     * Returns the options for the connection pool of the NetworkInterface made by createNet().
+     */
+    virtual ConnectionPool::Options makeConnectionPoolOptions();
+
 private:
     std::unique_ptr<NetworkInterface> _net;
     PseudoRandom* _rng = nullptr;
@@ -39,6 +39,7 @@
 #include "mongo/client/connection_string.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/executor/connection_pool_stats.h"
+#include "mongo/executor/host_latency_histogram.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface_integration_fixture.h"
 #include "mongo/executor/test_network_connection_hook.h"
@@ -701,6 +702,72 @@ TEST_F(NetworkInterfaceInternalClientTest, StartCommandOnAny) {
     assertNumOps(0u, 0u, 0u, 1u);
 }
 
+TEST_F(NetworkInterfaceInternalClientTest, DelayedHedgeIsOnlySentOnceTheFirstRequestIsSlow) {
+    // Keep the first request of the second command below from being killed once the hedge has
+    // answered, so that only the hedged commands are counted as sent.
+    FailPointEnableBlock fpb("networkInterfaceShouldNotKillPendingRequests");
+
+    const auto target = fixture().getServers().front();
+    auto makeRequest = [&](size_t numTargets) {
+        RemoteCommandRequestBase::HedgeOptions ho;
+        ho.count = numTargets - 1;
+        ho.maxTimeMSForHedgedReads = durationCount<Milliseconds>(kMaxWait);
+        ho.delayPercentile = 95;
+        return RemoteCommandRequestOnAny(std::vector<HostAndPort>(numTargets, target),
+                                         "admin",
+                                         makeEchoCmdObj(),
+                                         BSONObj(),
+                                         nullptr,
+                                         RemoteCommandRequest::kNoTimeout,
+                                         ho);
+    };
+
+    auto blockEcho = [&](BSONObj mode, Milliseconds blockTime) {
+        assertCommandOK("admin",
+                        BSON("configureFailPoint"
+                             << "failCommand"
+                             << "mode" << mode << "data"
+                             << BSON("blockConnection" << true << "blockTimeMS"
+                                                       << durationCount<Milliseconds>(blockTime)
+                                                       << "failInternalCommands" << true
+                                                       << "failCommands" << BSON_ARRAY("echo"))),
+                        kNoTimeout);
+    };
+    ON_BLOCK_EXIT([&] {
+        assertCommandOK("admin",
+                        BSON("configureFailPoint"
+                             << "failCommand"
+                             << "mode"
+                             << "off"),
+                        kNoTimeout);
+    });
+
+    // Make the target's recent latency for hedgeable requests about 200ms.
+    const Milliseconds kUsualLatency{200};
+    blockEcho(BSON("times" << static_cast<int>(HostLatencyHistogram::kMinSamples)), kUsualLatency);
+    for (uint64_t i = 0; i < HostLatencyHistogram::kMinSamples; ++i) {
+        uassertStatusOK(runCommandOnAny(makeCallbackHandle(), makeRequest(1)).get().status);
+    }
+
+    // The first request answers before it has taken that long, so the hedge is never sent.
+    auto sent = net().getCounters().sent;
+    auto res = runCommandOnAny(makeCallbackHandle(), makeRequest(2)).get();
+    uassertStatusOK(res.status);
+    ASSERT_EQ(sent + 1, net().getCounters().sent);
+
+    // The first request is slow, so the hedge is sent once it has taken longer than usual, and
+    // answers for it.
+    blockEcho(BSON("times" << 1), Seconds(10));
+    sent = net().getCounters().sent;
+    res = runCommandOnAny(makeCallbackHandle(), makeRequest(2)).get();
+    uassertStatusOK(res.status);
+    ASSERT_EQ(1, res.data.getIntField("ok"));
+    ASSERT_EQ(sent + 2, net().getCounters().sent);
+    ASSERT(res.elapsed);
+    ASSERT_GTE(duration_cast<Milliseconds>(*res.elapsed), kUsualLatency);
+    ASSERT_LT(duration_cast<Milliseconds>(*res.elapsed), Seconds(10));
+}
+
 TEST_F(NetworkInterfaceTest, SetAlarm) {
     // set a first alarm, to execute after "expiration"
     Date_t expiration = net().now() + Milliseconds(100);
@@ -902,6 +969,66 @@ TEST_F(NetworkInterfaceTest, StartExhaustCommandShouldStopOnFailure) {
     }
 }
 
+class NetworkInterfacePipeliningTest : public NetworkInterfaceTest {
+protected:
+    static constexpr size_t kMaxPipelinedRequests = 4;
+
+    ConnectionPool::Options makeConnectionPoolOptions() override {
+        auto options = NetworkInterfaceTest::makeConnectionPoolOptions();
+        options.maxPipelinedRequestsPerConnection = kMaxPipelinedRequests;
+        return options;
+    }
+
+    BSONObj makeShortSleepCmdObj() {
+        return BSON("sleep" << 1 << "lock"
+                            << "none"
+                            << "millis" << 3000);
+    }
+};
+
+TEST_F(NetworkInterfacePipeliningTest, TimeoutOnlyFailsTheTimedOutRequest) {
+    auto sleeping = runCommand(makeCallbackHandle(),
+                               makeTestCommand(Milliseconds{500}, makeShortSleepCmdObj()));
+    auto echo = runCommand(makeCallbackHandle(), makeTestCommand(kNoTimeout, makeEchoCmdObj()));
+
+    waitForIsMaster();
+
+    auto sleepResult = sleeping.get();
+    auto echoResult = echo.get();
+    ASSERT_OK(echoResult.status);
+    ASSERT_OK(getStatusFromCommandResult(echoResult.data));
+
+    // mongos doesn't implement the sleep command, so nothing times out there.
+    if (!pingCommandMissing(sleepResult)) {
+        ASSERT_EQ(ErrorCodes::NetworkInterfaceExceededTimeLimit, sleepResult.status);
+        assertNumOps(0u, 1u, 0u, 1u);
+    }
+
+    // The response to the timed out request does not confuse later requests.
+    auto laterResult =
+        runCommand(makeCallbackHandle(), makeTestCommand(kNoTimeout, makeEchoCmdObj())).get();
+    ASSERT_OK(laterResult.status);
+    ASSERT_OK(getStatusFromCommandResult(laterResult.data));
+}
+
+TEST_F(NetworkInterfacePipeliningTest, ShutdownFailsRequestsInFlight) {
+    std::vector<Future<RemoteCommandResponse>> futures;
+    for (size_t i = 0; i < kMaxPipelinedRequests; ++i) {
+        futures.push_back(
+            runCommand(makeCallbackHandle(), makeTestCommand(kNoTimeout, makeShortSleepCmdObj())));
+    }
+
+    waitForIsMaster();
+    net().shutdown();
+
+    for (auto& future : futures) {
+        auto result = future.get();
+        if (!pingCommandMissing(result)) {
+            ASSERT_EQ(ErrorCodes::ShutdownInProgress, result.status);
+        }
+    }
+}
+
 }  // namespace
 }  // namespace executor
 }  // namespace mongo
@@ -101,6 +101,172 @@ const Status kNetworkInterfaceShutdownInProgress = {ErrorCodes::ShutdownInProgre
                                                     "NetworkInterface shutdown in progress"};
 }
 
+/**
+ * Lets concurrent requests to a host share connections. A connection is checked out of the pool
+ * when a request finds no shared connection with room, and goes back to the pool as soon as its
+ * last request completes, so the pool's own accounting, refresh and expiry are unchanged.
+ */
+class NetworkInterfaceTL::ConnectionMultiplexer
+    : public std::enable_shared_from_this<ConnectionMultiplexer> {
+public:
+    ConnectionMultiplexer(std::shared_ptr<ConnectionPool> pool, size_t maxRequestsPerConnection)
+        : _pool(std::move(pool)), _maxRequestsPerConnection(maxRequestsPerConnection) {}
+
+    /**
+     * Returns a handle to a connection to 'host' with room for one more request. Destroying the
+     * handle gives the slot back; it does not return the connection to the pool by itself.
+     */
+    SemiFuture<ConnectionPool::ConnectionHandle> get(const HostAndPort& host,
+                                                     transport::ConnectSSLMode sslMode,
+                                                     Milliseconds timeout) {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (auto it = _connections.find(host); it != _connections.end()) {
+                for (auto& conn : it->second) {
+                    if (conn->status.isOK() && conn->sslMode == sslMode &&
+                        conn->inFlight < _maxRequestsPerConnection &&
+                        _getClient(conn->handle.get())->isStillConnected()) {
+                        return Future<ConnectionPool::ConnectionHandle>::makeReady(
+                                   _lease(lk, host, conn))
+                            .semi();
+                    }
+                }
+            }
+        }
+
+        return _pool->get(host, sslMode, timeout)
+            .unsafeToInlineFuture()
+            .then([this, anchor = shared_from_this(), host, sslMode](
+                      ConnectionPool::ConnectionHandle handle) {
+                auto conn = std::make_shared<SharedConnection>();
+                conn->handle = std::move(handle);
+                conn->sslMode = sslMode;
+
+                stdx::lock_guard<Latch> lk(_mutex);
+                _connections[host].push_back(conn);
+                return _lease(lk, host, conn);
+            })
+            .semi();
+    }
+
+    /**
+     * Stops new requests from using the connection. It goes back to the pool with 'status' once
+     * the requests already on it complete.
+     */
+    void indicateFailure(const ConnectionPool::ConnectionInterface* connection, Status status) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (auto& [_, conns] : _connections) {
+            for (auto& conn : conns) {
+                if (conn->handle.get() == connection && conn->status.isOK()) {
+                    conn->status = status;
+                }
+            }
+        }
+    }
+
+    /**
+     * Stops new requests from using the connections to 'host'.
+     */
+    void dropConnections(const HostAndPort& host) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (auto it = _connections.find(host); it != _connections.end()) {
+            for (auto& conn : it->second) {
+                if (conn->status.isOK()) {
+                    conn->status = {ErrorCodes::PooledConnectionsDropped,
+                                    "Pooled connections dropped"};
+                }
+            }
+        }
+    }
+
+    /**
+     * Ends every shared connection, failing the requests still on them.
+     */
+    void shutdown() {
+        std::vector<AsyncDBClient*> clients;
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            for (auto& [_, conns] : _connections) {
+                for (auto& conn : conns) {
+                    conn->status = kNetworkInterfaceShutdownInProgress;
+                    clients.push_back(_getClient(conn->handle.get()));
+                }
+            }
+        }
+
+        // The connections stay checked out until their last lease goes away, so the clients
+        // outlive this loop.
+        for (auto client : clients) {
+            client->end();
+        }
+    }
+
+private:
+    struct SharedConnection {
+        ConnectionPool::ConnectionHandle handle;
+        transport::ConnectSSLMode sslMode;
+        size_t inFlight = 0;
+        Status status = Status::OK();
+    };
+
+    static AsyncDBClient* _getClient(ConnectionPool::ConnectionInterface* connection) {
+        return checked_cast<connection_pool_tl::TLConnection*>(connection)->client();
+    }
+
+    ConnectionPool::ConnectionHandle _lease(WithLock,
+                                            const HostAndPort& host,
+                                            const std::shared_ptr<SharedConnection>& conn) {
+        ++conn->inFlight;
+        return ConnectionPool::ConnectionHandle(
+            conn->handle.get(),
+            [anchor = shared_from_this(), host, conn](ConnectionPool::ConnectionInterface*) {
+                anchor->_release(host, conn);
+            });
+    }
+
+    void _release(const HostAndPort& host, const std::shared_ptr<SharedConnection>& conn) {
+        ConnectionPool::ConnectionHandle handle;
+        Status status = Status::OK();
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (--conn->inFlight > 0) {
+                return;
+            }
+
+            auto it = _connections.find(host);
+            invariant(it != _connections.end());
+            auto& conns = it->second;
+            conns.erase(std::remove(conns.begin(), conns.end(), conn), conns.end());
+            if (conns.empty()) {
+                _connections.erase(it);
+            }
+
+            handle = std::move(conn->handle);
+            status = conn->status;
+        }
+
+        // Give the connection back to the pool outside of our mutex. A response to a canceled
+        // request could still arrive, and must not reach the connection's next user.
+        if (status.isOK() && _getClient(handle.get())->hasPipelinedResponsesOutstanding()) {
+            status = {ErrorCodes::CallbackCanceled,
+                      "Connection has responses to canceled pipelined requests outstanding"};
+        }
+        if (!status.isOK()) {
+            handle->indicateFailure(std::move(status));
+            return;
+        }
+        handle->indicateUsed();
+        handle->indicateSuccess();
+    }
+
+    const std::shared_ptr<ConnectionPool> _pool;
+    const size_t _maxRequestsPerConnection;
+
+    Mutex _mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0),
+                                    "NetworkInterfaceTL::ConnectionMultiplexer::_mutex");
+    stdx::unordered_map<HostAndPort, std::vector<std::shared_ptr<SharedConnection>>> _connections;
+};
+
 NetworkInterfaceTL::NetworkInterfaceTL(std::string instanceName,
                                        ConnectionPool::Options connPoolOpts,
                                        ServiceContext* svcCtx,
@@ -130,6 +296,11 @@ NetworkInterfaceTL::NetworkInterfaceTL(std::string instanceName,
     _pool = std::make_shared<ConnectionPool>(
         std::move(typeFactory), std::string("NetworkInterfaceTL-") + _instanceName, _connPoolOpts);
 
+    if (_connPoolOpts.maxPipelinedRequestsPerConnection > 1) {
+        _multiplexer = std::make_shared<ConnectionMultiplexer>(
+            _pool, _connPoolOpts.maxPipelinedRequestsPerConnection);
+    }
+
     if (TestingProctor::instance().isEnabled()) {
         _counters = std::make_unique<SynchronizedCounters>();
     }
@@ -221,6 +392,10 @@ void NetworkInterfaceTL::shutdown() {
         cmdState->fulfillFinalPromise(kNetworkInterfaceShutdownInProgress);
     }
 
+    if (_multiplexer) {
+        _multiplexer->shutdown();
+    }
+
     // Stop the reactor/thread first so that nothing runs on a partially dtor'd pool.
     _reactor->stop();
 
@@ -370,6 +545,15 @@ void NetworkInterfaceTL::RequestState::returnConnection(Status status) noexcept
 
     auto connToReturn = std::exchange(conn, {});
 
+    if (cmdState->pipelined) {
+        // Other requests may still be using the connection; the multiplexer hands it back to the
+        // pool once they are done. Canceling a request does not affect the others.
+        if (!status.isOK() && status != ErrorCodes::CallbackCanceled) {
+            interface()->_multiplexer->indicateFailure(connToReturn.get(), std::move(status));
+        }
+        return;
+    }
+
     if (!status.isOK()) {
         connToReturn->indicateFailure(std::move(status));
         return;
@@ -400,6 +584,8 @@ void NetworkInterfaceTL::CommandStateBase::tryFinish(Status status) noexcept {
     }
 
     invariant(requestManager);
+    requestManager->cancelDelayedHedges();
+
     if (operationKey &&
         !MONGO_unlikely(networkInterfaceShouldNotKillPendingRequests.shouldFail())) {
         // Kill operations for requests that we didn't use to fulfill the promise.
@@ -432,6 +618,13 @@ void NetworkInterfaceTL::CommandStateBase::tryFinish(Status status) noexcept {
 void NetworkInterfaceTL::RequestState::cancel() noexcept {
     auto connToCancel = weakConn.lock();
     if (auto clientPtr = getClient(connToCancel)) {
+        if (cmdState->pipelined) {
+            // Canceling the client would interrupt every request on the shared connection, so
+            // only this request fails. Its response is dropped whenever it arrives.
+            clientPtr->cancelPipelinedCommandRequest(pipelinedMsgId);
+            return;
+        }
+
         // If we have a client, cancel it
         clientPtr->cancel(cmdState->baton);
     }
@@ -537,21 +730,29 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
         return Status::OK();
     }
 
+    // Requests driven by a baton poll their own connection, and fire-and-forget requests leave
+    // no response to match, so only the rest can share connections.
+    cmdState->pipelined = _multiplexer && !baton &&
+        request.fireAndForgetMode == RemoteCommandRequest::FireAndForgetMode::kOff;
+
+    // Only hedge once the first request has taken longer than its target usually does. Until then,
+    // the hedges do not hold connections.
+    Milliseconds hedgeDelay{0};
+    if (request.hedgeOptions && request.hedgeOptions->delayPercentile > 0) {
+        if (auto latency =
+                _getHostLatency(request.target.front(), request.hedgeOptions->delayPercentile)) {
+            hedgeDelay = *latency;
+        }
+    }
+
     // Attempt to get a connection to every target host
     for (size_t idx = 0; idx < request.target.size(); ++idx) {
-        auto connFuture = _pool->get(request.target[idx], request.sslMode, request.timeout);
-
-        // If connection future is ready or requests should be sent in order, send the request
-        // immediately.
-        if (connFuture.isReady() || targetHostsInAlphabeticalOrder) {
-            cmdState->requestManager->trySend(std::move(connFuture).getNoThrow(), idx);
+        if (idx > 0 && hedgeDelay > Milliseconds(0)) {
+            cmdState->requestManager->delayHedge(idx, hedgeDelay);
             continue;
         }
 
-        // Otherwise, schedule the request.
-        std::move(connFuture).thenRunOn(_reactor).getAsync([cmdState = cmdState, idx](auto swConn) {
-            cmdState->requestManager->trySend(std::move(swConn), idx);
-        });
+        cmdState->requestManager->acquireConnection(idx, targetHostsInAlphabeticalOrder);
     }
 
     return Status::OK();
@@ -575,8 +776,12 @@ Future<RemoteCommandResponse> NetworkInterfaceTL::CommandState::sendRequest(
     std::shared_ptr<RequestState> requestState) {
     return makeReadyFutureWith([this, requestState] {
                setTimer();
-               return RequestState::getClient(requestState->conn)
-                   ->runCommandRequest(*requestState->request, baton);
+               auto client = RequestState::getClient(requestState->conn);
+               if (pipelined) {
+                   return client->runPipelinedCommandRequest(*requestState->request,
+                                                             requestState->pipelinedMsgId);
+               }
+               return client->runCommandRequest(*requestState->request, baton);
            })
         .then([this, requestState](RemoteCommandResponse response) {
             doMetadataHook(RemoteCommandOnAnyResponse(requestState->host, response));
@@ -629,6 +834,23 @@ void NetworkInterfaceTL::RequestManager::cancelRequests() {
     }
 }
 
+void NetworkInterfaceTL::RequestManager::cancelDelayedHedges() {
+    std::vector<transport::ReactorTimer*> timers;
+    {
+        stdx::lock_guard<Latch> lk(mutex);
+        isLocked = true;
+
+        for (auto& timer : hedgeTimers) {
+            timers.push_back(timer.get());
+        }
+    }
+
+    // Waking the timers early ends the waits of the hedges that will never be sent.
+    for (auto timer : timers) {
+        timer->cancel(cmdState->baton);
+    }
+}
+
 void NetworkInterfaceTL::RequestManager::killOperationsForPendingRequests() {
     {
         stdx::lock_guard<Latch> lk(mutex);
@@ -669,6 +891,66 @@ void NetworkInterfaceTL::RequestManager::killOperationsForPendingRequests() {
     }
 }
 
+void NetworkInterfaceTL::RequestManager::acquireConnection(size_t idx, bool sendInline) {
+    auto interface = cmdState->interface;
+    const auto& request = cmdState->requestOnAny;
+    auto connFuture = cmdState->pipelined
+        ? interface->_multiplexer->get(request.target[idx], request.sslMode, request.timeout)
+        : interface->_pool->get(request.target[idx], request.sslMode, request.timeout);
+
+    // If connection future is ready or requests should be sent in order, send the request
+    // immediately.
+    if (connFuture.isReady() || sendInline) {
+        trySend(std::move(connFuture).getNoThrow(), idx);
+        return;
+    }
+
+    // Otherwise, schedule the request.
+    std::move(connFuture)
+        .thenRunOn(interface->_reactor)
+        .getAsync([this, anchor = cmdState->shared_from_this(), idx](auto swConn) {
+            trySend(std::move(swConn), idx);
+        });
+}
+
+void NetworkInterfaceTL::RequestManager::delayHedge(size_t idx, Milliseconds delay) {
+    auto& reactor = cmdState->interface->_reactor;
+    transport::ReactorTimer* timer;
+    {
+        stdx::lock_guard<Latch> lk(mutex);
+        hedgeTimers.push_back(reactor->makeTimer());
+        timer = hedgeTimers.back().get();
+    }
+
+    LOGV2_DEBUG(4972503,
+                2,
+                "Delaying hedged request",
+                "requestId"_attr = cmdState->requestOnAny.id,
+                "target"_attr = cmdState->requestOnAny.target[idx],
+                "delay"_attr = delay);
+
+    timer->waitUntil(reactor->now() + delay, cmdState->baton)
+        .getAsync([this, anchor = cmdState->shared_from_this(), idx](Status status) {
+            if (status.isOK()) {
+                stdx::lock_guard<Latch> lk(mutex);
+                if (isLocked || cmdState->finishLine.isReady()) {
+                    status = {ErrorCodes::CallbackCanceled, "Command finished before hedging"};
+                }
+            }
+
+            if (!status.isOK()) {
+                // The first request answered in time, so the hedge is never sent.
+                return;
+            }
+
+            try {
+                acquireConnection(idx, false /* sendInline */);
+            } catch (const DBException& ex) {
+                trySend(ex.toStatus(), idx);
+            }
+        });
+}
+
 void NetworkInterfaceTL::RequestManager::trySend(
     StatusWith<ConnectionPool::ConnectionHandle> swConn, size_t idx) noexcept {
     // Our connection wasn't any good
@@ -732,6 +1014,9 @@ void NetworkInterfaceTL::RequestManager::trySend(
         // Set conn/weakConn+request under the lock so they will always be observed during cancel.
         requestState->conn = std::move(swConn.getValue());
         requestState->weakConn = requestState->conn;
+        if (cmdState->pipelined) {
+            requestState->pipelinedMsgId = nextMessageId();
+        }
 
         requestState->request = RemoteCommandRequest(cmdState->requestOnAny, idx);
         requestState->host = requestState->request->target;
@@ -739,6 +1024,12 @@ void NetworkInterfaceTL::RequestManager::trySend(
         requests.at(currentSentIdx) = requestState;
     }
 
+    send(std::move(requestState));
+}
+
+void NetworkInterfaceTL::RequestManager::send(std::shared_ptr<RequestState> requestState) noexcept {
+    const auto idx = requestState->reqId;
+
     LOGV2_DEBUG(4646300,
                 2,
                 "Sending request",
@@ -827,6 +1118,18 @@ void NetworkInterfaceTL::RequestState::resolve(Future<RemoteCommandResponse> fut
             returnConnection(status);
 
             auto commandStatus = getStatusFromCommandResult(response.data);
+            if (request->hedgeOptions) {
+                if (status.isOK() && commandStatus.isOK()) {
+                    interface()->_recordHostLatency(host, stopwatch.elapsed());
+                } else if (cmdState->finishLine.isReady() ||
+                           commandStatus == ErrorCodes::MaxTimeMSExpired) {
+                    // The request was cut short, because another one answered first or the
+                    // command was canceled or timed out, so it would have taken longer still.
+                    // Leaving it out would bias the latencies that delay hedges low.
+                    interface()->_recordHostLatencyAtLeast(host, stopwatch.elapsed());
+                }
+            }
+
             // Ignore maxTimeMS expiration errors for hedged reads without triggering the finish
             // line.
             if (isHedge && commandStatus == ErrorCodes::MaxTimeMSExpired) {
@@ -850,7 +1153,7 @@ void NetworkInterfaceTL::RequestState::resolve(Future<RemoteCommandResponse> fut
                 return;
             }
 
-            if (isHedge) {
+            if (isHedge && cmdState->interface->_svcCtx) {
                 auto hm = HedgingMetrics::get(cmdState->interface->_svcCtx);
                 invariant(hm);
                 hm->incrementNumAdvantageouslyHedgedOperations();
@@ -1269,7 +1572,35 @@ bool NetworkInterfaceTL::onNetworkThread() {
     return _reactor->onReactorThread();
 }
 
+void NetworkInterfaceTL::_recordHostLatency(const HostAndPort& host, Milliseconds latency) {
+    stdx::lock_guard<Latch> lk(_hostLatencyMutex);
+    _hostLatencies[host].record(latency);
+}
+
+void NetworkInterfaceTL::_recordHostLatencyAtLeast(const HostAndPort& host, Milliseconds latency) {
+    stdx::lock_guard<Latch> lk(_hostLatencyMutex);
+    _hostLatencies[host].recordAtLeast(latency);
+}
+
+boost::optional<Milliseconds> NetworkInterfaceTL::_getHostLatency(const HostAndPort& host,
+                                                                  int percentile) {
+    stdx::lock_guard<Latch> lk(_hostLatencyMutex);
+    auto it = _hostLatencies.find(host);
+    if (it == _hostLatencies.end()) {
+        return boost::none;
+    }
+
+    auto latency = it->second.percentile(percentile);
+    if (!latency) {
+        return boost::none;
+    }
+    return duration_cast<Milliseconds>(*latency);
+}
+
 void NetworkInterfaceTL::dropConnections(const HostAndPort& hostAndPort) {
+    if (_multiplexer) {
+        _multiplexer->dropConnections(hostAndPort);
+    }
     _pool->dropConnections(hostAndPort);
 }
 
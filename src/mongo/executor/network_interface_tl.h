@@ -34,6 +34,7 @@
 #include "mongo/client/async_client.h"
 #include "mongo/db/service_context.h"
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/host_latency_histogram.h"
 #include "mongo/executor/network_interface.h"
 #include "mongo/logv2/log_severity.h"
 #include "mongo/platform/mutex.h"
@@ -178,6 +179,10 @@ private:
         StrongWeakFinishLine finishLine;
 
         boost::optional<UUID> operationKey;
+
+        // True if the requests of this command are pipelined on connections shared with other
+        // commands.
+        bool pipelined = false;
     };
 
     struct CommandState final : public CommandStateBase {
@@ -232,8 +237,22 @@ private:
     struct RequestManager {
         RequestManager(CommandStateBase* cmdState);
 
+        /**
+         * Gets a connection to the target at 'idx' and sends the request on it, inline if
+         * 'sendInline' is true or the connection is ready.
+         */
+        void acquireConnection(size_t idx, bool sendInline);
+
+        /**
+         * Waits for 'delay' before getting a connection for the hedge to the target at 'idx', and
+         * skips it if the command has finished by then.
+         */
+        void delayHedge(size_t idx, Milliseconds delay);
+
         void trySend(StatusWith<ConnectionPool::ConnectionHandle> swConn, size_t idx) noexcept;
+        void send(std::shared_ptr<RequestState> requestState) noexcept;
         void cancelRequests();
+        void cancelDelayedHedges();
         void killOperationsForPendingRequests();
 
         CommandStateBase* cmdState;
@@ -241,6 +260,9 @@ private:
 
         Mutex mutex = MONGO_MAKE_LATCH("NetworkInterfaceTL::RequestManager::mutex");
 
+        // The timers on which delayed hedges wait.
+        std::vector<std::unique_ptr<transport::ReactorTimer>> hedgeTimers;
+
         // Number of connections we've resolved.
         size_t connsResolved{0};
 
@@ -296,6 +318,9 @@ private:
         ConnectionHandle conn;
         WeakConnectionHandle weakConn;
 
+        // Identifies the request to its connection if the command is pipelined.
+        int32_t pipelinedMsgId{0};
+
         // Internal id of this request as tracked by the RequestManager.
         size_t reqId;
 
@@ -333,6 +358,15 @@ private:
 
     Status _killOperation(std::shared_ptr<RequestState> requestStateToKill);
 
+    /**
+     * Records how long a hedgeable request to 'host' took, or a lower bound for it if the request
+     * was cut short, and returns the given percentile of the recent latencies to 'host' if enough
+     * have been recorded.
+     */
+    void _recordHostLatency(const HostAndPort& host, Milliseconds latency);
+    void _recordHostLatencyAtLeast(const HostAndPort& host, Milliseconds latency);
+    boost::optional<Milliseconds> _getHostLatency(const HostAndPort& host, int percentile);
+
     std::string _instanceName;
     ServiceContext* _svcCtx = nullptr;
     transport::TransportLayer* _tl = nullptr;
@@ -349,8 +383,18 @@ private:
     class SynchronizedCounters;
     std::shared_ptr<SynchronizedCounters> _counters;
 
+    // Set if ConnectionPool::Options::maxPipelinedRequestsPerConnection allows more than one
+    // request per connection.
+    class ConnectionMultiplexer;
+    std::shared_ptr<ConnectionMultiplexer> _multiplexer;
+
     std::unique_ptr<rpc::EgressMetadataHook> _metadataHook;
 
+    // Latencies of hedgeable requests, used to decide when to send a hedge.
+    Mutex _hostLatencyMutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "NetworkInterfaceTL::_hostLatencyMutex");
+    stdx::unordered_map<HostAndPort, HostLatencyHistogram> _hostLatencies;
+
     // We start in kDefault, transition to kStarted after startup() is complete and enter kStopped
     // at the first call to shutdown()
     enum State : int {
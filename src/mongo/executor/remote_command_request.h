@@ -47,6 +47,10 @@ struct RemoteCommandRequestBase {
     struct HedgeOptions {
         size_t count = 0;
         int maxTimeMSForHedgedReads = 0;
+
+        // When nonzero, a hedge is only sent once the first request has been outstanding for this
+        // percentile of its target's recent latency. Zero sends hedges right away.
+        int delayPercentile = 0;
     };
 
     enum FireAndForgetMode { kOn, kOff };
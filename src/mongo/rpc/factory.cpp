@@ -48,8 +48,11 @@ namespace rpc {
 
 Message messageFromOpMsgRequest(Protocol proto, const OpMsgRequest& request) {
     switch (proto) {
-        case Protocol::kOpMsg:
-            return request.serialize();
+        case Protocol::kOpMsg: {
+            auto message = request.serialize();
+            OpMsg::setFlag(&message, OpMsg::kDocumentSequencesAccepted);
+            return message;
+        }
         case Protocol::kOpQuery:
             return legacyRequestFromOpMsgRequest(request);
     }
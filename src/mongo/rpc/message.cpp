@@ -31,10 +31,12 @@
 
 #include "mongo/rpc/message.h"
 
+#include <cstring>
 #include <fmt/format.h>
 
 #include "mongo/platform/atomic_word.h"
 #include "mongo/rpc/op_msg.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 
@@ -46,6 +48,23 @@ int32_t nextMessageId() {
     return NextMsgId.fetchAndAdd(1);
 }
 
+void Message::flatten() {
+    if (!isGathered()) {
+        return;
+    }
+
+    auto flat = SharedBuffer::allocate(size());
+    size_t offset = 0;
+    forEachSegment([&](const char* data, size_t len) {
+        memcpy(flat.get() + offset, data, len);
+        offset += len;
+    });
+    invariant(offset == static_cast<size_t>(size()));
+
+    _buf = std::move(flat);
+    _fragments.clear();
+}
+
 std::string Message::opMsgDebugString() const {
     MsgData::ConstView headerView = header();
     auto opMsgRequest = OpMsgRequest::parse(*this);
@@ -30,11 +30,13 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/encoded_value_storage.h"
 #include "mongo/base/static_assert.h"
+#include "mongo/util/shared_buffer.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -392,6 +394,17 @@ inline int ConstView::dataLen() const {
 
 class Message {
 public:
+    /**
+     * Bytes of another buffer that belong in the message right before the byte at 'offset' of the
+     * message buffer. 'owner' keeps them alive until the message is sent.
+     */
+    struct Fragment {
+        ConstSharedBuffer owner;
+        const char* data;
+        size_t size;
+        size_t offset;
+    };
+
     Message() = default;
     explicit Message(SharedBuffer data) : _buf(std::move(data)) {}
 
@@ -434,8 +447,49 @@ public:
 
     void reset() {
         _buf = {};
+        _fragments.clear();
+    }
+
+    /**
+     * A gathered message references fragments of other buffers, such as the documents of a large
+     * reply batch, instead of copying them into the message buffer. The length in its header
+     * covers the whole message, but only the bytes before the first fragment can be read through
+     * buf(). The transport layer sends it with a single vectored write; anything else that needs
+     * the message bytes must flatten() it first.
+     */
+    bool isGathered() const {
+        return !_fragments.empty();
     }
 
+    void setFragments(std::vector<Fragment> fragments) {
+        verify(!empty());
+        _fragments = std::move(fragments);
+    }
+
+    /**
+     * Calls 'segmentFn(const char* data, size_t size)' for each contiguous segment of the message,
+     * in order.
+     */
+    template <typename SegmentFn>
+    void forEachSegment(SegmentFn&& segmentFn) const {
+        size_t fragmentBytes = 0;
+        size_t offset = 0;
+        for (const auto& fragment : _fragments) {
+            if (fragment.offset > offset) {
+                segmentFn(_buf.get() + offset, fragment.offset - offset);
+            }
+            segmentFn(fragment.data, fragment.size);
+            fragmentBytes += fragment.size;
+            offset = fragment.offset;
+        }
+        segmentFn(_buf.get() + offset, size() - fragmentBytes - offset);
+    }
+
+    /**
+     * Copies the fragments of a gathered message into a single buffer.
+     */
+    void flatten();
+
     // use to set first buffer if empty
     void setData(SharedBuffer buf) {
         verify(empty());
@@ -475,6 +529,9 @@ public:
 
 private:
     SharedBuffer _buf;
+
+    // Ordered by offset.
+    std::vector<Fragment> _fragments;
 };
 
 /**
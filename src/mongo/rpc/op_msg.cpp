@@ -33,6 +33,7 @@
 
 #include "mongo/rpc/op_msg.h"
 
+#include <algorithm>
 #include <bitset>
 #include <set>
 
@@ -43,6 +44,7 @@
 #include "mongo/rpc/object_check.h"
 #include "mongo/util/bufreader.h"
 #include "mongo/util/hex.h"
+#include "mongo/util/str.h"
 
 #ifdef MONGO_CONFIG_WIREDTIGER_ENABLED
 #include <wiredtiger.h>
@@ -114,6 +116,7 @@ void OpMsg::appendChecksum(Message* message) {
     }
 
     invariant(!isFlagSet(*message, kChecksumPresent));
+    message->flatten();
     setFlag(message, kChecksumPresent);
     const size_t newSize = message->size() + kCrc32Size;
     if (message->capacity() < newSize) {
@@ -131,6 +134,7 @@ OpMsg OpMsg::parse(const Message& message) try {
     // It is the caller's responsibility to call the correct parser for a given message type.
     invariant(!message.empty());
     invariant(message.operation() == dbMsg);
+    invariant(!message.isGathered());
 
     const uint32_t flags = OpMsg::flags(message);
     uassert(ErrorCodes::IllegalOpMsgFlag,
@@ -268,6 +272,61 @@ void OpMsg::shareOwnershipWith(const ConstSharedBuffer& buffer) {
     }
 }
 
+namespace {
+/**
+ * Appends the fields of 'obj', which is at 'path' in the body, to 'bob', followed by the document
+ * sequences whose names are fields of 'obj'.
+ */
+void appendWithSequences(BSONObjBuilder* bob,
+                         const BSONObj& obj,
+                         StringData path,
+                         const std::vector<OpMsg::DocumentSequence>& sequences) {
+    auto pathOf = [&](StringData fieldName) -> std::string {
+        return path.empty() ? fieldName.toString() : str::stream() << path << "." << fieldName;
+    };
+    auto hasSequencesUnder = [&](StringData fieldPath) {
+        return std::any_of(sequences.begin(), sequences.end(), [&](const auto& seq) {
+            return StringData(seq.name).startsWith(fieldPath + ".");
+        });
+    };
+
+    for (auto&& elem : obj) {
+        const auto fieldPath = pathOf(elem.fieldNameStringData());
+        if (elem.type() == Object && hasSequencesUnder(fieldPath)) {
+            BSONObjBuilder sub(bob->subobjStart(elem.fieldNameStringData()));
+            appendWithSequences(&sub, elem.Obj(), fieldPath, sequences);
+        } else {
+            bob->append(elem);
+        }
+    }
+
+    for (auto&& seq : sequences) {
+        const StringData name(seq.name);
+        const auto dot = name.rfind('.');
+        const auto parent = dot == std::string::npos ? StringData() : name.substr(0, dot);
+        if (parent != path) {
+            continue;
+        }
+        BSONArrayBuilder array(
+            bob->subarrayStart(dot == std::string::npos ? name : name.substr(dot + 1)));
+        for (auto&& doc : seq.objs) {
+            array.append(doc);
+        }
+    }
+}
+}  // namespace
+
+void OpMsg::foldSequencesIntoBody() {
+    if (sequences.empty()) {
+        return;
+    }
+
+    BSONObjBuilder bob;
+    appendWithSequences(&bob, body, "", sequences);
+    body = bob.obj();
+    sequences.clear();
+}
+
 auto OpMsgBuilder::beginDocSequence(StringData name) -> DocSequenceBuilder {
     invariant(_state == kEmpty || _state == kDocSequence);
     invariant(!_openBuilder);
@@ -277,6 +336,7 @@ auto OpMsgBuilder::beginDocSequence(StringData name) -> DocSequenceBuilder {
     int sizeOffset = _buf.len();
     _buf.skip(sizeof(int32_t));  // section size.
     _buf.appendStr(name, true);
+    _sequenceFragmentBytes = _fragmentBytes;
     return DocSequenceBuilder(this, &_buf, sizeOffset);
 }
 
@@ -284,11 +344,26 @@ void OpMsgBuilder::finishDocumentStream(DocSequenceBuilder* docSequenceBuilder)
     invariant(_state == kDocSequence);
     invariant(_openBuilder);
     _openBuilder = false;
-    const int32_t size = _buf.len() - docSequenceBuilder->_sizeOffset;
+    const int32_t size =
+        _buf.len() - docSequenceBuilder->_sizeOffset + (_fragmentBytes - _sequenceFragmentBytes);
     invariant(size > 0);
     DataView(_buf.buf()).write<LittleEndian<int32_t>>(size, docSequenceBuilder->_sizeOffset);
 }
 
+bool OpMsgBuilder::gatherDocument(const BSONObj& obj) {
+    invariant(_state == kDocSequence);
+    if (!_gatherOwnedDocuments || !obj.isOwned() || obj.objsize() < kMinGatheredDocumentSize) {
+        return false;
+    }
+
+    _fragments.push_back({obj.sharedBuffer(),
+                          obj.objdata(),
+                          static_cast<size_t>(obj.objsize()),
+                          static_cast<size_t>(_buf.len())});
+    _fragmentBytes += obj.objsize();
+    return true;
+}
+
 BSONObjBuilder OpMsgBuilder::beginBody() {
     invariant(_state == kEmpty || _state == kDocSequence);
     _state = kBody;
@@ -307,7 +382,7 @@ BSONObjBuilder OpMsgBuilder::resumeBody() {
 AtomicWord<bool> OpMsgBuilder::disableDupeFieldCheck_forTest{false};
 
 Message OpMsgBuilder::finish() {
-    const auto size = _buf.len();
+    const auto size = len();
     uassert(ErrorCodes::BSONObjectTooLarge,
             str::stream() << "BSON size limit hit while building Message. Size: " << size << " (0x"
                           << unsignedHex(size) << "); maxSize: " << BSONObjMaxInternalSize << "("
@@ -336,13 +411,17 @@ Message OpMsgBuilder::finishWithoutSizeChecking() {
     invariant(!_openBuilder);
     _state = kDone;
 
-    const auto size = _buf.len();
+    const auto size = len();
     MSGHEADER::View header(_buf.buf());
     header.setMessageLength(size);
     // header.setRequestMsgId(...); // These are currently filled in by the networking layer.
     // header.setResponseToMsgId(...);
     header.setOpCode(dbMsg);
-    return Message(_buf.release());
+    Message message(_buf.release());
+    if (!_fragments.empty()) {
+        message.setFragments(std::move(_fragments));
+    }
+    return message;
 }
 
 BSONObj OpMsgBuilder::releaseBody() {
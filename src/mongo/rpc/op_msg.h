@@ -49,6 +49,10 @@ struct OpMsg {
     static constexpr uint32_t kMoreToCome = 1 << 1;
     static constexpr uint32_t kExhaustSupported = 1 << 16;
 
+    // Set on requests by clients that read document sequences in replies, such as cursor batches
+    // sent as a "cursor.firstBatch" or "cursor.nextBatch" sequence. See foldSequencesIntoBody().
+    static constexpr uint32_t kDocumentSequencesAccepted = 1 << 17;
+
     /**
      * Returns the unvalidated flags for the given message if it is an OP_MSG message.
      * Returns 0 for other message kinds since they are the equivalent of no flags set.
@@ -110,9 +114,15 @@ struct OpMsg {
     static OpMsg parse(const Message& message);
 
     /**
-     * Parses and returns an OpMsg containing owned BSON.
+     * Parses and returns an OpMsg containing owned BSON. A gathered message is flattened into a
+     * copy first.
      */
     static OpMsg parseOwned(const Message& message) {
+        if (message.isGathered()) {
+            auto flat = message;
+            flat.flatten();
+            return parseOwned(flat);
+        }
         auto msg = parse(message);
         msg.shareOwnershipWith(message.sharedBuffer());
         return msg;
@@ -131,6 +141,13 @@ struct OpMsg {
      */
     void shareOwnershipWith(const ConstSharedBuffer& buffer);
 
+    /**
+     * Moves each document sequence into the body as an array at the dotted path the sequence is
+     * named after, such as "cursor.nextBatch". This is how replies are read: a document sequence
+     * in a reply stands for an array field of the body.
+     */
+    void foldSequencesIntoBody();
+
     /**
      * Returns a pointer to the sequence with the given name or nullptr if there are none.
      */
@@ -263,6 +280,9 @@ public:
         _bodyStart = 0;
         _state = kEmpty;
         _openBuilder = false;
+        _fragments.clear();
+        _fragmentBytes = 0;
+        _sequenceFragmentBytes = 0;
     }
 
     /**
@@ -280,7 +300,7 @@ public:
     /**
      * Returns whether or not this builder is already building a body.
      */
-    bool isBuildingBody() {
+    bool isBuildingBody() const {
         return _state == kBody;
     }
 
@@ -292,6 +312,19 @@ public:
         _buf.claimReservedBytes(bytes);
     }
 
+    /**
+     * Makes document sequences reference the buffers of large owned documents instead of copying
+     * them, which makes the message built by finish() a gathered one. Only use this for messages
+     * that go straight to the transport layer; see Message::isGathered().
+     */
+    void gatherOwnedDocuments() {
+        _gatherOwnedDocuments = true;
+    }
+
+    // Documents smaller than this are copied into document sequences even when they could be
+    // referenced, since copying them costs less than writing them out separately.
+    static constexpr int kMinGatheredDocumentSize = 1024;
+
 private:
     friend class DocSequenceBuilder;
 
@@ -304,6 +337,15 @@ private:
 
     void finishDocumentStream(DocSequenceBuilder* docSequenceBuilder);
 
+    // References 'obj' at the current position of the message if it is eligible for gathering.
+    // Returns whether it did.
+    bool gatherDocument(const BSONObj& obj);
+
+    // The length of the message being built, including the gathered fragments.
+    int len() const {
+        return _buf.len() + _fragmentBytes;
+    }
+
     void skipHeaderAndFlags() {
         _buf.skip(sizeof(MSGHEADER::Layout));  // This is filled in by finish().
         _buf.appendNum(uint32_t(0));           // flags (currently always 0).
@@ -314,6 +356,13 @@ private:
     int _bodyStart = 0;
     State _state = kEmpty;
     bool _openBuilder = false;
+
+    bool _gatherOwnedDocuments = false;
+    std::vector<Message::Fragment> _fragments;
+    int _fragmentBytes = 0;
+
+    // The value of '_fragmentBytes' when the open document sequence began.
+    int _sequenceFragmentBytes = 0;
 };
 
 /**
@@ -357,10 +406,13 @@ public:
     }
 
     /**
-     * Appends a single document to this sequence.
+     * Appends a single document to this sequence. If the builder gathers owned documents, large
+     * owned ones are referenced rather than copied.
      */
     void append(const BSONObj& obj) {
-        _buf->appendBuf(obj.objdata(), obj.objsize());
+        if (!_msgBuilder->gatherDocument(obj)) {
+            _buf->appendBuf(obj.objdata(), obj.objsize());
+        }
     }
 
     /**
@@ -373,7 +425,7 @@ public:
     }
 
     int len() const {
-        return _buf->len();
+        return _msgBuilder->len();
     }
 
 private:
@@ -38,8 +38,11 @@ namespace rpc {
 
 class OpMsgReply final : public rpc::ReplyInterface {
 public:
-    explicit OpMsgReply(const Message* message) : _msg(OpMsg::parseOwned(*message)) {}
-    explicit OpMsgReply(OpMsg msg) : _msg(std::move(msg)) {}
+    explicit OpMsgReply(const Message* message) : OpMsgReply(OpMsg::parseOwned(*message)) {}
+    explicit OpMsgReply(OpMsg msg) : _msg(std::move(msg)) {
+        // Callers only look at the body, so replies sent as document sequences are folded back.
+        _msg.foldSequencesIntoBody();
+    }
     const BSONObj& getCommandReply() const override {
         return _msg.body;
     }
@@ -78,12 +81,22 @@ public:
     void reserveBytes(const std::size_t bytes) override {
         _builder.reserveBytes(bytes);
     }
+    void acceptDocumentSequences(bool gather) override {
+        _documentSequencesAccepted = true;
+        if (gather) {
+            _builder.gatherOwnedDocuments();
+        }
+    }
+    bool canUseDocumentSequences() const override {
+        return _documentSequencesAccepted && !_builder.isBuildingBody();
+    }
     BSONObj releaseBody() {
         return _builder.releaseBody();
     }
 
 private:
     OpMsgBuilder _builder;
+    bool _documentSequencesAccepted = false;
 };
 
 }  // namespace rpc
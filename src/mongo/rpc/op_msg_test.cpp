@@ -823,6 +823,56 @@ TEST(OpMsgSerializer, BodyAndInPlaceSequenceInPlaceWithReset) {
                    });
 }
 
+TEST(OpMsgSerializer, GatheredSequenceFlattensToContiguousForm) {
+    const auto big = BSON("a" << std::string(OpMsgBuilder::kMinGatheredDocumentSize, 'x'));
+    const auto small = fromjson("{b: 1}");
+
+    OpMsgBuilder builder;
+    builder.gatherOwnedDocuments();
+    {
+        auto seq = builder.beginDocSequence("docs");
+        seq.append(small);
+        seq.append(big);
+        seq.append(small);
+    }
+    builder.beginBody().append("ping", 1);
+
+    auto msg = builder.finish();
+    ASSERT(msg.isGathered());
+
+    auto flat = msg;
+    flat.flatten();
+    ASSERT_FALSE(flat.isGathered());
+    ASSERT_EQ(flat.size(), msg.size());
+    testSerializer(flat,
+                   OpMsgBytes{
+                       kNoFlags,  //
+                       kDocSequenceSection,
+                       Sized{
+                           "docs",  //
+                           small,
+                           big,
+                           small,
+                       },
+
+                       kBodySection,
+                       fromjson("{ping: 1}"),
+                   });
+}
+
+TEST(OpMsg, FoldSequencesIntoBody) {
+    OpMsg msg;
+    msg.body = fromjson("{cursor: {id: 0, ns: 'a.b'}, ok: 1}");
+    msg.sequences = {{"cursor.firstBatch", {fromjson("{_id: 1}"), fromjson("{_id: 2}")}},
+                     {"top", {fromjson("{c: 1}")}}};
+
+    msg.foldSequencesIntoBody();
+    ASSERT(msg.sequences.empty());
+    ASSERT_BSONOBJ_EQ(msg.body,
+                      fromjson("{cursor: {id: 0, ns: 'a.b', firstBatch: [{_id: 1}, {_id: 2}]},"
+                               " ok: 1, top: [{c: 1}]}"));
+}
+
 TEST(OpMsgSerializer, ReplaceFlagsWorks) {
     {
         auto msg = OpMsgBytes{~0u}.done();
@@ -76,6 +76,20 @@ public:
         uasserted(50875, "Only OpMsg may use document sequences");
     }
 
+    /**
+     * Records that the peer advertised it accepts document sequences in replies. If 'gather' is
+     * true, large owned documents appended to document sequences are referenced rather than
+     * copied; only set it when the reply goes straight to a session.
+     */
+    virtual void acceptDocumentSequences(bool gather) {}
+
+    /**
+     * Returns true if a command may reply with document sequences instead of arrays in the body.
+     */
+    virtual bool canUseDocumentSequences() const {
+        return false;
+    }
+
     /**
      * Sets the reply for this command. If an engaged StatusWith<BSONObj> is passed, the command
      * reply will be set to the contained BSONObj, augmented with the element {ok, 1.0} if it
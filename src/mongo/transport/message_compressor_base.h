@@ -34,9 +34,14 @@
 #include "mongo/base/string_data.h"
 #include "mongo/platform/atomic_word.h"
 
+#include <memory>
 #include <type_traits>
 
 namespace mongo {
+
+class BSONObj;
+class BSONObjBuilder;
+
 enum class MessageCompressor : uint8_t {
     kNoop = 0,
     kSnappy = 1,
@@ -48,6 +53,22 @@ enum class MessageCompressor : uint8_t {
 StringData getMessageCompressorName(MessageCompressor id);
 using MessageCompressorId = std::underlying_type<MessageCompressor>::type;
 
+/*
+ * Per-connection state for a compressor, negotiated in the isMaster handshake. Compressors use it
+ * for things like a shared dictionary or a streaming context that keeps history across messages,
+ * so it must see every message its compressor handles on the connection, in wire order.
+ */
+class MessageCompressorContext {
+public:
+    virtual ~MessageCompressorContext() = default;
+
+    virtual std::size_t getMaxCompressedSize(size_t inputSize) = 0;
+
+    virtual StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) = 0;
+
+    virtual StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) = 0;
+};
+
 class MessageCompressorBase {
     MessageCompressorBase(const MessageCompressorBase&) = delete;
     MessageCompressorBase& operator=(const MessageCompressorBase&) = delete;
@@ -89,6 +110,29 @@ public:
      */
     virtual StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) = 0;
 
+    /*
+     * Called by a client constructing an isMaster request to append the per-connection options it
+     * offers for this compressor. Compressors without per-connection state append nothing.
+     */
+    virtual void appendContextOffer(BSONObjBuilder* output) {}
+
+    /*
+     * Called by a server with the options a client offered. Appends the options it accepts to
+     * 'accepted' and returns the context to use for this connection, or nullptr if messages should
+     * go through compressData and decompressData.
+     */
+    virtual std::unique_ptr<MessageCompressorContext> acceptContext(const BSONObj& offer,
+                                                                    BSONObjBuilder* accepted) {
+        return nullptr;
+    }
+
+    /*
+     * Called by a client with the options the server accepted in its isMaster response.
+     */
+    virtual std::unique_ptr<MessageCompressorContext> makeContext(const BSONObj& accepted) {
+        return nullptr;
+    }
+
     /*
      * This returns the number of bytes passed in the input for compressData
      */
@@ -74,6 +74,8 @@ struct CompressionHeader {
 
 const transport::Session::Decoration<MessageCompressorManager> getForSession =
     transport::Session::declareDecoration<MessageCompressorManager>();
+
+constexpr auto kCompressionOptionsField = "compressionOptions"_sd;
 }  // namespace
 
 MessageCompressorManager::MessageCompressorManager()
@@ -82,6 +84,15 @@ MessageCompressorManager::MessageCompressorManager()
 MessageCompressorManager::MessageCompressorManager(MessageCompressorRegistry* factory)
     : _registry{factory} {}
 
+MessageCompressorContext* MessageCompressorManager::_getContext(MessageCompressorId id) const {
+    for (const auto& [contextId, context] : _contexts) {
+        if (contextId == id) {
+            return context.get();
+        }
+    }
+    return nullptr;
+}
+
 StatusWith<Message> MessageCompressorManager::compressMessage(
     const Message& msg, const MessageCompressorId* compressorId) {
 
@@ -101,8 +112,10 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
                 "Compressing message",
                 "compressor"_attr = compressor->getName());
 
+    auto context = _getContext(compressor->getId());
     auto inputHeader = msg.header();
-    size_t bufferSize = compressor->getMaxCompressedSize(msg.dataSize()) +
+    size_t bufferSize = (context ? context->getMaxCompressedSize(msg.dataSize())
+                                 : compressor->getMaxCompressedSize(msg.dataSize())) +
         CompressionHeader::size() + MsgData::MsgDataHeaderSize;
 
     CompressionHeader compressionHeader(
@@ -131,7 +144,8 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
     compressionHeader.serialize(&output);
     ConstDataRange input(inputHeader.data(), inputHeader.data() + inputHeader.dataLen());
 
-    auto sws = compressor->compressData(input, output);
+    auto sws = context ? context->compressData(input, output)
+                       : compressor->compressData(input, output);
 
     if (!sws.isOK())
         return sws.getStatus();
@@ -189,7 +203,9 @@ StatusWith<Message> MessageCompressorManager::decompressMessage(const Message& m
 
     DataRangeCursor output(outMessage.data(), outMessage.data() + outMessage.dataLen());
 
-    auto sws = compressor->decompressData(input, output);
+    auto context = _getContext(compressor->getId());
+    auto sws = context ? context->decompressData(input, output)
+                       : compressor->decompressData(input, output);
 
     if (!sws.isOK())
         return sws.getStatus();
@@ -208,6 +224,7 @@ void MessageCompressorManager::clientBegin(BSONObjBuilder* output) {
 
     // We're about to update the compressor list with the negotiation result from the server.
     _negotiated.clear();
+    _contexts.clear();
 
     auto& compressorList = _registry->getCompressorNames();
     if (compressorList.size() == 0)
@@ -223,6 +240,18 @@ void MessageCompressorManager::clientBegin(BSONObjBuilder* output) {
         sub.append(e);
     }
     sub.doneFast();
+
+    BSONObjBuilder offers;
+    for (const auto& e : _registry->getCompressorNames()) {
+        BSONObjBuilder offer;
+        _registry->getCompressor(e)->appendContextOffer(&offer);
+        if (auto offerObj = offer.obj(); !offerObj.isEmpty()) {
+            offers.append(e, offerObj);
+        }
+    }
+    if (auto offersObj = offers.obj(); !offersObj.isEmpty()) {
+        output->append(kCompressionOptionsField, offersObj);
+    }
 }
 
 void MessageCompressorManager::clientFinish(const BSONObj& input) {
@@ -254,6 +283,25 @@ void MessageCompressorManager::clientFinish(const BSONObj& input) {
                     "compressor"_attr = ret->getName());
         _negotiated.push_back(ret);
     }
+
+    auto options = input.getField(kCompressionOptionsField);
+    if (options.type() != Object) {
+        return;
+    }
+    for (auto compressor : _negotiated) {
+        auto accepted = options.Obj().getField(compressor->getName());
+        if (accepted.type() != Object) {
+            continue;
+        }
+        if (auto context = compressor->makeContext(accepted.Obj())) {
+            LOGV2_DEBUG(4972500,
+                        3,
+                        "Using per-connection context for compressor",
+                        "compressor"_attr = compressor->getName(),
+                        "options"_attr = accepted.Obj());
+            _contexts.emplace_back(compressor->getId(), std::move(context));
+        }
+    }
 }
 
 void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuilder* output) {
@@ -281,6 +329,7 @@ void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuil
     // If compression has already been negotiated, then this is a renegotiation, so we should
     // reset the state of the manager.
     _negotiated.clear();
+    _contexts.clear();
 
     // First we go through all the compressor names that the client has requested support for
     BSONObj theirObj = elem.Obj();
@@ -321,6 +370,33 @@ void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuil
         sub.doneFast();
     } else {
         LOGV2_DEBUG(22939, 3, "Could not agree on compressor to use");
+        return;
+    }
+
+    auto offers = input.getField(kCompressionOptionsField);
+    if (offers.type() != Object) {
+        return;
+    }
+    BSONObjBuilder acceptedOptions;
+    for (auto algo : _negotiated) {
+        auto offer = offers.Obj().getField(algo->getName());
+        if (offer.type() != Object) {
+            continue;
+        }
+        BSONObjBuilder accepted;
+        if (auto context = algo->acceptContext(offer.Obj(), &accepted)) {
+            auto acceptedObj = accepted.obj();
+            LOGV2_DEBUG(4972501,
+                        3,
+                        "Accepted per-connection context for compressor",
+                        "compressor"_attr = algo->getName(),
+                        "options"_attr = acceptedObj);
+            acceptedOptions.append(algo->getName(), acceptedObj);
+            _contexts.emplace_back(algo->getId(), std::move(context));
+        }
+    }
+    if (!_contexts.empty()) {
+        output->append(kCompressionOptionsField, acceptedOptions.obj());
     }
 }
 
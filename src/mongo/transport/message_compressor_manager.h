@@ -33,6 +33,8 @@
 #include "mongo/transport/message_compressor_base.h"
 #include "mongo/transport/session.h"
 
+#include <memory>
+#include <utility>
 #include <vector>
 
 namespace mongo {
@@ -65,6 +67,9 @@ public:
      * Called by a client constructing an isMaster request. This function will append the result
      * of _registry->getCompressorNames() to the BSONObjBuilder as a BSON array. If no compressors
      * are configured, it won't append anything.
+     *
+     * Per-connection options that compressors offer (see MessageCompressorContext) are appended
+     * as a "compressionOptions" subobject keyed by compressor name.
      */
     void clientBegin(BSONObjBuilder* output);
 
@@ -75,6 +80,9 @@ public:
      * This looks for a BSON array called "compression" with the server's list of
      * requested algorithms. The first algorithm in that array will be used in subsequent calls
      * to compressMessage.
+     *
+     * If the server accepted per-connection options in "compressionOptions", the matching
+     * compressors use a context for every message on this connection from now on.
      */
     void clientFinish(const BSONObj& input);
 
@@ -87,6 +95,9 @@ public:
      *
      * If no compressors are configured that match those requested by the client, then it will
      * not append anything to the BSONObjBuilder output.
+     *
+     * Per-connection options the client offered for negotiated compressors are handed to those
+     * compressors, and the options they accept are echoed back in "compressionOptions".
      */
     void serverNegotiate(const BSONObj& input, BSONObjBuilder* output);
 
@@ -127,7 +138,11 @@ public:
     static MessageCompressorManager& forSession(const transport::SessionHandle& session);
 
 private:
+    MessageCompressorContext* _getContext(MessageCompressorId id) const;
+
     std::vector<MessageCompressorBase*> _negotiated;
+    std::vector<std::pair<MessageCompressorId, std::unique_ptr<MessageCompressorContext>>>
+        _contexts;
     MessageCompressorRegistry* _registry;
 };
 
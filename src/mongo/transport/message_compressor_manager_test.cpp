@@ -36,6 +36,7 @@
 #include <vector>
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/random.h"
 #include "mongo/rpc/message.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/message_compressor_noop.h"
@@ -167,8 +168,7 @@ void checkOverflow(std::unique_ptr<MessageCompressorBase> compressor) {
         compressor->decompressData(tooSmallRange, DataRange(scratch.data(), scratch.size())));
 }
 
-Message buildMessage() {
-    const auto data = std::string{"Hello, world!"};
+Message buildMessage(const std::string& data = "Hello, world!") {
     const auto bufferSize = MsgData::MsgDataHeaderSize + data.size();
     auto buf = SharedBuffer::allocate(bufferSize);
     MsgData::View testView(buf.get());
@@ -240,6 +240,95 @@ TEST(ZstdMessageCompressor, Fidelity) {
     checkFidelity(testMessage, std::make_unique<ZstdMessageCompressor>());
 }
 
+MessageCompressorRegistry buildZstdRegistry(ZstdMessageCompressor::Options options) {
+    MessageCompressorRegistry registry;
+    auto compressor = std::make_unique<ZstdMessageCompressor>(options);
+
+    std::vector<std::string> compressorList = {compressor->getName()};
+    registry.setSupportedCompressors(std::move(compressorList));
+    registry.registerImplementation(std::move(compressor));
+    registry.finalizeSupportedCompressors().transitional_ignore();
+
+    return registry;
+}
+
+BSONObj negotiate(MessageCompressorManager* clientManager,
+                  MessageCompressorManager* serverManager) {
+    BSONObjBuilder clientOutput;
+    clientOutput.append("isMaster", 1);
+    clientManager->clientBegin(&clientOutput);
+
+    BSONObjBuilder serverOutput;
+    serverManager->serverNegotiate(clientOutput.obj(), &serverOutput);
+    auto serverObj = serverOutput.obj();
+    clientManager->clientFinish(serverObj);
+    return serverObj;
+}
+
+TEST(ZstdMessageCompressor, StreamingKeepsHistoryAcrossMessages) {
+    auto registry = buildZstdRegistry({true /* streaming */, 17});
+    MessageCompressorManager clientManager(&registry);
+    MessageCompressorManager serverManager(&registry);
+
+    auto serverObj = negotiate(&clientManager, &serverManager);
+    checkNegotiationResult(serverObj, {"zstd"});
+    ASSERT_BSONOBJ_EQ(serverObj["compressionOptions"].Obj(),
+                      BSON("zstd" << BSON("streaming" << true)));
+
+    // Random bytes do not compress on their own, but a repeat of an earlier message on the same
+    // stream does.
+    PseudoRandom random(1);
+    std::string data;
+    for (int i = 0; i < 2048; ++i) {
+        data.push_back(static_cast<char>(random.nextInt32()));
+    }
+    const auto msg = buildMessage(data);
+    const auto original = msg.singleData();
+
+    std::size_t firstCompressedSize = 0;
+    for (int i = 0; i < 3; ++i) {
+        // Alternate directions; each direction of the connection is its own stream.
+        auto& sender = i % 2 ? serverManager : clientManager;
+        auto& receiver = i % 2 ? clientManager : serverManager;
+
+        auto compressed = assertOk(sender.compressMessage(msg));
+        ASSERT_EQ(compressed.operation(), dbCompressed);
+        auto decompressed = assertOk(receiver.decompressMessage(compressed));
+        ASSERT_EQ(decompressed.singleData().getLen(), original.getLen());
+        ASSERT_EQ(memcmp(decompressed.singleData().data(), original.data(), original.dataLen()),
+                  0);
+
+        if (i == 0) {
+            firstCompressedSize = compressed.size();
+        } else if (i == 2) {
+            ASSERT_LT(compressed.size(), firstCompressedSize / 4);
+        }
+    }
+}
+
+TEST(ZstdMessageCompressor, StreamingNeedsBothPeers) {
+    auto clientRegistry = buildZstdRegistry({true /* streaming */, 17});
+    auto serverRegistry = buildZstdRegistry({false /* streaming */, 17});
+    MessageCompressorManager clientManager(&clientRegistry);
+    MessageCompressorManager serverManager(&serverRegistry);
+
+    auto serverObj = negotiate(&clientManager, &serverManager);
+    checkNegotiationResult(serverObj, {"zstd"});
+    ASSERT_FALSE(serverObj.hasField("compressionOptions"));
+
+    // Without a context, messages are independent frames that either side can read.
+    const auto msg = buildMessage();
+    auto compressed = assertOk(clientManager.compressMessage(msg));
+    auto decompressed = assertOk(serverManager.decompressMessage(compressed));
+    ASSERT_EQ(decompressed.singleData().getLen(), msg.singleData().getLen());
+}
+
+TEST(ZstdMessageCompressor, RejectsDictionaryWithoutId) {
+    const std::string raw = "not a trained dictionary";
+    ZstdMessageCompressor compressor;
+    ASSERT_NOT_OK(compressor.loadDictionary(ConstDataRange(raw.data(), raw.size())));
+}
+
 TEST(SnappyMessageCompressor, Overflow) {
     checkOverflow(std::make_unique<SnappyMessageCompressor>());
 }
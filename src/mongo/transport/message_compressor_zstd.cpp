@@ -29,17 +29,184 @@
 
 #include "mongo/platform/basic.h"
 
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <string>
 
 #include <zstd.h>
 
 #include "mongo/base/init.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/transport/message_compressor_zstd_gen.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
+namespace {
+constexpr auto kStreamingField = "streaming"_sd;
+constexpr auto kDictionaryIdField = "dictionaryId"_sd;
 
-ZstdMessageCompressor::ZstdMessageCompressor() : MessageCompressorBase(MessageCompressor::kZstd) {}
+// A streaming context flushes each message as the continuation of a single frame, so on top of
+// ZSTD_compressBound() it can emit the frame header (with the first message) and a block header.
+constexpr std::size_t kStreamingOverhead = 32;
+
+struct CCtxDeleter {
+    void operator()(ZSTD_CCtx* cctx) const {
+        ZSTD_freeCCtx(cctx);
+    }
+};
+
+struct DCtxDeleter {
+    void operator()(ZSTD_DCtx* dctx) const {
+        ZSTD_freeDCtx(dctx);
+    }
+};
+
+Status zstdError(StringData what, size_t ret) {
+    return Status{ErrorCodes::BadValue, str::stream() << what << ZSTD_getErrorName(ret)};
+}
+}  // namespace
+
+struct ZstdMessageCompressor::Dictionary {
+    ~Dictionary() {
+        ZSTD_freeCDict(cdict);
+        ZSTD_freeDDict(ddict);
+    }
+
+    ZSTD_CDict* cdict = nullptr;
+    ZSTD_DDict* ddict = nullptr;
+    unsigned id = 0;
+};
+
+/*
+ * Compresses the messages of one connection. In streaming mode every message is flushed as part
+ * of one never-ending frame, so later messages can refer back to earlier ones; otherwise every
+ * message is its own frame, as with the stateless methods, but compressed with the dictionary.
+ * The zstd contexts are only created once the connection sends or receives a compressed message.
+ */
+class ZstdMessageCompressor::Context final : public MessageCompressorContext {
+public:
+    Context(ZstdMessageCompressor* compressor, bool streaming, bool useDictionary)
+        : _compressor(compressor), _streaming(streaming), _useDictionary(useDictionary) {}
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override {
+        return ZSTD_compressBound(inputSize) + (_streaming ? kStreamingOverhead : 0);
+    }
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override {
+        if (!_cctx) {
+            auto status = _initCCtx();
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+        if (!_streaming) {
+            ZSTD_CCtx_reset(_cctx.get(), ZSTD_reset_session_only);
+        }
+
+        ZSTD_inBuffer in{input.data(), input.length(), 0};
+        ZSTD_outBuffer out{const_cast<char*>(output.data()), output.length(), 0};
+        const auto endOp = _streaming ? ZSTD_e_flush : ZSTD_e_end;
+        size_t remaining;
+        do {
+            remaining = ZSTD_compressStream2(_cctx.get(), &out, &in, endOp);
+            if (ZSTD_isError(remaining)) {
+                return zstdError("Could not compress input: ", remaining);
+            }
+        } while (remaining != 0 && out.pos < out.size);
+
+        if (remaining != 0) {
+            return Status{ErrorCodes::BadValue, "Could not compress input: output buffer is full"};
+        }
+        _compressor->counterHitCompress(input.length(), out.pos);
+        return {out.pos};
+    }
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override {
+        if (!_dctx) {
+            _dctx.reset(ZSTD_createDCtx());
+            if (_useDictionary) {
+                ZSTD_DCtx_refDDict(_dctx.get(), _compressor->_dictionary->ddict);
+            }
+        }
+        if (!_streaming) {
+            ZSTD_DCtx_reset(_dctx.get(), ZSTD_reset_session_only);
+        }
+
+        ZSTD_inBuffer in{input.data(), input.length(), 0};
+        ZSTD_outBuffer out{const_cast<char*>(output.data()), output.length(), 0};
+        while (in.pos < in.size) {
+            const auto inPos = in.pos;
+            const auto outPos = out.pos;
+            size_t ret = ZSTD_decompressStream(_dctx.get(), &out, &in);
+            if (ZSTD_isError(ret)) {
+                return zstdError("Could not decompress message: ", ret);
+            }
+            if (in.pos == inPos && out.pos == outPos) {
+                return Status{ErrorCodes::BadValue,
+                              "Could not decompress message: output buffer is full"};
+            }
+        }
+
+        _compressor->counterHitDecompress(input.length(), out.pos);
+        return {out.pos};
+    }
+
+private:
+    Status _initCCtx() {
+        _cctx.reset(ZSTD_createCCtx());
+        size_t ret =
+            ZSTD_CCtx_setParameter(_cctx.get(), ZSTD_c_compressionLevel, ZSTD_CLEVEL_DEFAULT);
+        if (!ZSTD_isError(ret) && _streaming) {
+            ret = ZSTD_CCtx_setParameter(
+                _cctx.get(), ZSTD_c_windowLog, _compressor->_options.windowLog);
+        }
+        if (!ZSTD_isError(ret) && _useDictionary) {
+            ret = ZSTD_CCtx_refCDict(_cctx.get(), _compressor->_dictionary->cdict);
+        }
+        if (ZSTD_isError(ret)) {
+            _cctx.reset();
+            return zstdError("Could not set up compression context: ", ret);
+        }
+        return Status::OK();
+    }
+
+    ZstdMessageCompressor* const _compressor;
+    const bool _streaming;
+    const bool _useDictionary;
+
+    std::unique_ptr<ZSTD_CCtx, CCtxDeleter> _cctx;
+    std::unique_ptr<ZSTD_DCtx, DCtxDeleter> _dctx;
+};
+
+ZstdMessageCompressor::ZstdMessageCompressor() : ZstdMessageCompressor(Options{}) {}
+
+ZstdMessageCompressor::ZstdMessageCompressor(Options options)
+    : MessageCompressorBase(MessageCompressor::kZstd), _options(options) {}
+
+ZstdMessageCompressor::~ZstdMessageCompressor() = default;
+
+Status ZstdMessageCompressor::loadDictionary(ConstDataRange dictionary) {
+    const auto id = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.length());
+    if (id == 0) {
+        return Status{ErrorCodes::BadValue,
+                      "zstd network compression dictionary has no dictionary id; train it with "
+                      "'zstd --train'"};
+    }
+
+    auto loaded = std::make_unique<Dictionary>();
+    loaded->cdict = ZSTD_createCDict(dictionary.data(), dictionary.length(), ZSTD_CLEVEL_DEFAULT);
+    loaded->ddict = ZSTD_createDDict(dictionary.data(), dictionary.length());
+    if (!loaded->cdict || !loaded->ddict) {
+        return Status{ErrorCodes::BadValue, "Could not load zstd network compression dictionary"};
+    }
+    loaded->id = id;
+    _dictionary = std::move(loaded);
+    return Status::OK();
+}
 
 std::size_t ZstdMessageCompressor::getMaxCompressedSize(size_t inputSize) {
     return ZSTD_compressBound(inputSize);
@@ -75,13 +242,75 @@ StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange inp
     return {ret};
 }
 
+void ZstdMessageCompressor::appendContextOffer(BSONObjBuilder* output) {
+    if (_options.streaming) {
+        output->append(kStreamingField, true);
+    }
+    if (_dictionary) {
+        output->append(kDictionaryIdField, static_cast<long long>(_dictionary->id));
+    }
+}
+
+std::unique_ptr<MessageCompressorContext> ZstdMessageCompressor::acceptContext(
+    const BSONObj& offer, BSONObjBuilder* accepted) {
+    const bool streaming = _options.streaming && offer[kStreamingField].trueValue();
+    const auto dictionaryId = offer[kDictionaryIdField];
+    const bool useDictionary = _dictionary && dictionaryId.isNumber() &&
+        dictionaryId.safeNumberLong() == static_cast<long long>(_dictionary->id);
+
+    if (streaming) {
+        accepted->append(kStreamingField, true);
+    }
+    if (useDictionary) {
+        accepted->append(kDictionaryIdField, static_cast<long long>(_dictionary->id));
+    }
+    return _makeContext(streaming, useDictionary);
+}
+
+std::unique_ptr<MessageCompressorContext> ZstdMessageCompressor::makeContext(
+    const BSONObj& accepted) {
+    // The server only accepts what this process offered, so anything else is ignored.
+    const bool streaming = _options.streaming && accepted[kStreamingField].trueValue();
+    const auto dictionaryId = accepted[kDictionaryIdField];
+    const bool useDictionary = _dictionary && dictionaryId.isNumber() &&
+        dictionaryId.safeNumberLong() == static_cast<long long>(_dictionary->id);
+    return _makeContext(streaming, useDictionary);
+}
+
+std::unique_ptr<MessageCompressorContext> ZstdMessageCompressor::_makeContext(bool streaming,
+                                                                              bool useDictionary) {
+    if (!streaming && !useDictionary) {
+        return nullptr;
+    }
+    return std::make_unique<Context>(this, streaming, useDictionary);
+}
+
 
 MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
                           ("EndStartupOptionHandling"),
                           ("AllCompressorsRegistered"))
 (InitializerContext* context) {
+    auto compressor = std::make_unique<ZstdMessageCompressor>(ZstdMessageCompressor::Options{
+        gZstdNetworkCompressionStreaming, gZstdNetworkCompressionWindowLog});
+
+    if (!gZstdNetworkCompressionDictionaryFile.empty()) {
+        std::ifstream file(gZstdNetworkCompressionDictionaryFile, std::ios::binary);
+        if (!file) {
+            return Status{ErrorCodes::FileOpenFailed,
+                          str::stream() << "Could not open zstd network compression dictionary "
+                                        << gZstdNetworkCompressionDictionaryFile};
+        }
+        const std::string dictionary{std::istreambuf_iterator<char>(file),
+                                     std::istreambuf_iterator<char>()};
+        auto status =
+            compressor->loadDictionary(ConstDataRange(dictionary.data(), dictionary.size()));
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
     auto& compressorRegistry = MessageCompressorRegistry::get();
-    compressorRegistry.registerImplementation(std::make_unique<ZstdMessageCompressor>());
+    compressorRegistry.registerImplementation(std::move(compressor));
     return Status::OK();
 }
 }  // namespace mongo
@@ -27,18 +27,52 @@
  *    it in the license file.
  */
 
+#include <memory>
+
 #include "mongo/transport/message_compressor_base.h"
 
 namespace mongo {
 class ZstdMessageCompressor final : public MessageCompressorBase {
 public:
+    struct Options {
+        // Offer and accept a streaming context that keeps history across messages.
+        bool streaming = false;
+        // Base 2 logarithm of the history a streaming context keeps.
+        int windowLog = 17;
+    };
+
     ZstdMessageCompressor();
+    explicit ZstdMessageCompressor(Options options);
+    ~ZstdMessageCompressor();
+
+    /*
+     * Loads a dictionary trained with "zstd --train". Connections whose peers loaded a dictionary
+     * with the same id use it for every message. Raw content dictionaries have no id and are
+     * rejected.
+     */
+    Status loadDictionary(ConstDataRange dictionary);
 
     std::size_t getMaxCompressedSize(size_t inputSize) override;
 
     StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
 
     StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+    void appendContextOffer(BSONObjBuilder* output) override;
+
+    std::unique_ptr<MessageCompressorContext> acceptContext(const BSONObj& offer,
+                                                            BSONObjBuilder* accepted) override;
+
+    std::unique_ptr<MessageCompressorContext> makeContext(const BSONObj& accepted) override;
+
+private:
+    class Context;
+    struct Dictionary;
+
+    std::unique_ptr<MessageCompressorContext> _makeContext(bool streaming, bool useDictionary);
+
+    const Options _options;
+    std::unique_ptr<Dictionary> _dictionary;
 };
 
 
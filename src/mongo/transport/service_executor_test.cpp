@@ -41,6 +41,7 @@
 #include "mongo/transport/service_executor_fixed.h"
 #include "mongo/transport/service_executor_gen.h"
 #include "mongo/transport/service_executor_synchronous.h"
+#include "mongo/transport/service_executor_thread_per_core.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/transport/transport_layer_mock.h"
 #include "mongo/unittest/barrier.h"
@@ -398,5 +399,151 @@ TEST_F(ServiceExecutorFixedFixture, StartAndShutdownAreDeterministic) {
     shutdownThread.join();
 }
 
+class ServiceExecutorThreadPerCoreFixture : public unittest::Test {
+public:
+    static constexpr size_t kNumExecutorThreads = 2;
+
+    void setUp() override {
+        ServiceExecutorThreadPerCore::Options options;
+        options.numThreads = kNumExecutorThreads;
+        options.name = "Test";
+        executor = std::make_shared<ServiceExecutorThreadPerCore>(std::move(options));
+    }
+
+    void tearDown() override {
+        ASSERT_OK(executor->shutdown(kShutdownTime));
+    }
+
+    std::shared_ptr<ServiceExecutorThreadPerCore> executor;
+};
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, ScheduleFailsBeforeStartup) {
+    ASSERT_NOT_OK(executor->scheduleTask([] {}, ServiceExecutor::kEmptyFlags));
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, BasicTaskRuns) {
+    ASSERT_OK(executor->start());
+    ASSERT_EQ(executor->getThreadCount(), kNumExecutorThreads);
+
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+    ASSERT_OK(executor->scheduleTask([barrier]() mutable { barrier->countDownAndWait(); },
+                                     ServiceExecutor::kEmptyFlags));
+    barrier->countDownAndWait();
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, RecursiveTask) {
+    ASSERT_OK(executor->start());
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+
+    std::function<void()> recursiveTask;
+    recursiveTask = [&, barrier] {
+        if (executor->getRecursionDepthForExecutorThread() <
+            threadPerCoreServiceExecutorRecursionLimit.load()) {
+            ASSERT_OK(executor->scheduleTask(recursiveTask, ServiceExecutor::kMayRecurse));
+        } else {
+            barrier->countDownAndWait();
+        }
+    };
+
+    ASSERT_OK(executor->scheduleTask(recursiveTask, ServiceExecutor::kMayRecurse));
+    barrier->countDownAndWait();
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, IdleThreadStealsQueuedTask) {
+    ASSERT_OK(executor->start());
+    auto stolenTaskRan = std::make_shared<SharedPromise<void>>();
+    auto done = std::make_shared<SharedPromise<void>>();
+
+    // The first task queues a second one on its own thread, then blocks until it has run. The
+    // second task can therefore only run if the other executor thread steals it.
+    ASSERT_OK(executor->scheduleTask(
+        [this, stolenTaskRan, done] {
+            ASSERT_OK(executor->scheduleTask([stolenTaskRan] { stolenTaskRan->emplaceValue(); },
+                                             ServiceExecutor::kEmptyFlags));
+            stolenTaskRan->getFuture().get();
+            done->emplaceValue();
+        },
+        ServiceExecutor::kEmptyFlags));
+    done->getFuture().get();
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    auto obj = bob.obj();
+    ASSERT_EQ(obj["executor"].str(), "threadPerCore");
+    ASSERT_GTE(obj.getField("tasksStolen").numberLong(), 1);
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, ShutdownTimeLimit) {
+    ASSERT_OK(executor->start());
+    auto invoked = std::make_shared<SharedPromise<void>>();
+    auto mayReturn = std::make_shared<SharedPromise<void>>();
+
+    ASSERT_OK(executor->scheduleTask(
+        [invoked, mayReturn]() mutable {
+            invoked->emplaceValue();
+            mayReturn->getFuture().get();
+        },
+        ServiceExecutor::kEmptyFlags));
+
+    invoked->getFuture().get();
+    ASSERT_NOT_OK(executor->shutdown(kShutdownTime));
+
+    // Let the task return so that tearDown() can shut the executor down.
+    mayReturn->emplaceValue();
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, ShutdownFailsQueuedCallbacks) {
+    auto tl = std::make_unique<TransportLayerMock>();
+    auto session = tl->createSession();
+
+    // Keep the executor threads from running anything, so that work stays queued.
+    FailPointEnableBlock failpoint("hangAfterServiceExecutorThreadPerCoreThreadsStart");
+    ASSERT_OK(executor->start());
+    failpoint->waitForTimesEntered(failpoint.initialTimesEntered() + kNumExecutorThreads);
+
+    bool ranTask = false;
+    ASSERT_OK(executor->scheduleTask([&] { ranTask = true; }, ServiceExecutor::kEmptyFlags));
+
+    auto callbackStatus = std::make_shared<SharedPromise<void>>();
+    executor->runOnDataAvailable(session.get(), [callbackStatus](Status status) {
+        callbackStatus->setFrom(Future<void>::makeReady(status));
+    });
+    reinterpret_cast<MockSession*>(session.get())->signalAvailableData();
+
+    // The threads are still held by the failpoint, so they cannot exit in time.
+    ASSERT_NOT_OK(executor->shutdown(kShutdownTime));
+    ASSERT_EQ(callbackStatus->getFuture().getNoThrow(), ErrorCodes::ShutdownInProgress);
+    ASSERT_FALSE(ranTask);
+
+    // Continuations scheduled after shutdown also fail rather than hang.
+    auto lateStatus = std::make_shared<SharedPromise<void>>();
+    executor->runOnDataAvailable(session.get(), [lateStatus](Status status) {
+        lateStatus->setFrom(Future<void>::makeReady(status));
+    });
+    reinterpret_cast<MockSession*>(session.get())->signalAvailableData();
+    ASSERT_EQ(lateStatus->getFuture().getNoThrow(), ErrorCodes::ShutdownInProgress);
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, RunTaskAfterWaitingForData) {
+    auto tl = std::make_unique<TransportLayerMock>();
+    auto session = tl->createSession();
+    ASSERT_OK(executor->start());
+
+    const auto mainThreadId = stdx::this_thread::get_id();
+    AtomicWord<bool> ranOnDataAvailable{false};
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+    executor->runOnDataAvailable(
+        session.get(), [&ranOnDataAvailable, mainThreadId, barrier](Status) mutable -> void {
+            ranOnDataAvailable.store(true);
+            ASSERT(stdx::this_thread::get_id() != mainThreadId);
+            barrier->countDownAndWait();
+        });
+
+    ASSERT(!ranOnDataAvailable.load());
+    reinterpret_cast<MockSession*>(session.get())->signalAvailableData();
+    barrier->countDownAndWait();
+    ASSERT(ranOnDataAvailable.load());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,342 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_thread_per_core.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "mongo/base/error_codes.h"
+#include "mongo/logv2/log.h"
+#include "mongo/transport/service_executor_gen.h"
+#include "mongo/transport/session.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+MONGO_FAIL_POINT_DEFINE(hangBeforeSchedulingServiceExecutorThreadPerCoreTask);
+MONGO_FAIL_POINT_DEFINE(hangAfterServiceExecutorThreadPerCoreThreadsStart);
+
+namespace transport {
+namespace {
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kThreadsSleeping = "threadsSleeping"_sd;
+constexpr auto kTasksStolen = "tasksStolen"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "threadPerCore"_sd;
+
+// An idle thread sleeps at most this long before looking for work to steal again, in case tasks
+// were queued behind a busy thread without waking it.
+constexpr Milliseconds kIdleStealInterval{10};
+
+size_t numThreadsFromOptions(size_t numThreads) {
+    return numThreads ? numThreads : std::max<size_t>(1, ProcessInfo::getNumAvailableCores());
+}
+
+void pinCurrentThreadToCore(size_t core) {
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(core % CPU_SETSIZE, &cpuSet);
+    if (int err = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet)) {
+        LOGV2_WARNING(4972300,
+                      "Failed to pin service executor thread to core",
+                      "core"_attr = core,
+                      "error"_attr = errnoWithDescription(err));
+    }
+#endif
+}
+}  // namespace
+
+ServiceExecutorThreadPerCore::ServiceExecutorThreadPerCore(Options options)
+    : _options(std::move(options)) {
+    const auto numThreads = numThreadsFromOptions(_options.numThreads);
+    _workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+}
+
+ServiceExecutorThreadPerCore::~ServiceExecutorThreadPerCore() {
+    invariant(!_canScheduleWork.load());
+    if (_state == State::kNotStarted)
+        return;
+
+    // Ensures we always call "shutdown" after staring the service executor
+    invariant(_state == State::kStopped);
+    for (auto& worker : _workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    invariant(_numRunningExecutorThreads.load() == 0);
+}
+
+Status ServiceExecutorThreadPerCore::start() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto oldState = std::exchange(_state, State::kRunning);
+    invariant(oldState == State::kNotStarted);
+    _canScheduleWork.store(true);
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        _workers[i]->thread = stdx::thread([this, i] { _runWorker(i); });
+    }
+    LOGV2_DEBUG(4972301,
+                3,
+                "Started thread-per-core service executor",
+                "name"_attr = _options.name,
+                "numThreads"_attr = _workers.size());
+    return Status::OK();
+}
+
+Status ServiceExecutorThreadPerCore::shutdown(Milliseconds timeout) {
+    LOGV2_DEBUG(
+        4972302, 3, "Shutting down thread-per-core service executor", "name"_attr = _options.name);
+
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _canScheduleWork.store(false);
+        _state = State::kStopped;
+    }
+
+    for (auto& worker : _workers) {
+        std::deque<OutOfLineExecutor::Task> dropped;
+        {
+            stdx::lock_guard<Latch> lk(worker->mutex);
+            dropped.swap(worker->queue);
+            worker->wakeup.notify_one();
+        }
+        // Outstanding tasks are failed outside of the worker's lock.
+        for (auto& task : dropped) {
+            task(Status(ErrorCodes::ShutdownInProgress, "Executor is not running"));
+        }
+    }
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    bool success = _shutdownCondition.wait_for(lk, timeout.toSystemDuration(), [this] {
+        return _numRunningExecutorThreads.load() == 0;
+    });
+    return success ? Status::OK()
+                   : Status(ErrorCodes::ExceededTimeLimit,
+                            "Failed to shutdown all executor threads within the time limit");
+}
+
+Status ServiceExecutorThreadPerCore::scheduleTask(Task task, ScheduleFlags flags) {
+    if (!_canScheduleWork.load()) {
+        return Status(ErrorCodes::ShutdownInProgress, "Executor is not running");
+    }
+
+    auto context = _ownThreadContext();
+    if ((flags & ScheduleFlags::kMayRecurse) && context &&
+        context->recursionDepth < threadPerCoreServiceExecutorRecursionLimit.loadRelaxed()) {
+        // Recursively executing the task on the executor thread.
+        context->run(std::move(task));
+        return Status::OK();
+    }
+
+    hangBeforeSchedulingServiceExecutorThreadPerCoreTask.pauseWhileSet();
+
+    const auto index = context ? context->index : _nextWorker.fetchAndAdd(1) % _workers.size();
+    return _scheduleOnWorker(index, [task = std::move(task)](Status status) mutable {
+        if (status.isOK()) {
+            task();
+        }
+    });
+}
+
+void ServiceExecutorThreadPerCore::runOnDataAvailable(
+    Session* session, OutOfLineExecutor::Task onCompletionCallback) {
+    invariant(session);
+
+    // Resume the session on the thread that started waiting for it, so that it keeps its core.
+    auto context = _ownThreadContext();
+    const auto index = context ? context->index : _nextWorker.fetchAndAdd(1) % _workers.size();
+
+    session->waitForData().getAsync(
+        [this, anchor = shared_from_this(), index, callback = std::move(onCompletionCallback)](
+            Status status) mutable {
+            if (status.isOK() && !_canScheduleWork.load()) {
+                status = Status(ErrorCodes::ShutdownInProgress, "Executor is not running");
+            }
+            if (!status.isOK()) {
+                callback(std::move(status));
+                return;
+            }
+
+            // On failure, the callback has been invoked with the error.
+            _scheduleOnWorker(index, std::move(callback)).ignore();
+        });
+}
+
+void ServiceExecutorThreadPerCore::appendStats(BSONObjBuilder* bob) const {
+    *bob << kExecutorLabel << kExecutorName << kThreadsRunning
+         << static_cast<int>(_numRunningExecutorThreads.load()) << kThreadsSleeping
+         << static_cast<int>(_numSleepingExecutorThreads.load()) << kTasksStolen
+         << _tasksStolen.load();
+}
+
+int ServiceExecutorThreadPerCore::getRecursionDepthForExecutorThread() const {
+    auto context = _ownThreadContext();
+    invariant(context);
+    return context->recursionDepth;
+}
+
+ServiceExecutorThreadPerCore::ExecutorThreadContext*
+ServiceExecutorThreadPerCore::_ownThreadContext() const {
+    if (_executorContext && _executorContext->executor == this) {
+        return _executorContext;
+    }
+    return nullptr;
+}
+
+void ServiceExecutorThreadPerCore::_runWorker(size_t index) {
+    const std::string threadName = str::stream() << _options.name << "-" << index;
+    setThreadName(threadName);
+    if (_options.pinThreadsToCores) {
+        pinCurrentThreadToCore(index);
+    }
+    if (_options.onCreateThread) {
+        _options.onCreateThread(threadName);
+    }
+
+    ExecutorThreadContext context{this, index};
+    _executorContext = &context;
+    _numRunningExecutorThreads.fetchAndAdd(1);
+    ON_BLOCK_EXIT([&] {
+        _executorContext = nullptr;
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_numRunningExecutorThreads.subtractAndFetch(1) == 0) {
+            _shutdownCondition.notify_all();
+        }
+    });
+
+    hangAfterServiceExecutorThreadPerCoreThreadsStart.pauseWhileSet();
+
+    auto& worker = *_workers[index];
+    while (_canScheduleWork.load()) {
+        OutOfLineExecutor::Task task;
+        if (_popOrSteal(index, &task)) {
+            context.run([&] { task(Status::OK()); });
+            continue;
+        }
+
+        stdx::unique_lock<Latch> lk(worker.mutex);
+        if (!worker.queue.empty() || !_canScheduleWork.load()) {
+            continue;
+        }
+
+        worker.sleeping = true;
+        _numSleepingExecutorThreads.fetchAndAdd(1);
+        worker.wakeup.wait_for(lk, kIdleStealInterval.toSystemDuration());
+        _numSleepingExecutorThreads.fetchAndSubtract(1);
+        worker.sleeping = false;
+    }
+}
+
+Status ServiceExecutorThreadPerCore::_scheduleOnWorker(size_t index,
+                                                       OutOfLineExecutor::Task task) {
+    auto& worker = *_workers[index];
+    bool wakeThief;
+    {
+        stdx::unique_lock<Latch> lk(worker.mutex);
+        // Checked under the worker's lock so that no task is queued after shutdown drained it.
+        if (!_canScheduleWork.load()) {
+            lk.unlock();
+            Status status(ErrorCodes::ShutdownInProgress, "Executor is not running");
+            task(status);
+            return status;
+        }
+
+        worker.queue.push_back(std::move(task));
+        if (worker.sleeping) {
+            worker.wakeup.notify_one();
+            return Status::OK();
+        }
+
+        // A thread scheduling onto its own queue runs the task as soon as it returns, so another
+        // thread is only asked to take it when work is backing up.
+        auto context = _ownThreadContext();
+        wakeThief = !(context && context->index == index) || worker.queue.size() > 1;
+    }
+
+    if (wakeThief && _numSleepingExecutorThreads.load() > 0) {
+        _wakeSleepingWorker(index);
+    }
+    return Status::OK();
+}
+
+bool ServiceExecutorThreadPerCore::_popOrSteal(size_t index, OutOfLineExecutor::Task* task) {
+    {
+        auto& worker = *_workers[index];
+        stdx::lock_guard<Latch> lk(worker.mutex);
+        if (!worker.queue.empty()) {
+            *task = std::move(worker.queue.front());
+            worker.queue.pop_front();
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < _workers.size(); ++i) {
+        auto& victim = *_workers[(index + i) % _workers.size()];
+        stdx::lock_guard<Latch> lk(victim.mutex);
+        if (!victim.queue.empty()) {
+            *task = std::move(victim.queue.front());
+            victim.queue.pop_front();
+            _tasksStolen.fetchAndAdd(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ServiceExecutorThreadPerCore::_wakeSleepingWorker(size_t index) {
+    for (size_t i = 1; i < _workers.size(); ++i) {
+        auto& worker = *_workers[(index + i) % _workers.size()];
+        stdx::lock_guard<Latch> lk(worker.mutex);
+        if (worker.sleeping) {
+            worker.wakeup.notify_one();
+            return;
+        }
+    }
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * A service executor that runs one thread per core, each with its own run queue.
+ *
+ * Tasks scheduled from one of the executor threads, including the continuations of
+ * runOnDataAvailable() issued from them, are queued on that same thread, so a connection keeps
+ * running on the same core from one operation to the next. Tasks scheduled from other threads are
+ * spread across the run queues round-robin. A thread whose queue is empty steals the oldest task of
+ * another queue before going to sleep, and queueing a task behind a busy thread wakes a sleeping
+ * one to steal it. There is no queue shared by all threads, so scheduling only contends with the
+ * thread owning the target queue and with thieves.
+ *
+ * Continuations of runOnDataAvailable() that cannot be queued, or are still queued at shutdown,
+ * are invoked with a ShutdownInProgress status. Tasks passed to scheduleTask() are then dropped.
+ */
+class ServiceExecutorThreadPerCore
+    : public ServiceExecutor,
+      public std::enable_shared_from_this<ServiceExecutorThreadPerCore> {
+public:
+    struct Options {
+        // The number of executor threads. Zero means one per available core.
+        size_t numThreads = 0;
+
+        // Executor threads are named "<name>-<index>".
+        std::string name = "ThreadPerCore";
+
+        // Whether executor thread i is bound to core i. Only honored on Linux.
+        bool pinThreadsToCores = false;
+
+        // Invoked on each executor thread, with its name, before it runs any task.
+        std::function<void(const std::string&)> onCreateThread;
+    };
+
+    explicit ServiceExecutorThreadPerCore(Options options);
+    virtual ~ServiceExecutorThreadPerCore();
+
+    Status start() override;
+    Status shutdown(Milliseconds timeout) override;
+    Status scheduleTask(Task task, ScheduleFlags flags) override;
+
+    void runOnDataAvailable(Session* session,
+                            OutOfLineExecutor::Task onCompletionCallback) override;
+
+    Mode transportMode() const override {
+        return Mode::kSynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const override;
+
+    /**
+     * Returns the recursion depth of the active executor thread.
+     * It is forbidden to invoke this method outside scheduled tasks.
+     */
+    int getRecursionDepthForExecutorThread() const;
+
+    size_t getThreadCount() const {
+        return _workers.size();
+    }
+
+private:
+    struct Worker {
+        Mutex mutex = MONGO_MAKE_LATCH("ServiceExecutorThreadPerCore::Worker::mutex");
+        stdx::condition_variable wakeup;
+        std::deque<OutOfLineExecutor::Task> queue;
+        bool sleeping = false;
+        stdx::thread thread;
+    };
+
+    // Maintains the execution state (e.g., recursion depth) of an executor thread.
+    struct ExecutorThreadContext {
+        const ServiceExecutorThreadPerCore* executor;
+        const size_t index;
+        int recursionDepth = 0;
+
+        template <typename F>
+        void run(F&& task) {
+            recursionDepth++;
+            task();
+            recursionDepth--;
+        }
+    };
+
+    // Returns the context of the calling thread if it is one of this executor's threads.
+    ExecutorThreadContext* _ownThreadContext() const;
+
+    void _runWorker(size_t index);
+
+    // Queues 'task' on the worker at 'index', waking a thread to run it if needed. If the executor
+    // is shutting down, invokes 'task' with the returned error status instead.
+    Status _scheduleOnWorker(size_t index, OutOfLineExecutor::Task task);
+
+    // Takes the oldest task of the worker at 'index', or else steals one from another worker.
+    bool _popOrSteal(size_t index, OutOfLineExecutor::Task* task);
+
+    // Wakes one sleeping worker, other than the one at 'index', to steal work.
+    void _wakeSleepingWorker(size_t index);
+
+    const Options _options;
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    AtomicWord<size_t> _numRunningExecutorThreads{0};
+    AtomicWord<size_t> _numSleepingExecutorThreads{0};
+    AtomicWord<size_t> _nextWorker{0};
+    AtomicWord<long long> _tasksStolen{0};
+    AtomicWord<bool> _canScheduleWork{false};
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ServiceExecutorThreadPerCore::_mutex");
+    stdx::condition_variable _shutdownCondition;
+
+    /**
+     * State transition diagram: kNotStarted ---> kRunning ---> kStopped
+     * The service executor cannot be in "kRunning" when its destructor is invoked.
+     */
+    enum State { kNotStarted, kRunning, kStopped } _state = kNotStarted;
+
+    static inline thread_local ExecutorThreadContext* _executorContext = nullptr;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -143,6 +143,9 @@ Message makeExhaustMessage(Message requestMsg, DbResponse* dbresponse) {
     exhaustMessage.header().setId(dbresponse->response.header().getId());
     exhaustMessage.header().setResponseToMsgId(dbresponse->response.header().getResponseToMsgId());
     OpMsg::setFlag(&exhaustMessage, OpMsg::kExhaustSupported);
+    if (OpMsg::isFlagSet(requestMsg, OpMsg::kDocumentSequencesAccepted)) {
+        OpMsg::setFlag(&exhaustMessage, OpMsg::kDocumentSequencesAccepted);
+    }
     if (checksumPresent) {
         OpMsg::appendChecksum(&exhaustMessage);
     }
@@ -510,6 +513,7 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
                 networkCounter.hitLogicalOut(toSink.size());
 
                 if (_compressorId) {
+                    toSink.flatten();
                     auto swm = compressorMgr.compressMessage(toSink, &_compressorId.value());
                     uassertStatusOK(swm.getStatus());
                     toSink = swm.getValue();
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <utility>
+#include <vector>
 
 #include "mongo/base/system_error.h"
 #include "mongo/config.h"
@@ -38,6 +39,7 @@
 #include "mongo/transport/baton.h"
 #include "mongo/transport/ssl_connection_context.h"
 #include "mongo/transport/transport_layer_asio.h"
+#include "mongo/transport/transport_options_gen.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/net/socket_utils.h"
 #ifdef MONGO_CONFIG_SSL
@@ -171,6 +173,8 @@ public:
     }
 
     Future<void> waitForData() override {
+        if (_readBufferEnd > _readBufferStart)
+            return Future<void>::makeReady();
 #ifdef MONGO_CONFIG_SSL
         if (_sslSocket)
             return asio::async_read(*_sslSocket, asio::null_buffers(), UseFuture{}).ignoreValue();
@@ -181,7 +185,7 @@ public:
     Status sinkMessage(Message message) override {
         ensureSync();
 
-        return write(asio::buffer(message.buf(), message.size()))
+        return sinkSegments(message)
             .then([this, &message] {
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
@@ -192,7 +196,7 @@ public:
 
     Future<void> asyncSinkMessage(Message message, const BatonHandle& baton = nullptr) override {
         ensureAsync();
-        return write(asio::buffer(message.buf(), message.size()), baton)
+        return sinkSegments(message, baton)
             .then([this, message /*keep the buffer alive*/]() {
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
@@ -409,6 +413,10 @@ private:
     Future<Message> sourceMessageImpl(const BatonHandle& baton = nullptr) {
         static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
 
+        if (canCoalesceReads()) {
+            return sourceCoalescedMessage(baton);
+        }
+
         auto headerBuffer = SharedBuffer::allocate(kHeaderSize);
         auto ptr = headerBuffer.get();
         return read(asio::buffer(ptr, kHeaderSize), baton)
@@ -418,19 +426,8 @@ private:
                 }
 
                 const auto msgLen = size_t(MSGHEADER::View(headerBuffer.get()).getMessageLength());
-                if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
-                    StringBuilder sb;
-                    sb << "recv(): message msgLen " << msgLen << " is invalid. "
-                       << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
-                    const auto str = sb.str();
-                    LOGV2(4615638,
-                          "recv(): message msgLen {msgLen} is invalid. Min: {min} Max: {max}",
-                          "recv(): message mstLen is invalid.",
-                          "msgLen"_attr = msgLen,
-                          "min"_attr = kHeaderSize,
-                          "max"_attr = MaxMessageSizeBytes);
-
-                    return Future<Message>::makeReady(Status(ErrorCodes::ProtocolError, str));
+                if (auto status = checkMessageLength(msgLen); !status.isOK()) {
+                    return Future<Message>::makeReady(std::move(status));
                 }
 
                 if (msgLen == kHeaderSize) {
@@ -455,6 +452,158 @@ private:
             });
     }
 
+    Status checkMessageLength(size_t msgLen) {
+        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+        if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
+            StringBuilder sb;
+            sb << "recv(): message msgLen " << msgLen << " is invalid. "
+               << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
+            const auto str = sb.str();
+            LOGV2(4615638,
+                  "recv(): message msgLen {msgLen} is invalid. Min: {min} Max: {max}",
+                  "recv(): message mstLen is invalid.",
+                  "msgLen"_attr = msgLen,
+                  "min"_attr = kHeaderSize,
+                  "max"_attr = MaxMessageSizeBytes);
+
+            return Status(ErrorCodes::ProtocolError, str);
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Whether sourceMessageImpl() may receive a message with reads that can overshoot its end.
+     * TLS sessions are excluded because the SSL stream does its own buffering, as are sessions
+     * whose first bytes still have to be inspected for a TLS handshake.
+     */
+    bool canCoalesceReads() const {
+        if (_readBufferEnd > _readBufferStart)
+            return true;
+#ifdef MONGO_CONFIG_SSL
+        if (_sslSocket || !_ranHandshake)
+            return false;
+#endif
+        return size_t(gTransportLayerASIOCoalescedReadBytes.load()) >= sizeof(MSGHEADER::Value);
+    }
+
+    /**
+     * Sources a message by asking for up to transportLayerASIOCoalescedReadBytes at once, so that
+     * the header and body of a small message arrive with a single read. The read goes into a
+     * buffer owned by the session, from which each message is copied into a buffer of its own
+     * size. Any bytes received past the end of the message stay in the session's buffer and are
+     * consumed by the next call. Only the part of a large body that did not arrive with the first
+     * read is read separately, directly into the message's buffer.
+     */
+    Future<Message> sourceCoalescedMessage(const BatonHandle& baton) {
+        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+        const size_t pending = _readBufferEnd - _readBufferStart;
+        const size_t capacity = std::max(
+            {size_t(gTransportLayerASIOCoalescedReadBytes.load()), kHeaderSize, pending});
+        if (capacity > _readBufferCapacity) {
+            auto readBuffer = std::make_unique<char[]>(capacity);
+            if (pending) {
+                memcpy(readBuffer.get(), _readBuffer.get() + _readBufferStart, pending);
+            }
+            _readBuffer = std::move(readBuffer);
+            _readBufferCapacity = capacity;
+        } else if (_readBufferStart && pending) {
+            memmove(_readBuffer.get(), _readBuffer.get() + _readBufferStart, pending);
+        }
+        _readBufferStart = 0;
+        _readBufferEnd = 0;
+
+        auto ptr = _readBuffer.get();
+        return readAtLeast(ptr, capacity, pending, kHeaderSize, baton)
+            .then([this, ptr, baton](size_t filled) {
+                if (checkForHTTPRequest(asio::buffer(ptr, kHeaderSize))) {
+                    return sendHTTPResponse(baton);
+                }
+
+                const auto msgLen = size_t(MSGHEADER::View(ptr).getMessageLength());
+                if (auto status = checkMessageLength(msgLen); !status.isOK()) {
+                    return Future<Message>::makeReady(std::move(status));
+                }
+
+                auto buffer = SharedBuffer::allocate(msgLen);
+                if (filled >= msgLen) {
+                    memcpy(buffer.get(), ptr, msgLen);
+                    _readBufferStart = msgLen;
+                    _readBufferEnd = filled;
+                    if (_isIngressSession) {
+                        networkCounter.hitPhysicalIn(msgLen);
+                    }
+                    return Future<Message>::makeReady(Message(std::move(buffer)));
+                }
+
+                memcpy(buffer.get(), ptr, filled);
+                auto data = buffer.get();
+                return read(asio::buffer(data + filled, msgLen - filled), baton)
+                    .then([this, buffer = std::move(buffer), msgLen]() mutable {
+                        if (_isIngressSession) {
+                            networkCounter.hitPhysicalIn(msgLen);
+                        }
+                        return Message(std::move(buffer));
+                    });
+            });
+    }
+
+    /**
+     * Reads into 'buf' from offset 'filled' until at least 'minBytes' of it are filled, taking as
+     * many bytes as each read returns up to 'capacity'. Returns the number of bytes filled.
+     */
+    Future<size_t> readAtLeast(
+        char* buf, size_t capacity, size_t filled, size_t minBytes, const BatonHandle& baton) {
+        if (filled >= minBytes) {
+            return Future<size_t>::makeReady(filled);
+        }
+
+        return opportunisticReadSome(asio::buffer(buf + filled, capacity - filled), baton)
+            .then([this, buf, capacity, filled, minBytes, baton](size_t size) {
+                return readAtLeast(buf, capacity, filled + size, minBytes, baton);
+            });
+    }
+
+    /**
+     * Like opportunisticRead(), but completes as soon as any bytes have been read into 'buffer'
+     * rather than once it is full.
+     */
+    Future<size_t> opportunisticReadSome(asio::mutable_buffer buffer, const BatonHandle& baton) {
+        if (MONGO_unlikely(transportLayerASIOshortOpportunisticReadWrite.shouldFail()) &&
+            _blockingMode == Async && buffer.size()) {
+            buffer = asio::mutable_buffer(buffer.data(), 1);
+        }
+
+        std::error_code ec;
+        size_t size;
+        do {
+            size = _socket.read_some(buffer, ec);
+        } while (ec == asio::error::interrupted);  // retry syscall EINTR
+
+        if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
+            (_blockingMode == Async)) {
+            if (auto networkingBaton = baton ? baton->networking() : nullptr;
+                networkingBaton && networkingBaton->canWait()) {
+                return networkingBaton->addSession(*this, NetworkingBaton::Type::In)
+                    .onError([](Status error) {
+                        if (ErrorCodes::isShutdownError(error)) {
+                            // As in opportunisticRead(), fall back to asio::async_read_some() once
+                            // the baton has detached.
+                            return Status::OK();
+                        }
+
+                        return error;
+                    })
+                    .then([buffer, baton, this] { return opportunisticReadSome(buffer, baton); });
+            }
+
+            return _socket.async_read_some(buffer, UseFuture{});
+        }
+
+        return futurize(ec, size);
+    }
+
     template <typename MutableBufferSequence>
     Future<void> read(const MutableBufferSequence& buffers, const BatonHandle& baton = nullptr) {
         // TODO SERVER-47229 Guard active ops for cancelation here.
@@ -481,6 +630,54 @@ private:
         return opportunisticRead(_socket, buffers, baton);
     }
 
+    /**
+     * Writes a message to the socket. The segments of a gathered message go out in one vectored
+     * write so the documents it references are not copied; TLS encrypts into its own records, so
+     * there the message is flattened first. The caller keeps 'message' alive until the returned
+     * future is ready.
+     */
+    Future<void> sinkSegments(const Message& message, const BatonHandle& baton = nullptr) {
+        if (!message.isGathered()) {
+            return write(asio::buffer(message.buf(), message.size()), baton);
+        }
+
+#ifdef MONGO_CONFIG_SSL
+        if (_sslSocket) {
+            auto flat = message;
+            flat.flatten();
+            return write(asio::buffer(flat.buf(), flat.size()), baton).then([flat] {});
+        }
+        _ranHandshake = true;
+#endif
+
+        std::vector<asio::const_buffer> buffers;
+        message.forEachSegment(
+            [&](const char* data, size_t size) { buffers.emplace_back(data, size); });
+
+        std::error_code ec;
+        std::size_t size;
+        do {
+            size = asio::write(_socket, buffers, ec);
+        } while (ec == asio::error::interrupted);  // retry syscall EINTR
+
+        if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
+            (_blockingMode == Async)) {
+            // Drop whatever the socket already accepted and hand the rest to asio, which keeps its
+            // own copy of the buffer sequence.
+            auto it = buffers.begin();
+            for (; it != buffers.end() && size >= it->size(); ++it) {
+                size -= it->size();
+            }
+            if (it != buffers.end()) {
+                *it += size;
+            }
+            buffers.erase(buffers.begin(), it);
+            return asio::async_write(_socket, buffers, UseFuture{}).ignoreValue();
+        }
+
+        return futurize(ec);
+    }
+
     template <typename ConstBufferSequence>
     Future<void> write(const ConstBufferSequence& buffers, const BatonHandle& baton = nullptr) {
         // TODO SERVER-47229 Guard active ops for cancelation here.
@@ -821,6 +1018,13 @@ private:
     std::shared_ptr<SSLConnectionContext> _sslContext;
 #endif
 
+    // Buffer that coalesced reads go into. Bytes in [_readBufferStart, _readBufferEnd) were
+    // received past the end of the last message sourced by a coalesced read.
+    std::unique_ptr<char[]> _readBuffer;
+    size_t _readBufferCapacity = 0;
+    size_t _readBufferStart = 0;
+    size_t _readBufferEnd = 0;
+
     TransportLayerASIO* const _tl;
     bool _isIngressSession;
 };
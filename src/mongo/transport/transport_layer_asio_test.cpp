@@ -275,6 +275,11 @@ public:
     }
 
     void sendMessage() {
+        sendPipelinedMessages(1);
+    }
+
+    // Sends 'count' messages with a single write, so that they may arrive with a single read.
+    void sendPipelinedMessages(size_t count) {
         OpMsgBuilder builder;
         builder.setBody(BSON("ping" << 1));
         Message msg = builder.finish();
@@ -282,8 +287,13 @@ public:
         msg.header().setId(0);
         OpMsg::appendChecksum(&msg);
 
+        std::string buffer;
+        for (size_t i = 0; i < count; ++i) {
+            buffer.append(msg.buf(), msg.size());
+        }
+
         std::error_code ec;
-        asio::write(_sock, asio::buffer(msg.buf(), msg.size()), ec);
+        asio::write(_sock, asio::buffer(buffer.data(), buffer.size()), ec);
         ASSERT_FALSE(ec);
     }
 
@@ -331,6 +341,45 @@ TEST(TransportLayerASIO, SourceSyncTimeoutSucceeds) {
     tla->shutdown();
 }
 
+/* check that messages received together by one read are each sourced intact */
+class PipelinedSyncSEP : public TimeoutSEP {
+public:
+    static constexpr size_t kNumMessages = 3;
+
+    void startSession(transport::SessionHandle session) override {
+        startWorkerThread([this, session = std::move(session)]() mutable {
+            session->setTimeout(Milliseconds{5000});
+            for (size_t i = 0; i < kNumMessages; ++i) {
+                auto swMessage = session->sourceMessage();
+                ASSERT_OK(swMessage.getStatus());
+                auto& message = swMessage.getValue();
+                // Each message gets a buffer of its own size rather than one of the read's size.
+                ASSERT_EQ(message.sharedBuffer().capacity(), size_t(message.size()));
+                auto request = OpMsg::parse(message);
+                ASSERT_BSONOBJ_EQ(request.body, BSON("ping" << 1));
+            }
+
+            // Nothing else was sent, so a further message must not be sourced from leftovers.
+            session->setTimeout(Milliseconds{500});
+            ASSERT_EQ(session->sourceMessage().getStatus(), ErrorCodes::NetworkTimeout);
+
+            session.reset();
+            notifyComplete();
+        });
+    }
+};
+
+TEST(TransportLayerASIO, SourceSyncPipelinedMessages) {
+    PipelinedSyncSEP sep;
+    auto tla = makeAndStartTL(&sep);
+
+    TimeoutConnector connector(tla->listenerPort(), false);
+    connector.sendPipelinedMessages(PipelinedSyncSEP::kNumMessages);
+
+    sep.waitForTimeout();
+    tla->shutdown();
+}
+
 /* check that switching from timeouts to no timeouts correctly resets the timeout to unlimited */
 class TimeoutSwitchModesSEP : public TimeoutSEP {
 public:
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/adaptive_ticket_controller.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+AdaptiveTicketController::AdaptiveTicketController(TicketHolder* holder, Options options)
+    : _holder(holder),
+      _options(std::move(options)),
+      _lastReleased(holder->numReleased()),
+      _lastQueued(holder->numQueued()) {
+    invariant(_options.minTickets > 0);
+    invariant(_options.minTickets <= _options.maxTickets);
+}
+
+int AdaptiveTicketController::adjust(Date_t now) {
+    const int size = _holder->outof();
+    const long long released = _holder->numReleased();
+    const long long queued = _holder->numQueued();
+
+    if (_lastSampleTime == Date_t() || now <= _lastSampleTime) {
+        // The first sample only establishes the starting point of the counters.
+        _lastSampleTime = now;
+        _lastReleased = released;
+        _lastQueued = queued;
+        return size;
+    }
+
+    const double elapsedSecs = durationCount<Microseconds>(now - _lastSampleTime) / 1'000'000.0;
+    const double throughput = (released - _lastReleased) / elapsedSecs;
+    const bool saturated = queued > _lastQueued;
+    _lastSampleTime = now;
+    _lastReleased = released;
+    _lastQueued = queued;
+
+    if (throughput <= 0) {
+        // An idle holder says nothing about the concurrency the workload can sustain.
+        _lastAction = Action::kNone;
+        return size;
+    }
+
+    const double holdTime = std::max(_holder->used(), 1) / throughput;
+    _baselineHoldTime = _baselineHoldTime == 0
+        ? holdTime
+        : std::min(_baselineHoldTime * (1 + _options.baselineDecay), holdTime);
+
+    // A drop in throughput is only attributed to concurrency when it follows an increase, since
+    // every decrease is expected to lower throughput somewhat.
+    const bool throughputDropped = _lastAction == Action::kIncrease &&
+        throughput < _lastThroughput * (1 - _options.throughputDropThreshold);
+    const bool holdTimeInflated =
+        holdTime > _baselineHoldTime * _options.holdTimeInflationThreshold;
+    _lastThroughput = throughput;
+
+    int newSize = size;
+    _lastAction = Action::kNone;
+    if (throughputDropped || (saturated && holdTimeInflated)) {
+        newSize = std::max(static_cast<int>(std::floor(size * _options.multiplicativeDecrease)),
+                           _options.minTickets);
+        if (newSize < size) {
+            _lastAction = Action::kDecrease;
+            ++_numDecreases;
+        }
+    } else if (saturated) {
+        newSize = std::min(size + _options.additiveIncrease, _options.maxTickets);
+        if (newSize > size) {
+            _lastAction = Action::kIncrease;
+            ++_numIncreases;
+        }
+    }
+
+    if (newSize != size) {
+        uassertStatusOK(_holder->resize(newSize));
+    }
+    return newSize;
+}
+
+void AdaptiveTicketController::appendStats(BSONObjBuilder* builder) const {
+    builder->append("increases", _numIncreases);
+    builder->append("decreases", _numDecreases);
+    builder->append("throughput", _lastThroughput);
+    builder->append("baselineHoldTimeMicros",
+                    static_cast<long long>(_baselineHoldTime * 1'000'000));
+}
+
+}  // namespace mongo
@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Sizes a TicketHolder to the concurrency that the workload currently sustains, rather than to a
+ * fixed number of tickets.
+ *
+ * adjust() is called periodically. Each call measures the throughput of the holder, as the tickets
+ * released since the previous call, and by Little's law the average time a ticket is held, as the
+ * tickets in use divided by the throughput. The controller uses additive increase and
+ * multiplicative decrease:
+ *  - While operations queue for tickets and the holder shows no sign of congestion, the number of
+ *    tickets grows by a fixed step.
+ *  - When the hold time inflates well beyond the lowest recently observed, or throughput falls
+ *    after the last increase, the number of tickets shrinks by a constant factor.
+ * The number of tickets never leaves [minTickets, maxTickets].
+ *
+ * Not thread safe; adjust() must be called from a single thread.
+ */
+class AdaptiveTicketController {
+public:
+    struct Options {
+        int minTickets = 16;
+        int maxTickets = 1024;
+
+        // Tickets added per adjustment while the holder is saturated and not congested.
+        int additiveIncrease = 8;
+
+        // Factor by which the number of tickets is multiplied when the holder is congested.
+        double multiplicativeDecrease = 0.75;
+
+        // The holder is congested when the average hold time exceeds the baseline by this factor.
+        double holdTimeInflationThreshold = 2.0;
+
+        // ... or when throughput falls by more than this fraction after an increase.
+        double throughputDropThreshold = 0.1;
+
+        // The baseline hold time rises by this fraction per adjustment, so that it follows
+        // workloads whose operations become slower for reasons unrelated to concurrency.
+        double baselineDecay = 0.05;
+    };
+
+    AdaptiveTicketController(TicketHolder* holder, Options options);
+
+    /**
+     * Samples the holder at time 'now' and resizes it if needed. Returns the number of tickets
+     * after the adjustment.
+     */
+    int adjust(Date_t now);
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    enum class Action { kNone, kIncrease, kDecrease };
+
+    TicketHolder* const _holder;
+    const Options _options;
+
+    Date_t _lastSampleTime;
+    long long _lastReleased;
+    long long _lastQueued;
+    double _lastThroughput = 0;
+    Action _lastAction = Action::kNone;
+
+    // The lowest average hold time observed, in seconds, decayed upwards on every adjustment.
+    double _baselineHoldTime = 0;
+
+    long long _numIncreases = 0;
+    long long _numDecreases = 0;
+};
+
+}  // namespace mongo
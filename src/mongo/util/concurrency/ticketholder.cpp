@@ -33,13 +33,152 @@
 
 #include "mongo/util/concurrency/ticketholder.h"
 
-#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <tuple>
 
 #include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
 
+namespace {
+
+// Weight of the most recent wait in TicketHolder::_averageWaitMillis.
+constexpr double kAverageWaitAlpha = 0.1;
+
+// Time over which TicketHolder::_averageWaitMillis halves when no waiter is admitted, so that the
+// waits of a past burst stop shedding operations once the queue is quiet.
+constexpr Milliseconds kAverageWaitHalfLife{1000};
+
+}  // namespace
+
+TicketHolder::Admission TicketHolder::Admission::forOperation(OperationContext* opCtx) {
+    if (!opCtx) {
+        return {OperationContext::Priority::kInteractive, Date_t::max()};
+    }
+    return {opCtx->getPriority(), opCtx->getDeadline()};
+}
+
+bool TicketHolder::WaiterOrder::operator()(const Waiter* lhs, const Waiter* rhs) const {
+    return std::tie(lhs->admission.priority, lhs->admission.deadline, lhs->arrival) <
+        std::tie(rhs->admission.priority, rhs->admission.deadline, rhs->arrival);
+}
+
+void TicketHolder::waitForTicket(OperationContext* opCtx, const Admission& admission) {
+    invariant(waitForTicketUntil(opCtx, Date_t::max(), admission));
+}
+
+void TicketHolder::release() {
+    _numReleased.addAndFetch(1);
+    _returnTicket();
+}
+
+double TicketHolder::_decayAverageWait(WithLock, Date_t now) {
+    if (now > _averageWaitUpdated) {
+        const double halfLives = double(durationCount<Milliseconds>(now - _averageWaitUpdated)) /
+            durationCount<Milliseconds>(kAverageWaitHalfLife);
+        _averageWaitMillis *= std::exp2(-halfLives);
+        _averageWaitUpdated = now;
+    }
+    return _averageWaitMillis;
+}
+
+bool TicketHolder::_waitInQueue(stdx::unique_lock<Latch>& lk,
+                                OperationContext* opCtx,
+                                Date_t until,
+                                const Admission& admission) {
+    const auto now = Date_t::now();
+    Waiter waiter{admission, _nextArrival++, now};
+    _waiters.insert(&waiter);
+    _waitersByArrival.insert(&waiter);
+
+    // Shed operations that are unlikely to be admitted before their own deadline, judging by how
+    // long recent waiters have queued. Uninterruptible acquisitions cannot fail this way.
+    if (opCtx && _sheddingEnabled.load() && _firstWaiter(lk, now) != &waiter &&
+        admission.deadline != Date_t::max()) {
+        const auto averageWaitMillis = _decayAverageWait(lk, now);
+        if (admission.deadline < now + Milliseconds(static_cast<long long>(averageWaitMillis))) {
+            _removeWaiter(lk, &waiter);
+            _numShed.addAndFetch(1);
+            uasserted(opCtx->getTimeoutError(),
+                      str::stream() << "Operation would wait longer than its remaining time for a "
+                                    << "ticket; the recent average wait is " << averageWaitMillis
+                                    << "ms");
+        }
+    }
+
+    _numWaiters.addAndFetch(1);
+    auto guard = makeGuard([&] {
+        if (!lk.owns_lock()) {
+            lk.lock();
+        }
+        if (!waiter.granted) {
+            _removeWaiter(lk, &waiter);
+            _numWaiters.subtractAndFetch(1);
+            return;
+        }
+
+        // The wait was interrupted after a ticket was granted, which must go to someone else.
+        lk.unlock();
+        _returnTicket();
+    });
+
+#if defined(__linux__)
+    // A ticket may have been returned to the semaphore after the caller's last attempt and before
+    // this waiter became visible to releasers.
+    if (tryAcquire()) {
+        _removeWaiter(lk, &waiter);
+        _numWaiters.subtractAndFetch(1);
+        guard.dismiss();
+        return true;
+    }
+#endif
+
+    auto isGranted = [&] { return waiter.granted; };
+    if (opCtx) {
+        opCtx->waitForConditionOrInterruptUntil(waiter.cv, lk, until, isGranted);
+    } else {
+        waiter.cv.wait_until(lk, until.toSystemTimePoint(), isGranted);
+    }
+    if (!waiter.granted) {
+        return false;
+    }
+
+    guard.dismiss();
+    const auto admitted = Date_t::now();
+    const auto waitedMillis = durationCount<Milliseconds>(admitted - waiter.enqueued);
+    _averageWaitMillis = kAverageWaitAlpha * waitedMillis +
+        (1 - kAverageWaitAlpha) * _decayAverageWait(lk, admitted);
+    return true;
+}
+
+TicketHolder::Waiter* TicketHolder::_firstWaiter(WithLock, Date_t now) const {
+    auto oldest = *_waitersByArrival.begin();
+    if (!_priorityOrderEnabled.load() ||
+        now - oldest->enqueued >= Milliseconds(_maxPriorityWaitMillis.load())) {
+        return oldest;
+    }
+    return *_waiters.begin();
+}
+
+void TicketHolder::_removeWaiter(WithLock, Waiter* waiter) {
+    _waiters.erase(waiter);
+    _waitersByArrival.erase(waiter);
+}
+
+void TicketHolder::_grantFirstWaiter(WithLock lk) {
+    invariant(!_waiters.empty());
+    auto waiter = _firstWaiter(lk, Date_t::now());
+    _removeWaiter(lk, waiter);
+    _numWaiters.subtractAndFetch(1);
+
+    // The waiter cannot return, and destroy its condition variable, before the lock is released.
+    waiter->granted = true;
+    waiter->cv.notify_one();
+}
+
 #if defined(__linux__)
 namespace {
 
@@ -61,14 +200,6 @@ void check(int ret) {
         return;
     failWithErrno(errno);
 }
-
-/**
- * Takes a Date_t deadline and sets the appropriate values in a timespec structure.
- */
-void tsFromDate(const Date_t& deadline, struct timespec& ts) {
-    ts.tv_sec = deadline.toTimeT();
-    ts.tv_nsec = (deadline.toMillisSinceEpoch() % 1000) * 1'000'000;
-}
 }  // namespace
 
 TicketHolder::TicketHolder(int num) : _outof(num) {
@@ -89,48 +220,61 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
-}
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx,
+                                      Date_t until,
+                                      const Admission& admission) {
+    if (admission.priority == OperationContext::Priority::kInternal &&
+        _priorityLaneEnabled.load()) {
+        _acquireOrBorrow();
+        return true;
+    }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    // Attempt to get a ticket without waiting in order to avoid expensive time calculations.
-    if (sem_trywait(&_sem) == 0) {
+    // The semaphore is the uncontended fast path. Releases hand tickets directly to queued
+    // waiters, so it is empty while there are any.
+    if (tryAcquire()) {
         return true;
     }
 
-    const Milliseconds intervalMs(500);
-    struct timespec ts;
-
-    // To support interrupting ticket acquisition while still benefiting from semaphores, we do a
-    // timed wait on an interval to periodically check for interrupts.
-    // The wait period interval is the smaller of the default interval and the provided
-    // deadline.
-    Date_t deadline = std::min(until, Date_t::now() + intervalMs);
-    tsFromDate(deadline, ts);
-
-    while (0 != sem_timedwait(&_sem, &ts)) {
-        if (errno == ETIMEDOUT) {
-            // If we reached the deadline without being interrupted, we have completely timed out.
-            if (deadline == until)
-                return false;
-
-            deadline = std::min(until, Date_t::now() + intervalMs);
-            tsFromDate(deadline, ts);
-        } else if (errno != EINTR) {
-            failWithErrno(errno);
+    _numQueued.addAndFetch(1);
+    stdx::unique_lock<Latch> lk(_waitersMutex);
+    return _waitInQueue(lk, opCtx, until, admission);
+}
+
+void TicketHolder::_returnTicket() {
+    // Pay back a withheld release, if any, before making the ticket available to waiters.
+    int withheld = _withheldReleases.load();
+    while (withheld > 0) {
+        if (_withheldReleases.compareAndSwap(&withheld, withheld - 1)) {
+            return;
         }
+    }
 
-        // To correctly handle errors from sem_timedwait, we should check for interrupts last.
-        // It is possible to unset 'errno' after a call to checkForInterrupt().
-        if (opCtx)
-            opCtx->checkForInterrupt();
+    if (_numWaiters.load() > 0) {
+        stdx::lock_guard<Latch> lk(_waitersMutex);
+        if (!_waiters.empty()) {
+            _grantFirstWaiter(lk);
+            return;
+        }
     }
-    return true;
-}
 
-void TicketHolder::release() {
     check(sem_post(&_sem));
+
+    // A waiter that queued after the check above may have missed the ticket just posted. Take it
+    // back out of the semaphore for the first waiter, unless another acquisition got it first.
+    if (_numWaiters.load() > 0) {
+        stdx::lock_guard<Latch> lk(_waitersMutex);
+        if (!_waiters.empty() && tryAcquire()) {
+            _grantFirstWaiter(lk);
+        }
+    }
+}
+
+void TicketHolder::_acquireOrBorrow() {
+    if (tryAcquire()) {
+        return;
+    }
+    _withheldReleases.addAndFetch(1);
+    _numBorrowed.addAndFetch(1);
 }
 
 Status TicketHolder::resize(int newSize) {
@@ -146,12 +290,16 @@ Status TicketHolder::resize(int newSize) {
                                     << "; given " << newSize);
 
     while (_outof.load() < newSize) {
-        release();
+        _returnTicket();
         _outof.fetchAndAdd(1);
     }
 
+    // Take the tickets that are not in use right away and withhold the releases of the rest, so
+    // that shrinking never waits for operations holding tickets to finish.
     while (_outof.load() > newSize) {
-        waitForTicket();
+        if (!tryAcquire()) {
+            _withheldReleases.addAndFetch(1);
+        }
         _outof.subtractAndFetch(1);
     }
 
@@ -166,7 +314,7 @@ int TicketHolder::available() const {
 }
 
 int TicketHolder::used() const {
-    return outof() - available();
+    return outof() - available() + _withheldReleases.load();
 }
 
 int TicketHolder::outof() const {
@@ -180,64 +328,62 @@ TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
 TicketHolder::~TicketHolder() = default;
 
 bool TicketHolder::tryAcquire() {
-    stdx::lock_guard<Latch> lk(_mutex);
-    return _tryAcquire();
+    stdx::lock_guard<Latch> lk(_waitersMutex);
+    return _tryAcquire(lk);
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    stdx::unique_lock<Latch> lk(_mutex);
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx,
+                                      Date_t until,
+                                      const Admission& admission) {
+    if (admission.priority == OperationContext::Priority::kInternal &&
+        _priorityLaneEnabled.load()) {
+        _acquireOrBorrow();
+        return true;
+    }
 
-    if (opCtx) {
-        opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
-    } else {
-        _newTicket.wait(lk, [this] { return _tryAcquire(); });
+    stdx::unique_lock<Latch> lk(_waitersMutex);
+    if (_tryAcquire(lk)) {
+        return true;
     }
-}
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    stdx::unique_lock<Latch> lk(_mutex);
+    _numQueued.addAndFetch(1);
+    return _waitInQueue(lk, opCtx, until, admission);
+}
 
-    if (opCtx) {
-        return opCtx->waitForConditionOrInterruptUntil(
-            _newTicket, lk, until, [this] { return _tryAcquire(); });
-    } else {
-        return _newTicket.wait_until(
-            lk, until.toSystemTimePoint(), [this] { return _tryAcquire(); });
+void TicketHolder::_returnTicket() {
+    stdx::lock_guard<Latch> lk(_waitersMutex);
+    _num++;
+    if (_num > 0 && !_waiters.empty()) {
+        _num--;
+        _grantFirstWaiter(lk);
     }
 }
 
-void TicketHolder::release() {
-    {
-        stdx::lock_guard<Latch> lk(_mutex);
-        _num++;
+void TicketHolder::_acquireOrBorrow() {
+    stdx::lock_guard<Latch> lk(_waitersMutex);
+    if (_num <= 0) {
+        _numBorrowed.addAndFetch(1);
     }
-    _newTicket.notify_one();
+    _num--;
 }
 
 Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<Latch> lk(_mutex);
+    stdx::lock_guard<Latch> lk(_waitersMutex);
 
+    // Tickets in use beyond 'newSize' leave '_num' negative until they are released.
     int used = _outof.load() - _num;
-    if (used > newSize) {
-        std::stringstream ss;
-        ss << "can't resize since we're using (" << used << ") "
-           << "more than newSize(" << newSize << ")";
-
-        std::string errmsg = ss.str();
-        LOGV2(23120, "{errmsg}", "errmsg"_attr = errmsg);
-        return Status(ErrorCodes::BadValue, errmsg);
-    }
-
     _outof.store(newSize);
-    _num = _outof.load() - used;
+    _num = newSize - used;
 
-    // Potentially wasteful, but easier to see is correct
-    _newTicket.notify_all();
+    while (_num > 0 && !_waiters.empty()) {
+        _num--;
+        _grantFirstWaiter(lk);
+    }
     return Status::OK();
 }
 
 int TicketHolder::available() const {
-    return _num;
+    return std::max(_num, 0);
 }
 
 int TicketHolder::used() const {
@@ -248,11 +394,8 @@ int TicketHolder::outof() const {
     return _outof.load();
 }
 
-bool TicketHolder::_tryAcquire() {
+bool TicketHolder::_tryAcquire(WithLock) {
     if (_num <= 0) {
-        if (_num < 0) {
-            std::cerr << "DISASTER! in TicketHolder" << std::endl;
-        }
         return false;
     }
     _num--;
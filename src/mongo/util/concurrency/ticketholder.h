@@ -28,14 +28,18 @@
  */
 #pragma once
 
+#include <set>
+
 #if defined(__linux__)
 #include <semaphore.h>
 #endif
 
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/hierarchical_acquisition.h"
 #include "mongo/util/time_support.h"
 
@@ -46,6 +50,19 @@ class TicketHolder {
     TicketHolder& operator=(const TicketHolder&) = delete;
 
 public:
+    /**
+     * How an acquisition is ordered among the waiters for a ticket when priority order is enabled.
+     * See setPriorityOrderEnabled().
+     */
+    struct Admission {
+        static Admission forOperation(OperationContext* opCtx);
+
+        OperationContext::Priority priority;
+
+        // The deadline of the operation itself, which may be later than the deadline of the wait.
+        Date_t deadline;
+    };
+
     explicit TicketHolder(int num);
     ~TicketHolder();
 
@@ -56,7 +73,10 @@ public:
      * 'opCtx' is killed, throwing an AssertionException.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    void waitForTicket(OperationContext* opCtx);
+    void waitForTicket(OperationContext* opCtx, const Admission& admission);
+    void waitForTicket(OperationContext* opCtx) {
+        waitForTicket(opCtx, Admission::forOperation(opCtx));
+    }
     void waitForTicket() {
         waitForTicket(nullptr);
     }
@@ -65,15 +85,22 @@ public:
      * Attempts to acquire a ticket within a deadline, 'until'. Returns 'true' if a ticket is
      * acquired and 'false' if the deadline is reached, but the operation is retryable. Throws an
      * AssertionException if the OperationContext 'opCtx' is killed and no waits for tickets can
-     * proceed.
+     * proceed, or if shedding is enabled and the operation would wait past its own deadline.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    bool waitForTicketUntil(OperationContext* opCtx, Date_t until);
+    bool waitForTicketUntil(OperationContext* opCtx, Date_t until, const Admission& admission);
+    bool waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+        return waitForTicketUntil(opCtx, until, Admission::forOperation(opCtx));
+    }
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
     void release();
 
+    /**
+     * Changes the number of tickets. Shrinking never waits: tickets that are in use when the
+     * holder shrinks are withheld from the releases that return them.
+     */
     Status resize(int newSize);
 
     int available() const;
@@ -82,21 +109,154 @@ public:
 
     int outof() const;
 
+    /**
+     * The number of acquisitions currently queued for a ticket.
+     */
+    int waiting() const {
+        return _numWaiters.load();
+    }
+
+    /**
+     * When the priority lane is enabled, kInternal acquisitions take a ticket without waiting even
+     * if none is available, so that they never queue behind user operations. A ticket taken while
+     * none was available is borrowed: outof() is temporarily exceeded until a later release() is
+     * withheld to pay it back.
+     */
+    void setPriorityLaneEnabled(bool enabled) {
+        _priorityLaneEnabled.store(enabled);
+    }
+
+    /**
+     * Waiters are admitted in order of arrival unless priority order is enabled, in which case
+     * they are admitted in order of priority, then of deadline, then of arrival. So that waiters
+     * of low priority or without a deadline are not starved, a waiter that has been queued for
+     * longer than the maximum priority wait is admitted first, oldest first, in either order.
+     */
+    void setPriorityOrderEnabled(bool enabled) {
+        _priorityOrderEnabled.store(enabled);
+    }
+    void setMaxPriorityWait(Milliseconds maxWait) {
+        _maxPriorityWaitMillis.store(durationCount<Milliseconds>(maxWait));
+    }
+
+    /**
+     * When shedding is enabled, an interruptible acquisition fails with the operation's timeout
+     * error instead of queueing if it has waiters ahead of it and its deadline is nearer than the
+     * recent average wait for a ticket.
+     */
+    void setSheddingEnabled(bool enabled) {
+        _sheddingEnabled.store(enabled);
+    }
+
+    /**
+     * Cumulative counts of tickets released, of acquisitions that had to wait for a ticket, of
+     * tickets borrowed by the priority lane and of acquisitions shed. numReleased() and
+     * numQueued() feed AdaptiveTicketController.
+     */
+    long long numReleased() const {
+        return _numReleased.loadRelaxed();
+    }
+    long long numQueued() const {
+        return _numQueued.loadRelaxed();
+    }
+    long long numBorrowed() const {
+        return _numBorrowed.loadRelaxed();
+    }
+    long long numShed() const {
+        return _numShed.loadRelaxed();
+    }
+
 private:
+    // An acquisition waiting in '_waiters' until a releaser grants it a ticket.
+    struct Waiter {
+        Admission admission;
+        std::uint64_t arrival;
+        Date_t enqueued;
+        bool granted = false;
+        stdx::condition_variable cv;
+    };
+
+    struct WaiterOrder {
+        bool operator()(const Waiter* lhs, const Waiter* rhs) const;
+    };
+
+    struct ArrivalOrder {
+        bool operator()(const Waiter* lhs, const Waiter* rhs) const {
+            return lhs->arrival < rhs->arrival;
+        }
+    };
+
+    // Takes a ticket without waiting, borrowing one if none is available.
+    void _acquireOrBorrow();
+
+    // Makes a released ticket available again: pays back a withheld release if one is owed, and
+    // otherwise grants the ticket to the first waiter, if any.
+    void _returnTicket();
+
+    // Queues the caller in '_waiters' until it is granted a ticket, 'until' passes or 'opCtx' is
+    // interrupted. Returns whether a ticket was granted.
+    bool _waitInQueue(stdx::unique_lock<Latch>& lk,
+                      OperationContext* opCtx,
+                      Date_t until,
+                      const Admission& admission);
+
+    // Returns the waiter to admit next, according to the order in effect at 'now'.
+    Waiter* _firstWaiter(WithLock, Date_t now) const;
+
+    // Removes 'waiter' from both orderings of the waiters.
+    void _removeWaiter(WithLock, Waiter* waiter);
+
+    // Removes the waiter to admit next and wakes it with a ticket.
+    void _grantFirstWaiter(WithLock);
+
+    // Decays '_averageWaitMillis' for the time since it was last updated and returns it.
+    double _decayAverageWait(WithLock, Date_t now);
+
+    AtomicWord<bool> _priorityLaneEnabled{false};
+    AtomicWord<bool> _sheddingEnabled{false};
+    AtomicWord<bool> _priorityOrderEnabled{false};
+    AtomicWord<long long> _maxPriorityWaitMillis{1000};
+    AtomicWord<long long> _numReleased{0};
+    AtomicWord<long long> _numQueued{0};
+    AtomicWord<long long> _numBorrowed{0};
+    AtomicWord<long long> _numShed{0};
+
+    // Protects '_waiters' and the members below it. On platforms without semaphores, it also
+    // protects the count of available tickets.
+    Mutex _waitersMutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_waitersMutex");
+    // The queued waiters in priority order and in order of arrival.
+    std::set<Waiter*, WaiterOrder> _waiters;
+    std::set<Waiter*, ArrivalOrder> _waitersByArrival;
+    std::uint64_t _nextArrival = 0;
+
+    // Moving average of the time waiters spent queued before they were granted a ticket, decayed
+    // over time while no waiter is granted one, and when it was last updated.
+    double _averageWaitMillis = 0;
+    Date_t _averageWaitUpdated;
+
+    // The size of '_waiters', readable without '_waitersMutex'.
+    AtomicWord<int> _numWaiters{0};
+
 #if defined(__linux__)
     mutable sem_t _sem;
 
+    // The number of future releases that must not post the semaphore, either to pay back borrowed
+    // tickets or to complete a shrink of the holder.
+    AtomicWord<int> _withheldReleases{0};
+
     // You can read _outof without a lock, but have to hold _resizeMutex to change.
     AtomicWord<int> _outof;
     Mutex _resizeMutex =
-        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_resizeMutex");
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1), "TicketHolder::_resizeMutex");
 #else
-    bool _tryAcquire();
+    bool _tryAcquire(WithLock);
 
     AtomicWord<int> _outof;
+
+    // A negative count is the number of tickets borrowed, or still in use after a shrink, that
+    // later releases pay back before waiters are granted tickets.
     int _num;
-    Mutex _mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_mutex");
-    stdx::condition_variable _newTicket;
 #endif
 };
 
@@ -32,8 +32,15 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/adaptive_ticket_controller.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
 
 namespace {
 using namespace mongo;
@@ -72,4 +79,214 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, ShrinkWithTicketsInUseDoesNotWait) {
+    TicketHolder holder(10);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    ASSERT_OK(holder.resize(5));
+    ASSERT_EQ(holder.outof(), 5);
+    ASSERT_EQ(holder.available(), 0);
+    ASSERT_EQ(holder.used(), 8);
+
+    // The first three releases pay back the tickets in use beyond the new size.
+    for (int i = 0; i < 3; ++i) {
+        holder.release();
+        ASSERT_EQ(holder.available(), 0);
+    }
+    holder.release();
+    ASSERT_EQ(holder.available(), 1);
+    ASSERT_EQ(holder.used(), 4);
+
+    for (int i = 0; i < 4; ++i) {
+        holder.release();
+    }
+    ASSERT_EQ(holder.available(), 5);
+    ASSERT_EQ(holder.used(), 0);
+}
+
+TEST(TicketholderTest, PriorityLaneBorrowsTickets) {
+    TicketHolder holder(1);
+    ASSERT(holder.tryAcquire());
+
+    const TicketHolder::Admission internal{OperationContext::Priority::kInternal, Date_t::max()};
+
+    // Without the priority lane, internal acquisitions wait like the others.
+    ASSERT_FALSE(holder.waitForTicketUntil(nullptr, Date_t::now() + Milliseconds(1), internal));
+    ASSERT_EQ(holder.numBorrowed(), 0);
+
+    holder.setPriorityLaneEnabled(true);
+    ASSERT(holder.waitForTicketUntil(nullptr, Date_t::now(), internal));
+    ASSERT_EQ(holder.numBorrowed(), 1);
+    ASSERT_EQ(holder.used(), 2);
+    ASSERT_EQ(holder.available(), 0);
+
+    // The borrowed ticket is paid back before a normal waiter can be admitted.
+    holder.release();
+    ASSERT_FALSE(holder.tryAcquire());
+    holder.release();
+    ASSERT_EQ(holder.available(), 1);
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT_EQ(holder.numReleased(), 2);
+}
+
+// Queues a waiter for each of 'admissions' in turn behind the only ticket of 'holder', releases
+// that ticket and returns the indexes of the waiters in the order they were admitted.
+std::vector<size_t> admitQueued(TicketHolder& holder,
+                                const std::vector<TicketHolder::Admission>& admissions) {
+    ASSERT(holder.tryAcquire());
+
+    Mutex mutex = MONGO_MAKE_LATCH();
+    std::vector<size_t> admitted;
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < admissions.size(); ++i) {
+        threads.emplace_back([&, i] {
+            holder.waitForTicket(nullptr, admissions[i]);
+            {
+                stdx::lock_guard<Latch> lk(mutex);
+                admitted.push_back(i);
+            }
+            holder.release();
+        });
+
+        // Queue the waiters one at a time, so that their arrival order is known.
+        while (holder.waiting() < static_cast<int>(i + 1)) {
+            sleepmillis(1);
+        }
+    }
+
+    holder.release();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(holder.available(), 1);
+    return admitted;
+}
+
+std::vector<TicketHolder::Admission> mixedAdmissions() {
+    const auto now = Date_t::now();
+    return {
+        {OperationContext::Priority::kBatch, Date_t::max()},
+        {OperationContext::Priority::kInteractive, Date_t::max()},
+        {OperationContext::Priority::kInteractive, now + Hours(1)},
+        {OperationContext::Priority::kInternal, Date_t::max()},
+    };
+}
+
+TEST(TicketholderTest, WaitersAreAdmittedInArrivalOrderByDefault) {
+    TicketHolder holder(1);
+    ASSERT(admitQueued(holder, mixedAdmissions()) == (std::vector<size_t>{0, 1, 2, 3}));
+}
+
+TEST(TicketholderTest, WaitersAreAdmittedByPriorityThenDeadline) {
+    TicketHolder holder(1);
+    holder.setPriorityOrderEnabled(true);
+    holder.setMaxPriorityWait(Hours(1));
+    ASSERT(admitQueued(holder, mixedAdmissions()) == (std::vector<size_t>{3, 2, 1, 0}));
+
+    // Switching back at runtime restores the arrival order.
+    holder.setPriorityOrderEnabled(false);
+    ASSERT(admitQueued(holder, mixedAdmissions()) == (std::vector<size_t>{0, 1, 2, 3}));
+}
+
+TEST(TicketholderTest, WaitersQueuedPastMaxPriorityWaitAreAdmittedFirst) {
+    TicketHolder holder(1);
+    holder.setPriorityOrderEnabled(true);
+    holder.setMaxPriorityWait(Milliseconds(200));
+    ASSERT(holder.tryAcquire());
+
+    const TicketHolder::Admission batch{OperationContext::Priority::kBatch, Date_t::max()};
+    const TicketHolder::Admission interactive{OperationContext::Priority::kInteractive,
+                                              Date_t::max()};
+
+    AtomicWord<bool> batchAdmitted{false};
+    AtomicWord<int> interactiveAdmittedFirst{0};
+    stdx::thread batchThread([&] {
+        holder.waitForTicket(nullptr, batch);
+        batchAdmitted.store(true);
+        holder.release();
+    });
+    while (holder.waiting() < 1) {
+        sleepmillis(1);
+    }
+
+    // Keep an interactive waiter queued ahead of the batch waiter until the latter has been
+    // queued long enough to be admitted regardless of its priority.
+    std::vector<stdx::thread> interactiveThreads;
+    bool released = false;
+    while (!batchAdmitted.load()) {
+        if (holder.waiting() < 2) {
+            interactiveThreads.emplace_back([&] {
+                holder.waitForTicket(nullptr, interactive);
+                if (!batchAdmitted.load()) {
+                    interactiveAdmittedFirst.addAndFetch(1);
+                }
+                sleepmillis(1);
+                holder.release();
+            });
+            while (holder.waiting() < 2 && !batchAdmitted.load()) {
+                sleepmillis(1);
+            }
+        }
+        if (!released) {
+            holder.release();
+            released = true;
+        }
+        sleepmillis(1);
+    }
+
+    batchThread.join();
+    for (auto& thread : interactiveThreads) {
+        thread.join();
+    }
+    ASSERT_GT(interactiveAdmittedFirst.load(), 0);
+    ASSERT_EQ(holder.available(), 1);
+}
+
+TEST(AdaptiveTicketControllerTest, GrowsWhileSaturatedAndShrinksWhenCongested) {
+    TicketHolder holder(16);
+    AdaptiveTicketController::Options options;
+    options.minTickets = 8;
+    options.maxTickets = 24;
+    options.additiveIncrease = 4;
+    options.multiplicativeDecrease = 0.5;
+    AdaptiveTicketController controller(&holder, options);
+
+    auto now = Date_t::now();
+    ASSERT_EQ(controller.adjust(now), 16);
+
+    // Runs one interval in which 'completed' operations finish and one operation queues, leaving
+    // 'inUse' tickets held at the end of the interval.
+    auto runSaturatedInterval = [&](int completed, int inUse) {
+        for (int i = 0; i < completed; ++i) {
+            ASSERT(holder.tryAcquire());
+            holder.release();
+        }
+        for (int i = 0; i < inUse; ++i) {
+            ASSERT(holder.tryAcquire());
+        }
+        ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now()));
+        now += Seconds(1);
+        int size = controller.adjust(now);
+        for (int i = 0; i < inUse; ++i) {
+            holder.release();
+        }
+        return size;
+    };
+
+    // Throughput keeps up with the added concurrency, so the controller grows up to the maximum.
+    ASSERT_EQ(runSaturatedInterval(1000, 16), 20);
+    ASSERT_EQ(runSaturatedInterval(1250, 20), 24);
+    ASSERT_EQ(runSaturatedInterval(1500, 24), 24);
+
+    // The same concurrency completes far fewer operations: each holds its ticket for longer.
+    ASSERT_EQ(runSaturatedInterval(300, 24), 12);
+    ASSERT_EQ(holder.outof(), 12);
+
+    // Nothing queues for a ticket in this interval, so nothing changes.
+    now += Seconds(1);
+    ASSERT_EQ(controller.adjust(now), 12);
+}
 }  // namespace